@@ -22,7 +22,7 @@ FUZZ_AIRSPACE_PARSER_SOURCES = \
 	$(SRC)/Atmosphere/Pressure.cpp \
 	$(SRC)/RadioFrequency.cpp \
 	$(FUZZER_SRC_DIR)/FuzzAirspaceParser.cpp
-FUZZ_AIRSPACE_PARSER_DEPENDS = IO OS AIRSPACE ZZIP GEO MATH UTIL UNITS
+FUZZ_AIRSPACE_PARSER_DEPENDS = IO OS AIRSPACE ZZIP THREAD GEO MATH UTIL UNITS
 $(eval $(call link-program,FuzzAirspaceParser,FUZZ_AIRSPACE_PARSER))
 
 FUZZ_TOPOGRAPHY_FILE_SOURCES = \
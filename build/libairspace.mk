@@ -15,6 +15,7 @@ AIRSPACE_SOURCES = \
 	$(AIRSPACE_SRC_DIR)/Predicate/AirspacePredicateHeightRange.cpp \
 	$(AIRSPACE_SRC_DIR)/Predicate/OutsideAirspacePredicate.cpp \
 	$(AIRSPACE_SRC_DIR)/AirspaceIntersectionVisitor.cpp \
+	$(AIRSPACE_SRC_DIR)/AirspaceCandidateCache.cpp \
 	$(AIRSPACE_SRC_DIR)/AirspaceWarningConfig.cpp \
 	$(AIRSPACE_SRC_DIR)/AirspaceWarningManager.cpp \
 	$(AIRSPACE_SRC_DIR)/AirspaceWarning.cpp \
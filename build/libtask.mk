@@ -26,6 +26,7 @@ TASK_SOURCES = \
 	$(TASK_SRC_DIR)/Unordered/UnorderedTask.cpp \
 	$(TASK_SRC_DIR)/Unordered/UnorderedTaskPoint.cpp \
 	$(TASK_SRC_DIR)/Unordered/GotoTask.cpp \
+	$(TASK_SRC_DIR)/Unordered/AbortCandidates.cpp \
 	$(TASK_SRC_DIR)/Unordered/AbortTask.cpp \
 	$(TASK_SRC_DIR)/Unordered/AlternateTask.cpp \
 	$(TASK_SRC_DIR)/Factory/AbstractTaskFactory.cpp \
@@ -1,6 +1,7 @@
 TOPO_SOURCES = \
 	$(SRC)/Topography/ShapeFile.cpp \
 	$(SRC)/Topography/TopographyFile.cpp \
+	$(SRC)/Topography/ShapeCache.cpp \
 	$(SRC)/Topography/TopographyStore.cpp \
 	$(SRC)/Topography/TopographyFileRenderer.cpp \
 	$(SRC)/Topography/TopographyRenderer.cpp \
@@ -39,6 +39,13 @@ endif
 # compile without UI?
 HEADLESS ?= n
 
+# store the flight trace in contiguous arrays (FlatTrace) instead of
+# node-based containers (ListTrace)?
+FLAT_TRACE ?= n
+ifeq ($(FLAT_TRACE),y)
+  TARGET_CPPFLAGS += -DFLAT_TRACE
+endif
+
 ifeq ($(TARGET_IS_KOBO),y)
   DITHER ?= y
 else
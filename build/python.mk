@@ -7,8 +7,9 @@ python: $(call name-to-so,xcsoar)
 PYTHON_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/IGC/IGCFix.cpp \
+	$(ENGINE_SRC_DIR)/Trace/FlatTrace.cpp \
+	$(ENGINE_SRC_DIR)/Trace/ListTrace.cpp \
 	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
-	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
 	$(SRC)/Computer/CirclingComputer.cpp \
 	$(SRC)/Computer/Wind/Settings.cpp \
 	$(SRC)/Computer/Wind/WindEKF.cpp \
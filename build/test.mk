@@ -52,8 +52,10 @@ TEST1_DEPENDS = HARNESS TASK ROUTE GLIDE CONTEST WAYPOINT AIRSPACE IO OS THREAD
 
 define link-harness-program
 $(1)_SOURCES = \
+	$(SRC)/Engine/Trace/FlatTrace.cpp \
+	$(SRC)/Engine/Trace/ListTrace.cpp \
 	$(SRC)/Engine/Trace/Point.cpp \
-	$(SRC)/Engine/Trace/Trace.cpp \
+	$(SRC)/Engine/Trace/Snapshot.cpp \
 	$(SRC)/Engine/Trace/Vector.cpp \
 	$(SRC)/Engine/Navigation/Aircraft.cpp \
 	$(SRC)/Engine/Util/Gradient.cpp \
@@ -79,6 +81,7 @@ TEST_NAMES = \
 	TestInputTransformMode \
 	TestOverwritingRingBuffer \
 	TestDateTime TestRoughTime TestWrapClock \
+	TestLatencyHistogram \
 	TestPolylineDecoder \
 	TestTransponderCode \
 	TestMath \
@@ -93,9 +96,11 @@ TEST_NAMES = \
 	TestWaypointReader TestThermalBase \
 	TestFlarmNet TestFlarmMessaging \
 	TestColorRamp TestGeoPoint TestDiffFilter \
+	TestShadingKernel \
 	TestFileUtil TestPolars TestCSVLine TestGlidePolar \
 	test_replay_task TestProjection TestFlatPoint TestFlatLine TestFlatGeoPoint \
 	TestMacCready TestOrderedTask TestAATPoint TestTaskSave \
+	TestAbortTask \
 	TestTaskFileSeeYouParsing \
 	TestPlanes \
 	TestTaskPoint \
@@ -103,8 +108,10 @@ TEST_NAMES = \
 	TestTeamCode \
 	TestZeroFinder \
 	TestAirspaceParser \
+	TestPolygonSlabIndex \
 	TestMETARParser \
 	TestIGCParser \
+	TestFlatTrace \
 	TestStrings TestUTF8 TestWrapText \
 	TestInputConfig \
 	TestCRC16 TestCRC8 \
@@ -193,6 +200,7 @@ TEST_METAR_PARSER_DEPENDS = MATH UTIL UNITS
 $(eval $(call link-program,TestMETARParser,TEST_METAR_PARSER))
 
 TEST_AIRSPACE_PARSER_SOURCES = \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Airspace/AirspaceParser.cpp \
 	$(SRC)/Atmosphere/Pressure.cpp \
 	$(SRC)/RadioFrequency.cpp \
@@ -203,15 +211,34 @@ TEST_AIRSPACE_PARSER_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestAirspaceParser.cpp
 TEST_AIRSPACE_PARSER_LDADD = $(FAKE_LIBS)
-TEST_AIRSPACE_PARSER_DEPENDS = IO OS AIRSPACE UNITS ZZIP GEO MATH UTIL UNITS
+TEST_AIRSPACE_PARSER_DEPENDS = IO OS AIRSPACE UNITS ZZIP THREAD GEO MATH UTIL UNITS
 $(eval $(call link-program,TestAirspaceParser,TEST_AIRSPACE_PARSER))
 
+TEST_POLYGON_SLAB_INDEX_SOURCES = \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(SRC)/TransponderCode.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/FakeLanguage.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestPolygonSlabIndex.cpp
+TEST_POLYGON_SLAB_INDEX_LDADD = $(FAKE_LIBS)
+TEST_POLYGON_SLAB_INDEX_DEPENDS = IO OS AIRSPACE UNITS ZZIP THREAD GEO MATH UTIL
+$(eval $(call link-program,TestPolygonSlabIndex,TEST_POLYGON_SLAB_INDEX))
+
 TEST_DATE_TIME_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestDateTime.cpp
 TEST_DATE_TIME_DEPENDS = MATH TIME
 $(eval $(call link-program,TestDateTime,TEST_DATE_TIME))
 
+TEST_LATENCY_HISTOGRAM_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestLatencyHistogram.cpp
+TEST_LATENCY_HISTOGRAM_DEPENDS =
+$(eval $(call link-program,TestLatencyHistogram,TEST_LATENCY_HISTOGRAM))
+
 TEST_POLYLINE_DECODER_SOURCES = \
 	$(SRC)/Task/PolylineDecoder.cpp \
 	$(TEST_SRC_DIR)/tap.c \
@@ -264,6 +291,16 @@ TEST_ORDERED_TASK_OBJS = $(call SRC_TO_OBJ,$(TEST_ORDERED_TASK_SOURCES))
 TEST_ORDERED_TASK_DEPENDS = TASK ROUTE GLIDE WAYPOINT GEO TIME MATH UTIL
 $(eval $(call link-program,TestOrderedTask,TEST_ORDERED_TASK))
 
+TEST_ABORT_TASK_SOURCES = \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(SRC)/Engine/Util/Gradient.cpp \
+	$(SRC)/NMEA/FlyingState.cpp \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestAbortTask.cpp
+TEST_ABORT_TASK_OBJS = $(call SRC_TO_OBJ,$(TEST_ABORT_TASK_SOURCES))
+TEST_ABORT_TASK_DEPENDS = TASK ROUTE GLIDE WAYPOINT GEO TIME MATH UTIL
+$(eval $(call link-program,TestAbortTask,TEST_ABORT_TASK))
+
 TEST_AAT_POINT_SOURCES = \
 	$(SRC)/Engine/Util/Gradient.cpp \
 	$(SRC)/Engine/Navigation/Aircraft.cpp \
@@ -296,7 +333,7 @@ TEST_TASKFILE_SEEYOU_PARSING_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
 	$(TEST_SRC_DIR)/TestTaskFileSeeYouParsing.cpp
 TEST_TASKFILE_SEEYOU_PARSING_OBJS = $(call SRC_TO_OBJ,$(TEST_TASKFILE_SEEYOU_PARSING_SOURCES))
-TEST_TASKFILE_SEEYOU_PARSING_DEPENDS = TASK TASKFILE ROUTE GLIDE WAYPOINT WAYPOINTFILE GEO TIME MATH UTIL XML IO UNITS LIBNMEA TERRAIN ZZIP
+TEST_TASKFILE_SEEYOU_PARSING_DEPENDS = TASK TASKFILE ROUTE GLIDE WAYPOINT WAYPOINTFILE GEO TIME MATH UTIL XML IO UNITS LIBNMEA TERRAIN ZZIP OS THREAD
 $(eval $(call link-program,TestTaskFileSeeYouParsing,TEST_TASKFILE_SEEYOU_PARSING))
 
 TEST_PLANES_SOURCES = \
@@ -670,6 +707,11 @@ TEST_COLOR_RAMP_SOURCES = \
 TEST_COLOR_RAMP_CPPFLAGS = $(SCREEN_CPPFLAGS)
 $(eval $(call link-program,TestColorRamp,TEST_COLOR_RAMP))
 
+TEST_SHADING_KERNEL_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(TEST_SRC_DIR)/TestShadingKernel.cpp
+$(eval $(call link-program,TestShadingKernel,TEST_SHADING_KERNEL))
+
 TEST_SUN_EPHEMERIS_SOURCES = \
 	$(SRC)/Math/SunEphemeris.cpp \
 	$(TEST_SRC_DIR)/tap.c \
@@ -779,8 +821,9 @@ $(eval $(call link-program,TestWaypointReader,TEST_WAY_POINT_FILE))
 
 TEST_TRACE_SOURCES = \
 	$(TEST_SRC_DIR)/tap.c \
+	$(SRC)/Engine/Trace/FlatTrace.cpp \
+	$(SRC)/Engine/Trace/ListTrace.cpp \
 	$(SRC)/Engine/Trace/Point.cpp \
-	$(SRC)/Engine/Trace/Trace.cpp \
 	$(SRC)/IGC/IGCParser.cpp \
 	$(TEST_SRC_DIR)/FakeTerrain.cpp \
 	$(TEST_SRC_DIR)/Printing.cpp \
@@ -788,6 +831,17 @@ TEST_TRACE_SOURCES = \
 TEST_TRACE_DEPENDS = IO OS GEO MATH UTIL
 $(eval $(call link-program,TestTrace,TEST_TRACE))
 
+TEST_FLAT_TRACE_SOURCES = \
+	$(TEST_SRC_DIR)/tap.c \
+	$(SRC)/Engine/Trace/FlatTrace.cpp \
+	$(SRC)/Engine/Trace/ListTrace.cpp \
+	$(SRC)/Engine/Trace/Point.cpp \
+	$(SRC)/Engine/Trace/Vector.cpp \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(TEST_SRC_DIR)/TestFlatTrace.cpp
+TEST_FLAT_TRACE_DEPENDS = IO OS GEO MATH UTIL
+$(eval $(call link-program,TestFlatTrace,TEST_FLAT_TRACE))
+
 FLIGHT_TABLE_SOURCES = \
 	$(SRC)/IGC/IGCParser.cpp \
 	$(TEST_SRC_DIR)/FlightTable.cpp
@@ -814,6 +868,10 @@ DEBUG_PROGRAM_NAMES = \
 	FlightTable \
 	BenchmarkProjection \
 	BenchmarkFAITriangleSector \
+	BenchmarkAirspaceWarnings \
+	BenchmarkGlidePolar \
+	BenchmarkTrace \
+	BenchmarkTraceSnapshot \
 	DumpTextInflate \
 	DumpHexColor \
 	RunXMLParser \
@@ -823,6 +881,8 @@ DEBUG_PROGRAM_NAMES = \
 	AddChecksum \
 	LoadTopography LoadTerrain \
 	RunHeightMatrix \
+	BenchmarkTerrainShader \
+	BenchmarkTerrainHeights \
 	RunInputParser \
 	RunWaypointParser RunAirspaceParser \
 	RunFlightParser \
@@ -841,6 +901,7 @@ ifeq ($(TARGET_IS_ANDROID),n)
 DEBUG_PROGRAM_NAMES += \
 	RunTrace \
 	RunContestAnalysis \
+	RunContestBudget \
 	RunWaveComputer \
 	FlightPath \
 	ReadProfileString ReadProfileInt \
@@ -871,6 +932,7 @@ DEBUG_PROGRAM_NAMES += \
 	RunProgressWindow \
 	RunJobDialog \
 	RunAnalysis \
+	RunCalculationTiming \
 	RunAirspaceWarningDialog \
 	RunProfileListDialog \
 	TestNotify \
@@ -885,7 +947,9 @@ endif
 ifeq ($(TARGET),UNIX)
 DEBUG_PROGRAM_NAMES += \
 	AnalyseFlight \
-	FeedFlyNetData
+	FeedFlyNetData \
+	RunCloudLoad \
+	BenchmarkCloudDatabase
 endif
 
 ifeq ($(TARGET),PC)
@@ -986,6 +1050,49 @@ BENCHMARK_FAI_TRIANGLE_SECTOR_SOURCES = \
 BENCHMARK_FAI_TRIANGLE_SECTOR_DEPENDS = GEO MATH
 $(eval $(call link-program,BenchmarkFAITriangleSector,BENCHMARK_FAI_TRIANGLE_SECTOR))
 
+BENCHMARK_AIRSPACE_WARNINGS_SOURCES = \
+	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Atmosphere/Pressure.cpp \
+	$(SRC)/Engine/Navigation/Aircraft.cpp \
+	$(SRC)/RadioFrequency.cpp \
+	$(SRC)/TransponderCode.cpp \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(TEST_SRC_DIR)/FakeTerrain.cpp \
+	$(TEST_SRC_DIR)/FakeLanguage.cpp \
+	$(TEST_SRC_DIR)/BenchmarkAirspaceWarnings.cpp
+BENCHMARK_AIRSPACE_WARNINGS_LDADD = $(FAKE_LIBS)
+BENCHMARK_AIRSPACE_WARNINGS_DEPENDS = AIRSPACE TASK GLIDE IO OS ZZIP THREAD GEO TIME MATH UTIL UNITS
+$(eval $(call link-program,BenchmarkAirspaceWarnings,BENCHMARK_AIRSPACE_WARNINGS))
+
+BENCHMARK_GLIDE_POLAR_SOURCES = \
+	$(ENGINE_SRC_DIR)/GlideSolvers/GlidePolar.cpp \
+	$(ENGINE_SRC_DIR)/GlideSolvers/GlideResult.cpp \
+	$(ENGINE_SRC_DIR)/GlideSolvers/GlideState.cpp \
+	$(ENGINE_SRC_DIR)/GlideSolvers/MacCready.cpp \
+	$(TEST_SRC_DIR)/BenchmarkGlidePolar.cpp
+BENCHMARK_GLIDE_POLAR_DEPENDS = GEO MATH
+$(eval $(call link-program,BenchmarkGlidePolar,BENCHMARK_GLIDE_POLAR))
+
+BENCHMARK_TRACE_SOURCES = \
+	$(SRC)/Engine/Trace/FlatTrace.cpp \
+	$(SRC)/Engine/Trace/ListTrace.cpp \
+	$(SRC)/Engine/Trace/Point.cpp \
+	$(SRC)/Engine/Trace/Vector.cpp \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(TEST_SRC_DIR)/BenchmarkTrace.cpp
+BENCHMARK_TRACE_DEPENDS = IO OS GEO MATH UTIL
+$(eval $(call link-program,BenchmarkTrace,BENCHMARK_TRACE))
+
+BENCHMARK_TRACE_SNAPSHOT_SOURCES = \
+	$(SRC)/Engine/Trace/FlatTrace.cpp \
+	$(SRC)/Engine/Trace/ListTrace.cpp \
+	$(SRC)/Engine/Trace/Point.cpp \
+	$(SRC)/Engine/Trace/Snapshot.cpp \
+	$(SRC)/Engine/Trace/Vector.cpp \
+	$(TEST_SRC_DIR)/BenchmarkTraceSnapshot.cpp
+BENCHMARK_TRACE_SNAPSHOT_DEPENDS = GEO MATH UTIL
+$(eval $(call link-program,BenchmarkTraceSnapshot,BENCHMARK_TRACE_SNAPSHOT))
+
 DUMP_TEXT_FILE_SOURCES = \
 	$(TEST_SRC_DIR)/DumpTextFile.cpp
 DUMP_TEXT_FILE_DEPENDS = IO OS ZZIP UTIL
@@ -1093,6 +1200,25 @@ RUN_SL_TRACKING_SOURCES = \
 RUN_SL_TRACKING_DEPENDS = $(DEBUG_REPLAY_DEPENDS)
 $(eval $(call link-program,RunSkyLinesTracking,RUN_SL_TRACKING))
 
+RUN_CLOUD_LOAD_SOURCES = \
+	$(SRC)/Tracking/SkyLines/Assemble.cpp \
+	$(TEST_SRC_DIR)/RunCloudLoad.cpp
+RUN_CLOUD_LOAD_DEPENDS = ASYNC LIBNET IO OS GEO MATH UTIL
+$(eval $(call link-program,RunCloudLoad,RUN_CLOUD_LOAD))
+
+BENCHMARK_CLOUD_DATABASE_SOURCES = \
+	$(SRC)/Tracking/SkyLines/Assemble.cpp \
+	$(SRC)/Cloud/Serialiser.cpp \
+	$(SRC)/Cloud/Client.cpp \
+	$(SRC)/Cloud/Thermal.cpp \
+	$(SRC)/Cloud/Data.cpp \
+	$(SRC)/Cloud/Shards.cpp \
+	$(SRC)/Cloud/Journal.cpp \
+	$(SRC)/Cloud/Persist.cpp \
+	$(TEST_SRC_DIR)/BenchmarkCloudDatabase.cpp
+BENCHMARK_CLOUD_DATABASE_DEPENDS = ASYNC LIBNET IO OS THREAD GEO MATH UTIL
+$(eval $(call link-program,BenchmarkCloudDatabase,BENCHMARK_CLOUD_DATABASE))
+
 RUN_LIVETRACK24_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/net/SocketError.cxx \
@@ -1228,6 +1354,20 @@ RUN_HEIGHT_MATRIX_CPPFLAGS = $(SCREEN_CPPFLAGS)
 RUN_HEIGHT_MATRIX_DEPENDS = TERRAIN OPERATION GEO MATH IO OS ZZIP UTIL
 $(eval $(call link-program,RunHeightMatrix,RUN_HEIGHT_MATRIX))
 
+BENCHMARK_TERRAIN_SHADER_SOURCES = \
+	$(SRC)/Projection/Projection.cpp \
+	$(SRC)/Projection/WindowProjection.cpp \
+	$(SRC)/ui/canvas/Ramp.cpp \
+	$(TEST_SRC_DIR)/BenchmarkTerrainShader.cpp
+BENCHMARK_TERRAIN_SHADER_CPPFLAGS = $(SCREEN_CPPFLAGS)
+BENCHMARK_TERRAIN_SHADER_DEPENDS = TERRAIN OPERATION GEO MATH IO OS ZZIP UTIL
+$(eval $(call link-program,BenchmarkTerrainShader,BENCHMARK_TERRAIN_SHADER))
+
+BENCHMARK_TERRAIN_HEIGHTS_SOURCES = \
+	$(TEST_SRC_DIR)/BenchmarkTerrainHeights.cpp
+BENCHMARK_TERRAIN_HEIGHTS_DEPENDS = TERRAIN OPERATION GEO MATH IO OS ZZIP UTIL
+$(eval $(call link-program,BenchmarkTerrainHeights,BENCHMARK_TERRAIN_HEIGHTS))
+
 RUN_INPUT_PARSER_SOURCES = \
 	$(SRC)/Input/InputKeys.cpp \
 	$(SRC)/Input/InputConfig.cpp \
@@ -1269,6 +1409,7 @@ RUN_FLIGHT_PARSER_DEPENDS = IO OS TIME UTIL
 $(eval $(call link-program,RunFlightParser,RUN_FLIGHT_PARSER))
 
 RUN_AIRSPACE_PARSER_SOURCES = \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Airspace/AirspaceParser.cpp \
 	$(SRC)/Atmosphere/Pressure.cpp \
 	$(SRC)/RadioFrequency.cpp \
@@ -1277,7 +1418,7 @@ RUN_AIRSPACE_PARSER_SOURCES = \
 	$(TEST_SRC_DIR)/FakeLanguage.cpp \
 	$(TEST_SRC_DIR)/RunAirspaceParser.cpp
 RUN_AIRSPACE_PARSER_LDADD = $(FAKE_LIBS)
-RUN_AIRSPACE_PARSER_DEPENDS = AIRSPACE IO OS ZZIP GEO MATH UTIL UNITS
+RUN_AIRSPACE_PARSER_DEPENDS = AIRSPACE IO OS ZZIP THREAD GEO MATH UTIL UNITS
 $(eval $(call link-program,RunAirspaceParser,RUN_AIRSPACE_PARSER))
 
 ENUMERATE_PORTS_SOURCES = \
@@ -1639,8 +1780,9 @@ RUN_TRACE_SOURCES = \
 	$(SRC)/Formatter/NMEAFormatter.cpp \
 	$(SRC)/FLARM/Error.cpp \
 	$(ENGINE_SRC_DIR)/GlideSolvers/GlideSettings.cpp \
+	$(ENGINE_SRC_DIR)/Trace/FlatTrace.cpp \
+	$(ENGINE_SRC_DIR)/Trace/ListTrace.cpp \
 	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
-	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
 	$(TEST_SRC_DIR)/Printing.cpp \
 	$(TEST_SRC_DIR)/RunTrace.cpp
 RUN_TRACE_DEPENDS = $(DEBUG_REPLAY_DEPENDS) UTIL LIBNMEA GEO MATH TIME
@@ -1652,8 +1794,9 @@ RUN_CONTEST_SOURCES = \
 	$(SRC)/TransponderCode.cpp \
 	$(SRC)/Formatter/NMEAFormatter.cpp \
 	$(SRC)/FLARM/Error.cpp \
+	$(ENGINE_SRC_DIR)/Trace/FlatTrace.cpp \
+	$(ENGINE_SRC_DIR)/Trace/ListTrace.cpp \
 	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
-	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
 	$(TEST_SRC_DIR)/FakeTerrain.cpp \
 	$(TEST_SRC_DIR)/Printing.cpp \
 	$(TEST_SRC_DIR)/ContestPrinting.cpp \
@@ -1661,6 +1804,15 @@ RUN_CONTEST_SOURCES = \
 RUN_CONTEST_DEPENDS = $(DEBUG_REPLAY_DEPENDS) CONTEST UTIL GEO MATH TIME
 $(eval $(call link-program,RunContestAnalysis,RUN_CONTEST))
 
+RUN_CONTEST_BUDGET_SOURCES = \
+	$(SRC)/IGC/IGCParser.cpp \
+	$(ENGINE_SRC_DIR)/Trace/FlatTrace.cpp \
+	$(ENGINE_SRC_DIR)/Trace/ListTrace.cpp \
+	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
+	$(TEST_SRC_DIR)/RunContestBudget.cpp
+RUN_CONTEST_BUDGET_DEPENDS = CONTEST IO OS UTIL GEO MATH TIME
+$(eval $(call link-program,RunContestBudget,RUN_CONTEST_BUDGET))
+
 RUN_WAVE_COMPUTER_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/Computer/WaveComputer.cpp \
@@ -1669,8 +1821,9 @@ RUN_WAVE_COMPUTER_SOURCES = \
 	$(SRC)/TransponderCode.cpp \
 	$(SRC)/Formatter/NMEAFormatter.cpp \
 	$(SRC)/FLARM/Error.cpp \
+	$(ENGINE_SRC_DIR)/Trace/FlatTrace.cpp \
+	$(ENGINE_SRC_DIR)/Trace/ListTrace.cpp \
 	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
-	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
 	$(TEST_SRC_DIR)/RunWaveComputer.cpp
 RUN_WAVE_COMPUTER_DEPENDS = $(DEBUG_REPLAY_DEPENDS) UTIL GEO MATH TIME
 $(eval $(call link-program,RunWaveComputer,RUN_WAVE_COMPUTER))
@@ -1682,8 +1835,9 @@ ANALYSE_FLIGHT_SOURCES = \
 	$(SRC)/Formatter/NMEAFormatter.cpp \
 	$(SRC)/Computer/CirclingComputer.cpp \
 	$(SRC)/TransponderCode.cpp \
+	$(ENGINE_SRC_DIR)/Trace/FlatTrace.cpp \
+	$(ENGINE_SRC_DIR)/Trace/ListTrace.cpp \
 	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
-	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
 	$(ENGINE_SRC_DIR)/ThermalBand/ThermalBand.cpp \
     $(ENGINE_SRC_DIR)/ThermalBand/ThermalSlice.cpp \
 	$(ENGINE_SRC_DIR)/ThermalBand/ThermalEncounterBand.cpp \
@@ -1705,8 +1859,9 @@ FLIGHT_PATH_SOURCES = \
 	$(SRC)/Formatter/NMEAFormatter.cpp \
 	$(SRC)/FLARM/Error.cpp \
 	$(ENGINE_SRC_DIR)/GlideSolvers/GlideSettings.cpp \
+	$(ENGINE_SRC_DIR)/Trace/FlatTrace.cpp \
+	$(ENGINE_SRC_DIR)/Trace/ListTrace.cpp \
 	$(ENGINE_SRC_DIR)/Trace/Point.cpp \
-	$(ENGINE_SRC_DIR)/Trace/Trace.cpp \
 	$(TEST_SRC_DIR)/Printing.cpp \
 	$(TEST_SRC_DIR)/FlightPath.cpp
 FLIGHT_PATH_DEPENDS = $(DEBUG_REPLAY_DEPENDS) UTIL GEO MATH TIME
@@ -1746,8 +1901,10 @@ $(eval $(call link-program,RunCanvas,RUN_CANVAS))
 RUN_MAP_WINDOW_SOURCES = \
 	$(CONTEST_SRC_DIR)/Settings.cpp \
 	$(SRC)/Engine/Util/Gradient.cpp \
+	$(SRC)/Engine/Trace/FlatTrace.cpp \
+	$(SRC)/Engine/Trace/ListTrace.cpp \
 	$(SRC)/Engine/Trace/Point.cpp \
-	$(SRC)/Engine/Trace/Trace.cpp \
+	$(SRC)/Engine/Trace/Snapshot.cpp \
 	$(SRC)/Engine/Trace/Vector.cpp \
 	$(SRC)/Engine/Navigation/Aircraft.cpp \
 	$(ENGINE_SRC_DIR)/ThermalBand/ThermalBand.cpp \
@@ -1763,6 +1920,7 @@ RUN_MAP_WINDOW_SOURCES = \
 	$(SRC)/Airspace/ActivePredicate.cpp \
 	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
 	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Airspace/AirspaceGlue.cpp \
 	$(SRC)/Airspace/AirspaceVisibility.cpp \
 	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
@@ -2162,8 +2320,9 @@ $(eval $(call link-program,RunJobDialog,RUN_JOB_DIALOG))
 RUN_ANALYSIS_SOURCES = \
 	$(DEBUG_REPLAY_SOURCES) \
 	$(SRC)/Engine/Util/Gradient.cpp \
+	$(SRC)/Engine/Trace/FlatTrace.cpp \
+	$(SRC)/Engine/Trace/ListTrace.cpp \
 	$(SRC)/Engine/Trace/Point.cpp \
-	$(SRC)/Engine/Trace/Trace.cpp \
 	$(SRC)/Engine/Trace/Vector.cpp \
 	$(ENGINE_SRC_DIR)/ThermalBand/ThermalBand.cpp \
 	$(SRC)/UIUtil/GestureManager.cpp \
@@ -2252,6 +2411,7 @@ RUN_ANALYSIS_SOURCES = \
 	$(SRC)/Airspace/ActivePredicate.cpp \
 	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
 	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Airspace/AirspaceGlue.cpp \
 	$(SRC)/Airspace/AirspaceVisibility.cpp \
 	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
@@ -2283,6 +2443,41 @@ RUN_ANALYSIS_DEPENDS = \
 	ROUTE AIRSPACE ZZIP UTIL GEO MATH TIME
 $(eval $(call link-program,RunAnalysis,RUN_ANALYSIS))
 
+RUN_CALCULATION_TIMING_SOURCES = \
+	$(DEBUG_REPLAY_SOURCES) \
+	$(SRC)/Engine/Util/Gradient.cpp \
+	$(SRC)/Engine/Trace/FlatTrace.cpp \
+	$(SRC)/Engine/Trace/ListTrace.cpp \
+	$(SRC)/Engine/Trace/Point.cpp \
+	$(SRC)/Engine/Trace/Vector.cpp \
+	$(SRC)/Task/ProtectedTaskManager.cpp \
+	$(SRC)/Task/ProtectedRoutePlanner.cpp \
+	$(SRC)/Task/RoutePlannerGlue.cpp \
+	$(SRC)/Atmosphere/CuSonde.cpp \
+	$(SRC)/Computer/Wind/CirclingWind.cpp \
+	$(SRC)/Computer/Wind/Store.cpp \
+	$(SRC)/Computer/Wind/MeasurementList.cpp \
+	$(SRC)/Computer/Wind/WindEKF.cpp \
+	$(SRC)/Computer/Wind/WindEKFGlue.cpp \
+	$(SRC)/FlightStatistics.cpp \
+	$(SRC)/TeamCode/TeamCode.cpp \
+	$(SRC)/TeamCode/Settings.cpp \
+	$(SRC)/Logger/Settings.cpp \
+	$(SRC)/Airspace/ActivePredicate.cpp \
+	$(SRC)/Airspace/ProtectedAirspaceWarningManager.cpp \
+	$(SRC)/Airspace/AirspaceComputerSettings.cpp \
+	$(SRC)/Math/SunEphemeris.cpp \
+	$(SRC)/TransponderCode.cpp \
+	$(TEST_SRC_DIR)/FakeAsset.cpp \
+	$(TEST_SRC_DIR)/RunCalculationTiming.cpp
+RUN_CALCULATION_TIMING_DEPENDS = \
+	LIBCOMPUTER LIBNMEA \
+	CONTEST TASK ROUTE GLIDE \
+	WAYPOINT AIRSPACE TERRAIN \
+	$(DEBUG_REPLAY_DEPENDS) \
+	ZZIP UTIL GEO MATH
+$(eval $(call link-program,RunCalculationTiming,RUN_CALCULATION_TIMING))
+
 RUN_AIRSPACE_WARNING_DIALOG_SOURCES = \
 	$(SRC)/Engine/Navigation/Aircraft.cpp \
 	$(SRC)/NMEA/FlyingState.cpp \
@@ -2304,6 +2499,7 @@ RUN_AIRSPACE_WARNING_DIALOG_SOURCES = \
 	$(SRC)/Dialogs/DialogSettings.cpp \
 	$(SRC)/Dialogs/WidgetDialog.cpp \
 	$(SRC)/Airspace/AirspaceParser.cpp \
+	$(SRC)/Airspace/AirspaceCache.cpp \
 	$(SRC)/Airspace/AirspaceGlue.cpp \
 	$(SRC)/TransponderCode.cpp \
 	$(SRC)/Audio/Sound.cpp \
@@ -0,0 +1,307 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "AirspaceCache.hpp"
+#include "AirspaceParser.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "Engine/Airspace/AirspaceCircle.hpp"
+#include "Engine/Airspace/AirspacePolygon.hpp"
+#include "io/BufferedOutputStream.hxx"
+#include "io/FileCache.hpp"
+#include "io/FileMapping.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/MemoryReader.hxx"
+#include "system/Path.hpp"
+#include "util/StaticString.hxx"
+
+#include <cinttypes>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+
+struct CacheHeader {
+  /**
+   * The version of the cache format; increment whenever the layout
+   * of #CacheHeader or #AirspaceRecord changes.
+   */
+  static constexpr uint32_t VERSION = 1;
+
+  uint32_t version;
+
+  /**
+   * The #AIRSPACE_PARSER_VERSION which created the airspaces.
+   */
+  uint32_t parser_version;
+
+  uint64_t source_hash;
+
+  uint32_t n_airspaces;
+
+  /**
+   * sizeof(AirspaceRecord), to detect caches written by a different
+   * build of XCSoar.
+   */
+  uint32_t record_size;
+};
+
+/**
+ * The fixed-size part of one airspace.  It is followed by the name,
+ * the station name and (for polygons) the border points.
+ */
+struct AirspaceRecord {
+  AirspaceAltitude base, top;
+
+  /**
+   * The center of a circle.
+   */
+  GeoPoint center;
+
+  /**
+   * The radius of a circle [m].
+   */
+  double radius;
+
+  uint32_t n_points;
+  uint32_t name_length, station_name_length;
+
+  RadioFrequency radio_frequency;
+  TransponderCode transponder_code;
+
+  AbstractAirspace::Shape shape;
+  AirspaceClass asclass, astype;
+  AirspaceActivity days;
+};
+
+} // anonymous namespace
+
+/**
+ * 64 bit FNV-1a.
+ */
+[[gnu::pure]]
+static uint64_t
+FNV1a(std::span<const std::byte> src,
+      uint64_t hash=0xcbf29ce484222325ULL) noexcept
+{
+  for (const std::byte b : src) {
+    hash ^= static_cast<uint64_t>(b);
+    hash *= 0x100000001b3ULL;
+  }
+
+  return hash;
+}
+
+uint64_t
+HashAirspaceFile(Path path)
+{
+  const FileMapping mapping{path};
+  return FNV1a(mapping);
+}
+
+static void
+WriteString(BufferedOutputStream &os, std::string_view s)
+{
+  os.Write(std::as_bytes(std::span{s}));
+}
+
+static void
+WriteAirspace(BufferedOutputStream &os, const AbstractAirspace &as)
+{
+  AirspaceRecord record;
+
+  /* zero-fill all implicit padding bytes (to make valgrind happy) */
+  memset(static_cast<void *>(&record), 0, sizeof(record));
+
+  const std::string_view name = as.GetName();
+  const std::string_view station_name = as.GetStationName();
+
+  record.base = as.GetBase();
+  record.top = as.GetTop();
+  record.center = GeoPoint::Invalid();
+  record.radius = 0;
+  record.n_points = 0;
+  record.name_length = name.size();
+  record.station_name_length = station_name.size();
+  record.radio_frequency = as.GetRadioFrequency();
+  record.transponder_code = as.GetTransponderCode();
+  record.shape = as.GetShape();
+  record.asclass = as.GetClass();
+  record.astype = as.GetType();
+  record.days = as.GetDays();
+
+  switch (as.GetShape()) {
+  case AbstractAirspace::Shape::CIRCLE: {
+    const auto &circle = static_cast<const AirspaceCircle &>(as);
+    record.center = circle.GetCenter();
+    record.radius = circle.GetRadius();
+    break;
+  }
+
+  case AbstractAirspace::Shape::POLYGON:
+    record.n_points = as.GetPoints().size();
+    break;
+  }
+
+  os.WriteT(record);
+  WriteString(os, name);
+  WriteString(os, station_name);
+
+  if (as.GetShape() == AbstractAirspace::Shape::POLYGON)
+    for (const auto &i : as.GetPoints())
+      os.WriteT(i.GetLocation());
+}
+
+void
+WriteAirspaceCache(BufferedOutputStream &os, uint64_t source_hash,
+                   std::span<const AirspacePtr> airspaces)
+{
+  CacheHeader header;
+
+  /* zero-fill all implicit padding bytes (to make valgrind happy) */
+  memset(&header, 0, sizeof(header));
+
+  header.version = CacheHeader::VERSION;
+  header.parser_version = AIRSPACE_PARSER_VERSION;
+  header.source_hash = source_hash;
+  header.n_airspaces = airspaces.size();
+  header.record_size = sizeof(AirspaceRecord);
+
+  os.WriteT(header);
+
+  for (const auto &i : airspaces)
+    WriteAirspace(os, *i);
+}
+
+static std::string
+ReadString(MemoryReader &r, std::size_t length)
+{
+  std::string s(length, '\0');
+  r.ReadFull(std::as_writable_bytes(std::span{s}));
+  return s;
+}
+
+static AirspacePtr
+ReadAirspace(MemoryReader &r, std::vector<GeoPoint> &points)
+{
+  AirspaceRecord record;
+  r.ReadT(record);
+
+  if (record.asclass >= AIRSPACECLASSCOUNT ||
+      record.astype >= AIRSPACECLASSCOUNT)
+    throw std::runtime_error("Malformed airspace class");
+
+  auto name = ReadString(r, record.name_length);
+  auto station_name = ReadString(r, record.station_name_length);
+
+  AirspacePtr as;
+
+  switch (record.shape) {
+  case AbstractAirspace::Shape::CIRCLE:
+    if (!record.center.Check() || !(record.radius > 0))
+      throw std::runtime_error("Malformed airspace circle");
+
+    as = std::make_shared<AirspaceCircle>(record.center, record.radius);
+    break;
+
+  case AbstractAirspace::Shape::POLYGON:
+    if (record.n_points < 3 || record.n_points > 1024 * 1024)
+      throw std::runtime_error("Malformed airspace polygon");
+
+    points.resize(record.n_points);
+    r.ReadFull(std::as_writable_bytes(std::span{points}));
+    as = std::make_shared<AirspacePolygon>(points);
+    break;
+
+  default:
+    throw std::runtime_error("Malformed airspace shape");
+  }
+
+  as->SetProperties(std::move(name), std::move(station_name),
+                    TransponderCode{record.transponder_code},
+                    record.asclass, record.astype,
+                    record.base, record.top);
+  as->SetRadioFrequency(record.radio_frequency);
+  as->SetDays(record.days);
+  return as;
+}
+
+bool
+ReadAirspaceCache(std::span<const std::byte> src, uint64_t source_hash,
+                  std::vector<AirspacePtr> &airspaces)
+{
+  MemoryReader r{src};
+
+  CacheHeader header;
+  r.ReadT(header);
+
+  if (header.version != CacheHeader::VERSION ||
+      header.parser_version != AIRSPACE_PARSER_VERSION ||
+      header.source_hash != source_hash ||
+      header.record_size != sizeof(AirspaceRecord))
+    return false;
+
+  /* each airspace needs at least one record */
+  if (header.n_airspaces > src.size() / sizeof(AirspaceRecord))
+    throw std::runtime_error("Malformed airspace cache header");
+
+  std::vector<AirspacePtr> result;
+  result.reserve(header.n_airspaces);
+
+  std::vector<GeoPoint> points;
+  for (unsigned i = 0; i < header.n_airspaces; ++i)
+    result.emplace_back(ReadAirspace(r, points));
+
+  airspaces.insert(airspaces.end(),
+                   std::make_move_iterator(result.begin()),
+                   std::make_move_iterator(result.end()));
+  return true;
+}
+
+/**
+ * Each airspace file gets its own cache file, named after a hash of
+ * its path.
+ */
+static StaticString<32>
+MakeCacheName(Path path) noexcept
+{
+  const std::string_view s = path.c_str();
+
+  StaticString<32> name;
+  name.Format("airspace-%016" PRIx64,
+              FNV1a(std::as_bytes(std::span{s})));
+  return name;
+}
+
+bool
+LoadAirspaceCache(FileCache &cache, Path path,
+                  std::vector<AirspacePtr> &airspaces)
+{
+  const auto name = MakeCacheName(path);
+
+  std::span<const std::byte> payload;
+  const auto mapping = cache.Map(name.c_str(), path, payload);
+  if (!mapping)
+    return false;
+
+  if (!ReadAirspaceCache(payload, HashAirspaceFile(path), airspaces)) {
+    cache.Flush(name.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+void
+SaveAirspaceCache(FileCache &cache, Path path,
+                  std::span<const AirspacePtr> airspaces)
+{
+  const uint64_t source_hash = HashAirspaceFile(path);
+
+  auto os = cache.Save(MakeCacheName(path).c_str(), path);
+  BufferedOutputStream bos(*os);
+  WriteAirspaceCache(bos, source_hash, airspaces);
+  bos.Flush();
+  os->Commit();
+}
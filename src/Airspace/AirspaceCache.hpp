@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Engine/Airspace/Ptr.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+class BufferedOutputStream;
+class FileCache;
+class Path;
+
+/*
+ * A binary cache of the airspaces parsed from one airspace file.
+ * Loading it skips AirspaceParser (including the arc and circle
+ * tessellation).  It is only valid for the file contents it was
+ * created from (see HashAirspaceFile()) and for the current
+ * #AIRSPACE_PARSER_VERSION; the airspaces are projected by
+ * Airspaces::Optimise() as usual, because the projection depends on
+ * all airspace files.
+ */
+
+/**
+ * Calculate a hash of the contents of an airspace file which is
+ * used to validate its cache.
+ *
+ * Throws on error.
+ */
+uint64_t
+HashAirspaceFile(Path path);
+
+/**
+ * Serialise freshly parsed airspaces.
+ *
+ * Throws on error.
+ *
+ * @param source_hash the return value of HashAirspaceFile()
+ */
+void
+WriteAirspaceCache(BufferedOutputStream &os, uint64_t source_hash,
+                   std::span<const AirspacePtr> airspaces);
+
+/**
+ * Deserialise airspaces which were written by WriteAirspaceCache().
+ *
+ * Throws on error (e.g. if the data is malformed).
+ *
+ * @param source_hash the return value of HashAirspaceFile()
+ * @return false if the cache was created from a different file or
+ * by a different parser version
+ */
+bool
+ReadAirspaceCache(std::span<const std::byte> src, uint64_t source_hash,
+                  std::vector<AirspacePtr> &airspaces);
+
+/**
+ * Load the cached airspaces of the specified airspace file.
+ *
+ * Throws on error.
+ *
+ * @return false if there is no valid cache
+ */
+bool
+LoadAirspaceCache(FileCache &cache, Path path,
+                  std::vector<AirspacePtr> &airspaces);
+
+/**
+ * Save the airspaces which were just parsed from the specified
+ * airspace file.
+ *
+ * Throws on error.
+ */
+void
+SaveAirspaceCache(FileCache &cache, Path path,
+                  std::span<const AirspacePtr> airspaces);
@@ -2,6 +2,7 @@
 // Copyright The XCSoar Project
 
 #include "Airspace/AirspaceGlue.hpp"
+#include "Airspace/AirspaceCache.hpp"
 #include "Airspace/AirspaceParser.hpp"
 #include "Atmosphere/Pressure.hpp"
 #include "Engine/Airspace/Airspaces.hpp"
@@ -20,24 +21,67 @@
 #include "lib/fmt/PathFormatter.hpp"
 #include "lib/fmt/RuntimeError.hxx"
 #include "system/Path.hpp"
+#include "thread/ParallelFor.hpp"
+
+#include <vector>
 
 #include <string.h>
 
+/**
+ * Parse an airspace file into a list of airspaces, or load them from
+ * the cache.  Throws on error; the airspaces before the error are
+ * added anyway.
+ */
+static void
+ParseAirspaceFile(std::vector<AirspacePtr> &airspaces, Path path,
+                  FileCache *cache, OperationEnvironment &operation)
+{
+  if (cache != nullptr) {
+    try {
+      if (LoadAirspaceCache(*cache, path, airspaces))
+        return;
+    } catch (...) {
+      LogError(std::current_exception(), "Failed to load airspace cache");
+      airspaces.clear();
+    }
+  }
+
+  {
+    FileReader file_reader{path};
+    ProgressReader progress_reader{file_reader, file_reader.GetSize(),
+                                   operation};
+    BufferedReader buffered_reader{progress_reader};
+    ParseAirspaceFile(airspaces, buffered_reader, GetParallelThreadCount());
+  }
+
+  if (cache != nullptr) {
+    try {
+      SaveAirspaceCache(*cache, path, airspaces);
+    } catch (...) {
+      LogError(std::current_exception(), "Failed to save airspace cache");
+    }
+  }
+}
+
 bool
-ParseAirspaceFile(Airspaces &airspaces, Path path,
+ParseAirspaceFile(Airspaces &airspaces, Path path, FileCache *cache,
                   OperationEnvironment &operation) noexcept
 try {
-  FileReader file_reader{path};
-  ProgressReader progress_reader{file_reader, file_reader.GetSize(), operation};
-  BufferedReader buffered_reader{progress_reader};
+  std::vector<AirspacePtr> parsed;
 
   try {
-    ParseAirspaceFile(airspaces, buffered_reader);
+    ParseAirspaceFile(parsed, path, cache, operation);
   } catch (...) {
+    for (auto &i : parsed)
+      airspaces.Add(std::move(i));
+
     // TODO translate this?
     std::throw_with_nested(FmtRuntimeError("Error in file {}", path));
   }
 
+  for (auto &i : parsed)
+    airspaces.Add(std::move(i));
+
   return true;
 } catch (...) {
   LogError(std::current_exception());
@@ -69,7 +113,7 @@ try {
 }
 
 void
-ReadAirspace(Airspaces &airspaces,
+ReadAirspace(Airspaces &airspaces, FileCache *cache,
              AtmosphericPressure press,
              OperationEnvironment &operation)
 {
@@ -82,7 +126,7 @@ ReadAirspace(Airspaces &airspaces,
   const auto paths = Profile::GetMultiplePaths(ProfileKeys::AirspaceFileList,
                                                AIRSPACE_FILE_PATTERNS);
   for (const auto& path : paths) {
-  airspace_ok |= ParseAirspaceFile(airspaces, path, operation);
+  airspace_ok |= ParseAirspaceFile(airspaces, path, cache, operation);
   }
 
   try {
@@ -6,14 +6,18 @@
 class RasterTerrain;
 class AtmosphericPressure;
 class Airspaces;
+class FileCache;
 class OperationEnvironment;
 class Path;
 
 /**
  * Reads the airspace files into the memory
+ *
+ * @param cache an optional cache for the parsed airspaces (see
+ * AirspaceCache.hpp)
  */
 void
-ReadAirspace(Airspaces &airspaces,
+ReadAirspace(Airspaces &airspaces, FileCache *cache,
              AtmosphericPressure press,
              OperationEnvironment &operation);
 
@@ -23,6 +27,9 @@ SetAirspaceGroundLevels(Airspaces &airspaces,
 
 /**
  * Reads the airspace files from path.
+ *
+ * @param cache an optional cache for the parsed airspaces; if it
+ * contains the airspaces of this file, the file is not parsed
  */
-bool ParseAirspaceFile(Airspaces &airspaces, Path path,
+bool ParseAirspaceFile(Airspaces &airspaces, Path path, FileCache *cache,
                        OperationEnvironment &operation) noexcept;
@@ -17,14 +17,21 @@
 #include "Airspace/AirspaceCircle.hpp"
 #include "Geo/GeoVector.hpp"
 #include "Engine/Airspace/AirspaceClass.hpp"
+#include "Engine/Airspace/Ptr.hpp"
 #include "lib/fmt/RuntimeError.hxx"
 #include "io/BufferedReader.hxx"
 #include "io/StringConverter.hpp"
 #include "util/StaticString.hxx"
 #include "util/StringCompare.hxx"
 #include "util/StringSplit.hxx"
+#include "util/UTF8.hpp"
+#include "thread/ParallelFor.hpp"
 
+#include <cstring>
+#include <exception>
+#include <iterator>
 #include <stdexcept>
+#include <vector>
 
 using std::string_view_literals::operator""sv;
 
@@ -215,11 +222,11 @@ struct TempAirspace
   }
 
   /**
-   * If there is an airspace, add it to the #Airspaces and return
+   * If there is an airspace, add it to the list and return
    * true.  Returns false if no airspace was being constructed.
    * Throws if the airspace is bad.
    */
-  bool Commit(Airspaces &airspace_database) {
+  bool Commit(std::vector<AirspacePtr> &airspace_database) {
     if (!points.empty()) {
       AddPolygon(airspace_database);
       return true;
@@ -228,8 +235,8 @@ struct TempAirspace
   }
 
   /**
-   * Perform common checks before an airspace is committed to
-   * #Airspaces.  Throws on error.
+   * Perform common checks before an airspace is committed.  Throws
+   * on error.
    */
   void Check() {
     if (asclass == OTHER && name.empty())
@@ -237,7 +244,7 @@ struct TempAirspace
   }
 
   void
-  AddPolygon(Airspaces &airspace_database)
+  AddPolygon(std::vector<AirspacePtr> &airspace_database)
   {
     Check();
 
@@ -257,7 +264,7 @@ struct TempAirspace
     as->SetRadioFrequency(radio_frequency);
     as->SetTransponderCode(transponder_code);
     as->SetDays(days_of_operation);
-    airspace_database.Add(std::move(as));
+    airspace_database.emplace_back(std::move(as));
   }
 
   GeoPoint RequireCenter() {
@@ -273,7 +280,7 @@ struct TempAirspace
   }
 
   void
-  AddCircle(Airspaces &airspace_database)
+  AddCircle(std::vector<AirspacePtr> &airspace_database)
   {
     Check();
 
@@ -294,7 +301,7 @@ struct TempAirspace
     as->SetRadioFrequency(radio_frequency);
     as->SetTransponderCode(transponder_code);
     as->SetDays(days_of_operation);
-    airspace_database.Add(std::move(as));
+    airspace_database.emplace_back(std::move(as));
   }
 
   static constexpr int
@@ -655,7 +662,7 @@ ReadRadioFrequency(const std::string_view line) noexcept
  * Throws on error.
  */
 static void
-ParseLine(Airspaces &airspace_database, unsigned line_number,
+ParseLine(std::vector<AirspacePtr> &airspace_database, unsigned line_number,
           StringParser<> &&input,
           StringConverter &string_converter,
           TempAirspace &temp_area)
@@ -777,7 +784,8 @@ ParseLine(Airspaces &airspace_database, unsigned line_number,
  * Throws on error.
  */
 static void
-ParseLine(Airspaces &airspace_database, unsigned line_number, char *line,
+ParseLine(std::vector<AirspacePtr> &airspace_database,
+          unsigned line_number, char *line,
           StringConverter &string_converter,
           TempAirspace &temp_area)
 {
@@ -937,7 +945,7 @@ ParseCircleTNP(StringParser<> &input, TempAirspace &temp_area)
  * Throws on error.
  */
 static void
-ParseLineTNP(Airspaces &airspace_database, unsigned line_number,
+ParseLineTNP(std::vector<AirspacePtr> &airspace_database, unsigned line_number,
              StringParser<> &input,
              StringConverter &string_converter,
              TempAirspace &temp_area, bool &ignore)
@@ -1013,20 +1021,47 @@ DetectFileType(const char *line) noexcept
   return AirspaceFileType::UNKNOWN;
 }
 
-void
-ParseAirspaceFile(Airspaces &airspaces,
-                  BufferedReader &reader)
-{
-  StringConverter string_converter;
+/**
+ * An airspace file which has been loaded into memory.
+ */
+struct AirspaceFileLines {
+  struct Line {
+    /**
+     * The position of the null-terminated line in #text.
+     */
+    std::size_t offset;
+
+    unsigned number;
+  };
 
-  bool ignore = false;
+  std::vector<char> text;
 
-  TempAirspace temp_area;
-  AirspaceFileType filetype = AirspaceFileType::UNKNOWN;
+  /**
+   * The non-empty lines, beginning with the one which was used to
+   * detect the file type.
+   */
+  std::vector<Line> lines;
 
-  char *line;
+  AirspaceFileType type = AirspaceFileType::UNKNOWN;
 
-  // Iterate through the lines
+  /**
+   * Are all lines valid UTF-8?  If not, the file must be parsed by
+   * one #StringConverter, because its charset detection depends on
+   * the strings converted before.
+   */
+  bool utf8 = true;
+
+  char *GetLine(std::size_t i) noexcept {
+    return text.data() + lines[i].offset;
+  }
+};
+
+static AirspaceFileLines
+ReadLines(BufferedReader &reader)
+{
+  AirspaceFileLines file;
+
+  char *line;
   while ((line = reader.ReadLine()) != nullptr) {
     StripRight(line);
 
@@ -1034,20 +1069,127 @@ ParseAirspaceFile(Airspaces &airspaces,
     if (StringIsEmpty(line))
       continue;
 
-    if (filetype == AirspaceFileType::UNKNOWN) {
-      filetype = DetectFileType(line);
-      if (filetype == AirspaceFileType::UNKNOWN)
+    if (file.type == AirspaceFileType::UNKNOWN) {
+      file.type = DetectFileType(line);
+      if (file.type == AirspaceFileType::UNKNOWN)
         continue;
     }
 
+    if (file.utf8 && !ValidateUTF8(line))
+      file.utf8 = false;
+
+    file.lines.push_back({file.text.size(), reader.GetLineNumber()});
+    file.text.insert(file.text.end(), line, line + strlen(line) + 1);
+  }
+
+  return file;
+}
+
+/**
+ * Returns the part of an OpenAir line before the comment.
+ */
+[[gnu::pure]]
+static std::string_view
+StripOpenAirComment(const char *line) noexcept
+{
+  std::string_view s{line};
+  return s.substr(0, s.find('*'));
+}
+
+/**
+ * Does this OpenAir line begin a new airspace ("AC"), see
+ * ParseLine()?
+ */
+[[gnu::pure]]
+static bool
+IsOpenAirStart(std::string_view line) noexcept
+{
+  return line.size() > 2 && ToUpperASCII(line[0]) == 'A' &&
+    ToUpperASCII(line[1]) == 'C' && IsWhitespaceNotNull(line[2]);
+}
+
+/**
+ * Does this OpenAir line add polygon points (or throw), see
+ * ParseLine()?
+ */
+[[gnu::pure]]
+static bool
+IsOpenAirPoints(std::string_view line) noexcept
+{
+  if (line.size() < 2 || ToUpperASCII(line[0]) != 'D')
+    return false;
+
+  switch (ToUpperASCII(line[1])) {
+  case 'P':
+    return line.size() > 2 && IsWhitespaceNotNull(line[2]);
+
+  case 'A':
+  case 'B':
+    return true;
+
+  default:
+    return false;
+  }
+}
+
+/**
+ * Split an OpenAir file into chunks which can be parsed
+ * independently.  A chunk may only begin with an "AC" line which
+ * commits a polygon, because that resets the whole #TempAirspace;
+ * other airspace attributes may be inherited by the next airspace.
+ *
+ * @return the index of the first line of each chunk
+ */
+static std::vector<std::size_t>
+SplitOpenAir(AirspaceFileLines &file, std::size_t min_chunk_lines)
+{
+  std::vector<std::size_t> chunks{0};
+
+  bool has_points = false;
+  for (std::size_t i = 0; i < file.lines.size(); ++i) {
+    const auto line = StripOpenAirComment(file.GetLine(i));
+    if (IsOpenAirStart(line)) {
+      if (has_points && i - chunks.back() >= min_chunk_lines)
+        chunks.push_back(i);
+
+      has_points = false;
+    } else if (IsOpenAirPoints(line))
+      has_points = true;
+  }
+
+  return chunks;
+}
+
+/**
+ * Parse the lines from #begin to #end, beginning with a fresh parser
+ * state.  Throws on error.
+ *
+ * @param last is this the end of the file?
+ */
+static void
+ParseChunk(std::vector<AirspacePtr> &airspaces, AirspaceFileLines &file,
+           std::size_t begin, std::size_t end, bool last)
+{
+  StringConverter string_converter;
+
+  bool ignore = false;
+
+  TempAirspace temp_area;
+  if (begin > 0)
+    temp_area.Reset(file.lines[begin].number);
+
+  for (std::size_t i = begin; i < end; ++i) {
+    char *line = file.GetLine(i);
+    const unsigned line_number = file.lines[i].number;
+
     // Parse the line
     try {
-      if (filetype == AirspaceFileType::OPENAIR)
-        ParseLine(airspaces, reader.GetLineNumber(), line,
+      if (file.type == AirspaceFileType::OPENAIR)
+        ParseLine(airspaces, line_number, line,
                   string_converter, temp_area);
-      if (filetype == AirspaceFileType::TNP) {
+      if (file.type == AirspaceFileType::TNP) {
         StringParser<> input(line);
-        ParseLineTNP(airspaces, reader.GetLineNumber(), input, string_converter,
+        ParseLineTNP(airspaces, line_number, input, string_converter,
                      temp_area, ignore);
       }
     } catch (const TempAirspace::CommitError &e) {
@@ -1056,14 +1198,96 @@ ParseAirspaceFile(Airspaces &airspaces,
     } catch (...) {
       // TODO translate this?
       std::throw_with_nested(FmtRuntimeError("Error in line {} ('{}')",
-                                             reader.GetLineNumber(),
+                                             line_number,
                                              line));
     }
   }
 
-  if (filetype == AirspaceFileType::UNKNOWN)
+  if (last) {
+    // Process final area (if any)
+    temp_area.Commit(airspaces);
+    return;
+  }
+
+  /* the next chunk begins with "AC", which commits this airspace */
+  try {
+    temp_area.Commit(airspaces);
+  } catch (const TempAirspace::CommitError &e) {
+    throw FmtRuntimeError("Error in airspace at line {}: {}",
+                          temp_area.first_line_number, e.msg);
+  }
+}
+
+void
+ParseAirspaceFile(std::vector<AirspacePtr> &airspaces,
+                  BufferedReader &reader, unsigned n_threads)
+{
+  auto file = ReadLines(reader);
+  if (file.type == AirspaceFileType::UNKNOWN)
     throw std::runtime_error(_("Unknown airspace filetype"));
 
-  // Process final area (if any)
-  temp_area.Commit(airspaces);
+  /* a few chunks per thread, so a chunk with many arcs doesn't keep
+     the other threads waiting */
+  static constexpr std::size_t MIN_CHUNK_LINES = 1024;
+  const std::size_t chunk_lines =
+    std::max(file.lines.size() / (n_threads * 4), MIN_CHUNK_LINES);
+
+  const auto chunks =
+    n_threads > 1 && file.type == AirspaceFileType::OPENAIR && file.utf8
+    ? SplitOpenAir(file, chunk_lines)
+    : std::vector<std::size_t>{0};
+
+  struct ChunkResult {
+    std::vector<AirspacePtr> airspaces;
+    std::exception_ptr error;
+  };
+
+  std::vector<ChunkResult> results(chunks.size());
+
+  ParallelFor(chunks.size(), n_threads, [&](std::size_t i){
+    const bool last = i + 1 == chunks.size();
+    const std::size_t end = last ? file.lines.size() : chunks[i + 1];
+
+    try {
+      ParseChunk(results[i].airspaces, file, chunks[i], end, last);
+    } catch (...) {
+      results[i].error = std::current_exception();
+    }
+  });
+
+  /* add the airspaces in file order; like a sequential parser, stop
+     at the first error (but keep the airspaces before it) */
+  for (auto &i : results) {
+    airspaces.insert(airspaces.end(),
+                     std::make_move_iterator(i.airspaces.begin()),
+                     std::make_move_iterator(i.airspaces.end()));
+
+    if (i.error)
+      std::rethrow_exception(i.error);
+  }
+}
+
+void
+ParseAirspaceFile(Airspaces &airspaces,
+                  BufferedReader &reader, unsigned n_threads)
+{
+  std::vector<AirspacePtr> parsed;
+
+  try {
+    ParseAirspaceFile(parsed, reader, n_threads);
+  } catch (...) {
+    for (auto &i : parsed)
+      airspaces.Add(std::move(i));
+    throw;
+  }
+
+  for (auto &i : parsed)
+    airspaces.Add(std::move(i));
+}
+
+void
+ParseAirspaceFile(Airspaces &airspaces,
+                  BufferedReader &reader)
+{
+  ParseAirspaceFile(airspaces, reader, GetParallelThreadCount());
 }
@@ -3,10 +3,50 @@
 
 #pragma once
 
+#include "Engine/Airspace/Ptr.hpp"
+
+#include <vector>
+
 class Airspaces;
 class BufferedReader;
 
 /**
+ * The version of the parser's output.  It must be incremented
+ * whenever a change to the parser changes the airspaces it creates
+ * from the same file (e.g. the arc tessellation), because it
+ * invalidates all airspace caches (see AirspaceCache.hpp).
+ */
+static constexpr unsigned AIRSPACE_PARSER_VERSION = 1;
+
+/**
+ * Parse an OpenAir or TNP file into a list of airspaces, in file
+ * order.  Large OpenAir files are split into blocks of airspaces
+ * which are parsed in parallel.
+ *
+ * Throws on error.  The airspaces before the error are added anyway.
+ *
+ * @param n_threads the maximum number of threads
+ */
+void
+ParseAirspaceFile(std::vector<AirspacePtr> &airspaces,
+                  BufferedReader &reader, unsigned n_threads);
+
+/**
+ * Parse an OpenAir or TNP file.  Large OpenAir files are split into
+ * blocks of airspaces which are parsed in parallel; the airspaces
+ * are added in file order.
+ *
+ * Throws on error.  The airspaces before the error are added anyway.
+ *
+ * @param n_threads the maximum number of threads
+ */
+void
+ParseAirspaceFile(Airspaces &airspaces,
+                  BufferedReader &reader, unsigned n_threads);
+
+/**
+ * Parse with GetParallelThreadCount() threads.
+ *
  * Throws on error.
  */
 void
@@ -185,6 +185,8 @@ DeviceBlackboard::Merge() noexcept
 {
   NMEAInfo &basic = SetBasic();
 
+  const Validity last_location_available = basic.location_available;
+
   real_data.Reset();
   for (auto &basic : per_device_data) {
     if (!basic.alive)
@@ -212,4 +214,7 @@ DeviceBlackboard::Merge() noexcept
   } else {
     basic = real_data;
   }
+
+  if (basic.location_available.Modified(last_location_available))
+    fix_arrival = std::chrono::steady_clock::now();
 }
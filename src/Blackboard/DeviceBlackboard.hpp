@@ -11,6 +11,7 @@
 #include "time/WrapClock.hpp"
 
 #include <array>
+#include <chrono>
 
 class AtmosphericPressure;
 class OperationEnvironment;
@@ -55,6 +56,12 @@ class DeviceBlackboard
    */
   WrapClock real_clock, replay_clock;
 
+  /**
+   * The time when Merge() has last seen a new GPS fix.  This is used
+   * to measure the latency of the #CalculationThread.
+   */
+  std::chrono::steady_clock::time_point fix_arrival{};
+
 public:
   Mutex mutex;
 
@@ -71,6 +78,14 @@ public:
     calculated_info = derived_info;
   }
 
+  /**
+   * Returns the time when Merge() has last seen a new GPS fix.
+   * Caller must lock the blackboard.
+   */
+  std::chrono::steady_clock::time_point GetFixArrival() const noexcept {
+    return fix_arrival;
+  }
+
   /**
    * Reads the given settings usually provided by the InterfaceBlackboard
    * and saves it to the own Blackboard
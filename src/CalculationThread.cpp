@@ -26,6 +26,7 @@ CalculationThread::CalculationThread(DeviceBlackboard &_device_blackboard,
    force(false),
    device_blackboard(_device_blackboard),
    glide_computer(_glide_computer) {
+  timing.Clear();
 }
 
 void
@@ -60,6 +61,7 @@ CalculationThread::Tick() noexcept
 #endif
 
   bool gps_updated;
+  std::chrono::steady_clock::time_point fix_arrival;
 
   // update and transfer master info to glide computer
   {
@@ -67,6 +69,10 @@ CalculationThread::Tick() noexcept
 
     gps_updated = device_blackboard.Basic().location_available.Modified(glide_computer.Basic().location_available);
 
+    fix_arrival = gps_updated
+      ? device_blackboard.GetFixArrival()
+      : std::chrono::steady_clock::time_point{};
+
     // Copy data from DeviceBlackboard to GlideComputerBlackboard
     glide_computer.ReadBlackboard(device_blackboard.Basic());
   }
@@ -101,14 +107,30 @@ CalculationThread::Tick() noexcept
   }
 
   // if (new GPS data)
-  if (gps_updated || force)
+  if (gps_updated || force) {
     // inform map new data is ready
     TriggerCalculatedUpdate();
 
+    if (fix_arrival != std::chrono::steady_clock::time_point{})
+      glide_computer.SetTiming().latency.Add(std::chrono::steady_clock::now() -
+                                             fix_arrival);
+  }
+
   if (do_idle) {
     // do slow calculations last, to minimise latency
     glide_computer.ProcessIdle();
   }
+
+  {
+    const std::lock_guard lock{mutex};
+
+    if (reset_timing) {
+      reset_timing = false;
+      glide_computer.SetTiming().Clear();
+    }
+
+    timing = glide_computer.GetTiming();
+  }
 }
 
 void
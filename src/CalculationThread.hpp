@@ -6,6 +6,7 @@
 #include "thread/WorkerThread.hpp"
 #include "thread/Mutex.hxx"
 #include "Computer/Settings.hpp"
+#include "Computer/CalculationTiming.hpp"
 
 class DeviceBlackboard;
 class GlideComputer;
@@ -17,8 +18,8 @@ class GlideComputer;
  */
 class CalculationThread final : public WorkerThread {
   /**
-   * This mutex protects #settings_computer and
-   * #screen_distance_meters.
+   * This mutex protects #settings_computer,
+   * #screen_distance_meters, #timing and #reset_timing.
    */
   Mutex mutex;
 
@@ -33,6 +34,16 @@ class CalculationThread final : public WorkerThread {
 
   double screen_distance_meters;
 
+  /**
+   * A copy of GlideComputer::GetTiming(), updated after each Tick().
+   */
+  CalculationTiming timing;
+
+  /**
+   * Shall Tick() clear the run time histograms?
+   */
+  bool reset_timing = false;
+
   DeviceBlackboard &device_blackboard;
 
   /** Pointer to the GlideComputer that should be used */
@@ -56,6 +67,23 @@ public:
 
   void ForceTrigger() noexcept;
 
+  /**
+   * Returns a copy of the run time histograms.
+   */
+  CalculationTiming GetTiming() noexcept {
+    const std::lock_guard lock{mutex};
+    return timing;
+  }
+
+  /**
+   * Clear the run time histograms (asynchronously, in the next
+   * Tick()).
+   */
+  void ResetTiming() noexcept {
+    const std::lock_guard lock{mutex};
+    reset_timing = true;
+  }
+
 protected:
   void Tick() noexcept override;
 };
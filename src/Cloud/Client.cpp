@@ -94,6 +94,25 @@ CloudClientContainer::Insert(CloudClient &client)
   rtree.insert(client.shared_from_this());
 }
 
+void
+CloudClientContainer::InsertMany(std::span<const CloudClientPtr> clients)
+{
+  if (!rtree.empty()) {
+    for (const auto &client : clients)
+      Insert(*client);
+    return;
+  }
+
+  for (const auto &client : clients) {
+    list.push_front(*client);
+    key_set.insert(*client);
+    id_set.push_back(*client);
+  }
+
+  /* the packing algorithm is used by this constructor */
+  rtree = Tree(clients.begin(), clients.end());
+}
+
 void
 CloudClientContainer::Remove(CloudClient &client)
 {
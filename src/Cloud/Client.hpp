@@ -13,6 +13,7 @@
 #include <boost/range/iterator_range_core.hpp>
 #include <memory>
 #include <chrono>
+#include <span>
 
 class Serialiser;
 class Deserialiser;
@@ -230,6 +231,13 @@ public:
 
   void Insert(CloudClient &client);
 
+  /**
+   * Insert many clients at once.  If the container is empty, this is
+   * much faster than calling Insert() for each one, because the
+   * R-tree gets bulk-loaded.
+   */
+  void InsertMany(std::span<const CloudClientPtr> clients);
+
   /**
    * Remove a #CloudClient and its data.  Be careful - the given reference
    * is invalidated, unless the caller holds another #CloudClientPtr.
@@ -13,28 +13,24 @@ using std::cout;
 using std::cerr;
 using std::endl;
 
-static constexpr uint32_t CLOUD_MAGIC = 0x5753f60f;
-static constexpr uint32_t CLOUD_VERSION = 1;
-
 void
-CloudData::DumpClients()
+CloudData::DumpClients(std::ostream &os) const
 {
   for (const auto &client : clients) {
-    cout << ToString(client.address) << '\t'
+    os << ToString(client.address) << '\t'
          << std::hex << client.key << std::dec << '\t'
          << client.id << '\t'
          << client.location << '\t'
          << client.altitude << "m\n";
   }
-
-  cout.flush();
 }
 
 void
 CloudData::Save(Serialiser &s) const
 {
-  s.Write32(CLOUD_MAGIC);
-  s.Write32(CLOUD_VERSION);
+  s.Write32(MAGIC);
+  s.Write32(VERSION);
+  s.Write32(0); // journal generation
   clients.Save(s);
   s.Write8(1);
   thermals.Save(s);
@@ -44,12 +40,17 @@ CloudData::Save(Serialiser &s) const
 void
 CloudData::Load(Deserialiser &s)
 {
-  if (s.Read32() != CLOUD_MAGIC)
+  if (s.Read32() != MAGIC)
     throw std::runtime_error("Bad magic");
 
-  if (s.Read32() != CLOUD_VERSION)
+  const uint32_t version = s.Read32();
+  if (version < 1 || version > VERSION)
     throw std::runtime_error("Bad version");
 
+  if (version >= 2)
+    /* the journal generation is only used by the server */
+    s.Read32();
+
   clients.Load(s);
 
   if (s.Read8() != 0) {
@@ -6,14 +6,24 @@
 #include "Client.hpp"
 #include "Thermal.hpp"
 
+#include <iosfwd>
+
 class Serialiser;
 class Deserialiser;
 
 struct CloudData {
+  static constexpr uint32_t MAGIC = 0x5753f60f;
+
+  /**
+   * Version 2 added the #CloudJournal generation after the version
+   * number.
+   */
+  static constexpr uint32_t VERSION = 2;
+
   CloudClientContainer clients;
   CloudThermalContainer thermals;
 
-  void DumpClients();
+  void DumpClients(std::ostream &os) const;
 
   void Save(Serialiser &s) const;
   void Load(Deserialiser &s);
@@ -0,0 +1,404 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Journal.hpp"
+#include "Shards.hpp"
+#include "Tracking/SkyLines/Protocol.hpp"
+#include "Tracking/SkyLines/Export.hpp"
+#include "Tracking/SkyLines/Import.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "net/SocketAddress.hxx"
+#include "io/BufferedReader.hxx"
+#include "io/FileOutputStream.hxx"
+#include "io/FileReader.hxx"
+#include "system/FileUtil.hpp"
+#include "util/ByteOrder.hxx"
+#include "util/NumberParser.hpp"
+#include "util/StringCompare.hxx"
+#include "util/SpanCast.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+#include <stdio.h>
+
+static constexpr uint32_t JOURNAL_MAGIC = 0x5753f610;
+
+enum class JournalRecordType : uint8_t {
+  FIX = 1,
+  THERMAL = 2,
+};
+
+struct JournalHeader {
+  uint32_t magic;
+  uint32_t generation;
+};
+
+/**
+ * Large enough for a "struct sockaddr_in6".
+ */
+static constexpr std::size_t MAX_JOURNAL_ADDRESS_SIZE = 28;
+
+struct JournalFix {
+  uint64_t key;
+
+  /**
+   * Wall clock time [ms since epoch].
+   */
+  int64_t time;
+
+  uint32_t id;
+
+  SkyLinesTracking::GeoPoint location;
+
+  int32_t altitude;
+
+  uint8_t address_size;
+  uint8_t reserved[3];
+  std::byte address[MAX_JOURNAL_ADDRESS_SIZE];
+};
+
+struct JournalThermal {
+  uint64_t client_key;
+
+  /**
+   * Wall clock time [ms since epoch].
+   */
+  int64_t time;
+
+  SkyLinesTracking::GeoPoint bottom_location, top_location;
+  int32_t bottom_altitude, top_altitude;
+
+  /**
+   * Average lift [m/256s].
+   */
+  int32_t lift;
+};
+
+/* all fields are big-endian; all fixed-size, so the file is written
+   and read with plain memcpy() */
+static_assert(std::is_trivially_copyable_v<JournalFix>);
+static_assert(std::is_trivially_copyable_v<JournalThermal>);
+
+static int64_t
+ExportTime(std::chrono::system_clock::time_point t) noexcept
+{
+  using namespace std::chrono;
+  return ToBE64(duration_cast<milliseconds>(t.time_since_epoch()).count());
+}
+
+/**
+ * Convert a wall clock time stamp from the journal to the monotonic
+ * server-side clock.
+ */
+static std::chrono::steady_clock::time_point
+ImportTime(int64_t src_be,
+           std::chrono::steady_clock::time_point steady_now,
+           std::chrono::system_clock::time_point system_now) noexcept
+{
+  using namespace std::chrono;
+  const system_clock::time_point t{
+    duration_cast<system_clock::duration>(milliseconds(FromBE64(src_be)))};
+  return steady_now - duration_cast<steady_clock::duration>(system_now - t);
+}
+
+CloudJournal::CloudJournal(Path _db_path) noexcept
+  :db_path(_db_path) {}
+
+CloudJournal::~CloudJournal() noexcept = default;
+
+AllocatedPath
+CloudJournal::GetLogPath(unsigned _generation) const noexcept
+{
+  char suffix[32];
+  snprintf(suffix, sizeof(suffix), ".log.%u", _generation);
+  return db_path + suffix;
+}
+
+template<typename T>
+static void
+AppendRecord(std::vector<std::byte> &dest, JournalRecordType type,
+             const T &record) noexcept
+{
+  dest.push_back(std::byte(type));
+
+  const auto src = ReferenceAsBytes(record);
+  dest.insert(dest.end(), src.begin(), src.end());
+}
+
+void
+CloudJournal::AppendFix(SocketAddress address, uint64_t key, unsigned id,
+                        const GeoPoint &location, int altitude) noexcept
+{
+  JournalFix record{};
+  record.key = ToBE64(key);
+  record.time = ExportTime(std::chrono::system_clock::now());
+  record.id = ToBE32(id);
+  record.location = SkyLinesTracking::ExportGeoPoint(location);
+  record.altitude = ToBE32(altitude);
+
+  if (!address.IsNull() && address.GetSize() <= sizeof(record.address)) {
+    record.address_size = address.GetSize();
+    memcpy(record.address, address.GetAddress(), address.GetSize());
+  }
+
+  const std::scoped_lock lock{mutex};
+  AppendRecord(pending, JournalRecordType::FIX, record);
+}
+
+void
+CloudJournal::AppendThermal(uint64_t client_key,
+                            const AGeoPoint &bottom_location,
+                            const AGeoPoint &top_location,
+                            double lift) noexcept
+{
+  JournalThermal record{};
+  record.client_key = ToBE64(client_key);
+  record.time = ExportTime(std::chrono::system_clock::now());
+  record.bottom_location = SkyLinesTracking::ExportGeoPoint(bottom_location);
+  record.top_location = SkyLinesTracking::ExportGeoPoint(top_location);
+  record.bottom_altitude = ToBE32(int(bottom_location.altitude));
+  record.top_altitude = ToBE32(int(top_location.altitude));
+  record.lift = ToBE32(int(std::lround(lift * 256)));
+
+  const std::scoped_lock lock{mutex};
+  AppendRecord(pending, JournalRecordType::THERMAL, record);
+}
+
+std::vector<std::byte>
+CloudJournal::Cut() noexcept
+{
+  const std::scoped_lock lock{mutex};
+  return std::exchange(pending, {});
+}
+
+void
+CloudJournal::Open(unsigned _generation)
+{
+  auto new_file = std::make_unique<FileOutputStream>(GetLogPath(_generation),
+                                                     FileOutputStream::Mode::CREATE_VISIBLE);
+
+  JournalHeader header;
+  header.magic = ToBE32(JOURNAL_MAGIC);
+  header.generation = ToBE32(_generation);
+  new_file->Write(ReferenceAsBytes(header));
+  new_file->Sync();
+
+  file = std::move(new_file);
+  generation = _generation;
+}
+
+void
+CloudJournal::Flush()
+{
+  if (!file)
+    return;
+
+  const auto records = Cut();
+  if (records.empty())
+    return;
+
+  file->Write(records);
+  file->Sync();
+}
+
+unsigned
+CloudJournal::Rotate(std::span<const std::byte> cut_records)
+{
+  const unsigned old_generation = generation;
+
+  if (file) {
+    if (!cut_records.empty())
+      file->Write(cut_records);
+
+    file->Commit();
+    file.reset();
+  }
+
+  Open(old_generation + 1);
+  return old_generation;
+}
+
+void
+CloudJournal::RemoveUpTo(unsigned _generation) noexcept
+{
+  /* older log files may have been left over by a failed
+     compaction; stop at the first one which doesn't exist */
+  for (unsigned g = _generation; g > 0 && File::Delete(GetLogPath(g)); --g) {
+  }
+}
+
+void
+CloudJournal::RemoveAll() noexcept
+{
+  class LogFileVisitor final : public File::Visitor {
+    const std::string prefix;
+
+  public:
+    std::vector<AllocatedPath> paths;
+
+    explicit LogFileVisitor(Path db_path) noexcept
+      :prefix(std::string{db_path.GetBase().c_str()} + ".log.") {}
+
+    void Visit(Path path, Path filename) override {
+      const char *suffix = StringAfterPrefix(filename.c_str(), prefix);
+      if (suffix == nullptr || *suffix == 0)
+        return;
+
+      char *endptr;
+      ParseUnsigned(suffix, &endptr);
+      if (*endptr == 0)
+        paths.emplace_back(path);
+    }
+  };
+
+  try {
+    LogFileVisitor visitor(db_path);
+    Directory::VisitFiles(db_path.GetParent(), visitor);
+
+    /* delete after scanning, because modifying a directory while
+       reading it is not portable */
+    for (const auto &path : visitor.paths)
+      File::Delete(path);
+  } catch (...) {
+    /* out of memory; the next Open() will fail anyway */
+  }
+}
+
+/**
+ * Read one fixed-size object.
+ *
+ * @return false on end of file (or if the file is truncated)
+ */
+template<typename T>
+static bool
+ReadRecord(BufferedReader &r, T &dest)
+{
+  while (r.Read().size() < sizeof(dest))
+    if (!r.Fill(true))
+      return false;
+
+  memcpy(&dest, r.Read().data(), sizeof(dest));
+  r.Consume(sizeof(dest));
+  return true;
+}
+
+static void
+ReplayFix(CloudShardedData &data, const JournalFix &fix,
+          std::chrono::steady_clock::time_point steady_now,
+          std::chrono::system_clock::time_point system_now)
+{
+  const SocketAddress address = fix.address_size > 0 &&
+    fix.address_size <= sizeof(fix.address)
+    ? SocketAddress((const struct sockaddr *)(const void *)fix.address,
+                    fix.address_size)
+    : SocketAddress(nullptr);
+
+  data.RestoreClient(address, FromBE64(fix.key), FromBE32(fix.id),
+                     SkyLinesTracking::ImportGeoPoint(fix.location),
+                     int32_t(FromBE32(fix.altitude)),
+                     ImportTime(fix.time, steady_now, system_now));
+}
+
+static void
+ReplayThermal(CloudShardedData &data, const JournalThermal &thermal,
+              std::chrono::steady_clock::time_point steady_now,
+              std::chrono::system_clock::time_point system_now)
+{
+  data.RestoreThermal(FromBE64(thermal.client_key),
+                      AGeoPoint(SkyLinesTracking::ImportGeoPoint(thermal.bottom_location),
+                                int32_t(FromBE32(thermal.bottom_altitude))),
+                      AGeoPoint(SkyLinesTracking::ImportGeoPoint(thermal.top_location),
+                                int32_t(FromBE32(thermal.top_altitude))),
+                      int32_t(FromBE32(thermal.lift)) / 256.,
+                      ImportTime(thermal.time, steady_now, system_now));
+}
+
+/**
+ * The records of all journal files which are going to be replayed.
+ * Only the last fix of each client is kept, because each fix
+ * replaces the client's location; this makes replaying a long
+ * journal much cheaper than the original modifications were.
+ */
+struct JournalReplay {
+  std::unordered_map<uint64_t, JournalFix> fixes;
+  std::vector<JournalThermal> thermals;
+};
+
+/**
+ * Read one log file.
+ *
+ * @return false if the file does not exist
+ */
+static bool
+ReadFile(JournalReplay &replay, Path path, unsigned generation)
+{
+  if (!File::Exists(path))
+    return false;
+
+  FileReader file(path);
+  BufferedReader r(file);
+
+  JournalHeader header;
+  if (!ReadRecord(r, header))
+    /* the server has crashed right after creating this file */
+    return true;
+
+  if (FromBE32(header.magic) != JOURNAL_MAGIC ||
+      FromBE32(header.generation) != generation)
+    throw std::runtime_error("Malformed journal header");
+
+  JournalRecordType type;
+  while (ReadRecord(r, type)) {
+    switch (type) {
+    case JournalRecordType::FIX:
+      if (JournalFix fix; ReadRecord(r, fix))
+        replay.fixes.insert_or_assign(fix.key, fix);
+      else
+        return true;
+      break;
+
+    case JournalRecordType::THERMAL:
+      if (JournalThermal thermal; ReadRecord(r, thermal))
+        replay.thermals.push_back(thermal);
+      else
+        return true;
+      break;
+
+    default:
+      /* garbage at the end of the file, probably a torn write
+         during a crash */
+      return true;
+    }
+  }
+
+  return true;
+}
+
+unsigned
+CloudJournal::Replay(CloudShardedData &data, unsigned snapshot_generation)
+{
+  JournalReplay replay;
+
+  unsigned g = snapshot_generation;
+  while (ReadFile(replay, GetLogPath(g + 1), g + 1))
+    ++g;
+
+  const auto steady_now = std::chrono::steady_clock::now();
+  const auto system_now = std::chrono::system_clock::now();
+
+  for (const auto &[key, fix] : replay.fixes)
+    ReplayFix(data, fix, steady_now, system_now);
+
+  for (const auto &thermal : replay.thermals)
+    ReplayThermal(data, thermal, steady_now, system_now);
+
+  return g;
+}
@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "thread/Mutex.hxx"
+#include "system/Path.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+struct GeoPoint;
+struct AGeoPoint;
+class SocketAddress;
+class FileOutputStream;
+class CloudShardedData;
+
+/**
+ * An append-only log of all fixes and thermal submissions which
+ * modified the #CloudShardedData since the last snapshot was written.
+ *
+ * Each log file has a "generation" number which is part of its file
+ * name ("DBPATH.log.GENERATION").  A snapshot file contains the
+ * generation of the newest log file whose records it includes;
+ * loading the database means loading the snapshot and replaying all
+ * newer log files in ascending order.
+ *
+ * Records are collected in memory by the threads which modify the
+ * database, and are written to the file by Flush(), which is
+ * supposed to be called periodically from a thread which does not
+ * handle network traffic.
+ */
+class CloudJournal {
+  const AllocatedPath db_path;
+
+  /**
+   * Protects #pending.  This is a "leaf" lock: no other lock may be
+   * obtained while holding it.
+   */
+  Mutex mutex;
+
+  /**
+   * Serialised records which have not yet been written to the file.
+   */
+  std::vector<std::byte> pending;
+
+  /* the following attributes are only used by the persistence
+     thread */
+
+  /**
+   * The generation of the log file currently being written.
+   */
+  unsigned generation = 0;
+
+  std::unique_ptr<FileOutputStream> file;
+
+public:
+  explicit CloudJournal(Path _db_path) noexcept;
+  ~CloudJournal() noexcept;
+
+  CloudJournal(const CloudJournal &) = delete;
+  CloudJournal &operator=(const CloudJournal &) = delete;
+
+  [[gnu::pure]]
+  AllocatedPath GetLogPath(unsigned _generation) const noexcept;
+
+  unsigned GetGeneration() const noexcept {
+    return generation;
+  }
+
+  /**
+   * Record a fix which has created or moved a client.
+   */
+  void AppendFix(SocketAddress address, uint64_t key, unsigned id,
+                 const GeoPoint &location, int altitude) noexcept;
+
+  /**
+   * Record a new thermal.
+   */
+  void AppendThermal(uint64_t client_key,
+                     const AGeoPoint &bottom_location,
+                     const AGeoPoint &top_location,
+                     double lift) noexcept;
+
+  /**
+   * Remove all pending records and return them.  This is called by
+   * CloudShardedData::TakeSnapshot() while all shards are locked, so
+   * the returned records are exactly the ones which are included in
+   * the snapshot, but not yet in the log file.
+   */
+  std::vector<std::byte> Cut() noexcept;
+
+  /**
+   * Write all pending records to the log file and wait until they
+   * are on disk.
+   *
+   * Throws on error.
+   */
+  void Flush();
+
+  /**
+   * Write the given records (obtained by Cut()), close the current
+   * log file and start a new one with the next generation.
+   *
+   * Throws on error.
+   *
+   * @return the generation of the log file which was closed; the
+   * snapshot taken together with Cut() includes all of its records
+   */
+  unsigned Rotate(std::span<const std::byte> cut_records);
+
+  /**
+   * Start a new (empty) log file with the given generation.
+   *
+   * Throws on error.
+   */
+  void Open(unsigned _generation);
+
+  /**
+   * Delete all log files up to (and including) the given generation,
+   * after a snapshot which includes them has been committed.
+   */
+  void RemoveUpTo(unsigned _generation) noexcept;
+
+  /**
+   * Delete all log files, regardless of their generation.  This is
+   * used when the snapshot could not be loaded, i.e. when the
+   * generations of the existing log files are unknown.
+   */
+  void RemoveAll() noexcept;
+
+  /**
+   * Replay all log files newer than the given generation (i.e. the
+   * one of the snapshot which has just been loaded) into the
+   * database.  A truncated record at the end of a file (which may be
+   * the result of a crash) is ignored.
+   *
+   * Throws on I/O error.
+   *
+   * @return the generation of the newest log file which was
+   * replayed, or the given one if there was none
+   */
+  unsigned Replay(CloudShardedData &data, unsigned snapshot_generation);
+};
@@ -1,27 +1,35 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 // Copyright The XCSoar Project
 
-#include "Data.hpp"
+#include "Shards.hpp"
+#include "Persist.hpp"
 #include "Dump.hpp"
 #include "Sender.hpp"
-#include "Serialiser.hpp"
+#include "TrafficQueue.hpp"
 #include "Tracking/SkyLines/Server.hpp"
 #include "Tracking/SkyLines/Protocol.hpp"
 #include "util/ByteOrder.hxx"
 #include "event/Loop.hxx"
 #include "event/CoarseTimerEvent.hxx"
+#include "event/FineTimerEvent.hxx"
 #include "event/SignalMonitor.hxx"
+#include "thread/Thread.hpp"
+#include "thread/WorkerThread.hpp"
+#include "thread/Mutex.hxx"
 #include "net/IPv4Address.hxx"
-#include "io/FileOutputStream.hxx"
-#include "io/FileReader.hxx"
 #include "util/PrintException.hxx"
 #include "util/Exception.hxx"
 #include "util/Compiler.h"
 #include "util/ScopeExit.hxx"
+#include "util/NumberParser.hpp"
 
 #include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 
 #include <signal.h>
 
@@ -34,58 +42,82 @@ static constexpr std::chrono::steady_clock::duration MAX_THERMAL_AGE = std::chro
 
 static constexpr std::chrono::steady_clock::duration REQUEST_EXPIRY = std::chrono::minutes(5);
 
+/**
+ * Traffic updates are collected for this duration and then pushed to
+ * interested clients in one batch.
+ */
+static constexpr std::chrono::steady_clock::duration TRAFFIC_PUSH_INTERVAL = std::chrono::milliseconds(250);
+
+/**
+ * The access log on stdout is fully buffered; this is how often it
+ * gets flushed.
+ */
+static constexpr std::chrono::steady_clock::duration LOG_FLUSH_INTERVAL = std::chrono::seconds(1);
+
+/**
+ * How often are pending journal records written to disk?  This is
+ * the maximum amount of data lost in a crash.
+ */
+static constexpr std::chrono::steady_clock::duration JOURNAL_FLUSH_INTERVAL = std::chrono::seconds(1);
+
+/**
+ * How often is a new snapshot written (and the journal truncated)?
+ */
+static constexpr std::chrono::steady_clock::duration COMPACT_INTERVAL = std::chrono::minutes(1);
+
 using std::cout;
 using std::cerr;
 using std::endl;
 
+/**
+ * Protects the access log (i.e. std::cout), which is shared by all
+ * worker threads.
+ */
+static Mutex log_mutex;
+
+/**
+ * Handles the SkyLines tracking protocol on one #EventLoop.  In
+ * sharded mode, each worker thread has its own instance, all of them
+ * sharing one UDP port (SO_REUSEPORT) and one #CloudShardedData.
+ */
 class CloudServer final
-  : public SkyLinesTracking::Server, CloudData
+  : public SkyLinesTracking::Server
 {
-  const AllocatedPath db_path;
+  CloudShardedData &data;
 
-  CoarseTimerEvent save_timer, expire_timer;
+  CoarseTimerEvent log_flush_timer;
 
-public:
-  CloudServer(AllocatedPath &&_db_path, EventLoop &event_loop,
-              SocketAddress bind_address)
-    :SkyLinesTracking::Server(event_loop, bind_address),
-     db_path(std::move(_db_path)),
-     save_timer(event_loop, BIND_THIS_METHOD(OnSaveTimer)),
-     expire_timer(event_loop, BIND_THIS_METHOD(OnExpireTimer))
-  {
-#ifndef _WIN32
-    SignalMonitorRegister(SIGINT, BIND_THIS_METHOD(OnQuitSignal));
-    SignalMonitorRegister(SIGTERM, BIND_THIS_METHOD(OnQuitSignal));
-    SignalMonitorRegister(SIGQUIT, BIND_THIS_METHOD(OnQuitSignal));
+  FineTimerEvent traffic_push_timer;
 
-    SignalMonitorRegister(SIGHUP, BIND_THIS_METHOD(OnReloadSignal));
-    SignalMonitorRegister(SIGUSR1, BIND_THIS_METHOD(OnDumpSignal));
-#endif
+  TrafficPushQueue traffic_push_queue;
 
-    ScheduleSave();
+public:
+  CloudServer(CloudShardedData &_data, EventLoop &event_loop,
+              SocketAddress bind_address, bool reuse_port)
+    :SkyLinesTracking::Server(event_loop, bind_address, reuse_port),
+     data(_data),
+     log_flush_timer(event_loop, BIND_THIS_METHOD(OnLogFlushTimer)),
+     traffic_push_timer(event_loop, BIND_THIS_METHOD(OnTrafficPushTimer))
+  {
   }
 
-  void Load();
-  void Save();
-
 private:
-  void OnSaveTimer() noexcept {
-    Save();
-    ScheduleSave();
+  void OnLogFlushTimer() noexcept {
+    const std::scoped_lock lock{log_mutex};
+    cout.flush();
   }
 
-  void ScheduleSave() {
-    save_timer.Schedule(std::chrono::minutes(1));
+  /**
+   * Called after a line has been written to the (buffered) access
+   * log.
+   */
+  void ScheduleLogFlush() noexcept {
+    if (!log_flush_timer.IsPending())
+      log_flush_timer.Schedule(LOG_FLUSH_INTERVAL);
   }
 
-  void OnExpireTimer() noexcept {
-    clients.Expire(GetEventLoop().SteadyNow() - std::chrono::minutes(10));
-    if (!clients.empty())
-      ScheduleExpire();
-  }
-
-  void ScheduleExpire() {
-    expire_timer.Schedule(std::chrono::minutes(5));
+  void OnTrafficPushTimer() noexcept {
+    traffic_push_queue.Flush(*this);
   }
 
 protected:
@@ -116,29 +148,20 @@ protected:
 
   void OnSendError(SocketAddress address,
                    std::exception_ptr e) noexcept override {
+    const std::scoped_lock lock{log_mutex};
     cerr << "Failed to send to " << address
          << ": " << GetFullMessage(e)
          << endl;
   }
 
   void OnError(std::exception_ptr e) override {
-    cerr << GetFullMessage(e) << endl;
-    GetEventLoop().Break();
-  }
+    {
+      const std::scoped_lock lock{log_mutex};
+      cerr << GetFullMessage(e) << endl;
+    }
 
-#ifndef _WIN32
-  void OnQuitSignal() noexcept {
     GetEventLoop().Break();
   }
-
-  void OnReloadSignal() noexcept {
-    Save();
-  }
-
-  void OnDumpSignal() noexcept {
-    DumpClients();
-  }
-#endif
 };
 
 void
@@ -148,46 +171,47 @@ CloudServer::OnFix(const Client &c,
 {
   (void)time_of_day; // TODO: use this parameter
 
-  CloudClient *client;
+  CloudShardedData::ClientInfo client;
   if (location.IsValid()) {
-    bool was_empty = clients.empty();
-
-    client = &clients.Make(c.address, c.key, location, altitude);
+    client = data.MakeClient(c.address, c.key, location, altitude);
 
+    const std::scoped_lock lock{log_mutex};
     cout << "FIX\t"
-         << client->address << '\t'
-         << std::hex << client->key << std::dec << '\t'
-         << client->id << '\t'
-         << client->location << '\t'
-         << client->altitude << 'm'
-         << endl;
-
-    if (was_empty)
-      ScheduleExpire();
+         << SocketAddress(c.address) << '\t'
+         << std::hex << c.key << std::dec << '\t'
+         << client.id << '\t'
+         << client.location << '\t'
+         << client.altitude << "m\n";
+    ScheduleLogFlush();
   } else {
-    client = clients.Find(c.key);
-    if (client != nullptr)
-      clients.Refresh(*client, c.address);
+    auto found = data.RefreshClient(c.key, c.address);
+    if (!found)
+      return;
+
+    client = *found;
   }
 
-  /* send this new traffic location to all interested clients
-     immediately */
+  /* queue this new traffic location for all interested clients; the
+     queue is flushed after a short delay, so a burst of fixes results
+     in only one datagram per destination */
   const auto now = std::chrono::steady_clock::now();
-  for (const auto &i : clients.QueryWithinRange(location, TRAFFIC_RANGE)) {
-    if (i->key == c.key)
+  data.VisitClientsWithinRange(client.location, TRAFFIC_RANGE,
+                               [&](const CloudClient &i){
+    if (i.key == c.key)
       /* ignore this client's own submissions - he knows them
          already */
-      continue;
+      return;
 
-    if (now > i->wants_traffic)
+    if (now > i.wants_traffic)
       /* not interested (anymore) */
-      continue;
+      return;
 
-    TrafficResponseSender s(*this, i->address, i->key);
-    s.Add(client->id, 0, //TODO: time?
-          client->location, client->altitude);
-    s.Flush();
-  }
+    traffic_push_queue.Add(i.address, i.key,
+                           client.id, client.location, client.altitude);
+  });
+
+  if (!traffic_push_queue.empty() && !traffic_push_timer.IsPending())
+    traffic_push_timer.Schedule(TRAFFIC_PUSH_INTERVAL);
 }
 
 void
@@ -197,36 +221,37 @@ CloudServer::OnTrafficRequest(const Client &c, bool near)
     /* "near" is the only selection flag we know */
     return;
 
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  const auto now = std::chrono::steady_clock::now();
+
+  ::GeoPoint location;
+  if (!data.WithClient(c.key, [&](CloudClient &client){
+        client.wants_traffic = now + REQUEST_EXPIRY;
+        location = client.location;
+      }))
     /* we don't send our data to clients who didn't sent anything to
        us yet */
     return;
 
-  const auto now = std::chrono::steady_clock::now();
-
-  client->wants_traffic = now + REQUEST_EXPIRY;
-
   const auto min_stamp = now - MAX_TRAFFIC_AGE;
 
   TrafficResponseSender s(*this, c.address, c.key);
 
   unsigned n = 0;
-  for (const auto &traffic : clients.QueryWithinRange(client->location,
-                                                      TRAFFIC_RANGE)) {
-    if (traffic.get() == client)
-      continue;
+  data.VisitClientsWithinRange(location, TRAFFIC_RANGE,
+                               [&](const CloudClient &traffic){
+    if (traffic.key == c.key)
+      return;
 
-    if (traffic->stamp < min_stamp)
+    if (traffic.stamp < min_stamp)
       /* don't send stale traffic, it's probably not there anymore */
-      continue;
+      return;
 
-    s.Add(traffic->id, 0, //TODO: time?
-          traffic->location, traffic->altitude);
+    if (n++ > 64)
+      return;
 
-    if (++n > 64)
-      break;
-  }
+    s.Add(traffic.id, 0, //TODO: time?
+          traffic.location, traffic.altitude);
+  });
 
   s.Flush();
 }
@@ -239,21 +264,24 @@ CloudServer::OnWaveSubmit(const Client &c,
                           int top_altitude,
                           double lift)
 {
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  unsigned id;
+  if (!data.WithClient(c.key, [&id](const CloudClient &client){
+        id = client.id;
+      }))
     /* we don't trust the client if he didn't sent anything to us
        yet */
     return;
 
+  const std::scoped_lock lock{log_mutex};
   cout << "WAVE\t"
-       << client->address << '\t'
-       << std::hex << client->key << std::dec << '\t'
-       << client->id << '\t'
+       << SocketAddress(c.address) << '\t'
+       << std::hex << c.key << std::dec << '\t'
+       << id << '\t'
        << a << '\t'
        << b << '\t'
        << bottom_altitude << '-' << top_altitude << "m\t"
-       << lift << "m/s"
-       << endl;
+       << lift << "m/s\n";
+  ScheduleLogFlush();
 }
 
 void
@@ -265,135 +293,327 @@ CloudServer::OnThermalSubmit(const Client &c,
                              int top_altitude,
                              double lift)
 {
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  unsigned id;
+  if (!data.WithClient(c.key, [&id](const CloudClient &client){
+        id = client.id;
+      }))
     /* we don't trust the client if he didn't sent anything to us
        yet */
     return;
 
-  cout << "THERMAL\t"
-       << client->address << '\t'
-       << std::hex << client->key << std::dec << '\t'
-       << client->id << '\t'
-       << top_location << '\t'
-       << bottom_altitude << '-' << top_altitude << "m\t"
-       << lift << "m/s"
-       << endl;
+  {
+    const std::scoped_lock lock{log_mutex};
+    cout << "THERMAL\t"
+         << SocketAddress(c.address) << '\t'
+         << std::hex << c.key << std::dec << '\t'
+         << id << '\t'
+         << top_location << '\t'
+         << bottom_altitude << '-' << top_altitude << "m\t"
+         << lift << "m/s\n";
+    ScheduleLogFlush();
+  }
 
-  const auto &thermal =
-    thermals.Make(c.key,
-                  AGeoPoint(bottom_location, bottom_altitude),
-                  AGeoPoint(top_location, top_altitude),
-                  lift);
+  const auto thermal =
+    data.MakeThermal(c.key,
+                     AGeoPoint(bottom_location, bottom_altitude),
+                     AGeoPoint(top_location, top_altitude),
+                     lift);
 
   /* send this new thermal to all interested clients immediately */
   const auto now = std::chrono::steady_clock::now();
-  for (const auto &i : clients.QueryWithinRange(bottom_location,
-                                                THERMAL_RANGE)) {
-    if (i->key == c.key)
+  data.VisitClientsWithinRange(bottom_location, THERMAL_RANGE,
+                               [&](const CloudClient &i){
+    if (i.key == c.key)
       /* ignore this client's own submissions - he knows them
          already */
-      continue;
+      return;
 
-    if (now > i->wants_thermals)
+    if (now > i.wants_thermals)
       /* not interested (anymore) */
-      continue;
+      return;
 
-    ThermalResponseSender s(*this, i->address, i->key);
-    s.Add(thermal.Pack());
+    ThermalResponseSender s(*this, i.address, i.key);
+    s.Add(thermal);
     s.Flush();
-  }
+  });
 }
 
 void
 CloudServer::OnThermalRequest(const Client &c)
 {
-  auto *client = clients.Find(c.key);
-  if (client == nullptr)
+  const auto now = std::chrono::steady_clock::now();
+
+  ::GeoPoint location;
+  if (!data.WithClient(c.key, [&](CloudClient &client){
+        client.wants_thermals = now + REQUEST_EXPIRY;
+        location = client.location;
+      }))
     /* we don't send our data to clients who didn't sent anything to
        us yet */
     return;
 
-  const auto now = std::chrono::steady_clock::now();
-
-  client->wants_thermals = now + REQUEST_EXPIRY;
-
   const auto min_time = now - MAX_THERMAL_AGE;
 
   ThermalResponseSender s(*this, c.address, c.key);
 
   unsigned n = 0;
-  for (const auto &thermal : thermals.QueryWithinRange(client->location,
-                                                       THERMAL_RANGE)) {
-    if (thermal->client_key == c.key)
+  data.VisitThermalsWithinRange(location, THERMAL_RANGE,
+                                [&](const CloudThermal &thermal){
+    if (thermal.client_key == c.key)
       /* ignore this client's own submissions - he knows them
          already */
-      continue;
+      return;
 
-    if (thermal->time < min_time)
+    if (thermal.time < min_time)
       /* don't send old thermals, they're useless */
-      continue;
+      return;
 
-    s.Add(thermal->Pack());
+    if (n++ > 256)
+      return;
 
-    if (++n > 256)
-      break;
-  }
+    s.Add(thermal.Pack());
+  });
 
   s.Flush();
 }
 
+/**
+ * Writes the journal and the snapshots (see #CloudPersistence), so
+ * disk I/O never blocks an #EventLoop thread.
+ */
+class CloudPersistThread final : public WorkerThread {
+  CloudPersistence &persistence;
+
+  std::atomic<bool> compact_requested{false};
+
+public:
+  explicit CloudPersistThread(CloudPersistence &_persistence) noexcept
+    :WorkerThread("persist"), persistence(_persistence) {}
+
+  void RequestCompaction() noexcept {
+    compact_requested = true;
+    Trigger();
+  }
+
+  void Stop() noexcept {
+    BeginStop();
+    Join();
+  }
+
+protected:
+  /* virtual methods from WorkerThread */
+  void Tick() noexcept override;
+};
+
 void
-CloudServer::Load()
-{
-  FileReader fr(db_path);
-  Deserialiser s(fr);
-  CloudData::Load(s);
+CloudPersistThread::Tick() noexcept
+try {
+  if (compact_requested.exchange(false)) {
+    {
+      const std::scoped_lock lock{log_mutex};
+      cout << "Saving data to " << persistence.GetPath().c_str() << endl;
+    }
+
+    persistence.Compact();
+  } else
+    persistence.Flush();
+} catch (...) {
+  const std::scoped_lock lock{log_mutex};
+  cerr << "Failed to save database: "
+       << GetFullMessage(std::current_exception()) << endl;
 }
 
-void
-CloudServer::Save()
-{
-  cout << "Saving data to " << db_path.c_str() << endl;
+/**
+ * Performs periodic maintenance on the #CloudShardedData.  Runs in
+ * the main thread.
+ */
+class CloudDatabase final {
+  CloudShardedData &data;
+
+  CloudPersistThread &persist_thread;
 
-  FileOutputStream fos(db_path);
+  EventLoop &event_loop;
 
+  CoarseTimerEvent flush_timer, compact_timer, expire_timer;
+
+public:
+  CloudDatabase(CloudShardedData &_data, CloudPersistThread &_persist_thread,
+                EventLoop &_event_loop)
+    :data(_data), persist_thread(_persist_thread),
+     event_loop(_event_loop),
+     flush_timer(event_loop, BIND_THIS_METHOD(OnFlushTimer)),
+     compact_timer(event_loop, BIND_THIS_METHOD(OnCompactTimer)),
+     expire_timer(event_loop, BIND_THIS_METHOD(OnExpireTimer))
   {
-    Serialiser s(fos);
-    CloudData::Save(s);
-    s.Flush();
+#ifndef _WIN32
+    SignalMonitorRegister(SIGINT, BIND_THIS_METHOD(OnQuitSignal));
+    SignalMonitorRegister(SIGTERM, BIND_THIS_METHOD(OnQuitSignal));
+    SignalMonitorRegister(SIGQUIT, BIND_THIS_METHOD(OnQuitSignal));
+
+    SignalMonitorRegister(SIGHUP, BIND_THIS_METHOD(OnReloadSignal));
+    SignalMonitorRegister(SIGUSR1, BIND_THIS_METHOD(OnDumpSignal));
+#endif
+
+    flush_timer.Schedule(JOURNAL_FLUSH_INTERVAL);
+    compact_timer.Schedule(COMPACT_INTERVAL);
+    ScheduleExpire();
   }
 
-  fos.Commit();
-}
+private:
+  void OnFlushTimer() noexcept {
+    persist_thread.Trigger();
+    flush_timer.Schedule(JOURNAL_FLUSH_INTERVAL);
+  }
+
+  void OnCompactTimer() noexcept {
+    persist_thread.RequestCompaction();
+    compact_timer.Schedule(COMPACT_INTERVAL);
+  }
+
+  void OnExpireTimer() noexcept {
+    data.ExpireClients(event_loop.SteadyNow() - std::chrono::minutes(10));
+    ScheduleExpire();
+  }
+
+  void ScheduleExpire() {
+    expire_timer.Schedule(std::chrono::minutes(5));
+  }
+
+#ifndef _WIN32
+  void OnQuitSignal() noexcept {
+    event_loop.Break();
+  }
+
+  void OnReloadSignal() noexcept {
+    persist_thread.RequestCompaction();
+  }
+
+  void OnDumpSignal() noexcept {
+    /* copy the clients out of the shards first: the worker threads
+       lock log_mutex (in OnSendError()) while holding a shard
+       lock */
+    std::ostringstream os;
+    data.DumpClients(os);
+
+    const std::scoped_lock lock{log_mutex};
+    cout << os.view();
+    cout.flush();
+  }
+#endif
+};
+
+/**
+ * A thread which runs an additional #CloudServer instance in sharded
+ * mode.
+ */
+class CloudWorkerThread final : Thread {
+  EventLoop event_loop{ThreadId::Null()};
+
+  CloudServer server;
+
+public:
+  CloudWorkerThread(CloudShardedData &data, SocketAddress bind_address)
+    :Thread("worker"),
+     server(data, event_loop, bind_address, true) {}
+
+  void Start() {
+    event_loop.SetAlive(true);
+    Thread::Start();
+  }
+
+  void Stop() noexcept {
+    event_loop.InjectBreak();
+    Join();
+
+    /* the CloudServer will be destroyed in the main thread */
+    event_loop.SetAlive(false);
+  }
+
+protected:
+  /* virtual methods from Thread */
+  void Run() noexcept override {
+    event_loop.Run();
+  }
+};
 
 int
 main(int argc, char **argv)
 try {
-  if (argc != 2) {
-    cerr << "Usage: " << argv[0] << " DBPATH" << endl;
+  /* the access log is flushed periodically by CloudServer, not after
+     each line */
+  std::ios_base::sync_with_stdio(false);
+
+  if (argc < 2 || argc > 3) {
+    cerr << "Usage: " << argv[0] << " DBPATH [THREADS]" << endl;
     return EXIT_FAILURE;
   }
 
   const Path db_path(argv[1]);
 
+  unsigned n_threads = 1;
+  if (argc > 2) {
+    n_threads = ParseUnsigned(argv[2]);
+    if (n_threads < 1 || n_threads > CloudShardedData::MAX_SHARDS) {
+      cerr << "Invalid number of threads" << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  const IPv4Address bind_address(CloudServer::GetDefaultPort());
+
+  CloudShardedData data(n_threads);
+
   EventLoop event_loop;
   SignalMonitorInit(event_loop);
   AtScopeExit() { SignalMonitorFinish(); };
 
-  CloudServer server(db_path, event_loop,
-                     IPv4Address(CloudServer::GetDefaultPort()));
+  CloudPersistence persistence(data, db_path);
 
+  unsigned generation = 0;
   try {
-    server.Load();
+    generation = persistence.Load();
   } catch (const std::runtime_error &e) {
     cerr << "Failed to load database" << endl;
     PrintException(e);
+
+    persistence.DiscardJournal();
   }
 
+  persistence.Open(generation);
+
+  CloudPersistThread persist_thread(persistence);
+
+  /* this registers the signal handlers, which blocks the signals;
+     this must be done before starting threads, because they inherit
+     the signal mask */
+  CloudDatabase database(data, persist_thread, event_loop);
+
+  /* the main thread runs the first server instance, and each
+     additional thread runs another one on the same port */
+  CloudServer server(data, event_loop, bind_address, n_threads > 1);
+
+  std::vector<std::unique_ptr<CloudWorkerThread>> workers;
+  for (unsigned i = 1; i < n_threads; ++i)
+    workers.emplace_back(std::make_unique<CloudWorkerThread>(data,
+                                                             bind_address));
+
+  /* start the threads only after all sockets have been bound
+     successfully; the CloudServer constructor throws if the port is
+     in use */
+  persist_thread.Start();
+
+  for (auto &worker : workers)
+    worker->Start();
+
   event_loop.Run();
 
-  server.Save();
+  for (auto &worker : workers)
+    worker->Stop();
+
+  persist_thread.Stop();
+
+  cout << "Saving data to " << db_path.c_str() << endl;
+  persistence.Compact();
 
   return EXIT_SUCCESS;
 } catch (const std::exception &exception) {
@@ -0,0 +1,75 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Persist.hpp"
+#include "Serialiser.hpp"
+#include "io/FileOutputStream.hxx"
+#include "io/FileReader.hxx"
+#include "system/FileUtil.hpp"
+
+CloudPersistence::CloudPersistence(CloudShardedData &_data,
+                                   Path _db_path) noexcept
+  :data(_data), db_path(_db_path), journal(_db_path) {}
+
+CloudPersistence::~CloudPersistence() noexcept
+{
+  data.SetJournal(nullptr);
+}
+
+unsigned
+CloudPersistence::Load()
+{
+  unsigned generation = 0;
+
+  if (File::Exists(db_path)) {
+    FileReader fr(db_path);
+    Deserialiser s(fr);
+    generation = data.Load(s);
+  }
+
+  return journal.Replay(data, generation);
+}
+
+void
+CloudPersistence::Open(unsigned generation)
+{
+  /* the snapshot includes all journal files which have been
+     replayed, therefore they can be deleted */
+  data.TakeSnapshot(snapshot);
+  WriteSnapshot(generation);
+  journal.RemoveUpTo(generation);
+
+  journal.Open(generation + 1);
+  data.SetJournal(&journal);
+}
+
+void
+CloudPersistence::Compact()
+{
+  data.TakeSnapshot(snapshot);
+
+  /* the records which were pending in the moment the snapshot was
+     taken are written to the old journal file, because the snapshot
+     may fail to be written */
+  const unsigned generation = journal.Rotate(snapshot.journal_records);
+
+  WriteSnapshot(generation);
+  journal.RemoveUpTo(generation);
+}
+
+void
+CloudPersistence::WriteSnapshot(unsigned generation)
+{
+  FileOutputStream fos(db_path);
+
+  {
+    Serialiser s(fos);
+    snapshot.Save(s, generation);
+    s.Flush();
+  }
+
+  /* the snapshot must be on disk before the journal files it
+     includes are deleted */
+  fos.Sync();
+  fos.Commit();
+}
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Journal.hpp"
+#include "Shards.hpp"
+#include "system/Path.hpp"
+
+/**
+ * Keeps the #CloudShardedData on disk: a snapshot file ("DBPATH")
+ * plus a #CloudJournal with all modifications since the snapshot was
+ * taken.
+ *
+ * None of these methods is called in an #EventLoop thread; the
+ * database is only locked while the snapshot is being copied (see
+ * CloudShardedData::TakeSnapshot()).
+ */
+class CloudPersistence {
+  CloudShardedData &data;
+
+  const AllocatedPath db_path;
+
+  CloudJournal journal;
+
+  /**
+   * Reused by each compaction, see CloudShardedData::TakeSnapshot().
+   */
+  CloudShardedData::Snapshot snapshot;
+
+public:
+  CloudPersistence(CloudShardedData &_data, Path _db_path) noexcept;
+  ~CloudPersistence() noexcept;
+
+  CloudPersistence(const CloudPersistence &) = delete;
+  CloudPersistence &operator=(const CloudPersistence &) = delete;
+
+  Path GetPath() const noexcept {
+    return db_path;
+  }
+
+  /**
+   * Load the snapshot (if one exists) and replay the journal.
+   *
+   * Throws on error.
+   *
+   * @return the generation of the newest journal file which was
+   * loaded
+   */
+  unsigned Load();
+
+  /**
+   * Write a fresh snapshot (with everything that was loaded), start
+   * a new journal file and begin recording all modifications.  This
+   * must be called after Load() (even if it has failed) and before
+   * the database is modified.
+   *
+   * Throws on error.
+   *
+   * @param generation the return value of Load()
+   */
+  void Open(unsigned generation);
+
+  /**
+   * Delete all journal files.  This must be called before Open() if
+   * Load() has failed: Open() only replaces the files up to the
+   * generation it is given, and the next Load() would replay the
+   * stale records of newer files on top of the new snapshot.
+   */
+  void DiscardJournal() noexcept {
+    journal.RemoveAll();
+  }
+
+  /**
+   * Write all pending journal records to disk.
+   *
+   * Throws on error.
+   */
+  void Flush() {
+    journal.Flush();
+  }
+
+  /**
+   * Write a new snapshot and delete the journal files it includes.
+   *
+   * Throws on error.
+   */
+  void Compact();
+
+private:
+  void WriteSnapshot(unsigned generation);
+};
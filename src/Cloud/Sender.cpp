@@ -37,7 +37,7 @@ TrafficResponseSender::Flush()
 
   data.header.header.crc = 0;
   data.header.header.crc = ToBE16(UpdateCRC16CCITT(&data, size, 0));
-  server.SendBuffer(address, {(const std::byte *)&data, size});
+  server.QueueBuffer(address, {(const std::byte *)&data, size});
 }
 
 void
@@ -64,5 +64,5 @@ ThermalResponseSender::Flush()
 
   data.header.header.crc = 0;
   data.header.header.crc = ToBE16(UpdateCRC16CCITT(&data, size, 0));
-  server.SendBuffer(address, {(const std::byte *)&data, size});
+  server.QueueBuffer(address, {(const std::byte *)&data, size});
 }
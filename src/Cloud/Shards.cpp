@@ -0,0 +1,426 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Shards.hpp"
+#include "Journal.hpp"
+#include "Serialiser.hpp"
+#include "Geo/Boost/RangeBox.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+CloudShardedData::CloudShardedData(unsigned n_shards)
+{
+  assert(n_shards > 0);
+  assert(n_shards <= MAX_SHARDS);
+
+  shards.reserve(n_shards);
+  for (unsigned i = 0; i < n_shards; ++i)
+    shards.emplace_back(std::make_unique<Shard>());
+}
+
+CloudShardedData::~CloudShardedData() noexcept = default;
+
+inline int
+CloudShardedData::ToCell(Angle longitude) noexcept
+{
+  return (int)std::floor((longitude.Degrees() + 180) / CELL_WIDTH);
+}
+
+unsigned
+CloudShardedData::GetShardIndex(GeoPoint location) const noexcept
+{
+  int cell = ToCell(location.longitude) % (int)N_CELLS;
+  if (cell < 0)
+    cell += N_CELLS;
+
+  return unsigned(cell) % shards.size();
+}
+
+uint64_t
+CloudShardedData::GetShardsWithinRange(GeoPoint location,
+                                       double range) const noexcept
+{
+  const auto box = BoostRangeBox(location, range);
+  const int west = ToCell(box.min_corner().longitude);
+  const int east = ToCell(box.max_corner().longitude);
+
+  if (east < west || unsigned(east - west) + 1 >= shards.size())
+    /* the range touches all shards */
+    return shards.size() >= 64
+      ? ~uint64_t(0)
+      : (uint64_t(1) << shards.size()) - 1;
+
+  uint64_t mask = 0;
+  for (int cell = west; cell <= east; ++cell) {
+    int wrapped = cell % (int)N_CELLS;
+    if (wrapped < 0)
+      wrapped += N_CELLS;
+
+    mask |= uint64_t(1) << (unsigned(wrapped) % shards.size());
+  }
+
+  return mask;
+}
+
+CloudShardedData::ClientInfo
+CloudShardedData::MakeClient(SocketAddress address, uint64_t key, unsigned id,
+                             const GeoPoint &location, int altitude,
+                             std::chrono::steady_clock::time_point stamp,
+                             CloudJournal *_journal)
+{
+  const unsigned new_index = GetShardIndex(location);
+  auto &new_shard = *shards[new_index];
+
+  auto &stripe = GetKeyStripe(key);
+  const std::scoped_lock stripe_lock{stripe.mutex};
+
+  auto i = stripe.shards.find(key);
+  if (i == stripe.shards.end()) {
+    const std::scoped_lock lock{new_shard.mutex};
+
+    if (id == 0)
+      id = next_id++;
+    else if (id >= next_id)
+      /* restoring from the journal: don't hand out this id again */
+      next_id = id + 1;
+
+    auto client = std::make_shared<CloudClient>(address, key, id,
+                                                location, altitude);
+    client->stamp = stamp;
+    new_shard.data.clients.Insert(*client);
+    stripe.shards.emplace(key, new_index);
+
+    if (_journal != nullptr)
+      _journal->AppendFix(address, key, id, location, altitude);
+
+    return {id, location, altitude};
+  }
+
+  const unsigned old_index = i->second;
+  if (old_index == new_index) {
+    const std::scoped_lock lock{new_shard.mutex};
+    auto &client = *new_shard.data.clients.Find(key);
+    new_shard.data.clients.Refresh(client, address, location, altitude);
+    client.stamp = stamp;
+
+    if (_journal != nullptr)
+      _journal->AppendFix(address, key, client.id, location, altitude);
+
+    return {client.id, location, altitude};
+  }
+
+  /* the client has crossed a shard border: move it */
+
+  auto &old_shard = *shards[old_index];
+
+  /* std::scoped_lock uses a deadlock avoidance algorithm, therefore
+     we don't need to care for the order here */
+  const std::scoped_lock lock{old_shard.mutex, new_shard.mutex};
+
+  auto ptr = old_shard.data.clients.Find(key)->shared_from_this();
+  old_shard.data.clients.Remove(*ptr);
+
+  ptr->Refresh(address);
+  ptr->stamp = stamp;
+  ptr->location = location;
+  ptr->altitude = altitude;
+  new_shard.data.clients.Insert(*ptr);
+
+  i->second = new_index;
+
+  if (_journal != nullptr)
+    _journal->AppendFix(address, key, ptr->id, location, altitude);
+
+  return {ptr->id, location, altitude};
+}
+
+std::optional<CloudShardedData::ClientInfo>
+CloudShardedData::RefreshClient(uint64_t key, SocketAddress address)
+{
+  auto &stripe = GetKeyStripe(key);
+  const std::scoped_lock stripe_lock{stripe.mutex};
+
+  auto i = stripe.shards.find(key);
+  if (i == stripe.shards.end())
+    return std::nullopt;
+
+  auto &shard = *shards[i->second];
+  const std::scoped_lock lock{shard.mutex};
+  auto *client = shard.data.clients.Find(key);
+  if (client == nullptr)
+    return std::nullopt;
+
+  shard.data.clients.Refresh(*client, address);
+  return ClientInfo{client->id, client->location, client->altitude};
+}
+
+SkyLinesTracking::Thermal
+CloudShardedData::MakeThermal(uint64_t client_key,
+                              const AGeoPoint &bottom_location,
+                              const AGeoPoint &top_location,
+                              double lift)
+{
+  /* thermals are indexed by their top location, see
+     CloudThermalIndexable */
+  auto &shard = *shards[GetShardIndex(top_location)];
+  const std::scoped_lock lock{shard.mutex};
+
+  if (journal != nullptr)
+    journal->AppendThermal(client_key, bottom_location, top_location, lift);
+
+  return shard.data.thermals.Make(client_key, bottom_location, top_location,
+                                  lift).Pack();
+}
+
+void
+CloudShardedData::RestoreThermal(uint64_t client_key,
+                                 const AGeoPoint &bottom_location,
+                                 const AGeoPoint &top_location,
+                                 double lift,
+                                 std::chrono::steady_clock::time_point time)
+{
+  auto &shard = *shards[GetShardIndex(top_location)];
+  const std::scoped_lock lock{shard.mutex};
+  shard.data.thermals.Make(client_key, bottom_location, top_location,
+                           lift).time = time;
+}
+
+void
+CloudShardedData::ExpireClients(std::chrono::steady_clock::time_point before)
+{
+  std::vector<uint64_t> keys;
+
+  for (unsigned index = 0; index < shards.size(); ++index) {
+    auto &shard = *shards[index];
+
+    /* collect candidates first; we must not lock the key stripe
+       while holding the shard lock */
+    keys.clear();
+
+    {
+      const std::scoped_lock lock{shard.mutex};
+      for (const auto &client : shard.data.clients)
+        if (client.stamp < before)
+          keys.push_back(client.key);
+    }
+
+    for (const uint64_t key : keys) {
+      auto &stripe = GetKeyStripe(key);
+      const std::scoped_lock stripe_lock{stripe.mutex};
+
+      auto i = stripe.shards.find(key);
+      if (i == stripe.shards.end() || i->second != index)
+        /* has been moved to another shard meanwhile */
+        continue;
+
+      const std::scoped_lock lock{shard.mutex};
+      auto *client = shard.data.clients.Find(key);
+      if (client == nullptr || client->stamp >= before)
+        /* has been refreshed meanwhile */
+        continue;
+
+      shard.data.clients.Remove(*client);
+      stripe.shards.erase(i);
+    }
+  }
+}
+
+void
+CloudShardedData::DumpClients(std::ostream &os) const
+{
+  for (const auto &shard : shards) {
+    const std::scoped_lock lock{shard->mutex};
+    shard->data.DumpClients(os);
+  }
+}
+
+/**
+ * Write the file header and the first half of the #CloudData file
+ * format.  The clients must be written next with WriteClient(),
+ * followed by WriteThermalsBegin().
+ */
+static void
+WriteBegin(Serialiser &s, unsigned journal_generation, unsigned next_id)
+{
+  s.Write32(CloudData::MAGIC);
+  s.Write32(CloudData::VERSION);
+  s.Write32(journal_generation);
+
+  /* see CloudClientContainer::Save() */
+  s.Write32(next_id);
+}
+
+static void
+WriteClient(Serialiser &s, const CloudClient &client)
+{
+  s.Write8(1);
+  client.Save(s);
+}
+
+static void
+WriteThermalsBegin(Serialiser &s)
+{
+  s.Write8(0);
+  s.Write8(0);
+
+  /* see CloudThermalContainer::Save() */
+  s.Write8(1);
+  s.Write8(1);
+}
+
+static void
+WriteThermal(Serialiser &s, const CloudThermal &thermal)
+{
+  s.Write8(1);
+  thermal.Save(s);
+}
+
+static void
+WriteEnd(Serialiser &s)
+{
+  s.Write8(0);
+  s.Write8(0);
+
+  s.Write8(0);
+}
+
+void
+CloudShardedData::TakeSnapshot(Snapshot &snapshot) const
+{
+  snapshot.clients.clear();
+  snapshot.thermals.clear();
+
+  /* lock all shards to get a consistent snapshot */
+  std::vector<std::unique_lock<Mutex>> locks;
+  locks.reserve(shards.size());
+  for (const auto &shard : shards)
+    locks.emplace_back(shard->mutex);
+
+  snapshot.next_id = next_id;
+
+  for (const auto &shard : shards) {
+    for (const auto &client : shard->data.clients)
+      snapshot.clients.push_back({
+          StaticSocketAddress(client.address),
+          client.key, client.id, client.stamp,
+          client.location, client.altitude,
+        });
+
+    for (const auto &thermal : shard->data.thermals)
+      snapshot.thermals.emplace_back(thermal);
+  }
+
+  /* all modifications until now are in the snapshot; all later ones
+     will be in the next journal file */
+  if (journal != nullptr)
+    snapshot.journal_records = journal->Cut();
+  else
+    snapshot.journal_records.clear();
+}
+
+void
+CloudShardedData::Snapshot::Save(Serialiser &s,
+                                 unsigned journal_generation) const
+{
+  WriteBegin(s, journal_generation, next_id);
+
+  for (const auto &i : clients) {
+    CloudClient client(SocketAddress(i.address), i.key, i.id,
+                       i.location, i.altitude);
+    client.stamp = i.stamp;
+    WriteClient(s, client);
+  }
+
+  WriteThermalsBegin(s);
+
+  for (const auto &thermal : thermals)
+    WriteThermal(s, thermal);
+
+  WriteEnd(s);
+}
+
+void
+CloudShardedData::Save(Serialiser &s) const
+{
+  /* lock all shards to get a consistent snapshot */
+  std::vector<std::unique_lock<Mutex>> locks;
+  locks.reserve(shards.size());
+  for (const auto &shard : shards)
+    locks.emplace_back(shard->mutex);
+
+  WriteBegin(s, 0, next_id);
+
+  for (const auto &shard : shards)
+    for (const auto &client : shard->data.clients)
+      WriteClient(s, client);
+
+  WriteThermalsBegin(s);
+
+  for (const auto &shard : shards)
+    for (const auto &thermal : shard->data.thermals)
+      WriteThermal(s, thermal);
+
+  WriteEnd(s);
+}
+
+unsigned
+CloudShardedData::Load(Deserialiser &s)
+{
+  if (s.Read32() != CloudData::MAGIC)
+    throw std::runtime_error("Bad magic");
+
+  const unsigned version = s.Read32();
+  if (version < 1 || version > CloudData::VERSION)
+    throw std::runtime_error("Bad version");
+
+  const unsigned journal_generation = version >= 2 ? s.Read32() : 0;
+
+  /* see CloudClientContainer::Load() */
+  next_id = s.Read32();
+
+  /* collect everything first and insert it into each shard at once,
+     which allows bulk-loading the R-trees */
+  std::vector<std::vector<CloudClientPtr>> shard_clients(shards.size());
+
+  while (s.Read8() != 0) {
+    auto client = std::make_shared<CloudClient>(CloudClient::Load(s));
+    const unsigned index = GetShardIndex(client->location);
+
+    auto &stripe = GetKeyStripe(client->key);
+    const std::scoped_lock stripe_lock{stripe.mutex};
+    if (!stripe.shards.emplace(client->key, index).second)
+      /* duplicate key; ignore */
+      continue;
+
+    shard_clients[index].emplace_back(std::move(client));
+  }
+
+  s.Read8();
+
+  std::vector<std::vector<CloudThermalPtr>> shard_thermals(shards.size());
+
+  if (s.Read8() != 0) {
+    /* see CloudThermalContainer::Load() */
+    s.Read8();
+
+    while (s.Read8() != 0) {
+      auto thermal = std::make_shared<CloudThermal>(CloudThermal::Load(s));
+      const unsigned index = GetShardIndex(thermal->top_location);
+      shard_thermals[index].emplace_back(std::move(thermal));
+    }
+
+    s.Read8();
+    s.Read8();
+  }
+
+  for (unsigned i = 0; i < shards.size(); ++i) {
+    auto &shard = *shards[i];
+    const std::scoped_lock lock{shard.mutex};
+    shard.data.clients.InsertMany(shard_clients[i]);
+    shard.data.thermals.InsertMany(shard_thermals[i]);
+  }
+
+  return journal_generation;
+}
@@ -0,0 +1,329 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Data.hpp"
+#include "Tracking/SkyLines/Protocol.hpp"
+#include "thread/Mutex.hxx"
+#include "net/StaticSocketAddress.hxx"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+class Serialiser;
+class Deserialiser;
+class CloudJournal;
+
+/**
+ * The cloud database, partitioned geographically into several
+ * #CloudData shards which can be accessed concurrently by multiple
+ * worker threads.
+ *
+ * The world is divided into longitude columns (#CELL_WIDTH degrees
+ * wide), and the columns are assigned to shards round-robin, so a
+ * busy area spans several shards.  Clients and thermals are stored in
+ * the shard which owns their current location; range queries visit
+ * all shards which own a column intersecting the query box, so
+ * queries near shard borders see all results.
+ *
+ * Locking order: at most one key stripe mutex first, then shard
+ * mutexes.  Several shards are only locked at once in ascending index
+ * order or with std::scoped_lock.  The #CloudJournal mutex is locked
+ * last.
+ */
+class CloudShardedData {
+public:
+  static constexpr unsigned MAX_SHARDS = 64;
+
+private:
+  /**
+   * The width of one longitude column [degrees].
+   */
+  static constexpr double CELL_WIDTH = 1;
+  static constexpr unsigned N_CELLS = 360;
+
+  struct Shard {
+    mutable Mutex mutex;
+    CloudData data;
+  };
+
+  std::vector<std::unique_ptr<Shard>> shards;
+
+  /**
+   * Maps a client's secret key to the index of the shard which
+   * currently owns it.  This map is split into stripes to reduce
+   * contention; the stripe mutex also serialises all modifications
+   * of one client.
+   */
+  struct KeyStripe {
+    Mutex mutex;
+    std::unordered_map<uint64_t, unsigned> shards;
+  };
+
+  static constexpr std::size_t N_KEY_STRIPES = 64;
+  std::array<KeyStripe, N_KEY_STRIPES> key_stripes;
+
+  /**
+   * The public id assigned to the next new #CloudClient.
+   */
+  std::atomic<unsigned> next_id{1};
+
+  /**
+   * If set, then all modifications which need to survive a restart
+   * are recorded here.
+   */
+  CloudJournal *journal = nullptr;
+
+public:
+  explicit CloudShardedData(unsigned n_shards);
+  ~CloudShardedData() noexcept;
+
+  unsigned size() const noexcept {
+    return shards.size();
+  }
+
+  /**
+   * Start (or stop) recording modifications in the given journal.
+   * Must be called before the worker threads are started.
+   */
+  void SetJournal(CloudJournal *_journal) noexcept {
+    journal = _journal;
+  }
+
+  /**
+   * Copies of the #CloudClient attributes which are needed after the
+   * shard has been unlocked.
+   */
+  struct ClientInfo {
+    unsigned id;
+    GeoPoint location;
+    int altitude;
+  };
+
+  /**
+   * Create a new #CloudClient, or refresh the existing one (and move
+   * it to another shard if necessary).
+   */
+  ClientInfo MakeClient(SocketAddress address, uint64_t key,
+                        const GeoPoint &location, int altitude) {
+    return MakeClient(address, key, 0, location, altitude,
+                      std::chrono::steady_clock::now(), journal);
+  }
+
+  /**
+   * Like MakeClient(), but with the public id and the time stamp
+   * from a #CloudJournal record.  This modification is not
+   * journaled.
+   */
+  void RestoreClient(SocketAddress address, uint64_t key, unsigned id,
+                     const GeoPoint &location, int altitude,
+                     std::chrono::steady_clock::time_point stamp) {
+    MakeClient(address, key, id, location, altitude, stamp, nullptr);
+  }
+
+  /**
+   * Refresh the address and time stamp of an existing client.
+   */
+  std::optional<ClientInfo> RefreshClient(uint64_t key,
+                                          SocketAddress address);
+
+  /**
+   * Look up a client by its secret key and invoke f(client) while the
+   * owning shard is locked.  The function must not modify the
+   * client's location.
+   *
+   * @return false if no such client exists
+   */
+  template<typename F>
+  bool WithClient(uint64_t key, F &&f) {
+    auto &stripe = GetKeyStripe(key);
+    const std::scoped_lock stripe_lock{stripe.mutex};
+
+    auto i = stripe.shards.find(key);
+    if (i == stripe.shards.end())
+      return false;
+
+    auto &shard = *shards[i->second];
+    const std::scoped_lock lock{shard.mutex};
+    auto *client = shard.data.clients.Find(key);
+    if (client == nullptr)
+      return false;
+
+    f(*client);
+    return true;
+  }
+
+  /**
+   * Invoke f(client) for each #CloudClient within the given range.
+   * Each shard is locked while its clients are being visited, so the
+   * function must not call other methods of this class.
+   */
+  template<typename F>
+  void VisitClientsWithinRange(GeoPoint location, double range,
+                               F &&f) const {
+    const auto mask = GetShardsWithinRange(location, range);
+    for (unsigned i = 0; i < shards.size(); ++i) {
+      if ((mask & (uint64_t(1) << i)) == 0)
+        continue;
+
+      const auto &shard = *shards[i];
+      const std::scoped_lock lock{shard.mutex};
+      for (const auto &client : shard.data.clients.QueryWithinRange(location,
+                                                                    range))
+        f(*client);
+    }
+  }
+
+  SkyLinesTracking::Thermal MakeThermal(uint64_t client_key,
+                                        const AGeoPoint &bottom_location,
+                                        const AGeoPoint &top_location,
+                                        double lift);
+
+  /**
+   * Like MakeThermal(), but with the time stamp from a #CloudJournal
+   * record.  This modification is not journaled.
+   */
+  void RestoreThermal(uint64_t client_key,
+                      const AGeoPoint &bottom_location,
+                      const AGeoPoint &top_location,
+                      double lift,
+                      std::chrono::steady_clock::time_point time);
+
+  /**
+   * Invoke f(thermal) for each #CloudThermal within the given range.
+   */
+  template<typename F>
+  void VisitThermalsWithinRange(GeoPoint location, double range,
+                                F &&f) const {
+    const auto mask = GetShardsWithinRange(location, range);
+    for (unsigned i = 0; i < shards.size(); ++i) {
+      if ((mask & (uint64_t(1) << i)) == 0)
+        continue;
+
+      const auto &shard = *shards[i];
+      const std::scoped_lock lock{shard.mutex};
+      for (const auto &thermal : shard.data.thermals.QueryWithinRange(location,
+                                                                      range))
+        f(*thermal);
+    }
+  }
+
+  /**
+   * Remove all clients which have not submitted data since the given
+   * time stamp.
+   */
+  void ExpireClients(std::chrono::steady_clock::time_point before);
+
+  /**
+   * Write all clients to the given stream.  Each shard is locked
+   * while its clients are being written, so this must not be called
+   * while holding a lock which the worker threads may take inside
+   * VisitClientsWithinRange() (e.g. the access log's); write to a
+   * private buffer instead.
+   */
+  void DumpClients(std::ostream &os) const;
+
+  /**
+   * A consistent copy of all shards, which can be written to a file
+   * without blocking the worker threads.
+   */
+  struct Snapshot {
+    /**
+     * A copy of the #CloudClient attributes which get saved.  Unlike
+     * #CloudClient, this can be copied without allocating memory.
+     */
+    struct Client {
+      StaticSocketAddress address;
+      uint64_t key;
+      unsigned id;
+      std::chrono::steady_clock::time_point stamp;
+      GeoPoint location;
+      int altitude;
+    };
+
+    unsigned next_id;
+    std::vector<Client> clients;
+    std::vector<CloudThermal> thermals;
+
+    /**
+     * The #CloudJournal records which were pending when the
+     * snapshot was taken (see CloudJournal::Cut()).
+     */
+    std::vector<std::byte> journal_records;
+
+    /**
+     * Write this snapshot in the #CloudData file format.
+     *
+     * @param journal_generation the generation of the newest
+     * #CloudJournal file whose records are included
+     */
+    void Save(Serialiser &s, unsigned journal_generation) const;
+  };
+
+  /**
+   * Copy all shards.  All shards are locked while their contents are
+   * being copied, which is much quicker than serialising them.
+   *
+   * @param snapshot the destination; its old contents are discarded,
+   * but its buffers are reused, therefore passing the same object
+   * each time avoids allocating memory while the shards are locked
+   */
+  void TakeSnapshot(Snapshot &snapshot) const;
+
+  /**
+   * Write all shards in the #CloudData file format.  This locks all
+   * shards for the whole duration; TakeSnapshot() is usually the
+   * better choice.
+   */
+  void Save(Serialiser &s) const;
+
+  /**
+   * Load a file written by Save() or CloudData::Save() and
+   * distribute its contents to the shards.
+   *
+   * @return the generation of the newest #CloudJournal file which is
+   * included in the file (0 if the file does not have a journal)
+   */
+  unsigned Load(Deserialiser &s);
+
+private:
+  KeyStripe &GetKeyStripe(uint64_t key) noexcept {
+    return key_stripes[key % N_KEY_STRIPES];
+  }
+
+  /**
+   * Convert a longitude to a (not yet wrapped) column index.
+   */
+  [[gnu::const]]
+  static int ToCell(Angle longitude) noexcept;
+
+  [[gnu::pure]]
+  unsigned GetShardIndex(GeoPoint location) const noexcept;
+
+  /**
+   * Determine the shards owning at least one longitude column which
+   * intersects the given range.
+   *
+   * @return a bit mask of shard indices
+   */
+  [[gnu::pure]]
+  uint64_t GetShardsWithinRange(GeoPoint location,
+                                double range) const noexcept;
+
+  /**
+   * @param id the public id of a new client; 0 allocates a new one
+   * @param _journal where to record this modification (or nullptr)
+   */
+  ClientInfo MakeClient(SocketAddress address, uint64_t key, unsigned id,
+                        const GeoPoint &location, int altitude,
+                        std::chrono::steady_clock::time_point stamp,
+                        CloudJournal *_journal);
+};
@@ -47,6 +47,22 @@ CloudThermalContainer::Insert(CloudThermal &thermal)
   rtree.insert(thermal.shared_from_this());
 }
 
+void
+CloudThermalContainer::InsertMany(std::span<const CloudThermalPtr> thermals)
+{
+  if (!rtree.empty()) {
+    for (const auto &thermal : thermals)
+      Insert(*thermal);
+    return;
+  }
+
+  for (const auto &thermal : thermals)
+    list.push_front(*thermal);
+
+  /* the packing algorithm is used by this constructor */
+  rtree = Tree(thermals.begin(), thermals.end());
+}
+
 void
 CloudThermalContainer::Remove(CloudThermal &thermal)
 {
@@ -10,6 +10,7 @@
 #include <boost/range/iterator_range_core.hpp>
 #include <memory>
 #include <chrono>
+#include <span>
 
 class Serialiser;
 class Deserialiser;
@@ -115,6 +116,12 @@ public:
 
   void Insert(CloudThermal &client);
 
+  /**
+   * Insert many thermals at once (see
+   * CloudClientContainer::InsertMany()).
+   */
+  void InsertMany(std::span<const CloudThermalPtr> thermals);
+
   /**
    * Remove a #CloudThermal and its data.  Be careful - the given reference
    * is invalidated, unless the caller holds another #CloudThermalPtr.
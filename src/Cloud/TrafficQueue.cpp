@@ -0,0 +1,41 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "TrafficQueue.hpp"
+#include "Sender.hpp"
+
+#include <algorithm>
+
+void
+TrafficPushQueue::Add(SocketAddress address, uint64_t key,
+                      uint32_t pilot_id, GeoPoint location,
+                      int altitude)
+{
+  auto &d = destinations[key];
+  d.address = address;
+
+  auto i = std::find_if(d.traffic.begin(), d.traffic.end(),
+                        [pilot_id](const Traffic &t){
+                          return t.pilot_id == pilot_id;
+                        });
+  if (i != d.traffic.end()) {
+    /* replace the obsolete location which was not yet sent */
+    i->location = location;
+    i->altitude = altitude;
+  } else
+    d.traffic.push_back({pilot_id, location, altitude});
+}
+
+void
+TrafficPushQueue::Flush(SkyLinesTracking::Server &server)
+{
+  for (const auto &[key, d] : destinations) {
+    TrafficResponseSender s(server, d.address, key);
+    for (const auto &t : d.traffic)
+      s.Add(t.pilot_id, 0, //TODO: time?
+            t.location, t.altitude);
+    s.Flush();
+  }
+
+  destinations.clear();
+}
@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Geo/GeoPoint.hpp"
+#include "net/StaticSocketAddress.hxx"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace SkyLinesTracking { class Server; }
+
+/**
+ * Collects traffic updates which shall be pushed to interested
+ * clients.  All updates for one destination are coalesced into as
+ * few datagrams as possible, and only the most recent location of
+ * each pilot is kept.
+ */
+class TrafficPushQueue {
+  struct Traffic {
+    uint32_t pilot_id;
+    GeoPoint location;
+    int altitude;
+  };
+
+  struct Destination {
+    StaticSocketAddress address;
+    std::vector<Traffic> traffic;
+  };
+
+  /**
+   * Pending updates, indexed by the destination client's key.
+   */
+  std::unordered_map<uint64_t, Destination> destinations;
+
+public:
+  bool empty() const noexcept {
+    return destinations.empty();
+  }
+
+  void Add(SocketAddress address, uint64_t key,
+           uint32_t pilot_id, GeoPoint location, int altitude);
+
+  /**
+   * Submit all pending updates to the server's send queue and clear
+   * this object.
+   */
+  void Flush(SkyLinesTracking::Server &server);
+};
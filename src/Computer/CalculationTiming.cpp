@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "CalculationTiming.hpp"
+#include "LogFile.hpp"
+
+#include <stdio.h>
+
+static constexpr const char *stage_names[] = {
+  "air data",
+  "task",
+  "route",
+  "vertical",
+  "cu sonde",
+  "monitors",
+  "logging",
+  "contest",
+  "task idle",
+  "warnings",
+  "idle monitors",
+};
+
+static_assert(std::size(stage_names) == unsigned(CalculationStage::COUNT));
+
+const char *
+ToString(CalculationStage stage) noexcept
+{
+  return stage_names[unsigned(stage)];
+}
+
+static constexpr double
+ToMilliseconds(LatencyHistogram::Duration d) noexcept
+{
+  return d.count() / 1000.;
+}
+
+void
+FormatLatencySummary(char *buffer, std::size_t size,
+                     const LatencyHistogram &histogram) noexcept
+{
+  snprintf(buffer, size, "n=%u mean=%.2f p50=%.2f p99=%.2f max=%.2f ms",
+           histogram.GetCount(),
+           ToMilliseconds(histogram.GetMean()),
+           ToMilliseconds(histogram.GetQuantile(0.5)),
+           ToMilliseconds(histogram.GetQuantile(0.99)),
+           ToMilliseconds(histogram.GetMax()));
+}
+
+static void
+LogHistogram(const char *name, const LatencyHistogram &histogram) noexcept
+{
+  char buffer[128];
+  FormatLatencySummary(buffer, sizeof(buffer), histogram);
+  LogFormat("Timing %s: %s", name, buffer);
+}
+
+void
+LogCalculationTiming(const CalculationTiming &timing) noexcept
+{
+  LogHistogram("latency", timing.latency);
+  LogHistogram("gps", timing.gps);
+  LogHistogram("idle", timing.idle);
+
+  for (unsigned i = 0; i < unsigned(CalculationStage::COUNT); ++i)
+    LogHistogram(stage_names[i], timing.stages[i]);
+}
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "time/LatencyHistogram.hpp"
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * The computers called by GlideComputer::ProcessGPS() and
+ * GlideComputer::ProcessIdle() whose run time is measured.
+ */
+enum class CalculationStage : uint8_t {
+  AIR_DATA,
+  TASK,
+  ROUTE,
+  VERTICAL,
+  CU_SONDE,
+  MONITORS,
+  LOGGING,
+  CONTEST,
+  TASK_IDLE,
+  WARNINGS,
+  IDLE_MONITORS,
+
+  COUNT
+};
+
+[[gnu::const]]
+const char *
+ToString(CalculationStage stage) noexcept;
+
+/**
+ * Run time histograms of the #CalculationThread.
+ */
+struct CalculationTiming {
+  std::array<LatencyHistogram, unsigned(CalculationStage::COUNT)> stages;
+
+  /**
+   * The duration of GlideComputer::ProcessGPS().
+   */
+  LatencyHistogram gps;
+
+  /**
+   * The duration of GlideComputer::ProcessIdle().
+   */
+  LatencyHistogram idle;
+
+  /**
+   * The time from the arrival of a GPS fix in the #DeviceBlackboard
+   * (the std::chrono::steady_clock time recorded by
+   * DeviceBlackboard::Merge(), see DeviceBlackboard::GetFixArrival())
+   * until the calculated results are handed to the user interface.
+   */
+  LatencyHistogram latency;
+
+  constexpr void Clear() noexcept {
+    for (auto &i : stages)
+      i.Clear();
+    gps.Clear();
+    idle.Clear();
+    latency.Clear();
+  }
+
+  constexpr LatencyHistogram &operator[](CalculationStage stage) noexcept {
+    return stages[unsigned(stage)];
+  }
+
+  constexpr const LatencyHistogram &operator[](CalculationStage stage) const noexcept {
+    return stages[unsigned(stage)];
+  }
+};
+
+static_assert(std::is_trivial_v<CalculationTiming>);
+
+/**
+ * Format a one-line summary of the histogram: number of samples,
+ * mean, median, 99th percentile and maximum in milliseconds.
+ */
+void
+FormatLatencySummary(char *buffer, std::size_t size,
+                     const LatencyHistogram &histogram) noexcept;
+
+/**
+ * Write all histograms to the log file.
+ */
+void
+LogCalculationTiming(const CalculationTiming &timing) noexcept;
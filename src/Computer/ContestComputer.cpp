@@ -2,44 +2,164 @@
 // Copyright The XCSoar Project
 
 #include "ContestComputer.hpp"
-#include "Engine/Contest/Settings.hpp"
+#include "FullTrace.hpp"
 
-ContestComputer::ContestComputer(const Trace &trace_full,
-                                 const Trace &trace_triangle,
-                                 const Trace &trace_sprint)
-  :contest_manager(Contest::OLC_SPRINT, trace_full, trace_triangle, trace_sprint, true)
+#include <utility>
+
+using namespace std::chrono;
+
+static constexpr unsigned contest_trace_size = 256;
+static constexpr unsigned sprint_trace_size = 128;
+
+/**
+ * The wall-clock time of one search slice in the worker thread.  New
+ * trace points and settings are picked up and the result is
+ * published after each slice.
+ */
+static constexpr auto SLICE_BUDGET = milliseconds(100);
+
+ContestComputer::ContestComputer()
+  :StandbyThread("Contest"),
+   full(FullTrace::NO_THIN_TIME, Trace::null_time, FullTrace::SIZE),
+   triangle({}, Trace::null_time, contest_trace_size),
+   sprint({}, minutes{120}, sprint_trace_size),
+   contest_manager(Contest::OLC_SPRINT, full, triangle, sprint, true)
 {
+  settings.SetDefaults();
   contest_manager.SetIncremental(true);
 }
 
+ContestComputer::~ContestComputer() noexcept
+{
+  LockStop();
+}
+
+void
+ContestComputer::SetIncremental(bool _incremental)
+{
+  const std::lock_guard lock{mutex};
+  incremental = _incremental;
+}
+
+void
+ContestComputer::Reset()
+{
+  const std::lock_guard lock{mutex};
+  new_full_points.clear();
+  new_contest_points.clear();
+  reset = true;
+  result.Reset();
+  result.progress.Reset();
+}
+
+void
+ContestComputer::Append(const TracePoint &point, bool contest_enabled)
+{
+  const std::lock_guard lock{mutex};
+  new_full_points.push_back(point);
+  if (contest_enabled)
+    new_contest_points.push_back(point);
+}
+
 void
-ContestComputer::Solve(const ContestSettings &settings,
+ContestComputer::SetPredicted(const TracePoint &_predicted)
+{
+  const std::lock_guard lock{mutex};
+  predicted = _predicted;
+}
+
+void
+ContestComputer::Solve(const ContestSettings &_settings,
                        ContestStatistics &contest_stats)
 {
-  if (!settings.enable)
+  if (!_settings.enable)
     return;
 
-  contest_manager.SetHandicap(settings.handicap);
-  contest_manager.SetContest(settings.contest);
+  const std::lock_guard lock{mutex};
+  settings = _settings;
 
-  contest_manager.UpdateIdle();
+  if (!IsBusy())
+    Trigger();
 
-  contest_stats = contest_manager.GetStats();
+  contest_stats = result;
 }
 
 bool
-ContestComputer::SolveExhaustive(const ContestSettings &settings,
+ContestComputer::SolveExhaustive(const ContestSettings &_settings,
                                  ContestStatistics &contest_stats)
 {
-  if (!settings.enable)
+  if (!_settings.enable)
     return false;
 
-  contest_manager.SetHandicap(settings.handicap);
-  contest_manager.SetContest(settings.contest);
+  std::unique_lock lock{mutex};
+  settings = _settings;
+  exhaustive = true;
+  Trigger();
+  WaitDone(lock);
+
+  contest_stats = result;
+  return exhaustive_result;
+}
+
+void
+ContestComputer::Tick() noexcept
+{
+  SetLowPriority();
+
+  while (!IsStopped()) {
+    /* copy the input while the mutex is locked */
+    const bool _reset = std::exchange(reset, false);
+    const bool _exhaustive = std::exchange(exhaustive, false);
+    const ContestSettings _settings = settings;
+    const TracePoint _predicted = predicted;
+    const bool _incremental = incremental;
+    full_points.swap(new_full_points);
+    contest_points.swap(new_contest_points);
+
+    bool improved;
+
+    {
+      const ScopeUnlock unlock(mutex);
+
+      if (_reset) {
+        full.clear();
+        triangle.clear();
+        sprint.clear();
+        contest_manager.Reset();
+      }
+
+      for (const auto &point : full_points)
+        full.push_back(point);
+
+      for (const auto &point : contest_points) {
+        triangle.push_back(point);
+        sprint.push_back(point);
+      }
+
+      full_points.clear();
+      contest_points.clear();
+
+      contest_manager.SetIncremental(_incremental);
+      contest_manager.SetHandicap(_settings.handicap);
+      contest_manager.SetContest(_settings.contest);
+      contest_manager.SetPredicted(_predicted);
+
+      improved = _exhaustive
+        ? contest_manager.SolveExhaustive()
+        : contest_manager.UpdateIdle(SLICE_BUDGET);
+    }
 
-  bool result = contest_manager.SolveExhaustive();
+    /* the result is obsolete if Reset() was called meanwhile */
+    if (!reset)
+      result = contest_manager.GetStats();
 
-  contest_stats = contest_manager.GetStats();
+    if (_exhaustive)
+      exhaustive_result = improved;
 
-  return result;
+    /* keep going while the search is not finished or new input has
+       arrived; otherwise wait for the next Trigger() call */
+    if (!contest_manager.IsRunning() && !reset && !exhaustive &&
+        new_full_points.empty() && new_contest_points.empty())
+      break;
+  }
 }
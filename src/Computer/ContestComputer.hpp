@@ -3,38 +3,111 @@
 
 #pragma once
 
+#include "thread/StandbyThread.hpp"
 #include "Engine/Contest/ContestManager.hpp"
+#include "Engine/Contest/Settings.hpp"
+#include "Engine/Trace/Trace.hpp"
+#include "Engine/Trace/Vector.hpp"
 
-struct ContestSettings;
-struct ContestStatistics;
-class Trace;
+/**
+ * Runs the contest optimisation in a low-priority worker thread, so
+ * a long search does not delay the #CalculationThread.
+ *
+ * The worker has its own copies of the traces: the calculation
+ * thread only queues new points with Append(), and the worker feeds
+ * them into its traces before each search slice.  The best result is
+ * published back to the caller in Solve().
+ *
+ * All public methods must be called from the same thread (the
+ * #CalculationThread).
+ */
+class ContestComputer final : private StandbyThread {
+  /* the following attributes are owned by the worker thread */
+
+  Trace full, triangle, sprint;
 
-class ContestComputer {
   ContestManager contest_manager;
 
+  /**
+   * Points moved from #new_full_points and #new_contest_points, kept
+   * here to reuse their allocations.
+   */
+  TracePointVector full_points, contest_points;
+
+  /* the following attributes are protected by StandbyThread::mutex */
+
+  /**
+   * Points which were added by Append() and have not yet been
+   * consumed by the worker thread.
+   */
+  TracePointVector new_full_points, new_contest_points;
+
+  ContestSettings settings;
+
+  TracePoint predicted = TracePoint::Invalid();
+
+  bool incremental = true;
+
+  /**
+   * Shall the worker clear its traces and the solvers?  Set by
+   * Reset().
+   */
+  bool reset = false;
+
+  /**
+   * Shall the worker run an exhaustive search?  Set by
+   * SolveExhaustive().
+   */
+  bool exhaustive = false;
+
+  /**
+   * The return value of the last exhaustive search.
+   */
+  bool exhaustive_result = false;
+
+  /**
+   * The latest result published by the worker thread.
+   */
+  ContestStatistics result;
+
 public:
-  ContestComputer(const Trace &trace_full,
-                  const Trace &trace_triangle,
-                  const Trace &trace_sprint);
+  ContestComputer();
+  ~ContestComputer() noexcept;
+
+  ContestComputer(const ContestComputer &) = delete;
+  ContestComputer &operator=(const ContestComputer &) = delete;
 
-  void SetIncremental(bool incremental) {
-    contest_manager.SetIncremental(incremental);
-  }
+  void SetIncremental(bool incremental);
 
-  void Reset() {
-    contest_manager.Reset();
-  }
+  void Reset();
+
+  /**
+   * Queue a point which was appended to the full trace.
+   *
+   * @param contest_enabled true if contest optimisation is enabled;
+   * only then the point is added to the triangle and sprint traces
+   */
+  void Append(const TracePoint &point, bool contest_enabled);
 
   /**
    * @see ContestDijkstra::SetPredicted()
    */
-  void SetPredicted(const TracePoint &predicted) {
-    contest_manager.SetPredicted(predicted);
-  }
+  void SetPredicted(const TracePoint &predicted);
 
+  /**
+   * Wake up the worker thread (unless it is already busy) and copy
+   * the best result found so far.
+   */
   void Solve(const ContestSettings &settings_computer,
              ContestStatistics &contest_stats);
 
+  /**
+   * Run an exhaustive search and wait for it to finish.
+   */
   bool SolveExhaustive(const ContestSettings &settings_computer,
                        ContestStatistics &contest_stats);
+
+private:
+  /* virtual methods from class StandbyThread */
+  void Tick() noexcept override;
 };
@@ -0,0 +1,26 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <chrono>
+
+/**
+ * The configuration of the full trace of the flight.  #TraceComputer
+ * and #ContestComputer must use the same one: the latter replays the
+ * points of the former into its own trace and relies on getting the
+ * same thinning.
+ */
+namespace FullTrace {
+
+/**
+ * The maximum number of points.
+ */
+inline constexpr unsigned SIZE = 1024;
+
+/**
+ * Points younger than this are never thinned.
+ */
+inline constexpr std::chrono::minutes NO_THIN_TIME{2};
+
+} // namespace FullTrace
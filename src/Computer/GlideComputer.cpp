@@ -24,6 +24,7 @@ GlideComputer::GlideComputer(const ComputerSettings &_settings,
    retrospective(_way_points),
    team_code_ref_id(-1)
 {
+  timing.Clear();
   ReadComputerSettings(_settings);
   events.SetComputer(*this);
   idle_clock.Update();
@@ -54,6 +55,8 @@ GlideComputer::Initialise()
 bool
 GlideComputer::ProcessGPS(bool force)
 {
+  const LatencyHistogram::ScopeTimer total_timer(timing.gps);
+
   const MoreData &basic = Basic();
   DerivedInfo &calculated = SetCalculated();
   const ComputerSettings &settings = GetComputerSettings();
@@ -78,20 +81,29 @@ GlideComputer::ProcessGPS(bool force)
   calculated.Expire(basic.clock);
 
   // Process basic information
-  air_data_computer.ProcessBasic(Basic(), SetCalculated(),
-                                 settings);
+  {
+    const LatencyHistogram::ScopeTimer timer(timing[CalculationStage::AIR_DATA]);
+    air_data_computer.ProcessBasic(Basic(), SetCalculated(),
+                                   settings);
+  }
 
   // Process basic task information
   const bool last_finished = calculated.ordered_task_stats.task_finished;
 
-  task_computer.ProcessBasicTask(basic,
-                                 calculated,
-                                 settings,
-                                 force);
+  {
+    const LatencyHistogram::ScopeTimer timer(timing[CalculationStage::TASK]);
+    task_computer.ProcessBasicTask(basic,
+                                   calculated,
+                                   settings,
+                                   force);
+  }
 
   CalculateWorkingBand();
 
-  task_computer.ProcessMoreTask(basic, calculated, settings);
+  {
+    const LatencyHistogram::ScopeTimer timer(timing[CalculationStage::ROUTE]);
+    task_computer.ProcessMoreTask(basic, calculated, settings);
+  }
 
   if (!last_finished && calculated.ordered_task_stats.task_finished)
     OnFinishTask();
@@ -108,13 +120,19 @@ GlideComputer::ProcessGPS(bool force)
                                 const_cast<Waypoints &>(waypoints));
 
   // Process extended information
-  air_data_computer.ProcessVertical(Basic(),
-                                    SetCalculated(),
-                                    settings);
+  {
+    const LatencyHistogram::ScopeTimer timer(timing[CalculationStage::VERTICAL]);
+    air_data_computer.ProcessVertical(Basic(),
+                                      SetCalculated(),
+                                      settings);
 
-  stats_computer.ProcessClimbEvents(calculated);
+    stats_computer.ProcessClimbEvents(calculated);
+  }
 
-  cu_computer.Compute(basic, calculated, settings);
+  {
+    const LatencyHistogram::ScopeTimer timer(timing[CalculationStage::CU_SONDE]);
+    cu_computer.Compute(basic, calculated, settings);
+  }
 
   // Calculate the team code
   CalculateOwnTeamCode();
@@ -136,7 +154,10 @@ GlideComputer::ProcessGPS(bool force)
   CalculateVarioScale();
 
   // Update the ConditionMonitors
-  condition_monitors.Update(Basic(), Calculated(), settings);
+  {
+    const LatencyHistogram::ScopeTimer timer(timing[CalculationStage::MONITORS]);
+    condition_monitors.Update(Basic(), Calculated(), settings);
+  }
 
   return idle_clock.CheckUpdate(milliseconds(500));
 }
@@ -144,21 +165,40 @@ GlideComputer::ProcessGPS(bool force)
 void
 GlideComputer::ProcessIdle(bool exhaustive)
 {
+  const LatencyHistogram::ScopeTimer total_timer(timing.idle);
+
   const MoreData &basic = Basic();
   DerivedInfo &calculated = SetCalculated();
 
   // Log GPS fixes for internal usage
   // (snail trail, stats, contest, ...)
-  stats_computer.DoLogging(basic, calculated);
-  log_computer.Run(basic, calculated, GetComputerSettings().logger);
+  {
+    const LatencyHistogram::ScopeTimer timer(timing[CalculationStage::LOGGING]);
+    stats_computer.DoLogging(basic, calculated);
+    log_computer.Run(basic, calculated, GetComputerSettings().logger);
+  }
 
-  task_computer.ProcessIdle(basic, calculated, GetComputerSettings(),
-                            exhaustive);
+  {
+    const LatencyHistogram::ScopeTimer timer(timing[CalculationStage::CONTEST]);
+    task_computer.ProcessContest(basic, calculated, GetComputerSettings(),
+                                 exhaustive);
+  }
 
-  warning_computer.Update(GetComputerSettings(), basic,
-                          calculated, calculated.airspace_warnings);
+  {
+    const LatencyHistogram::ScopeTimer timer(timing[CalculationStage::TASK_IDLE]);
+    task_computer.ProcessIdle(basic, calculated);
+  }
 
-  idle_condition_monitors.Update(basic, calculated, GetComputerSettings());
+  {
+    const LatencyHistogram::ScopeTimer timer(timing[CalculationStage::WARNINGS]);
+    warning_computer.Update(GetComputerSettings(), basic,
+                            calculated, calculated.airspace_warnings);
+  }
+
+  {
+    const LatencyHistogram::ScopeTimer timer(timing[CalculationStage::IDLE_MONITORS]);
+    idle_condition_monitors.Update(basic, calculated, GetComputerSettings());
+  }
 
   // Calculate summary of flight
   if (basic.location_available)
@@ -12,6 +12,7 @@
 #include "LogComputer.hpp"
 #include "WarningComputer.hpp"
 #include "CuComputer.hpp"
+#include "CalculationTiming.hpp"
 #include "Engine/Contest/Solvers/Retrospective.hpp"
 #include "ConditionMonitor/ConditionMonitors.hpp"
 #include "ConditionMonitor/MoreConditionMonitors.hpp"
@@ -46,6 +47,8 @@ class GlideComputer : public GlideComputerBlackboard
 
   PeriodClock idle_clock;
 
+  CalculationTiming timing;
+
   /**
    * This object is used to check whether to update
    * DerivedInfo::trace_history.
@@ -133,6 +136,18 @@ public:
     task_computer.ClearAirspaces();
   }
 
+  /**
+   * Returns the run time histograms.  This object may be used only
+   * inside the #CalculationThread.
+   */
+  const CalculationTiming &GetTiming() const {
+    return timing;
+  }
+
+  CalculationTiming &SetTiming() {
+    return timing;
+  }
+
   const FlightStatistics &GetFlightStats() const {
     return stats_computer.GetFlightStats();
   }
@@ -10,6 +10,7 @@
 #include "NMEA/Validity.hpp"
 
 struct NMEAInfo;
+struct ComputerSettings;
 class ProtectedTaskManager;
 class ProtectedAirspaceWarningManager;
 class Waypoints;
@@ -52,16 +53,6 @@ public:
     return trace;
   }
 
-  void LockedCopyTraceTo(TracePointVector &v) const {
-    trace.LockedCopyTo(v);
-  }
-
-  void LockedCopyTraceTo(TracePointVector &v,
-                         std::chrono::duration<unsigned> min_time,
-                         const GeoPoint &location, double resolution) const {
-    trace.LockedCopyTo(v, min_time, location, resolution);
-  }
-
   void ProcessBasicTask(const MoreData &basic,
                         DerivedInfo &calculated,
                         const ComputerSettings &settings_computer,
@@ -83,7 +74,13 @@ public:
   void ProcessAutoTask(const NMEAInfo &basic, const DerivedInfo &calculated,
                        Waypoints &waypoints);
 
-  void ProcessIdle(const MoreData &basic, DerivedInfo &calculated,
-                   const ComputerSettings &settings_computer,
-                   bool exhaustive=false);
+  /**
+   * Pass the current state to the contest optimisation and copy its
+   * latest result.
+   */
+  void ProcessContest(const MoreData &basic, DerivedInfo &calculated,
+                      const ComputerSettings &settings_computer,
+                      bool exhaustive=false);
+
+  void ProcessIdle(const MoreData &basic, const DerivedInfo &calculated);
 };
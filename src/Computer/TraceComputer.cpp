@@ -2,73 +2,56 @@
 // Copyright The XCSoar Project
 
 #include "TraceComputer.hpp"
-#include "Settings.hpp"
+#include "FullTrace.hpp"
 #include "NMEA/MoreData.hpp"
 #include "NMEA/Derived.hpp"
 
-static constexpr unsigned full_trace_size = 1024;
-static constexpr unsigned contest_trace_size = 256;
-static constexpr unsigned sprint_trace_size = 128;
-
-static constexpr auto full_trace_no_thin_time = std::chrono::minutes{2};
-
 TraceComputer::TraceComputer()
- :full(full_trace_no_thin_time, Trace::null_time, full_trace_size),
-  contest({}, Trace::null_time, contest_trace_size),
-  sprint({}, std::chrono::minutes{120}, sprint_trace_size)
+  :full(FullTrace::NO_THIN_TIME, Trace::null_time, FullTrace::SIZE),
+   snapshot(std::make_shared<const TraceSnapshot>())
 {
 }
 
 void
-TraceComputer::Reset()
+TraceComputer::Publish() noexcept
 {
-  {
-    const std::lock_guard lock{mutex};
-    full.clear();
-  }
+  /* only the CalculationThread replaces the snapshot, therefore it
+     may read the pointer without locking */
+  const auto &previous = *snapshot;
+  if (previous.IsCurrent(full))
+    return;
 
-  contest.clear();
-  sprint.clear();
-}
+  /* build the new snapshot outside of the critical section, and
+     release the old one after leaving it */
+  std::shared_ptr<const TraceSnapshot> next =
+    std::make_shared<const TraceSnapshot>(previous, full);
 
-void
-TraceComputer::LockedCopyTo(TracePointVector &v) const
-{
-  const std::lock_guard lock{mutex};
-  full.GetPoints(v);
+  {
+    const std::scoped_lock lock{snapshot_mutex};
+    snapshot.swap(next);
+  }
 }
 
 void
-TraceComputer::LockedCopyTo(TracePointVector &v,
-                            std::chrono::duration<unsigned> min_time,
-                            const GeoPoint &location,
-                            double resolution) const
+TraceComputer::Reset()
 {
-  const std::lock_guard lock{mutex};
-  full.GetPoints(v, min_time, location, resolution);
+  full.clear();
+  Publish();
 }
 
-void
-TraceComputer::Update(const ComputerSettings &settings_computer,
-                      const MoreData &basic, const DerivedInfo &calculated)
+bool
+TraceComputer::Update(const MoreData &basic, const DerivedInfo &calculated)
 {
   /* time warps are handled by the Trace class */
 
   if (!basic.time_available || !basic.location_available ||
       !basic.NavAltitudeAvailable() ||
       !calculated.flight.flying)
-    return;
+    return false;
 
   const TracePoint point(basic);
 
-  {
-    const std::lock_guard lock{mutex};
-    full.push_back(point);
-  }
-
-  // only contest requires trace_sprint
-  if (settings_computer.contest.enable) {
-    sprint.push_back(point);
-    contest.push_back(point);
-  }
+  full.push_back(point);
+  Publish();
+  return true;
 }
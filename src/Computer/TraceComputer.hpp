@@ -3,10 +3,12 @@
 
 #pragma once
 
-#include "thread/Mutex.hxx"
 #include "Engine/Trace/Trace.hpp"
+#include "Engine/Trace/Snapshot.hpp"
+#include "thread/Mutex.hxx"
+
+#include <memory>
 
-struct ComputerSettings;
 struct MoreData;
 struct DerivedInfo;
 
@@ -15,61 +17,59 @@ struct DerivedInfo;
  */
 class TraceComputer {
   /**
-   * This mutex protects trace_full: it must be locked while editing
-   * the trace, and while reading it from a thread other than the
-   * #CalculationThread.
+   * The trace.  It is owned by the #CalculationThread and must not
+   * be accessed by other threads; they use GetSnapshot() instead.
+   */
+  Trace full;
+
+  /**
+   * Protects #snapshot.  It is held only while the pointer is being
+   * copied or replaced, never while a snapshot is being built.
    */
-  mutable Mutex mutex;
+  mutable Mutex snapshot_mutex;
 
-  Trace full, contest, sprint;
+  /**
+   * The most recent snapshot of #full.  The #CalculationThread
+   * replaces it after each modification of the trace; it is never
+   * modified in place, therefore readers may keep a reference as
+   * long as they need.
+   */
+  std::shared_ptr<const TraceSnapshot> snapshot;
 
 public:
   TraceComputer();
 
-  operator Mutex &() const {
-    return const_cast<Mutex &>(mutex);
-  }
-
   /**
-   * Returns a reference to the full trace.  When using this reference
-   * outside of the #CalculationThread, the mutex must be locked.
+   * Returns a reference to the full trace.  This may only be used in
+   * the #CalculationThread.
    */
   const Trace &GetFull() const {
     return full;
   }
 
   /**
-   * Returns an unprotected reference to the contest trace.  This
-   * object may be used only inside the #CalculationThread.
+   * Obtain the most recent immutable snapshot of the trace.  This
+   * method may be called from any thread; it does not copy the
+   * trace, and it locks only while copying the pointer.
    */
-  const Trace &GetContest() const {
-    return contest;
-  }
-
-  /**
-   * Returns an unprotected reference to the sprint trace.  This
-   * object may be used only inside the #CalculationThread.
-   */
-  const Trace &GetSprint() const {
-    return sprint;
+  std::shared_ptr<const TraceSnapshot> GetSnapshot() const noexcept {
+    const std::scoped_lock lock{snapshot_mutex};
+    return snapshot;
   }
 
   void Reset();
 
   /**
-   * Extract all trace points.  The trace is locked, and the method
-   * may be called from any thread.
+   * Append the current location to the trace.
+   *
+   * @return true if a point was appended
    */
-  void LockedCopyTo(TracePointVector &v) const;
+  bool Update(const MoreData &basic, const DerivedInfo &calculated);
 
+private:
   /**
-   * Extract some trace points.  The trace is locked, and the method
-   * may be called from any thread.
+   * Replace the snapshot if the trace has been modified since it
+   * was taken.
    */
-  void LockedCopyTo(TracePointVector &v,
-                    std::chrono::duration<unsigned> min_time,
-                    const GeoPoint &location, double resolution) const;
-
-  void Update(const ComputerSettings &settings_computer,
-              const MoreData &basic, const DerivedInfo &calculated);
+  void Publish() noexcept;
 };
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "TimingStatusPanel.hpp"
+#include "Components.hpp"
+#include "BackendComponents.hpp"
+#include "CalculationThread.hpp"
+#include "Interface.hpp"
+#include "Language/Language.hpp"
+
+enum Controls {
+  LATENCY,
+  GPS,
+  IDLE,
+  FIRST_STAGE,
+};
+
+void
+TimingStatusPanel::Refresh() noexcept
+{
+  if (backend_components == nullptr ||
+      backend_components->calculation_thread == nullptr)
+    return;
+
+  const CalculationTiming timing =
+    backend_components->calculation_thread->GetTiming();
+
+  char buffer[128];
+
+  FormatLatencySummary(buffer, sizeof(buffer), timing.latency);
+  SetText(LATENCY, buffer);
+
+  FormatLatencySummary(buffer, sizeof(buffer), timing.gps);
+  SetText(GPS, buffer);
+
+  FormatLatencySummary(buffer, sizeof(buffer), timing.idle);
+  SetText(IDLE, buffer);
+
+  for (unsigned i = 0; i < unsigned(CalculationStage::COUNT); ++i) {
+    FormatLatencySummary(buffer, sizeof(buffer), timing.stages[i]);
+    SetText(FIRST_STAGE + i, buffer);
+  }
+}
+
+void
+TimingStatusPanel::Prepare([[maybe_unused]] ContainerWindow &parent,
+                           [[maybe_unused]] const PixelRect &rc) noexcept
+{
+  AddReadOnly(_("Latency"),
+              _("Time from the arrival of a GPS fix until the results are calculated."));
+  AddReadOnly(_("GPS"));
+  AddReadOnly(_("Idle"));
+
+  for (unsigned i = 0; i < unsigned(CalculationStage::COUNT); ++i)
+    AddReadOnly(ToString(CalculationStage(i)));
+
+  AddButton(_("Reset"), [this](){
+    if (backend_components != nullptr &&
+        backend_components->calculation_thread != nullptr)
+      backend_components->calculation_thread->ResetTiming();
+    Refresh();
+  });
+
+  AddButton(_("Write to log"), [](){
+    if (backend_components != nullptr &&
+        backend_components->calculation_thread != nullptr)
+      LogCalculationTiming(backend_components->calculation_thread->GetTiming());
+  });
+}
+
+void
+TimingStatusPanel::Show(const PixelRect &rc) noexcept
+{
+  Refresh();
+  CommonInterface::GetLiveBlackboard().AddListener(rate_limiter);
+  StatusPanel::Show(rc);
+}
+
+void
+TimingStatusPanel::Hide() noexcept
+{
+  StatusPanel::Hide();
+  CommonInterface::GetLiveBlackboard().RemoveListener(rate_limiter);
+  rate_limiter.Cancel();
+}
+
+void
+TimingStatusPanel::OnGPSUpdate([[maybe_unused]] const MoreData &basic)
+{
+  Refresh();
+}
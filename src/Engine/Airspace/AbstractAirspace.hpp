@@ -246,6 +246,11 @@ public:
     days_of_operation = mask;
   }
 
+  [[gnu::pure]]
+  AirspaceActivity GetDays() const noexcept {
+    return days_of_operation;
+  }
+
   /**
    * Get asclass of airspace
    *
@@ -413,7 +418,7 @@ public:
 
 protected:
   /** Project border */
-  void Project(const FlatProjection &tp) noexcept;
+  virtual void Project(const FlatProjection &tp) noexcept;
 
 private:
   /**
@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "AirspaceCandidateCache.hpp"
+#include "Airspaces.hpp"
+#include "AirspaceIntersectionVisitor.hpp"
+#include "AirspacePolygon.hpp"
+#include "Geo/Flat/BoostFlatBoundingBox.hpp"
+
+#include <boost/geometry/algorithms/intersects.hpp>
+#include <boost/geometry/strategies/strategies.hpp>
+#include <boost/geometry/geometries/segment.hpp>
+
+/**
+ * The minimum distance [m] between the query vectors and the border
+ * of a new region.  The aircraft can fly this far before the cache
+ * needs to be rebuilt.
+ */
+static constexpr double REGION_MARGIN = 10000;
+
+/**
+ * Polygons with more points than this get a list of the border edges
+ * within the region, see AirspacePolygon::CollectEdges().
+ */
+static constexpr std::size_t MIN_CLIP_POINTS = 16;
+
+void
+AirspaceCandidateCache::Rebuild(FlatGeoPoint location, FlatGeoPoint end,
+                                unsigned margin) noexcept
+{
+  region = update_box;
+
+  /* extend the region along the direction of flight (assuming the
+     query vector points there), to make it last longer */
+  region.Expand(end + (end - location));
+  region.Grow(margin);
+
+  candidates.clear();
+  edges.clear();
+
+  for (const auto &i : airspaces.QueryIntersecting(region)) {
+    const AbstractAirspace &airspace = i.GetAirspace();
+    const bool clipped = airspace.GetShape() == AbstractAirspace::Shape::POLYGON &&
+      airspace.GetPoints().size() > MIN_CLIP_POINTS;
+
+    const unsigned edges_begin = edges.size();
+    if (clipped)
+      static_cast<const AirspacePolygon &>(airspace).CollectEdges(region,
+                                                                  edges);
+
+    candidates.push_back({i, edges_begin, unsigned(edges.size()), clipped});
+  }
+
+  airspaces_serial = airspaces.GetSerial();
+  valid = true;
+  inside_valid = false;
+  ++n_rebuilds;
+}
+
+void
+AirspaceCandidateCache::Require(const GeoPoint &location,
+                                FlatGeoPoint flat_location,
+                                FlatGeoPoint flat_end) noexcept
+{
+  FlatBoundingBox box(flat_location);
+  box.Expand(flat_end);
+
+  if (update_box_empty) {
+    update_box = box;
+    update_box_empty = false;
+  } else
+    update_box.Merge(box);
+
+  if (valid && airspaces.GetSerial() == airspaces_serial &&
+      region.IsInside(box.GetLowerLeft()) &&
+      region.IsInside(box.GetUpperRight()))
+    return;
+
+  const auto &projection = airspaces.GetProjection();
+  Rebuild(flat_location, flat_end,
+          projection.ProjectRangeInteger(location, REGION_MARGIN));
+}
+
+const std::vector<const Airspace *> &
+AirspaceCandidateCache::QueryInside(const GeoPoint &location) noexcept
+{
+  if (!enabled) {
+    inside.clear();
+    for (const auto &i : airspaces.QueryInside(location))
+      inside.push_back(&i);
+    return inside;
+  }
+
+  const auto flat_location =
+    airspaces.GetProjection().ProjectInteger(location);
+  Require(location, flat_location, flat_location);
+
+  if (inside_valid && location == inside_location)
+    return inside;
+
+  inside.clear();
+  for (const auto &c : candidates) {
+    const Airspace &airspace = c.airspace;
+    if (static_cast<const FlatBoundingBox &>(airspace).IsInside(flat_location) &&
+        airspace.IsInside(location))
+      inside.push_back(&airspace);
+  }
+
+  inside_location = location;
+  inside_valid = true;
+  return inside;
+}
+
+void
+AirspaceCandidateCache::VisitIntersecting(const GeoPoint &location,
+                                          const GeoPoint &end,
+                                          AirspaceIntersectionVisitor &visitor) noexcept
+{
+  if (!enabled) {
+    airspaces.VisitIntersecting(location, end, visitor);
+    return;
+  }
+
+  const auto &projection = airspaces.GetProjection();
+  const boost::geometry::model::segment line{
+    projection.ProjectInteger(location),
+    projection.ProjectInteger(end),
+  };
+
+  Require(location, line.first, line.second);
+
+  const std::span<const unsigned> all_edges{edges};
+
+  for (const auto &c : candidates) {
+    const Airspace &i = c.airspace;
+    if (!boost::geometry::intersects(line,
+                                     static_cast<const FlatBoundingBox &>(i)))
+      continue;
+
+    auto intersections = c.clipped
+      ? static_cast<const AirspacePolygon &>(i.GetAirspace())
+          .Intersects(location, end, projection,
+                      all_edges.subspan(c.edges_begin,
+                                        c.edges_end - c.edges_begin))
+      : i.Intersects(location, end, projection);
+
+    if (visitor.SetIntersections(std::move(intersections)))
+      visitor.Visit(i.GetAirspacePtr());
+  }
+}
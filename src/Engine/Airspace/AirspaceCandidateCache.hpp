@@ -0,0 +1,165 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Airspace.hpp"
+#include "Geo/Flat/FlatBoundingBox.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "util/Serial.hpp"
+
+#include <vector>
+
+class Airspaces;
+class AirspaceIntersectionVisitor;
+
+/**
+ * A cache of the airspaces near the aircraft, used by
+ * #AirspaceWarningManager to avoid querying the #Airspaces R-tree
+ * several times per update.
+ *
+ * The cache covers a rectangular "corridor" around the query
+ * vectors, extended along the direction of flight.  It collects all
+ * airspaces whose bounding box overlaps this region, and it is
+ * rebuilt only when a query leaves the region or when the
+ * #Airspaces object has been modified.  All query vectors of one
+ * update (see BeginUpdate()) are included in the new region, so the
+ * passes of one update cannot rebuild the cache over and over.
+ *
+ * The queries return the same airspaces as the corresponding
+ * #Airspaces methods, but not necessarily in the same order.
+ */
+class AirspaceCandidateCache {
+  const Airspaces &airspaces;
+
+  struct Candidate {
+    Airspace airspace;
+
+    /**
+     * For large polygons: the range of #edges containing the border
+     * edges which overlap #region.  Only these need to be tested
+     * for intersections.
+     */
+    unsigned edges_begin, edges_end;
+
+    bool clipped;
+  };
+
+  /**
+   * The airspaces whose bounding box overlaps #region.
+   */
+  std::vector<Candidate> candidates;
+
+  /**
+   * Indexes of polygon border edges, see Candidate::edges_begin.
+   */
+  std::vector<unsigned> edges;
+
+  /**
+   * The airspaces containing #inside_location.  This is calculated
+   * only once per update, because all passes query the aircraft
+   * location.  The pointers refer to #candidates or (if the cache is
+   * disabled) to the #Airspaces tree.
+   */
+  std::vector<const Airspace *> inside;
+  GeoPoint inside_location;
+
+  /**
+   * The region covered by #candidates (in the projection of
+   * #airspaces).
+   */
+  FlatBoundingBox region;
+
+  /**
+   * The bounding box of all queries since BeginUpdate().
+   */
+  FlatBoundingBox update_box;
+
+  /**
+   * The #Airspaces serial #candidates was built from.
+   */
+  Serial airspaces_serial;
+
+  unsigned n_rebuilds = 0;
+
+  bool enabled = true, valid = false, update_box_empty = true;
+  bool inside_valid = false;
+
+public:
+  explicit AirspaceCandidateCache(const Airspaces &_airspaces) noexcept
+    :airspaces(_airspaces) {}
+
+  AirspaceCandidateCache(const AirspaceCandidateCache &) = delete;
+  AirspaceCandidateCache &operator=(const AirspaceCandidateCache &) = delete;
+
+  /**
+   * Enable or disable the cache.  While it is disabled, all queries
+   * are passed to the #Airspaces object.
+   */
+  void SetEnabled(bool _enabled) noexcept {
+    enabled = _enabled;
+    Invalidate();
+  }
+
+  bool IsEnabled() const noexcept {
+    return enabled;
+  }
+
+  /**
+   * Returns the number of times the cache has been (re)built.
+   */
+  unsigned GetRebuildCount() const noexcept {
+    return n_rebuilds;
+  }
+
+  std::size_t size() const noexcept {
+    return candidates.size();
+  }
+
+  /**
+   * Discard the cached airspaces.
+   */
+  void Invalidate() noexcept {
+    valid = false;
+    inside_valid = false;
+    candidates.clear();
+    edges.clear();
+  }
+
+  /**
+   * Start a new update: all following queries will be collected for
+   * building the next region.
+   */
+  void BeginUpdate() noexcept {
+    update_box_empty = true;
+    inside_valid = false;
+  }
+
+  /**
+   * Like Airspaces::VisitIntersecting() (without "include_inside").
+   */
+  void VisitIntersecting(const GeoPoint &location, const GeoPoint &end,
+                         AirspaceIntersectionVisitor &visitor) noexcept;
+
+  /**
+   * Like Airspaces::QueryInside(), but the result is remembered until
+   * the next BeginUpdate() call.
+   *
+   * @return a list of airspaces which is valid until the next call
+   */
+  const std::vector<const Airspace *> &QueryInside(const GeoPoint &location) noexcept;
+
+private:
+  /**
+   * Make sure that the region contains the given (projected) vector,
+   * and rebuild the cache if it does not.
+   *
+   * @param location the start of the vector (unprojected), used to
+   * calculate the margin
+   */
+  void Require(const GeoPoint &location,
+               FlatGeoPoint flat_location, FlatGeoPoint flat_end) noexcept;
+
+  void Rebuild(FlatGeoPoint location, FlatGeoPoint end,
+               unsigned margin) noexcept;
+};
@@ -4,6 +4,7 @@
 #include "AirspacePolygon.hpp"
 #include "Geo/Flat/FlatProjection.hpp"
 #include "Geo/Flat/FlatRay.hpp"
+#include "Geo/Flat/FlatBoundingBox.hpp"
 #include "AirspaceIntersectSort.hpp"
 #include "AirspaceIntersectionVector.hpp"
 
@@ -52,9 +53,19 @@ AirspacePolygon::GetCenter() const noexcept
   return GeoPoint(Angle::Native(lon), Angle::Native(lat));
 }
 
+void
+AirspacePolygon::Project(const FlatProjection &projection) noexcept
+{
+  AbstractAirspace::Project(projection);
+  slabs.Build(m_border);
+}
+
 bool
 AirspacePolygon::Inside(const GeoPoint &loc) const noexcept
 {
+  if (!slabs.empty())
+    return slabs.IsInside(m_border, loc);
+
   return m_border.IsInside(loc);
 }
 
@@ -62,11 +73,26 @@ AirspaceIntersectionVector
 AirspacePolygon::Intersects(const GeoPoint &start, const GeoPoint &end,
                             const FlatProjection &projection) const noexcept
 {
-  const FlatRay ray(projection.ProjectInteger(start),
-                    projection.ProjectInteger(end));
+  const auto flat_start = projection.ProjectInteger(start);
+  const auto flat_end = projection.ProjectInteger(end);
+  const FlatRay ray(flat_start, flat_end);
 
   AirspaceIntersectSort sorter(start, *this);
 
+  if (!slabs.empty()) {
+    /* only the edges overlapping the ray vertically can intersect
+       it */
+    slabs.VisitEdges(flat_start, flat_end, [&](unsigned i){
+      const FlatRay r_seg(m_border[i].GetFlatLocation(),
+                          m_border[i + 1].GetFlatLocation());
+      auto t = ray.DistinctIntersection(r_seg);
+      if (t >= 0)
+        sorter.add(t, projection.Unproject(ray.Parametric(t)));
+    });
+
+    return sorter.all();
+  }
+
   for (auto it = m_border.begin(); it + 1 != m_border.end(); ++it) {
 
     const FlatRay r_seg(it->GetFlatLocation(), (it + 1)->GetFlatLocation());
@@ -78,6 +104,39 @@ AirspacePolygon::Intersects(const GeoPoint &start, const GeoPoint &end,
   return sorter.all();
 }
 
+void
+AirspacePolygon::CollectEdges(const FlatBoundingBox &box,
+                              std::vector<unsigned> &edges) const noexcept
+{
+  for (unsigned i = 0, n = m_border.size(); i + 1 < n; ++i) {
+    FlatBoundingBox edge(m_border[i].GetFlatLocation());
+    edge.Expand(m_border[i + 1].GetFlatLocation());
+    if (edge.Overlaps(box))
+      edges.push_back(i);
+  }
+}
+
+AirspaceIntersectionVector
+AirspacePolygon::Intersects(const GeoPoint &start, const GeoPoint &end,
+                            const FlatProjection &projection,
+                            std::span<const unsigned> edges) const noexcept
+{
+  const FlatRay ray(projection.ProjectInteger(start),
+                    projection.ProjectInteger(end));
+
+  AirspaceIntersectSort sorter(start, *this);
+
+  for (const unsigned i : edges) {
+    const FlatRay r_seg(m_border[i].GetFlatLocation(),
+                        m_border[i + 1].GetFlatLocation());
+    auto t = ray.DistinctIntersection(r_seg);
+    if (t >= 0)
+      sorter.add(t, projection.Unproject(ray.Parametric(t)));
+  }
+
+  return sorter.all();
+}
+
 GeoPoint
 AirspacePolygon::ClosestPoint(const GeoPoint &loc,
                               const FlatProjection &projection) const noexcept
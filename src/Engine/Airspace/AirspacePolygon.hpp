@@ -4,14 +4,27 @@
 #pragma once
 
 #include "AbstractAirspace.hpp"
+#include "Geo/PolygonSlabIndex.hpp"
+
+#include <span>
 #include <vector>
 
 #ifdef DO_PRINT
 #include <iosfwd>
 #endif
 
+struct FlatBoundingBox;
+
 /** General polygon form airspace */
 class AirspacePolygon final : public AbstractAirspace {
+  /**
+   * Speeds up Inside() and Intersects() on large polygons.  It is
+   * built by Project(), i.e. when the airspace is inserted into the
+   * #Airspaces tree; until then (and for small polygons), all border
+   * edges are scanned.
+   */
+  PolygonSlabIndex slabs;
+
 public:
   /**
    * Constructor.  For testing, pts vector is a cloud of points,
@@ -29,6 +42,7 @@ public:
   void MakeConvex() noexcept {
     m_border.PruneInterior();
     is_convex = TriState::TRUE;
+    slabs.Clear();
   }
 
   /* virtual methods from class AbstractAirspace */
@@ -41,6 +55,30 @@ public:
   GeoPoint ClosestPoint(const GeoPoint &loc,
                         const FlatProjection &projection) const noexcept override;
 
+protected:
+  void Project(const FlatProjection &projection) noexcept override;
+
+public:
+
+  /**
+   * Collect the indices of all border edges whose bounding box
+   * overlaps the given box (in the projection this airspace was
+   * projected with).
+   */
+  void CollectEdges(const FlatBoundingBox &box,
+                    std::vector<unsigned> &edges) const noexcept;
+
+  /**
+   * Like Intersects(), but test only the given border edges (see
+   * CollectEdges()).  The result is the same if the vector lies
+   * within the box the edges were collected with.
+   */
+  [[gnu::pure]]
+  AirspaceIntersectionVector Intersects(const GeoPoint &g1,
+                                        const GeoPoint &end,
+                                        const FlatProjection &projection,
+                                        std::span<const unsigned> edges) const noexcept;
+
 public:
 #ifdef DO_PRINT
   friend std::ostream &operator<<(std::ostream &f,
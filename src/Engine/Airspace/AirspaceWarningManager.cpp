@@ -13,7 +13,7 @@ static constexpr double CRUISE_FILTER_FACT = 0.5;
 
 AirspaceWarningManager::AirspaceWarningManager(const AirspaceWarningConfig &_config,
                                                const Airspaces &_airspaces)
-  :airspaces(_airspaces)
+  :airspaces(_airspaces), candidates(_airspaces)
 {
   /* force filter initialisation in the first SetConfig() call */
   config.warning_time = AirspaceWarningConfig::Duration::max();
@@ -118,6 +118,8 @@ AirspaceWarningManager::Update(const AircraftState& state,
   for (auto &w : warnings)
     w.SaveState();
 
+  candidates.BeginUpdate();
+
   // check from strongest to weakest alerts
   UpdateInside(state, glide_polar);
   UpdateGlide(state, glide_polar);
@@ -285,13 +287,12 @@ AirspaceWarningManager::UpdatePredicted(const AircraftState& state,
                                              warning_state, max_time_limit,
                                              ceiling);
 
-  airspaces.VisitIntersecting(state.location, location_predicted, visitor);
+  candidates.VisitIntersecting(state.location, location_predicted, visitor);
 
   visitor.SetMode(true);
 
-  for (const auto &i : airspaces.QueryInside(state.location)) {
-    visitor.Visit(i.GetAirspacePtr());
-  }
+  for (const Airspace *i : candidates.QueryInside(state.location))
+    visitor.Visit(i->GetAirspacePtr());
 
   return visitor.Found();
 }
@@ -379,8 +380,8 @@ AirspaceWarningManager::UpdateInside(const AircraftState& state,
 
   bool found = false;
 
-  for (const auto &i : airspaces.QueryInside(state.location)) {
-    const auto airspace = i.GetAirspacePtr();
+  for (const Airspace *i : candidates.QueryInside(state.location)) {
+    const auto airspace = i->GetAirspacePtr();
 
     const AltitudeState &altitude = state;
     if (// ignore inactive airspaces
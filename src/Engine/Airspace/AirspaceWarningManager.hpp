@@ -5,6 +5,7 @@
 
 #include "AirspaceWarning.hpp"
 #include "AirspaceWarningConfig.hpp"
+#include "AirspaceCandidateCache.hpp"
 #include "Util/AircraftStateFilter.hpp"
 #include "time/FloatDuration.hxx"
 #include "util/Serial.hpp"
@@ -33,6 +34,11 @@ class AirspaceWarningManager {
 
   const Airspaces &airspaces;
 
+  /**
+   * The airspaces near the aircraft, shared by all update passes.
+   */
+  AirspaceCandidateCache candidates;
+
   FloatDuration prediction_time_glide;
   FloatDuration prediction_time_filter;
 
@@ -72,6 +78,18 @@ public:
 
   void SetConfig(const AirspaceWarningConfig &_config);
 
+  const AirspaceCandidateCache &GetCandidateCache() const noexcept {
+    return candidates;
+  }
+
+  /**
+   * Enable or disable the airspace candidate cache (enabled by
+   * default).  This is only useful for benchmarks.
+   */
+  void SetCandidateCacheEnabled(bool enabled) noexcept {
+    candidates.SetEnabled(enabled);
+  }
+
   /**
    * Returns a serial for the current state.  The serial gets
    * incremented each time the a warning or the list of warnings is
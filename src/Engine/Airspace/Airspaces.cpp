@@ -41,6 +41,16 @@ Airspaces::QueryIntersecting(const GeoPoint &a, const GeoPoint &b) const noexcep
   return {airspace_tree.qbegin(bgi::intersects(line)), airspace_tree.qend()};
 }
 
+Airspaces::const_iterator_range
+Airspaces::QueryIntersecting(const FlatBoundingBox &box) const noexcept
+{
+  if (IsEmpty())
+    // nothing to do
+    return {airspace_tree.qend(), airspace_tree.qend()};
+
+  return {airspace_tree.qbegin(bgi::intersects(box)), airspace_tree.qend()};
+}
+
 void
 Airspaces::VisitIntersecting(const GeoPoint &loc, const GeoPoint &end,
                              bool include_inside,
@@ -83,9 +93,23 @@ Airspaces::Optimise() noexcept
     airspace_tree.clear();
   }
 
-  for (auto &i : tmp_as) {
-    Airspace as(std::move(i), task_projection);
-    airspace_tree.insert(as);
+  if (tmp_as.size() >= airspace_tree.size()) {
+    /* bulk-load ("pack") the whole tree in one pass; this is much
+       faster than inserting the airspaces one by one, and the
+       resulting tree has less overlap between its nodes */
+    std::vector<Airspace> v;
+    v.reserve(airspace_tree.size() + tmp_as.size());
+    v.insert(v.end(), airspace_tree.begin(), airspace_tree.end());
+
+    for (auto &i : tmp_as)
+      v.emplace_back(std::move(i), task_projection);
+
+    airspace_tree = AirspaceTree(v.begin(), v.end());
+  } else {
+    for (auto &i : tmp_as) {
+      Airspace as(std::move(i), task_projection);
+      airspace_tree.insert(as);
+    }
   }
 
   tmp_as.clear();
@@ -124,6 +148,8 @@ Airspaces::Clear() noexcept
 
   // then delete the tree
   airspace_tree.clear();
+
+  ++serial;
 }
 
 unsigned
@@ -139,6 +139,14 @@ public:
   const_iterator_range QueryIntersecting(const GeoPoint &a,
                                          const GeoPoint &b) const noexcept;
 
+  /**
+   * Query airspaces whose bounding box overlaps the given box (in
+   * the projection returned by GetProjection()).  The result is in
+   * no specific order.
+   */
+  [[gnu::pure]]
+  const_iterator_range QueryIntersecting(const FlatBoundingBox &box) const noexcept;
+
   /**
    * Call visitor class on airspaces intersected by vector.
    * Note that the visitor is not instantiated separately for each match
@@ -303,10 +303,129 @@ ContestManager::UpdateIdle(bool exhaustive) noexcept
   return retval;
 }
 
+bool
+ContestManager::UpdateIdle(AbstractContest::Clock::duration budget) noexcept
+{
+  using Clock = AbstractContest::Clock;
+
+  const auto start = Clock::now();
+  const auto deadline = start + budget;
+  const double old_score = stats.GetResult().score;
+
+  SetDeadline(deadline);
+
+  unsigned steps = 0;
+  do {
+    UpdateIdle(false);
+    ++steps;
+  } while (IsRunning() && Clock::now() < deadline);
+
+  SetDeadline(Clock::time_point::max());
+
+  const bool improved = stats.GetResult().score > old_score;
+
+  auto &progress = stats.progress;
+  ++progress.slices;
+  progress.steps += steps;
+  progress.elapsed += Clock::now() - start;
+  if (improved) {
+    ++progress.improvements;
+    progress.last_improvement = progress.slices;
+  }
+  progress.converged = !IsRunning();
+
+  return improved;
+}
+
+void
+ContestManager::SetDeadline(AbstractContest::Clock::time_point deadline) noexcept
+{
+  olc_sprint.SetDeadline(deadline);
+  olc_fai.SetDeadline(deadline);
+  olc_classic.SetDeadline(deadline);
+  olc_league.SetDeadline(deadline);
+  olc_plus.SetDeadline(deadline);
+  dmst_quad.SetDeadline(deadline);
+  dmst_triangle.SetDeadline(deadline);
+  dmst_or.SetDeadline(deadline);
+  dmst_free.SetDeadline(deadline);
+  xcontest_free.SetDeadline(deadline);
+  xcontest_triangle.SetDeadline(deadline);
+  dhv_xc_free.SetDeadline(deadline);
+  dhv_xc_triangle.SetDeadline(deadline);
+  sis_at.SetDeadline(deadline);
+  net_coupe.SetDeadline(deadline);
+  weglide_free.SetDeadline(deadline);
+  weglide_distance.SetDeadline(deadline);
+  weglide_fai.SetDeadline(deadline);
+  weglide_or.SetDeadline(deadline);
+  charron_small.SetDeadline(deadline);
+  charron_large.SetDeadline(deadline);
+}
+
+bool
+ContestManager::IsRunning() const noexcept
+{
+  switch (contest) {
+  case Contest::NONE:
+    break;
+
+  case Contest::OLC_SPRINT:
+    return olc_sprint.IsRunning();
+
+  case Contest::OLC_FAI:
+    return olc_fai.IsRunning();
+
+  case Contest::OLC_CLASSIC:
+    return olc_classic.IsRunning();
+
+  case Contest::OLC_LEAGUE:
+    return olc_classic.IsRunning() || olc_league.IsRunning();
+
+  case Contest::OLC_PLUS:
+    return olc_classic.IsRunning() || olc_fai.IsRunning();
+
+  case Contest::DMST:
+    return dmst_quad.IsRunning() || dmst_triangle.IsRunning() ||
+      dmst_or.IsRunning();
+
+  case Contest::XCONTEST:
+    return xcontest_free.IsRunning() || xcontest_triangle.IsRunning();
+
+  case Contest::DHV_XC:
+    return dhv_xc_free.IsRunning() || dhv_xc_triangle.IsRunning();
+
+  case Contest::SIS_AT:
+    return sis_at.IsRunning();
+
+  case Contest::NET_COUPE:
+    return net_coupe.IsRunning();
+
+  case Contest::WEGLIDE_FREE:
+    return weglide_distance.IsRunning() || weglide_fai.IsRunning() ||
+      weglide_or.IsRunning();
+
+  case Contest::WEGLIDE_DISTANCE:
+    return weglide_distance.IsRunning();
+
+  case Contest::WEGLIDE_FAI:
+    return weglide_fai.IsRunning();
+
+  case Contest::WEGLIDE_OR:
+    return weglide_or.IsRunning();
+
+  case Contest::CHARRON:
+    return charron_large.IsRunning() || charron_small.IsRunning();
+  }
+
+  return false;
+}
+
 void
 ContestManager::Reset() noexcept
 {
   stats.Reset();
+  stats.progress.Reset();
   olc_sprint.Reset();
   olc_fai.Reset();
   olc_classic.Reset();
@@ -103,6 +103,17 @@ public:
    */
   bool UpdateIdle(bool exhaustive = false) noexcept;
 
+  /**
+   * Run the solvers of the selected contest incrementally until they
+   * have finished or until the given wall-clock budget is used up.
+   * A suspended search is resumed by the next call, and the best
+   * result found so far is always available in GetStats(), together
+   * with convergence statistics (ContestStatistics::progress).
+   *
+   * @return true if the best score was improved
+   */
+  bool UpdateIdle(AbstractContest::Clock::duration budget) noexcept;
+
   bool SolveExhaustive() noexcept {
     return UpdateIdle(true);
   }
@@ -132,4 +143,14 @@ public:
   const ContestStatistics &GetStats() const noexcept {
     return stats;
   }
+
+  /**
+   * Is a suspended search pending in one of the solvers of the
+   * selected contest?
+   */
+  [[gnu::pure]]
+  bool IsRunning() const noexcept;
+
+private:
+  void SetDeadline(AbstractContest::Clock::time_point deadline) noexcept;
 };
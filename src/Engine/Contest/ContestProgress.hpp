@@ -0,0 +1,46 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "time/FloatDuration.hxx"
+
+#include <type_traits>
+
+/**
+ * Convergence statistics of the time-budgeted contest optimisation,
+ * see ContestManager::UpdateIdle(Clock::duration).
+ */
+struct ContestProgress
+{
+  /** The number of idle slices in which the solvers have run */
+  unsigned slices;
+
+  /** The number of incremental solver steps in all slices */
+  unsigned steps;
+
+  /** The number of slices which have improved the best score */
+  unsigned improvements;
+
+  /** The number of the slice which has last improved the best score */
+  unsigned last_improvement;
+
+  /** The wall-clock time spent in the solvers */
+  FloatDuration elapsed;
+
+  /**
+   * Have all solvers finished their search in the last slice?  If
+   * yes, the result is optimal for the trace seen so far; if not, the
+   * best result so far is available, and the search continues in the
+   * next slice.
+   */
+  bool converged;
+
+  constexpr void Reset() noexcept {
+    slices = steps = improvements = last_improvement = 0;
+    elapsed = {};
+    converged = false;
+  }
+};
+
+static_assert(std::is_trivial<ContestProgress>::value, "type is not trivial");
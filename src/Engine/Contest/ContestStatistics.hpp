@@ -5,6 +5,7 @@
 
 #include "ContestResult.hpp"
 #include "ContestTrace.hpp"
+#include "ContestProgress.hpp"
 
 #include <array>
 #include <type_traits>
@@ -16,6 +17,12 @@ struct ContestStatistics
   std::array<ContestResult, N> result;
   std::array<ContestTraceVector, N> solution;
 
+  /**
+   * This is not cleared by Reset(), because it describes the solvers,
+   * not the results; see ContestManager::Reset().
+   */
+  ContestProgress progress;
+
   void Reset() noexcept {
     for (auto &i : result)
       i.Reset();
@@ -9,6 +9,7 @@
 #include "PathSolvers/SolverResult.hpp"
 
 #include <cassert>
+#include <chrono>
 
 class TracePoint;
 
@@ -17,11 +18,21 @@ class TracePoint;
  *
  */
 class AbstractContest {
+public:
+  using Clock = std::chrono::steady_clock;
+
+private:
   unsigned handicap;
   const unsigned finish_alt_diff;
   ContestResult best_result;
   ContestTraceVector best_solution;
 
+  /**
+   * Incremental searches suspend when this time is reached, see
+   * SetDeadline().
+   */
+  Clock::time_point deadline = Clock::time_point::max();
+
 public:
   /**
    * Constructor
@@ -36,6 +47,16 @@ public:
     handicap = _handicap;
   }
 
+  /**
+   * Limit the wall-clock time of incremental (non-exhaustive)
+   * Solve() calls: a long search is suspended when the given time is
+   * reached, and resumed by the next Solve() call.  Pass
+   * Clock::time_point::max() to disable the limit.
+   */
+  void SetDeadline(Clock::time_point _deadline) noexcept {
+    deadline = _deadline;
+  }
+
   /**
    * Calculate the scored values of the Contest path
    *
@@ -79,7 +100,21 @@ public:
    */
   virtual SolverResult Solve(bool exhaustive) noexcept = 0;
 
+  /**
+   * Was a search suspended by Solve() which will be resumed by the
+   * next call?
+   */
+  [[gnu::pure]]
+  virtual bool IsRunning() const noexcept {
+    return false;
+  }
+
 protected:
+  [[gnu::pure]]
+  bool IsDeadlineExpired() const noexcept {
+    return deadline != Clock::time_point::max() && Clock::now() >= deadline;
+  }
+
   [[gnu::pure]]
   bool IsFinishAltitudeValid(const TracePoint &start,
                              const TracePoint &finish) const noexcept;
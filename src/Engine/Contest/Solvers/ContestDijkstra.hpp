@@ -167,6 +167,10 @@ public:
   SolverResult Solve(bool exhaustive) noexcept override;
   void Reset() noexcept override;
 
+  bool IsRunning() const noexcept override {
+    return !finished && !dijkstra.IsEmpty();
+  }
+
 protected:
   /* protected virtual methods from AbstractContest */
   ContestResult CalculateResult() const noexcept override;
@@ -5,6 +5,7 @@
 #include "Cast.hpp"
 #include "Trace/Trace.hpp"
 #include "util/QuadTree.hxx"
+#include "util/Compiler.h"
 
 /*
  @todo potential to use 3d convex hull to speed search
@@ -308,7 +309,8 @@ TriangleContest::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d,
 
   // set max_iterations only if non-exhaustive and predictive solving is enabled.
   // otherwise use predefined value.
-  if (!exhaustive && predict)
+  const bool suspendable = !exhaustive && predict;
+  if (suspendable)
     max_iterations = tick_iterations;
 
   while (!branch_and_bound.empty()) {
@@ -323,6 +325,11 @@ TriangleContest::RunBranchAndBound(unsigned from, unsigned to, unsigned worst_d,
     if (iterations > max_iterations || branch_and_bound.size() > max_tree_size)
       break;
 
+    // suspend if the time budget is used up; the tree is kept and the
+    // next call continues with it
+    if (suspendable && iterations % 64 == 0 && IsDeadlineExpired())
+      break;
+
     // first clean up tree, removeing all nodes with d_max < worst_d
     branch_and_bound.erase(branch_and_bound.begin(), branch_and_bound.lower_bound(worst_d));
 
@@ -297,6 +297,10 @@ public:
   void Reset() noexcept override;
   SolverResult Solve(bool exhaustive) noexcept override;
 
+  bool IsRunning() const noexcept override {
+    return running;
+  }
+
 protected:
   /* virtual methods from AbstractContest */
   const ContestTraceVector &GetCurrentPath() const noexcept override;
@@ -278,72 +278,30 @@ GlidePolar::IsGlidePossible(const GlideState &task) const noexcept
 }
 
 /**
- * Finds speed to fly for a given MacCready setting
- * Intended to be used temporarily.
+ * Calculate the speed over ground with the best MacCready-adjusted
+ * glide ratio over ground, i.e. the minimum of
+ *
+ * \f[ f(V) = {{w(V+h) + mc + n}\over{V}} = a.V + (2.a.h+b) + {{k}\over{V}} \f]
+ * with \f$ k = w(h) + mc + n \f$.
  *
- * This finds the speed that maximises the glide angle over the ground
+ * If \f$ k>0 \f$, the minimum is at \f$ \sqrt{k/a} \f$; else f
+ * increases monotonically and the lower bound is the minimum.
  */
-class GlidePolarSpeedToFly final : public ZeroFinder {
-  static constexpr double TOLERANCE_DOLPHIN = 0.0001;
-
-  const GlidePolar &polar;
-  const double m_net_sink_rate;
-  const double m_head_wind;
-
-public:
-  /**
-   * Constructor.
-   *
-   * @param _polar Glide polar to optimise
-   * @param net_sink_rate Instantaneous netto sink rate (m/s), positive down
-   * @param head_wind Head wind component (m/s)
-   * @param vmin Minimum speed to search (m/s)
-   * @param vmax Maximum speed to search (m/s)
-   *
-   * @return Initialised object (no search yet)
-   */
-  GlidePolarSpeedToFly(const GlidePolar &_polar, const double net_sink_rate,
-                       const double head_wind, const double vmin,
-                       const double vmax) :
-    ZeroFinder(std::max(1., vmin - head_wind), vmax - head_wind,
-               TOLERANCE_DOLPHIN),
-    polar(_polar),
-    m_net_sink_rate(net_sink_rate),
-    m_head_wind(head_wind)
-  {
-  }
-
-  /**
-   * Glide ratio over ground function
-   *
-   * @param V Speed over ground (m/s)
-   *
-   * @return MacCready-adjusted inverse glide ratio over ground
-   */
-  double f(const double V) noexcept override {
-    return (polar.MSinkRate(V + m_head_wind) + m_net_sink_rate) / V;
-  }
-
-  /**
-   * Find best speed to fly
-   *
-   * @param Vstart Initial search speed (m/s)
-   *
-   * @return Speed to fly (m/s)
-   */
-  double solve(const double Vstart) {
-    auto Vopt = find_min(Vstart);
-    return Vopt + m_head_wind;
-  }
-};
-
 double
 GlidePolar::SpeedToFly(const double stf_sink_rate,
                        const double head_wind) const noexcept
 {
   assert(IsValid());
-  GlidePolarSpeedToFly gp_stf(*this, stf_sink_rate, head_wind, Vmin, Vmax);
-  return gp_stf.solve(Vmax);
+
+  const double k = head_wind * (head_wind * polar.a + polar.b) + polar.c
+    + mc + stf_sink_rate;
+  const double v = sqrt(std::max(k, 0.) / polar.a);
+
+  /* stay within the speed range of the polar, and keep a positive
+     ground speed */
+  const double v_ground = std::min(std::max(v, std::max(1., Vmin - head_wind)),
+                                   Vmax - head_wind);
+  return v_ground + head_wind;
 }
 
 double
@@ -15,7 +15,13 @@ GlideResult::GlideResult(const GlideState &task, const double V) noexcept
    min_arrival_altitude(task.min_arrival_altitude),
    vector(task.vector),
    pure_glide_min_arrival_altitude(task.min_arrival_altitude),
+   pure_glide_height(0),
    pure_glide_altitude_difference(task.altitude_difference),
+   cruise_track_bearing(task.vector.bearing),
+   height_climb(0),
+   height_glide(0),
+   time_elapsed{},
+   time_virtual{},
    altitude_difference(task.altitude_difference),
    effective_wind_speed(task.wind.norm),
    effective_wind_angle(task.effective_wind_angle),
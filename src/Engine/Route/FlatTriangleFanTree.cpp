@@ -155,17 +155,31 @@ FlatTriangleFanTree::UpdateTerrainBase(const FlatGeoPoint o,
     return;
   }
 
-  for (const auto &x : fan.GetVertices()) {
-    const FlatGeoPoint av = (o + x) * 0.5;
-    const GeoPoint p = parms.projection.Unproject(av);
-    const auto h = parms.terrain->GetHeight(p);
-
-    if (h.IsWater())
-      /* water: assume 0m MSL */
-      parms.terrain_counter++;
-    else if (!h.IsInvalid()) {
-      parms.terrain_counter++;
-      parms.terrain_base += h.GetValue();
+  /* look up the terrain heights in batches, which is cheaper than
+     one query per vertex */
+  constexpr std::size_t BATCH_SIZE = 64;
+  GeoPoint points[BATCH_SIZE];
+  TerrainHeight heights[BATCH_SIZE];
+
+  for (auto vertices = fan.GetVertices(); !vertices.empty();) {
+    const auto chunk = vertices.first(std::min(vertices.size(), BATCH_SIZE));
+    vertices = vertices.subspan(chunk.size());
+
+    for (std::size_t i = 0; i < chunk.size(); ++i) {
+      const FlatGeoPoint av = (o + chunk[i]) * 0.5;
+      points[i] = parms.projection.Unproject(av);
+    }
+
+    parms.terrain->GetHeights({points, chunk.size()}, heights);
+
+    for (const auto h : std::span{heights, chunk.size()}) {
+      if (h.IsWater())
+        /* water: assume 0m MSL */
+        parms.terrain_counter++;
+      else if (!h.IsInvalid()) {
+        parms.terrain_counter++;
+        parms.terrain_base += h.GetValue();
+      }
     }
   }
 
@@ -88,17 +88,25 @@ RoutePolars::CalcVHeight(const RouteLink &link) const noexcept
 
 std::optional<RoutePoint>
 RoutePolars::CheckClearance(const RouteLink &e, const RasterMap &map,
-                            const FlatProjection &proj) const noexcept
+                            const FlatProjection &proj,
+                            ClearanceGrid *grid) const noexcept
 {
   if (!config.IsTerrainEnabled())
     return std::nullopt;
 
   GeoPoint start = proj.Unproject(e.first);
   GeoPoint dest = proj.Unproject(e.second);
+  const int vh = CalcVHeight(e);
+
+  if (grid != nullptr &&
+      map.IsClear(*grid, start, e.first.altitude, dest,
+                  e.second.altitude, vh,
+                  climb_ceiling, GetSafetyHeight()))
+    return std::nullopt;
 
   const auto intersection =
     map.FirstIntersection(start, e.first.altitude, dest,
-                          e.second.altitude, CalcVHeight(e),
+                          e.second.altitude, vh,
                           climb_ceiling, GetSafetyHeight());
   if (!intersection)
     return std::nullopt;
@@ -14,6 +14,7 @@ class GlidePolar;
 struct GlideSettings;
 class FlatProjection;
 class RasterMap;
+class ClearanceGrid;
 struct SpeedVector;
 struct GeoPoint;
 struct AGeoPoint;
@@ -86,14 +87,17 @@ public:
    * @param e Link to evaluate
    * @param map RasterMap of terrain.
    * @param proj Task projection
+   * @param grid an optional #ClearanceGrid for #map which is used to
+   * skip the raster walk for links which are clearly above the
+   * terrain
    *
    * @return std::nullopt if intersect occurs or clearance after
    * intersection point
    */
-  [[gnu::pure]]
   std::optional<RoutePoint> CheckClearance(const RouteLink &e,
                                            const RasterMap &map,
-                                           const FlatProjection &proj) const noexcept;
+                                           const FlatProjection &proj,
+                                           ClearanceGrid *grid=nullptr) const noexcept;
 
   /**
    * Rotate line from start to end either left or right
@@ -75,7 +75,10 @@ TerrainRoute::IsClear(const RouteLink &e) const noexcept
   if (terrain == nullptr || !terrain->IsDefined())
     return true;
 
-  auto inp = rpolars_route.CheckClearance(e, *terrain, projection);
+  auto inp = rpolars_route.CheckClearance(e, *terrain, projection,
+                                          clearance_grid_enabled
+                                          ? &clearance_grid
+                                          : nullptr);
   if (inp)
     m_inx_terrain = *inp;
   return !inp;
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "RoutePlanner.hpp"
+#include "Terrain/ClearanceGrid.hpp"
 
 class ReachFan;
 
@@ -27,6 +28,13 @@ class TerrainRoute: public RoutePlanner
 
   mutable RoutePoint m_inx_terrain;
 
+  /**
+   * Speeds up IsClear(); it is kept as long as the terrain does not
+   * change.
+   */
+  mutable ClearanceGrid clearance_grid;
+  bool clearance_grid_enabled = true;
+
 public:
   friend class PrintHelper;
 
@@ -36,6 +44,15 @@ public:
    */
   void SetTerrain(const RasterMap *_terrain) noexcept {
     terrain = _terrain;
+    clearance_grid.Clear();
+  }
+
+  /**
+   * Enable or disable the #ClearanceGrid (enabled by default).  This
+   * does not affect the result, only the time it takes.
+   */
+  void SetClearanceGridEnabled(bool enabled) noexcept {
+    clearance_grid_enabled = enabled;
   }
 
   const auto &GetReachPolar() const noexcept {
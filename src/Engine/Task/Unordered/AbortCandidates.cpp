@@ -0,0 +1,137 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "AbortCandidates.hpp"
+#include "AbortIntersectionTest.hpp"
+#include "UnorderedTaskPoint.hpp"
+#include "Navigation/Aircraft.hpp"
+#include "Task/TaskBehaviour.hpp"
+#include "Task/Solvers/TaskSolution.hpp"
+#include "GlideSolvers/GlidePolar.hpp"
+#include "Engine/Waypoint/Waypoint.hpp"
+
+#include <algorithm>
+
+void
+AbortCandidateList::Add(double cost, const WaypointPtr &waypoint,
+                        const GlideResult &solution) noexcept
+{
+  if (!Accepts(cost))
+    return;
+
+  if (IsFull())
+    items.pop_back();
+
+  /* insert after all candidates with the same cost, so the first one
+     added wins */
+  const auto i = std::upper_bound(items.begin(), items.end(), cost,
+                                  [](double c, const Item &item){
+                                    return c < item.cost;
+                                  });
+  items.insert(i, Item{cost, AlternatePoint{waypoint, solution}});
+}
+
+/**
+ * A lower bound for the height lost per metre over ground in a final
+ * glide solved by MacCready::Solve(), assuming a direct tail wind.
+ */
+[[gnu::pure]]
+static double
+GetMinGlideSlope(const GlidePolar &polar, double wind_speed) noexcept
+{
+  const double ce = polar.GetCruiseEfficiency();
+
+  if (polar.GetMC() > 0)
+    /* MacCready::SolveGlide() at the best L/D speed for this MC */
+    return polar.GetSBestLD() / (polar.GetVBestLD() * ce + wind_speed);
+
+  /* MacCready::OptimiseGlide() searches the speed with the flattest
+     glide; it cannot beat the best glide ratio over ground */
+  const double v =
+    std::clamp(polar.GetBestGlideRatioSpeed(-wind_speed / ce),
+               polar.GetVMin(), polar.GetVMax());
+  return polar.SinkRate(v) / (v * ce + wind_speed);
+}
+
+/**
+ * The highest ground speed of a solution by MacCready::Solve().
+ */
+[[gnu::pure]]
+static double
+GetMaxGroundSpeed(const GlidePolar &polar, double wind_speed) noexcept
+{
+  const double v = polar.GetMC() > 0
+    ? polar.GetVBestLD()
+    : polar.GetVMax();
+  return v * polar.GetCruiseEfficiency() + wind_speed;
+}
+
+[[gnu::pure]]
+static double
+GetArrivalTime(const GlideResult &solution) noexcept
+{
+  return (solution.time_elapsed + solution.time_virtual).count();
+}
+
+AbortCandidates::AbortCandidates(const AircraftState &_state,
+                                 const TaskBehaviour &_task_behaviour,
+                                 const GlidePolar &_polar,
+                                 const AbortIntersectionTest *_intersection_test,
+                                 std::size_t _capacity,
+                                 double min_elevation) noexcept
+  :state(_state), task_behaviour(_task_behaviour), polar(_polar),
+   intersection_test(_intersection_test),
+   capacity(_capacity),
+   max_altitude_difference(state.altitude -
+                           std::max(0., min_elevation +
+                                    task_behaviour.safety_height_arrival)),
+   min_glide_slope(GetMinGlideSlope(polar, state.wind.norm)),
+   max_ground_speed(GetMaxGroundSpeed(polar, state.wind.norm)),
+   airports(capacity), outlandings(capacity), unreachable(capacity)
+{
+}
+
+void
+AbortCandidates::Add(const WaypointPtr &waypoint) noexcept
+{
+  const UnorderedTaskPoint t(waypoint, task_behaviour);
+  const GlideResult result =
+    TaskSolution::GlideSolutionRemaining(t, state,
+                                         task_behaviour.glide, polar);
+  if (!result.IsAchievable())
+    return;
+
+  if (result.IsFinalGlide() &&
+      (intersection_test == nullptr ||
+       !intersection_test->Intersects(AGeoPoint(waypoint->location,
+                                                result.min_arrival_altitude)))) {
+    auto &list = waypoint->IsAirport() ? airports : outlandings;
+    list.Add(-result.altitude_difference, waypoint, result);
+  } else
+    unreachable.Add(GetArrivalTime(result), waypoint, result);
+}
+
+bool
+AbortCandidates::IsComplete(double distance) const noexcept
+{
+  /* the best arrival altitude of all remaining landables */
+  const double altitude_difference =
+    max_altitude_difference - distance * min_glide_slope;
+
+  if (airports.IsFull())
+    /* the other categories are not going to be used */
+    return !airports.Accepts(-altitude_difference);
+
+  if (altitude_difference >= 0)
+    /* more landables may be reachable */
+    return false;
+
+  const std::size_t n_reachable =
+    std::min(airports.size() + outlandings.size(), capacity);
+  const std::size_t n_unreachable = capacity - n_reachable;
+  if (n_unreachable == 0)
+    return true;
+
+  return unreachable.size() >= n_unreachable &&
+    distance / max_ground_speed >= unreachable.GetCost(n_unreachable - 1);
+}
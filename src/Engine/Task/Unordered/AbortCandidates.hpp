@@ -0,0 +1,146 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "AlternatePoint.hpp"
+
+#include <cstddef>
+#include <vector>
+
+struct AircraftState;
+struct TaskBehaviour;
+class GlidePolar;
+class AbortIntersectionTest;
+
+/**
+ * A bounded list of the best landable candidates of one category,
+ * sorted by ascending cost.  Candidates which cannot get into the
+ * list are discarded right away.
+ */
+class AbortCandidateList {
+  struct Item {
+    double cost;
+    AlternatePoint point;
+  };
+
+  std::vector<Item> items;
+  std::size_t capacity;
+
+public:
+  explicit AbortCandidateList(std::size_t _capacity) noexcept
+    :capacity(_capacity) {
+    items.reserve(capacity);
+  }
+
+  bool empty() const noexcept {
+    return items.empty();
+  }
+
+  std::size_t size() const noexcept {
+    return items.size();
+  }
+
+  const AlternatePoint &operator[](std::size_t i) const noexcept {
+    return items[i].point;
+  }
+
+  double GetCost(std::size_t i) const noexcept {
+    return items[i].cost;
+  }
+
+  bool IsFull() const noexcept {
+    return items.size() >= capacity;
+  }
+
+  /**
+   * Would a candidate with the specified cost get into the list?
+   * Candidates with the same cost as the worst one don't.
+   */
+  [[gnu::pure]]
+  bool Accepts(double cost) const noexcept {
+    return !IsFull() || cost < items.back().cost;
+  }
+
+  void Add(double cost, const WaypointPtr &waypoint,
+           const GlideResult &solution) noexcept;
+};
+
+/**
+ * Evaluates landable waypoints for the #AbortTask and sorts them into
+ * the categories of AbortTask::UpdateSample(), keeping only the best
+ * #capacity of each:
+ *
+ * - airfields reachable in final glide, by arrival altitude
+ * - other landables reachable in final glide, by arrival altitude
+ * - all others which are achievable, by arrival time
+ *
+ * The landables are supposed to be added in ascending order of
+ * distance, see Waypoints::VisitNearestIf().  IsComplete() uses a
+ * conservative bound of the glide solution for a given distance to
+ * find out when the remaining landables cannot change the result.
+ */
+class AbortCandidates {
+  const AircraftState &state;
+  const TaskBehaviour &task_behaviour;
+  const GlidePolar &polar;
+  const AbortIntersectionTest *const intersection_test;
+
+  const std::size_t capacity;
+
+  /**
+   * The highest altitude difference any landable can have before
+   * gliding to it [m].
+   */
+  double max_altitude_difference;
+
+  /**
+   * The lowest height lost per metre (over ground) in a final glide.
+   */
+  double min_glide_slope;
+
+  /**
+   * The highest ground speed of any solution [m/s].
+   */
+  double max_ground_speed;
+
+  AbortCandidateList airports, outlandings, unreachable;
+
+public:
+  /**
+   * @param min_elevation the lowest elevation of all landables
+   */
+  AbortCandidates(const AircraftState &_state,
+                  const TaskBehaviour &_task_behaviour,
+                  const GlidePolar &_polar,
+                  const AbortIntersectionTest *_intersection_test,
+                  std::size_t _capacity, double min_elevation) noexcept;
+
+  const AbortCandidateList &GetReachableAirports() const noexcept {
+    return airports;
+  }
+
+  const AbortCandidateList &GetReachableOutlandings() const noexcept {
+    return outlandings;
+  }
+
+  const AbortCandidateList &GetUnreachable() const noexcept {
+    return unreachable;
+  }
+
+  /**
+   * Calculate the glide solution of a landable waypoint and add it to
+   * its category.
+   */
+  void Add(const WaypointPtr &waypoint) noexcept;
+
+  /**
+   * Can no landable at the specified distance or farther change the
+   * result?
+   *
+   * @param distance a lower bound for the distance of all remaining
+   * landables [m]
+   */
+  [[gnu::pure]]
+  bool IsComplete(double distance) const noexcept;
+};
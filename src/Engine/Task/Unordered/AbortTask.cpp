@@ -2,11 +2,9 @@
 // Copyright The XCSoar Project
 
 #include "AbortTask.hpp"
-#include "AbortIntersectionTest.hpp"
-#include "AlternateList.hpp"
+#include "AbortCandidates.hpp"
 #include "Navigation/Aircraft.hpp"
 #include "Task/Visitors/TaskPointVisitor.hpp"
-#include "Task/Solvers/TaskSolution.hpp"
 #include "GlideSolvers/GlidePolar.hpp"
 #include "Waypoint/Waypoints.hpp"
 
@@ -16,6 +14,12 @@ static constexpr double min_search_range = 50000;
 /** max search range in m */
 static constexpr double max_search_range = 100000;
 
+static bool
+IsLandable(const Waypoint &wp) noexcept
+{
+  return wp.IsLandable();
+}
+
 AbortTask::AbortTask(const TaskBehaviour &_task_behaviour,
                      const Waypoints &wps) noexcept
   :UnorderedTask(TaskType::ABORT, _task_behaviour),
@@ -88,84 +92,16 @@ AbortTask::GetAbortRange(const AircraftState &state,
                     min_search_range, max_search_range);
 }
 
-[[gnu::pure]]
-static bool
-IsReachable(const GlideResult &result, bool final_glide) noexcept
-{
-  return final_glide
-    ? result.IsFinalGlide()
-    : result.IsAchievable();
-}
-
 bool
-AbortTask::FillReachable(const AircraftState &state,
-                         AlternateList &approx_waypoints,
-                         const GlidePolar &polar, bool only_airfield,
-                         bool final_glide, [[maybe_unused]] bool safety) noexcept
+AbortTask::AddAlternates(const AbortCandidateList &list) noexcept
 {
-  if (IsTaskFull() || approx_waypoints.empty())
+  if (IsTaskFull())
     return false;
 
-  const AGeoPoint p_start(state.location, state.altitude);
-
-  bool found_final_glide = false;
-  AlternateList q;
-  q.reserve(32);
-
-  for (auto v = approx_waypoints.begin(); v != approx_waypoints.end();) {
-    if (only_airfield && !v->waypoint->IsAirport()) {
-      ++v;
-      continue;
-    }
-
-    UnorderedTaskPoint t(v->waypoint, task_behaviour);
-    GlideResult result =
-        TaskSolution::GlideSolutionRemaining(t, state,
-                                             task_behaviour.glide, polar);
-
-    if (IsReachable(result, final_glide)) {
-      bool intersects = false;
-      const bool is_reachable_final = IsReachable(result, true);
-
-      if (intersection_test && final_glide && is_reachable_final)
-        intersects = intersection_test->Intersects(
-            AGeoPoint(v->waypoint->location, result.min_arrival_altitude));
-
-      if (!intersects) {
-        q.emplace_back(v->waypoint, result);
-        // remove it since it's already in the list now      
-        v = approx_waypoints.erase(v);
-
-        if (is_reachable_final)
-          found_final_glide = true;
-
-        continue; // skip incrementing v since we just erased it
-      }
-    } 
-
-    ++v;
-  }
-
-  /**
-   * If dealing with reachable points, sort by arrival altitude.
-   * Otherwise, sort by arrival time, which takes into account the wind
-   * drift while circling to gain the altitude needed to reach the point.
-   */
-  if (final_glide) {
-    std::sort(q.begin(), q.end(), [](const auto &x, const auto &y){
-      return x.solution.altitude_difference > y.solution.altitude_difference;
-    });
-  } else {
-    std::sort(q.begin(), q.end(), [](const auto &x, const auto &y){
-      return x.solution.time_elapsed + x.solution.time_virtual <
-        y.solution.time_elapsed + y.solution.time_virtual;
-    });
-  }
-
-  const auto n = std::min(q.size(), max_abort - task_points.size());
+  const auto n = std::min(list.size(), max_abort - task_points.size());
   for (std::size_t j = 0; j < n; ++j) {
-    auto &top = q[j];
-    task_points.emplace_back(std::move(top.waypoint), task_behaviour,
+    const auto &top = list[j];
+    task_points.emplace_back(WaypointPtr{top.waypoint}, task_behaviour,
                              top.solution);
 
     const int i = task_points.size() - 1;
@@ -173,7 +109,28 @@ AbortTask::FillReachable(const AircraftState &state,
       active_task_point = i;
   }
 
-  return found_final_glide;
+  return !list.empty();
+}
+
+double
+AbortTask::GetMinLandableElevation() noexcept
+{
+  if (waypoints.GetSerial() != min_landable_elevation_serial) {
+    min_landable_elevation_serial = waypoints.GetSerial();
+
+    bool found = false;
+    for (const auto &wp : waypoints) {
+      if (!wp->IsLandable())
+        continue;
+
+      const double elevation = wp->GetElevationOrZero();
+      if (!found || elevation < min_landable_elevation)
+        min_landable_elevation = elevation;
+      found = true;
+    }
+  }
+
+  return min_landable_elevation;
 }
 
 void
@@ -206,32 +163,41 @@ AbortTask::UpdateSample(const AircraftState &state,
     /* can't work without a polar */
     return false;
 
-  AlternateList approx_waypoints;
-  approx_waypoints.reserve(128);
-
-  waypoints.VisitWithinRange(state.location,
-                             GetAbortRange(state, glide_polar), [&approx_waypoints](const auto &wp){
-                               if (wp->IsLandable())
-                                 approx_waypoints.emplace_back(wp);
-                             });
-  if (approx_waypoints.empty()) {
+  /**
+   * Evaluate the landable waypoints within range, nearest first, and
+   * stop as soon as the remaining ones cannot get into the list.
+   */
+  AbortCandidates candidates(state, task_behaviour, glide_polar,
+                             intersection_test, max_abort,
+                             GetMinLandableElevation());
+  bool found = false;
+
+  waypoints.VisitNearestIf(state.location,
+                           GetAbortRange(state, glide_polar), IsLandable,
+                           [&candidates, &found](const auto &wp, double distance){
+                             if (candidates.IsComplete(distance))
+                               return false;
+
+                             candidates.Add(wp);
+                             found = true;
+                             return true;
+                           });
+  if (!found) {
     /** @todo increase range */
     return false;
   }
 
   /**
-   * First, get only reachable airfields (no outlanding sites), sort them by
-   * arrival altitude, and put them in task_points.
+   * First, get only reachable airfields (no outlanding sites), sorted
+   * by arrival altitude, and put them in task_points.
    */
-  reachable_landable |=  FillReachable(state, approx_waypoints, glide_polar,
-                                       true, true, true);
+  reachable_landable |= AddAlternates(candidates.GetReachableAirports());
 
   /**
    * Now add to task_points reachable outlanding sites, sorted by arrival
    * altitude.
    */
-  reachable_landable |=  FillReachable(state, approx_waypoints, glide_polar,
-                                       false, true, true);
+  reachable_landable |= AddAlternates(candidates.GetReachableOutlandings());
 
   /**
    * Add to the "alternates" list the reachable airfield and outlanding site
@@ -250,7 +216,7 @@ AbortTask::UpdateSample(const AircraftState &state,
    * arrival time, not necessarily the one with the greatest arrival
    * altitude.
    */
-  FillReachable(state, approx_waypoints, glide_polar, false, false, false);
+  AddAlternates(candidates.GetUnreachable());
 
   /**
    * Add to the "alternates" list the unreachable landable waypoints
@@ -5,13 +5,14 @@
 
 #include "UnorderedTask.hpp"
 #include "UnorderedTaskPoint.hpp"
+#include "util/Serial.hpp"
 
 #include <vector>
 #include <cassert>
 
 class Waypoints;
 class AbortIntersectionTest;
-class AlternateList;
+class AbortCandidateList;
 
 /**
  * AbortTask continuously automatically maintains a prioritized list of
@@ -57,6 +58,13 @@ private:
   unsigned active_waypoint;
   bool reachable_landable;
 
+  /**
+   * The lowest elevation of all landable waypoints, see
+   * GetMinLandableElevation().
+   */
+  double min_landable_elevation = 0;
+  Serial min_landable_elevation_serial;
+
 public:
   /** 
    * Base constructor.
@@ -134,23 +142,21 @@ protected:
                        const GlidePolar &glide_polar) const noexcept;
 
   /**
-   * Fill abort task list with candidate waypoints given a list of
-   * waypoints satisfying approximate range queries.  Can be used
-   * to add airfields only, or outlanding sites, too.
-   *
-   * @param state Aircraft state
-   * @param approx_waypoints List of candidate waypoints
-   * @param polar Polar used for tests
-   * @param only_airfield If true, only add waypoints that are airfields.
-   * @param final_glide Whether solution must be glide only or climb allowed
-   * @param safety Whether solution uses safety polar
+   * Append the candidates of the list (best first) to the abort task
+   * list, until it is full.
    *
-   * @return True if a landable point within final glide was found
+   * @return True if the list was not empty and the abort task list
+   * was not full
+   */
+  bool AddAlternates(const AbortCandidateList &list) noexcept;
+
+  /**
+   * Returns the lowest elevation of all landable waypoints.  It is
+   * used to bound the arrival altitude of landables which have not
+   * been evaluated, and gets recalculated only when the waypoints
+   * change.
    */
-  bool FillReachable(const AircraftState &state,
-                     AlternateList &approx_waypoints,
-                     const GlidePolar &polar, bool only_airfield,
-                     bool final_glide, bool safety) noexcept;
+  double GetMinLandableElevation() noexcept;
 
 protected:
   /**
@@ -0,0 +1,494 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "FlatTrace.hpp"
+#include "Metric.hpp"
+#include "Vector.hpp"
+
+#include <algorithm>
+
+FlatTrace::FlatTrace(const Time _no_thin_time, const Time _max_time,
+                     const unsigned _max_size) noexcept
+  :max_time(_max_time),
+   no_thin_time(_no_thin_time),
+   max_size(_max_size),
+   opt_size((3 * _max_size) / 4),
+   slack(std::max(_max_size / 4, 1U)),
+   points(max_size + slack),
+   elim_time(max_size + slack),
+   elim_distance(max_size + slack),
+   delta_distance(max_size + slack),
+   average_delta_time{},
+   average_delta_distance(0)
+{
+  assert(max_size >= 4);
+}
+
+std::size_t
+FlatTrace::GetMemoryUsage() const noexcept
+{
+  return points.size() * sizeof(points[0]) +
+    elim_time.size() * sizeof(elim_time[0]) +
+    elim_distance.size() * sizeof(elim_distance[0]) +
+    delta_distance.size() * sizeof(delta_distance[0]) +
+    link_previous.size() * sizeof(link_previous[0]) +
+    link_next.size() * sizeof(link_next[0]) +
+    heap_position.size() * sizeof(heap_position[0]) +
+    heap.capacity() * sizeof(heap[0]);
+}
+
+void
+FlatTrace::clear() noexcept
+{
+  average_delta_distance = 0;
+  average_delta_time = {};
+
+  head = tail = 0;
+
+  ++modify_serial;
+  ++append_serial;
+}
+
+FlatTrace::Time
+FlatTrace::GetRecentTime(const Time t) const noexcept
+{
+  if (empty())
+    return {};
+
+  const TracePoint &last = back();
+  if (last.GetTime() > t)
+    return last.GetTime() - t;
+
+  return {};
+}
+
+void
+FlatTrace::UpdateDelta(unsigned i, unsigned previous, unsigned next) noexcept
+{
+  const TracePoint &point = points[i];
+  elim_time[i] = TraceMetric::TimeMetric(points[previous], point,
+                                         points[next]);
+  elim_distance[i] = TraceMetric::DistanceMetric(points[previous], point,
+                                                 points[next]);
+  delta_distance[i] = point.FlatDistanceTo(points[previous]);
+}
+
+inline bool
+FlatTrace::HeapLess(unsigned a, unsigned b) const noexcept
+{
+  return TraceMetric::Rank(elim_distance[a], elim_time[a], points[a],
+                           elim_distance[b], elim_time[b], points[b]);
+}
+
+void
+FlatTrace::HeapSiftUp(std::size_t position) noexcept
+{
+  const unsigned i = heap[position];
+  while (position > 0) {
+    const std::size_t parent = (position - 1) / 2;
+    if (!HeapLess(i, heap[parent]))
+      break;
+
+    HeapSet(position, heap[parent]);
+    position = parent;
+  }
+
+  HeapSet(position, i);
+}
+
+void
+FlatTrace::HeapSiftDown(std::size_t position) noexcept
+{
+  const std::size_t n = heap.size();
+  const unsigned i = heap[position];
+  while (true) {
+    std::size_t child = 2 * position + 1;
+    if (child >= n)
+      break;
+
+    if (child + 1 < n && HeapLess(heap[child + 1], heap[child]))
+      ++child;
+
+    if (!HeapLess(heap[child], i))
+      break;
+
+    HeapSet(position, heap[child]);
+    position = child;
+  }
+
+  HeapSet(position, i);
+}
+
+void
+FlatTrace::HeapPush(unsigned i) noexcept
+{
+  heap.push_back(i);
+  HeapSiftUp(heap.size() - 1);
+}
+
+unsigned
+FlatTrace::HeapPop() noexcept
+{
+  assert(!heap.empty());
+
+  const unsigned top = heap.front();
+  heap_position[top] = NOT_IN_HEAP;
+
+  const unsigned last = heap.back();
+  heap.pop_back();
+  if (!heap.empty()) {
+    heap_position[last] = 0;
+    heap.front() = last;
+    HeapSiftDown(0);
+  }
+
+  return top;
+}
+
+bool
+FlatTrace::EraseDelta(const unsigned target_size, const Time recent) noexcept
+{
+  if (size() <= 2)
+    return false;
+
+  const Time recent_time = GetRecentTime(recent);
+
+  const unsigned capacity = points.size();
+  if (link_previous.size() < capacity) {
+    link_previous.ResizeDiscard(capacity);
+    link_next.ResizeDiscard(capacity);
+    heap_position.ResizeDiscard(capacity);
+    heap.reserve(capacity);
+  }
+
+  /* link all points and collect the candidates in a heap; the first
+     and the last point are always edges */
+  heap.clear();
+  for (unsigned i = head; i < tail; ++i) {
+    link_previous[i] = i - 1;
+    link_next[i] = i + 1;
+    heap_position[i] = NOT_IN_HEAP;
+
+    if (!IsEdge(i) && points[i].GetTime() < recent_time) {
+      heap_position[i] = heap.size();
+      heap.push_back(i);
+    }
+  }
+
+  for (std::size_t position = heap.size() / 2; position-- > 0;)
+    HeapSiftDown(position);
+
+  const unsigned first = head, last = tail - 1;
+  const auto Update = [&](unsigned i){
+    if (i == first || i == last)
+      return;
+
+    UpdateDelta(i, link_previous[i], link_next[i]);
+
+    const unsigned position = heap_position[i];
+    if (position != NOT_IN_HEAP) {
+      HeapSiftUp(position);
+      HeapSiftDown(heap_position[i]);
+    } else if (points[i].GetTime() < recent_time)
+      HeapPush(i);
+  };
+
+  unsigned n = size();
+  while (n > target_size && !heap.empty()) {
+    const unsigned i = HeapPop();
+    const unsigned previous = link_previous[i], next = link_next[i];
+    link_next[previous] = next;
+    link_previous[next] = previous;
+    --n;
+
+    Update(previous);
+    Update(next);
+  }
+
+  if (n == size())
+    return false;
+
+  /* compact the arrays, following the links of the remaining
+     points */
+  unsigned dest = 0;
+  for (unsigned i = first;; i = link_next[i]) {
+    Move(dest++, i);
+    if (i == last)
+      break;
+  }
+
+  head = 0;
+  tail = dest;
+  assert(size() == n);
+  return true;
+}
+
+void
+FlatTrace::Move(unsigned dest, unsigned src) noexcept
+{
+  assert(dest <= src);
+
+  if (dest == src)
+    return;
+
+  points[dest] = points[src];
+  elim_time[dest] = elim_time[src];
+  elim_distance[dest] = elim_distance[src];
+  delta_distance[dest] = delta_distance[src];
+}
+
+void
+FlatTrace::MoveToStart() noexcept
+{
+  const unsigned n = size();
+  for (unsigned i = 0; i < n; ++i)
+    Move(i, head + i);
+
+  head = 0;
+  tail = n;
+}
+
+bool
+FlatTrace::EraseEarlierThan(const Time p_time) noexcept
+{
+  if (p_time == Time{} || empty() || front().GetTime() >= p_time)
+    // there will be nothing to remove
+    return false;
+
+  do {
+    ++head;
+  } while (!empty() && front().GetTime() < p_time);
+
+  if (!empty())
+    EraseStart(head);
+
+  if (head >= slack)
+    MoveToStart();
+
+  ++modify_serial;
+  ++append_serial;
+  return true;
+}
+
+void
+FlatTrace::EraseLaterThan(const Time min_time) noexcept
+{
+  assert(min_time.count() > 0);
+  assert(!empty());
+
+  while (!empty() && back().GetTime() > min_time)
+    --tail;
+
+  if (!empty())
+    EraseStart(tail - 1);
+}
+
+void
+FlatTrace::EraseStart(unsigned i) noexcept
+{
+  elim_distance[i] = null_delta;
+  elim_time[i] = null_time;
+}
+
+void
+FlatTrace::push_back(const TracePoint &point) noexcept
+{
+  const Time min_delta = std::chrono::seconds{2};
+
+  if (empty()) {
+    // first point determines origin for flat projection
+    task_projection.Reset(point.GetLocation());
+    task_projection.Update();
+  } else if (point.GetTime() < back().GetTime()) {
+    // gone back in time
+
+    const Time clear_threshold = std::chrono::minutes{3};
+    const Time fix_threshold = std::chrono::seconds{10};
+
+    if (point.GetTime() + clear_threshold < back().GetTime()) {
+      /* not fixable, clear the trace and restart from scratch */
+      clear();
+      return;
+    }
+
+    /* not much, try to fix it */
+    EraseLaterThan(point.GetTime() - fix_threshold);
+    ++modify_serial;
+  } else if (point.GetTime() - back().GetTime() < min_delta)
+    // only add one item per two seconds
+    return;
+
+  EnforceTimeWindow(point.GetTime());
+
+  if (size() >= max_size)
+    Thin();
+
+  assert(size() < max_size);
+  assert(tail < points.size());
+
+  const unsigned i = tail++;
+  points[i] = point;
+  points[i].Project(task_projection);
+  elim_time[i] = null_time;
+  elim_distance[i] = null_delta;
+  delta_distance[i] = 0;
+
+  /* the previous point is not an edge anymore (unless it is the
+     first one) */
+  if (i > head + 1)
+    UpdateDelta(i - 1, i - 2, i);
+
+  ++append_serial;
+}
+
+unsigned
+FlatTrace::CalcAverageDeltaDistance(const Time no_thin) const noexcept
+{
+  const Time r = GetRecentTime(no_thin);
+  unsigned acc = 0;
+  unsigned counter = 0;
+
+  for (unsigned i = head; i < tail && points[i].GetTime() < r;
+       ++i, ++counter)
+    acc += delta_distance[i];
+
+  if (counter)
+    return acc / counter;
+
+  return 0;
+}
+
+FlatTrace::Time
+FlatTrace::CalcAverageDeltaTime(const Time no_thin) const noexcept
+{
+  const Time r = GetRecentTime(no_thin);
+
+  /* find the last item before the "r" timestamp */
+  unsigned i = head;
+  while (i < tail && points[i].GetTime() < r)
+    ++i;
+
+  unsigned counter = i - head;
+  if (counter < 2)
+    return {};
+
+  --i;
+  --counter;
+
+  Time start_time = front().GetTime();
+  Time end_time = points[i].GetTime();
+  return (end_time - start_time) / counter;
+}
+
+void
+FlatTrace::EnforceTimeWindow(const Time latest_time) noexcept
+{
+  if (max_time == null_time)
+    /* no time window configured */
+    return;
+
+  if (latest_time <= max_time)
+    /* this can only happen if the flight launched shortly after
+       midnight; this check is just here to avoid unsigned integer
+       underflow */
+    return;
+
+  EraseEarlierThan(latest_time - max_time);
+}
+
+inline void
+FlatTrace::Thin2() noexcept
+{
+  const unsigned target_size = opt_size;
+  assert(size() > target_size);
+
+  // if still too big, remove points based on line simplification
+  EraseDelta(target_size, no_thin_time);
+  if (size() <= target_size)
+    return;
+
+  // if still too big, thin again, ignoring recency
+  if (no_thin_time.count() > 0)
+    EraseDelta(target_size, {});
+
+  assert(size() <= target_size);
+}
+
+void
+FlatTrace::Thin() noexcept
+{
+  assert(size() == max_size);
+
+  Thin2();
+
+  assert(size() < max_size);
+
+  average_delta_distance = CalcAverageDeltaDistance(no_thin_time);
+  average_delta_time = CalcAverageDeltaTime(no_thin_time);
+
+  ++modify_serial;
+  ++append_serial;
+}
+
+void
+FlatTrace::GetPoints(TracePointVector &iov) const noexcept
+{
+  iov.assign(points.data() + head, points.data() + tail);
+}
+
+void
+FlatTrace::GetPoints(TracePointerVector &v) const noexcept
+{
+  v.clear();
+  v.reserve(size());
+  for (unsigned i = head; i < tail; ++i)
+    v.push_back(&points[i]);
+}
+
+bool
+FlatTrace::SyncPoints(TracePointerVector &v) const noexcept
+{
+  assert(v.size() <= size());
+
+  if (v.size() == size())
+    /* no news */
+    return false;
+
+  v.reserve(size());
+  for (unsigned i = head + v.size(); i < tail; ++i)
+    v.push_back(&points[i]);
+  assert(v.size() == size());
+  return true;
+}
+
+void
+FlatTrace::GetPoints(TracePointVector &v, const Time min_time,
+                     const GeoPoint &location,
+                     double min_distance) const noexcept
+{
+  /* skip the trace points that are before min_time */
+  const_iterator i = begin(), end = this->end();
+  unsigned skipped = 0;
+  while (true) {
+    if (i == end)
+      /* nothing left */
+      return;
+
+    if (i->GetTime() >= min_time)
+      /* found the first point that is within range */
+      break;
+
+    ++i;
+    ++skipped;
+  }
+
+  assert(skipped < size());
+
+  v.reserve(size() - skipped);
+  const unsigned range = ProjectRange(location, min_distance);
+  const unsigned sq_range = range * range;
+  do {
+    v.push_back(*i);
+    i.NextSquareRange(sq_range, end);
+  } while (i != end);
+}
@@ -0,0 +1,391 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Point.hpp"
+#include "util/AllocatedArray.hxx"
+#include "util/NonCopyable.hpp"
+#include "util/Serial.hpp"
+#include "Geo/Flat/TaskProjection.hpp"
+#include "time/Stamp.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+class TracePointVector;
+class TracePointerVector;
+
+/**
+ * An implementation of #Trace which keeps the points and their
+ * thinning metrics in contiguous arrays ("struct of arrays") in
+ * chronological order, instead of allocating a node per point.
+ *
+ * Appending a point touches only the end of the arrays.  Thinning
+ * builds a binary heap of array indices sorted by the thinning rank
+ * (with a reverse index, so a point can be repositioned after its
+ * neighbour was removed), removes the points with the lowest rank
+ * and then compacts the arrays in one pass.  The ranking and the
+ * metrics are shared with #ListTrace (see TraceMetric), and both
+ * produce identical results.
+ *
+ * Pointers to points stay valid as long as the modify serial does
+ * not change, just like with #ListTrace.
+ */
+class FlatTrace : private NonCopyable
+{
+  using Time = TracePoint::Time;
+
+  static constexpr unsigned null_delta = 0 - 1;
+
+public:
+  static constexpr auto null_time = TracePoint::INVALID_TIME;
+
+private:
+  /**
+   * A marker for #heap_position: the point is not in the heap.
+   */
+  static constexpr unsigned NOT_IN_HEAP = 0 - 1;
+
+  const Time max_time;
+  const Time no_thin_time;
+  const unsigned max_size;
+  const unsigned opt_size;
+
+  /**
+   * The number of array slots which may be wasted at the beginning
+   * of the arrays after old points were removed by
+   * EraseEarlierThan().  When #head reaches this value, the arrays
+   * are moved down.
+   */
+  const unsigned slack;
+
+  /**
+   * The points are stored in the array range [head, tail).
+   */
+  unsigned head = 0, tail = 0;
+
+  AllocatedArray<TracePoint> points;
+  AllocatedArray<Time> elim_time;
+  AllocatedArray<unsigned> elim_distance;
+  AllocatedArray<unsigned> delta_distance;
+
+  /**
+   * Scratch arrays used by EraseDelta(): the chronological links
+   * between the points which have not been removed yet, the heap
+   * of point indices and the position of each point in the heap.
+   * They are allocated on the first thinning and reused.
+   */
+  AllocatedArray<unsigned> link_previous, link_next;
+  AllocatedArray<unsigned> heap_position;
+  std::vector<unsigned> heap;
+
+  TaskProjection task_projection;
+
+  Time average_delta_time;
+  unsigned average_delta_distance;
+
+  Serial append_serial, modify_serial;
+
+public:
+  /**
+   * Constructor.  Task projection is updated after first call to append().
+   *
+   * @param no_thin_time Time window in seconds in which points most recent
+   * wont be trimmed
+   * @param max_time Time window size (seconds), null_time for unlimited
+   * @param max_size Maximum number of points that can be stored
+   */
+  explicit FlatTrace(const Time no_thin_time = {},
+                     const Time max_time = null_time,
+                     const unsigned max_size = 1000) noexcept;
+
+  /**
+   * Returns the number of bytes allocated by this object.
+   */
+  [[gnu::pure]]
+  std::size_t GetMemoryUsage() const noexcept;
+
+protected:
+  /**
+   * Find recent time after which points should not be culled
+   * (this is set to n seconds before the latest time)
+   */
+  [[gnu::pure]]
+  Time GetRecentTime(Time t) const noexcept;
+
+  /**
+   * Is the point at the given index the first or the last point?
+   */
+  bool IsEdge(unsigned i) const noexcept {
+    return elim_time[i] == null_time;
+  }
+
+  /**
+   * Update the thinning metrics of the point at the given index
+   * from its neighbours.
+   */
+  void UpdateDelta(unsigned i, unsigned previous, unsigned next) noexcept;
+
+  /**
+   * Erase elements based on delta metric until the size is
+   * equal to the target size.  Wont remove elements more recent than
+   * specified time from the last point.
+   *
+   * Note that the recent time is obeyed even if the results will
+   * fail to set the target size.
+   *
+   * @return True if items were erased
+   */
+  bool EraseDelta(unsigned target_size, Time recent = {}) noexcept;
+
+  /**
+   * Erase elements older than specified time, and update earliest
+   * item to become the new start
+   *
+   * @return True if items were erased
+   */
+  bool EraseEarlierThan(Time p_time) noexcept;
+
+  /**
+   * Erase elements more recent than specified time.  This is used to
+   * work around slight time warps.
+   */
+  void EraseLaterThan(Time min_time) noexcept;
+
+  /**
+   * Turn the point at the given index into an edge after the points
+   * before or after it were removed.
+   */
+  void EraseStart(unsigned i) noexcept;
+
+public:
+  /**
+   * Add trace to internal store.
+   *
+   * @param a new point; its "flat" (projected) location is ignored
+   */
+  void push_back(const TracePoint &point) noexcept;
+
+  /**
+   * Clear the trace store
+   */
+  void clear() noexcept;
+
+  void EraseEarlierThan(TimeStamp time) noexcept {
+    EraseEarlierThan(time.Cast<Time>());
+  }
+
+  void EraseLaterThan(TimeStamp time) noexcept {
+    EraseLaterThan(time.Cast<Time>());
+  }
+
+  unsigned GetMaxSize() const noexcept {
+    return max_size;
+  }
+
+  unsigned size() const noexcept {
+    return tail - head;
+  }
+
+  bool empty() const noexcept {
+    return tail == head;
+  }
+
+  /**
+   * Returns a #Serial that gets incremented when data gets appended
+   * to the #Trace.
+   */
+  const Serial &GetAppendSerial() const noexcept {
+    return append_serial;
+  }
+
+  /**
+   * Returns a #Serial that gets incremented when iterators get
+   * Invalidated (e.g. when the #Trace gets cleared or optimised).
+   */
+  const Serial &GetModifySerial() const noexcept {
+    return modify_serial;
+  }
+
+  /**
+   * Retrieve a vector of trace points sorted by time
+   */
+  void GetPoints(TracePointVector &iov) const noexcept;
+
+  /**
+   * Retrieve a vector of trace points sorted by time
+   */
+  void GetPoints(TracePointerVector &v) const noexcept;
+
+  /**
+   * Update the given #TracePointVector after points were appended to
+   * this object.  This must not be called after thinning has
+   * occurred, see GetModifySerial().
+   *
+   * @return true if new points were added
+   */
+  bool SyncPoints(TracePointerVector &v) const noexcept;
+
+  /**
+   * Fill the vector with trace points, not before #min_time, minimum
+   * resolution #min_distance.
+   */
+  void GetPoints(TracePointVector &v, Time min_time,
+                 const GeoPoint &location, double resolution) const noexcept;
+
+  const TracePoint &front() const noexcept {
+    assert(!empty());
+
+    return points[head];
+  }
+
+  const TracePoint &back() const noexcept {
+    assert(!empty());
+
+    return points[tail - 1];
+  }
+
+private:
+  /**
+   * Enforce the maximum duration, i.e. remove points that are too
+   * old.  This will be called before a new point is added, therefore
+   * the time stamp of the new point is passed to this method.
+   *
+   * This method is a no-op if no time window was configured.
+   */
+  void EnforceTimeWindow(Time latest_time) noexcept;
+
+  /**
+   * Helper function for Thin().
+   */
+  void Thin2() noexcept;
+
+  /**
+   * Thin the trace: remove old and irrelevant points to make room for
+   * more points.
+   */
+  void Thin() noexcept;
+
+  /**
+   * Move the given point from one array slot to another.
+   */
+  void Move(unsigned dest, unsigned src) noexcept;
+
+  /**
+   * Move all points to the beginning of the arrays.
+   */
+  void MoveToStart() noexcept;
+
+  [[gnu::pure]]
+  bool HeapLess(unsigned a, unsigned b) const noexcept;
+
+  void HeapSet(std::size_t position, unsigned i) noexcept {
+    heap[position] = i;
+    heap_position[i] = position;
+  }
+
+  void HeapSiftUp(std::size_t position) noexcept;
+  void HeapSiftDown(std::size_t position) noexcept;
+  void HeapPush(unsigned i) noexcept;
+  unsigned HeapPop() noexcept;
+
+  [[gnu::pure]]
+  unsigned CalcAverageDeltaDistance(Time no_thin) const noexcept;
+
+  [[gnu::pure]]
+  Time CalcAverageDeltaTime(Time no_thin) const noexcept;
+
+public:
+  unsigned GetAverageDeltaDistance() const noexcept {
+    return average_delta_distance;
+  }
+
+  Time GetAverageDeltaTime() const noexcept {
+    return average_delta_time;
+  }
+
+  class const_iterator {
+    friend class FlatTrace;
+
+    const TracePoint *p;
+
+    constexpr const_iterator(const TracePoint *_p) noexcept:p(_p) {}
+
+  public:
+    using iterator_category = std::bidirectional_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = const TracePoint;
+    using pointer = const TracePoint *;
+    using reference = const TracePoint &;
+
+    const_iterator() = default;
+
+    const TracePoint &operator*() const noexcept {
+      return *p;
+    }
+
+    const TracePoint *operator->() const noexcept {
+      return p;
+    }
+
+    const_iterator &operator++() noexcept {
+      ++p;
+      return *this;
+    }
+
+    const_iterator operator++(int) noexcept {
+      return p++;
+    }
+
+    const_iterator &operator--() noexcept {
+      --p;
+      return *this;
+    }
+
+    const_iterator operator--(int) noexcept {
+      return p--;
+    }
+
+    constexpr bool operator==(const const_iterator &other) const noexcept {
+      return p == other.p;
+    }
+
+    constexpr bool operator!=(const const_iterator &other) const noexcept {
+      return p != other.p;
+    }
+
+    const_iterator &NextSquareRange(unsigned sq_resolution,
+                                    const const_iterator &end) noexcept {
+      const TracePoint &previous = **this;
+      while (true) {
+        ++*this;
+
+        if (*this == end)
+          return *this;
+
+        if (p->FlatSquareDistanceTo(previous) >= sq_resolution)
+          return *this;
+      }
+    }
+  };
+
+  const_iterator begin() const noexcept {
+    return points.data() + head;
+  }
+
+  const_iterator end() const noexcept {
+    return points.data() + tail;
+  }
+
+  const TaskProjection &GetProjection() const noexcept {
+    return task_projection;
+  }
+
+  [[gnu::pure]]
+  unsigned ProjectRange(const GeoPoint &location, double distance) const noexcept {
+    return task_projection.ProjectRangeInteger(location, distance);
+  }
+};
@@ -1,15 +1,15 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 // Copyright The XCSoar Project
 
-#include "Trace.hpp"
+#include "ListTrace.hpp"
 #include "Vector.hpp"
 #include "util/GlobalSliceAllocator.hxx"
 
 #include <algorithm>
 #include <iterator>
 
-Trace::Trace(const Time _no_thin_time, const Time max_time,
-             const unsigned max_size) noexcept
+ListTrace::ListTrace(const Time _no_thin_time, const Time max_time,
+                     const unsigned max_size) noexcept
   :cached_size(0),
    max_time(max_time),
    no_thin_time(_no_thin_time),
@@ -20,7 +20,7 @@ Trace::Trace(const Time _no_thin_time, const Time max_time,
 }
 
 void
-Trace::clear() noexcept
+ListTrace::clear() noexcept
 {
   assert(cached_size == delta_list.size());
   assert(cached_size == chronological_list.size());
@@ -39,8 +39,8 @@ Trace::clear() noexcept
   ++append_serial;
 }
 
-Trace::Time
-Trace::GetRecentTime(const Time t) const noexcept
+ListTrace::Time
+ListTrace::GetRecentTime(const Time t) const noexcept
 {
   if (empty())
     return {};
@@ -53,7 +53,7 @@ Trace::GetRecentTime(const Time t) const noexcept
 }
 
 void
-Trace::UpdateDelta(TraceDelta &td) noexcept
+ListTrace::UpdateDelta(TraceDelta &td) noexcept
 {
   assert(cached_size == delta_list.size());
   assert(cached_size == chronological_list.size());
@@ -72,7 +72,7 @@ Trace::UpdateDelta(TraceDelta &td) noexcept
 }
 
 void
-Trace::EraseInside(DeltaList::iterator it) noexcept
+ListTrace::EraseInside(DeltaList::iterator it) noexcept
 {
   assert(cached_size > 0);
   assert(cached_size == delta_list.size());
@@ -97,7 +97,7 @@ Trace::EraseInside(DeltaList::iterator it) noexcept
 }
 
 bool
-Trace::EraseDelta(const unsigned target_size, const Time recent) noexcept
+ListTrace::EraseDelta(const unsigned target_size, const Time recent) noexcept
 {
   assert(cached_size == delta_list.size());
   assert(cached_size == chronological_list.size());
@@ -110,7 +110,7 @@ Trace::EraseDelta(const unsigned target_size, const Time recent) noexcept
   const Time recent_time = GetRecentTime(recent);
 
   auto candidate = delta_list.begin();
-  while (size() > target_size) {
+  while (size() > target_size && candidate != delta_list.end()) {
     const TraceDelta &td = *candidate;
     if (!td.IsEdge() && td.point.GetTime() < recent_time) {
       EraseInside(candidate);
@@ -126,7 +126,7 @@ Trace::EraseDelta(const unsigned target_size, const Time recent) noexcept
 }
 
 bool
-Trace::EraseEarlierThan(const Time p_time) noexcept
+ListTrace::EraseEarlierThan(const Time p_time) noexcept
 {
   if (p_time == Time{} || empty() || GetFront().point.GetTime() >= p_time)
     // there will be nothing to remove
@@ -155,7 +155,7 @@ Trace::EraseEarlierThan(const Time p_time) noexcept
 }
 
 void
-Trace::EraseLaterThan(const Time min_time) noexcept
+ListTrace::EraseLaterThan(const Time min_time) noexcept
 {
   assert(min_time.count() > 0);
   assert(!empty());
@@ -182,7 +182,7 @@ Trace::EraseLaterThan(const Time min_time) noexcept
  * Update start node (and neighbour) after min time pruning
  */
 void
-Trace::EraseStart(TraceDelta &td) noexcept
+ListTrace::EraseStart(TraceDelta &td) noexcept
 {
   delta_list.erase(delta_list.iterator_to(td));
 
@@ -193,7 +193,7 @@ Trace::EraseStart(TraceDelta &td) noexcept
 }
 
 void
-Trace::push_back(const TracePoint &point) noexcept
+ListTrace::push_back(const TracePoint &point) noexcept
 {
   assert(cached_size == delta_list.size());
   assert(cached_size == chronological_list.size());
@@ -246,7 +246,7 @@ Trace::push_back(const TracePoint &point) noexcept
 }
 
 unsigned
-Trace::CalcAverageDeltaDistance(const Time no_thin) const noexcept
+ListTrace::CalcAverageDeltaDistance(const Time no_thin) const noexcept
 {
   const Time r = GetRecentTime(no_thin);
   unsigned acc = 0;
@@ -263,8 +263,8 @@ Trace::CalcAverageDeltaDistance(const Time no_thin) const noexcept
   return 0;
 }
 
-Trace::Time
-Trace::CalcAverageDeltaTime(const Time no_thin) const noexcept
+ListTrace::Time
+ListTrace::CalcAverageDeltaTime(const Time no_thin) const noexcept
 {
   const Time r = GetRecentTime(no_thin);
   unsigned counter = 0;
@@ -287,7 +287,7 @@ Trace::CalcAverageDeltaTime(const Time no_thin) const noexcept
 }
 
 void
-Trace::EnforceTimeWindow(const Time latest_time) noexcept
+ListTrace::EnforceTimeWindow(const Time latest_time) noexcept
 {
   if (max_time == null_time)
     /* no time window configured */
@@ -303,7 +303,7 @@ Trace::EnforceTimeWindow(const Time latest_time) noexcept
 }
 
 inline void
-Trace::Thin2() noexcept
+ListTrace::Thin2() noexcept
 {
   const unsigned target_size = opt_size;
   assert(size() > target_size);
@@ -321,7 +321,7 @@ Trace::Thin2() noexcept
 }
 
 void
-Trace::Thin() noexcept
+ListTrace::Thin() noexcept
 {
   assert(cached_size == delta_list.size());
   assert(cached_size == chronological_list.size());
@@ -339,7 +339,7 @@ Trace::Thin() noexcept
 }
 
 void
-Trace::GetPoints(TracePointVector& iov) const noexcept
+ListTrace::GetPoints(TracePointVector& iov) const noexcept
 {
   iov.clear();
   iov.reserve(size());
@@ -384,7 +384,7 @@ public:
 };
 
 void
-Trace::GetPoints(TracePointerVector &v) const noexcept
+ListTrace::GetPoints(TracePointerVector &v) const noexcept
 {
   v.clear();
   v.reserve(size());
@@ -394,7 +394,7 @@ Trace::GetPoints(TracePointerVector &v) const noexcept
 }
 
 bool
-Trace::SyncPoints(TracePointerVector &v) const noexcept
+ListTrace::SyncPoints(TracePointerVector &v) const noexcept
 {
   assert(v.size() <= size());
 
@@ -412,12 +412,12 @@ Trace::SyncPoints(TracePointerVector &v) const noexcept
 }
 
 void
-Trace::GetPoints(TracePointVector &v, const Time min_time,
-                 const GeoPoint &location,
-                 double min_distance) const noexcept
+ListTrace::GetPoints(TracePointVector &v, const Time min_time,
+                     const GeoPoint &location,
+                     double min_distance) const noexcept
 {
   /* skip the trace points that are before min_time */
-  Trace::const_iterator i = begin(), end = this->end();
+  ListTrace::const_iterator i = begin(), end = this->end();
   unsigned skipped = 0;
   while (true) {
     if (i == end)
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Point.hpp"
+
+#include <algorithm>
+
+#include <stdlib.h>
+
+/**
+ * The thinning metrics shared by the #Trace implementations.  Both
+ * must use the same formulas and the same ranking to produce
+ * identical results.
+ */
+namespace TraceMetric {
+
+using Time = TracePoint::Time;
+
+/**
+ * Calculate error distance, between last through this to next,
+ * if this node is removed.  This metric provides for Douglas-Peuker
+ * thinning.
+ *
+ * @param last Point previous in time to this node
+ * @param node This node
+ * @param next Point succeeding this node
+ *
+ * @return Distance error if this node is thinned
+ */
+[[gnu::pure]]
+inline unsigned
+DistanceMetric(const TracePoint &last, const TracePoint &node,
+               const TracePoint &next) noexcept
+{
+  const int d_this = last.FlatDistanceTo(node) + node.FlatDistanceTo(next);
+  const int d_rem = last.FlatDistanceTo(next);
+  return abs(d_this - d_rem);
+}
+
+/**
+ * Calculate error time, between last through this to next,
+ * if this node is removed.  This metric provides for fair thinning
+ * (tendency to to result in equal time steps)
+ *
+ * @param last Point previous in time to this node
+ * @param node This node
+ * @param next Point succeeding this node
+ *
+ * @return Time delta if this node is thinned
+ */
+constexpr Time
+TimeMetric(const TracePoint &last, const TracePoint &node,
+           const TracePoint &next) noexcept
+{
+  return next.DeltaTime(last)
+    - std::min(next.DeltaTime(node), node.DeltaTime(last));
+}
+
+/**
+ * Function used to points for sorting by deltas.
+ * Ranking is primarily by distance delta; for equal distances, rank by
+ * time delta.
+ * This is like a modified Douglas-Peuker algorithm
+ *
+ * @return true if #x shall be thinned before #y
+ */
+constexpr bool
+Rank(unsigned x_distance, Time x_time, const TracePoint &x,
+     unsigned y_distance, Time y_time, const TracePoint &y) noexcept
+{
+  // distance is king
+  if (x_distance < y_distance)
+    return true;
+
+  if (x_distance > y_distance)
+    return false;
+
+  // distance is equal, so go by time error
+  if (x_time < y_time)
+    return true;
+
+  if (x_time > y_time)
+    return false;
+
+  // all else fails, go by age
+  return x.IsOlderThan(y);
+}
+
+} // namespace TraceMetric
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Snapshot.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+TraceSnapshot::TraceSnapshot(const Trace &trace) noexcept
+  :projection(trace.GetProjection()),
+   append_serial(trace.GetAppendSerial()),
+   modify_serial(trace.GetModifySerial())
+{
+  trace.GetPoints(points);
+}
+
+TraceSnapshot::TraceSnapshot(const TraceSnapshot &previous,
+                             const Trace &trace) noexcept
+  :projection(trace.GetProjection()),
+   append_serial(trace.GetAppendSerial()),
+   modify_serial(trace.GetModifySerial())
+{
+  if (previous.modify_serial != modify_serial ||
+      previous.size() > trace.size()) {
+    trace.GetPoints(points);
+    return;
+  }
+
+  /* the trace has only been appended to: copy the old points from
+     the previous snapshot's contiguous vector (which is faster than
+     walking the list, but still O(n)) and walk only the new ones in
+     the list */
+  points.reserve(trace.size());
+  points.assign(previous.points.begin(), previous.points.end());
+  std::copy(std::prev(trace.end(), trace.size() - previous.size()),
+            trace.end(), std::back_inserter(points));
+  assert(points.size() == trace.size());
+}
+
+bool
+TraceSnapshot::IsCurrent(const Trace &trace) const noexcept
+{
+  return append_serial == trace.GetAppendSerial() &&
+    modify_serial == trace.GetModifySerial();
+}
+
+void
+TraceSnapshot::GetPoints(TracePointVector &v, const Time min_time,
+                         const GeoPoint &location,
+                         double min_distance) const noexcept
+{
+  /* skip the trace points that are before min_time */
+  auto i = std::find_if(points.begin(), points.end(),
+                        [min_time](const TracePoint &p){
+                          return p.GetTime() >= min_time;
+                        });
+  if (i == points.end())
+    /* nothing left */
+    return;
+
+  v.reserve(std::distance(i, points.end()));
+
+  const unsigned range =
+    projection.ProjectRangeInteger(location, min_distance);
+  const unsigned sq_range = range * range;
+
+  const TracePoint *previous = &*i;
+  v.push_back(*previous);
+  for (++i; i != points.end(); ++i) {
+    if (i->FlatSquareDistanceTo(*previous) >= sq_range) {
+      previous = &*i;
+      v.push_back(*previous);
+    }
+  }
+}
@@ -0,0 +1,92 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Vector.hpp"
+#include "util/Serial.hpp"
+#include "Geo/Flat/TaskProjection.hpp"
+
+class Trace;
+
+/**
+ * An immutable copy of a #Trace, tagged with the trace's serials at
+ * the time it was taken.  It is meant to be published through a
+ * std::shared_ptr: the owner of the #Trace creates a new snapshot
+ * after modifying it, and readers in other threads keep a reference
+ * to the snapshot as long as they need it, without copying the
+ * points and without locking the #Trace.
+ */
+class TraceSnapshot {
+  TracePointVector points;
+
+  /**
+   * A copy of the trace's projection, which was used to calculate
+   * the flat locations of #points.
+   */
+  TaskProjection projection;
+
+  Serial append_serial, modify_serial;
+
+public:
+  using Time = TracePoint::Time;
+
+  /**
+   * Create an empty snapshot.
+   */
+  TraceSnapshot() noexcept = default;
+
+  /**
+   * Copy all points of the given #Trace.
+   */
+  explicit TraceSnapshot(const Trace &trace) noexcept;
+
+  /**
+   * Create a snapshot of the given #Trace.  If it has only been
+   * appended to since the previous snapshot was taken (i.e. the
+   * modify serial is unchanged), the old points are copied from the
+   * previous snapshot's vector and only the new ones are read from
+   * the #Trace's linked list.  This is still O(n), because every
+   * snapshot owns a complete copy of the points.
+   */
+  TraceSnapshot(const TraceSnapshot &previous, const Trace &trace) noexcept;
+
+  /**
+   * Was this snapshot taken of the current state of the given
+   * #Trace?
+   */
+  [[gnu::pure]]
+  bool IsCurrent(const Trace &trace) const noexcept;
+
+  const Serial &GetAppendSerial() const noexcept {
+    return append_serial;
+  }
+
+  const Serial &GetModifySerial() const noexcept {
+    return modify_serial;
+  }
+
+  bool empty() const noexcept {
+    return points.empty();
+  }
+
+  std::size_t size() const noexcept {
+    return points.size();
+  }
+
+  /**
+   * Returns all trace points, sorted by time.
+   */
+  const TracePointVector &GetPoints() const noexcept {
+    return points;
+  }
+
+  /**
+   * Fill the vector with trace points, not before #min_time, minimum
+   * resolution #min_distance.  This is equivalent to the same
+   * method of #Trace.
+   */
+  void GetPoints(TracePointVector &v, Time min_time,
+                 const GeoPoint &location,
+                 double min_distance) const noexcept;
+};
@@ -5,8 +5,13 @@
 #include "util/AllocatedArray.hxx"
 #include "util/StringUtil.hpp"
 #include "Math/Classify.hpp"
+#include "Geo/FAISphere.hpp"
+
+#include <algorithm>
+#include <iterator>
 
 #include <cassert>
+#include <math.h>
 
 static constexpr std::size_t NORMALIZE_BUFFER_SIZE = 4096;
 
@@ -60,6 +65,35 @@ Waypoints::WaypointNameTree::Add(WaypointPtr wp) noexcept
   }
 }
 
+inline void
+Waypoints::WaypointNameTree::Add(std::span<const WaypointPtr> wps) noexcept
+{
+  /* normalise all keys into one buffer, in the same order as
+     Add(WaypointPtr) */
+  std::size_t buffer_size = 0;
+  for (const auto &wp : wps)
+    buffer_size += wp->name.length() + wp->shortname.length() + 2;
+
+  AllocatedArray<char> buffer(buffer_size);
+  std::vector<KeyValue> items;
+  items.reserve(wps.size() * 2);
+
+  char *p = buffer.data();
+  for (const auto &wp : wps) {
+    NormalizeSearchString(p, wp->name);
+    items.emplace_back(p, wp);
+    p += wp->name.length() + 1;
+
+    if (!wp->shortname.empty()) {
+      NormalizeSearchString(p, wp->shortname);
+      items.emplace_back(p, wp);
+      p += wp->shortname.length() + 1;
+    }
+  }
+
+  AddAll(items);
+}
+
 inline void
 Waypoints::WaypointNameTree::Remove(const WaypointPtr &wp) noexcept
 {
@@ -94,8 +128,8 @@ Waypoints::Optimise() noexcept
   waypoint_tree.Optimise();
 }
 
-void
-Waypoints::Append(WaypointPtr wp) noexcept
+inline void
+Waypoints::AppendToTree(const WaypointPtr &wp) noexcept
 {
   // TODO: eliminate this const_cast hack
   Waypoint &w = const_cast<Waypoint &>(*wp);
@@ -113,11 +147,47 @@ Waypoints::Append(WaypointPtr wp) noexcept
   w.id = next_id++;
 
   waypoint_tree.Add(wp);
+}
+
+void
+Waypoints::Append(WaypointPtr wp) noexcept
+{
+  AppendToTree(wp);
   name_tree.Add(wp);
 
   ++serial;
 }
 
+void
+Waypoints::Append(std::vector<Waypoint> &&waypoints) noexcept
+{
+  if (waypoints.empty())
+    return;
+
+  /* rebuilding the name tree is only worth it if it does not
+     contain many more waypoints already */
+  const bool rebuild = waypoints.size() >= size();
+
+  std::vector<WaypointPtr> wps;
+  wps.reserve(waypoints.size());
+
+  for (auto &i : waypoints) {
+    WaypointPtr wp(new Waypoint(std::move(i)));
+    if (rebuild)
+      AppendToTree(wp);
+    else
+      Append(wp);
+    wps.push_back(std::move(wp));
+  }
+
+  waypoints.clear();
+
+  if (rebuild)
+    name_tree.Add(wps);
+
+  ++serial;
+}
+
 WaypointPtr
 Waypoints::GetNearest(const GeoPoint &loc, double range) const noexcept
 {
@@ -168,6 +238,65 @@ Waypoints::GetNearestIf(const GeoPoint &loc, double range,
   return *found.first;
 }
 
+std::vector<WaypointPtr>
+Waypoints::GetNearestIf(const GeoPoint &loc, double range,
+                        bool (*predicate)(const Waypoint &),
+                        std::size_t n) const noexcept
+{
+  std::vector<WaypointPtr> result;
+  if (IsEmpty())
+    return result;
+
+  const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
+  const WaypointTree::Point point(flat_location.x, flat_location.y);
+  const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
+  waypoint_tree.FindNearestIf(point, mrange,
+                              [predicate](const WaypointPtr &ptr){
+                                return predicate(*ptr);
+                              },
+                              n, std::back_inserter(result));
+  return result;
+}
+
+void
+Waypoints::VisitNearestIf(const GeoPoint &loc, double range,
+                          bool (*predicate)(const Waypoint &),
+                          const NearestWaypointVisitor &visitor) const
+{
+  if (IsEmpty())
+    return;
+
+  const FlatGeoPoint flat_location = task_projection.ProjectInteger(loc);
+  const WaypointTree::Point point(flat_location.x, flat_location.y);
+  const unsigned mrange = task_projection.ProjectRangeInteger(loc, range);
+
+  /* convert flat distances to a lower bound of the real distance:
+     east-west distances are stretched by up to cos(center)/cos(lat)
+     at latitudes farther from the equator than the projection
+     center, both points were rounded to integers, and the projection
+     uses the FAI sphere instead of the WGS84 ellipsoid */
+  const Angle max_latitude =
+    loc.latitude.Absolute() + FAISphere::EarthDistanceToAngle(range);
+  const double center_cos =
+    std::max(task_projection.GetCenter().latitude.cos(), 0.01);
+  const double stretch =
+    std::clamp(max_latitude.cos() / center_cos, 0., 1.);
+  const double metres_per_unit =
+    0.98 * stretch / task_projection.ProjectRangeFloat(loc, 1);
+
+  waypoint_tree.VisitNearestIf(point, mrange,
+                               [predicate](const WaypointPtr &ptr){
+                                 return predicate(*ptr);
+                               },
+                               [&visitor, metres_per_unit](const WaypointPtr &wp,
+                                                           unsigned square_distance){
+                                 const double distance =
+                                   std::max(sqrt(double(square_distance)) - 1.5,
+                                            0.);
+                                 return visitor(wp, distance * metres_per_unit);
+                               });
+}
+
 WaypointPtr
 Waypoints::LookupName(std::string_view name) const noexcept
 {
@@ -10,11 +10,21 @@
 #include "util/QuadTree.hxx"
 #include "util/Serial.hpp"
 
+#include <span>
 #include <string_view>
 #include <functional>
+#include <vector>
 
 using WaypointVisitor = std::function<void(const WaypointPtr &)>;
 
+/**
+ * A visitor for Waypoints::VisitNearestIf().  The second parameter is
+ * a lower bound for the distance (m) of this and all following
+ * waypoints.  It returns false to stop the search.
+ */
+using NearestWaypointVisitor =
+  std::function<bool(const WaypointPtr &, double)>;
+
 /**
  * Container for waypoints using kd-tree representation internally for
  * fast geospatial lookups.
@@ -50,6 +60,12 @@ class Waypoints {
     char *SuggestNormalisedPrefix(std::string_view prefix,
                                    char *dest, size_t max_length) const noexcept;
     void Add(WaypointPtr wp) noexcept;
+
+    /**
+     * Add many waypoints at once, see RadixTree::AddAll().
+     */
+    void Add(std::span<const WaypointPtr> wps) noexcept;
+
     void Remove(const WaypointPtr &wp) noexcept;
   };
 
@@ -66,6 +82,11 @@ class Waypoints {
 
   WaypointPtr home;
 
+  /**
+   * The part of Append() which does not touch the name tree.
+   */
+  void AppendToTree(const WaypointPtr &wp) noexcept;
+
 public:
   using const_iterator = WaypointTree::const_iterator;
 
@@ -107,6 +128,17 @@ public:
     return ptr;
   }
 
+  /**
+   * Add many waypoints to the internal store, e.g. all waypoints of
+   * a file.  This is equivalent to calling Append() for each of
+   * them, but if there are not many more waypoints in the store
+   * already, the name tree is rebuilt in one pass, which is much
+   * faster.
+   *
+   * @param waypoints the waypoints to add; they are moved from
+   */
+  void Append(std::vector<Waypoint> &&waypoints) noexcept;
+
   /**
    * Erase waypoint from the internal store.  Requires Optimise() to
    * be called afterwards
@@ -342,6 +374,31 @@ public:
   WaypointPtr GetNearestIf(const GeoPoint &loc, double range,
                            bool (*predicate)(const Waypoint &)) const noexcept;
 
+  /**
+   * Looks up the (up to) #n nearest waypoints within the given range
+   * which match the predicate.  Performs search according to
+   * flat-earth internal representation, so is approximate.
+   *
+   * @return the waypoints, nearest first
+   */
+  std::vector<WaypointPtr> GetNearestIf(const GeoPoint &loc, double range,
+                                        bool (*predicate)(const Waypoint &),
+                                        std::size_t n) const noexcept;
+
+  /**
+   * Call the visitor for the waypoints within the given range which
+   * match the predicate, in ascending order of their flat-earth
+   * distance, until the visitor returns false.  This allows "best
+   * first" searches which stop as soon as the remaining waypoints
+   * cannot be better than the ones found so far.
+   *
+   * The distance bound passed to the visitor is conservative: it
+   * accounts for the distortion of the flat-earth projection.
+   */
+  void VisitNearestIf(const GeoPoint &loc, double range,
+                      bool (*predicate)(const Waypoint &),
+                      const NearestWaypointVisitor &visitor) const;
+
   /**
    * Access first waypoint in store, for use in iterators.
    *
@@ -40,6 +40,64 @@ isLeft( const FlatGeoPoint &P0, const FlatGeoPoint &P1, const FlatGeoPoint &P2 )
 
 //===================================================================
 
+/**
+ * The contribution of the edge from #a to #b to the winding number
+ * of #P.
+ */
+static inline int
+WindingNumber(const GeoPoint &P, const GeoPoint &a, const GeoPoint &b)
+{
+  // edge from current to next
+  if (a.latitude <= P.latitude) {
+    // start y <= P.latitude
+
+    if (b.latitude > P.latitude)
+      // an upward crossing
+      if (isLeft(a, b, P) > 0)
+        // P left of edge
+        // have a valid up intersect
+        return 1;
+  } else {
+    // start y > P.latitude (no test needed)
+
+    if (b.latitude <= P.latitude)
+      // a downward crossing
+      if (isLeft(a, b, P) < 0)
+        // P right of edge
+        // have a valid down intersect
+        return -1;
+  }
+
+  return 0;
+}
+
+static inline int
+WindingNumber(const FlatGeoPoint &P, const FlatGeoPoint &a,
+              const FlatGeoPoint &b)
+{
+  // edge from current to next
+  if (a.y <= P.y) {
+    // start y <= P.y
+    if (b.y > P.y)
+      // an upward crossing
+      if (isLeft(a, b, P) > 0)
+        // P left of edge
+        // have a valid up intersect
+        return 1;
+  } else {
+    // start y > P.y (no test needed)
+
+    if (b.y <= P.y)
+      // a downward crossing
+      if (isLeft(a, b, P) < 0)
+        // P right of edge
+        // have a valid down intersect
+        return -1;
+  }
+
+  return 0;
+}
+
 // PolygonInterior(): winding number interior test for a point in a polygon
 //      Input:   P = a point,
 //               V[] = vertex points of a polygon V[n+1] with V[n]=V[0]
@@ -57,28 +115,9 @@ PolygonInterior(const GeoPoint &P,
 
   // loop through all edges of the polygon
   for (auto i = begin, next = std::next(i); next != end;
-       i = next, next = std::next(i)) {
-    // edge from current to next
-    if (i->GetLocation().latitude <= P.latitude) {
-      // start y <= P.latitude
-
-      if (next->GetLocation().latitude > P.latitude)
-        // an upward crossing
-        if (isLeft(i->GetLocation(), next->GetLocation(), P) > 0)
-          // P left of edge
-          // have a valid up intersect
-          ++wn;
-    } else {
-      // start y > P.latitude (no test needed)
-
-      if (next->GetLocation().latitude <= P.latitude)
-        // a downward crossing
-        if (isLeft(i->GetLocation(), next->GetLocation(), P) < 0)
-          // P right of edge
-          // have a valid down intersect
-          --wn;
-    }
-  }
+       i = next, next = std::next(i))
+    wn += WindingNumber(P, i->GetLocation(), next->GetLocation());
+
   return wn != 0;
 }
 
@@ -95,28 +134,23 @@ PolygonInterior(const FlatGeoPoint &P,
 
   // loop through all edges of the polygon
   for (auto i = begin, next = std::next(i); next != end;
-       i = next, next = std::next(i)) {
-    // edge from current to next
-    if (i->GetFlatLocation().y <= P.y) {
-      // start y <= P.y
-      if (next->GetFlatLocation().y > P.y)
-        // an upward crossing
-        if (isLeft(i->GetFlatLocation(), next->GetFlatLocation(), P) > 0)
-          // P left of edge
-          // have a valid up intersect
-          ++wn;
-    } else {
-      // start y > P.y (no test needed)
-
-      if (next->GetFlatLocation().y <= P.y)
-        // a downward crossing
-        if (isLeft(i->GetFlatLocation(), next->GetFlatLocation(), P) < 0)
-          // P right of edge
-          // have a valid down intersect
-          --wn;
-    }
-  }
+       i = next, next = std::next(i))
+    wn += WindingNumber(P, i->GetFlatLocation(), next->GetFlatLocation());
+
   return wn != 0;
 }
 
+bool
+PolygonInterior(const GeoPoint &P, const SearchPointVector &polygon,
+                std::span<const unsigned> edges)
+{
+  if (polygon.size() < 3)
+    return false;
+
+  int wn = 0;
+  for (const unsigned i : edges)
+    wn += WindingNumber(P, polygon[i].GetLocation(),
+                        polygon[i + 1].GetLocation());
 
+  return wn != 0;
+}
@@ -5,6 +5,8 @@
 
 #include "Geo/SearchPointVector.hpp"
 
+#include <span>
+
 struct GeoPoint;
 struct FlatGeoPoint;
 class SearchPoint;
@@ -24,3 +26,14 @@ bool
 PolygonInterior(const FlatGeoPoint &p,
                 SearchPointVector::const_iterator begin,
                 SearchPointVector::const_iterator end);
+
+/**
+ * Like PolygonInterior(), but only the given edges (index of the
+ * first point of each edge) contribute to the winding number.  The
+ * result is the same as long as #edges contains all edges whose
+ * latitude range includes the latitude of #p (see #PolygonSlabIndex).
+ */
+[[gnu::pure]]
+bool
+PolygonInterior(const GeoPoint &p, const SearchPointVector &polygon,
+                std::span<const unsigned> edges);
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "PolygonSlabIndex.hpp"
+#include "SearchPointVector.hpp"
+#include "ConvexHull/PolygonInterior.hpp"
+
+#include <cassert>
+#include <cmath>
+
+template<typename Y>
+void
+PolygonSlabIndex::Slabs::Build(const std::size_t n_points, Y &&get_y) noexcept
+{
+  assert(n_points >= 2);
+
+  const unsigned n_edges = n_points - 1;
+
+  double y_min = get_y(0), y_max = y_min;
+  for (std::size_t i = 1; i < n_points; ++i) {
+    const double y = get_y(i);
+    y_min = std::min(y_min, y);
+    y_max = std::max(y_max, y);
+  }
+
+  /* on average, a slab is crossed by a few edges plus the edges
+     which lie inside it */
+  const unsigned n_slabs = std::max(n_edges / 4, 1U);
+
+  origin = y_min;
+  scale = y_max > y_min ? n_slabs / (y_max - y_min) : 0;
+
+  offsets.assign(n_slabs + 1, 0);
+  first_slab.resize(n_edges);
+
+  /* pass 1: count the edges of each slab */
+  for (unsigned i = 0; i < n_edges; ++i) {
+    const double a = get_y(i), b = get_y(i + 1);
+    const unsigned first = FindSlab(std::min(a, b)),
+      last = FindSlab(std::max(a, b));
+    first_slab[i] = first;
+    for (unsigned slab = first; slab <= last; ++slab)
+      ++offsets[slab + 1];
+  }
+
+  for (unsigned slab = 0; slab < n_slabs; ++slab)
+    offsets[slab + 1] += offsets[slab];
+
+  /* pass 2: fill the edge lists (in ascending edge order) */
+  edges.resize(offsets.back());
+  std::vector<unsigned> fill(offsets.begin(), std::prev(offsets.end()));
+  for (unsigned i = 0; i < n_edges; ++i) {
+    const double a = get_y(i), b = get_y(i + 1);
+    const unsigned last = FindSlab(std::max(a, b));
+    for (unsigned slab = first_slab[i]; slab <= last; ++slab)
+      edges[fill[slab]++] = i;
+  }
+}
+
+unsigned
+PolygonSlabIndex::Slabs::FindSlab(double y) const noexcept
+{
+  assert(!offsets.empty());
+
+  /* this is monotonic in y, which guarantees that an edge's slab
+     range includes the slab of each point within its vertical
+     extent; values outside of the polygon are clamped to the
+     outermost slabs */
+  const double slab = std::floor((y - origin) * scale);
+  const unsigned n_slabs = offsets.size() - 1;
+  if (!(slab > 0))
+    return 0;
+
+  if (slab >= n_slabs)
+    return n_slabs - 1;
+
+  return unsigned(slab);
+}
+
+void
+PolygonSlabIndex::Build(const SearchPointVector &polygon) noexcept
+{
+  Clear();
+
+  if (polygon.size() < MIN_POINTS)
+    return;
+
+  geo.Build(polygon.size(), [&polygon](std::size_t i){
+    return polygon[i].GetLocation().latitude.Native();
+  });
+
+  flat.Build(polygon.size(), [&polygon](std::size_t i){
+    return double(polygon[i].GetFlatLocation().y);
+  });
+}
+
+bool
+PolygonSlabIndex::IsInside(const SearchPointVector &polygon,
+                           const GeoPoint &p) const noexcept
+{
+  assert(!empty());
+
+  return PolygonInterior(p, polygon,
+                         geo.GetEdges(geo.FindSlab(p.latitude.Native())));
+}
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Flat/FlatGeoPoint.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+struct GeoPoint;
+class SearchPointVector;
+
+/**
+ * An acceleration structure for point-in-polygon and intersection
+ * tests on large closed polygons.
+ *
+ * The vertical extent of the polygon is divided into horizontal
+ * slabs of equal height, and each slab has a list of the edges which
+ * overlap it vertically.  A test then only needs to look at the
+ * edges of the slabs it touches, instead of all edges.  Since the
+ * same per-edge test is applied to a superset of all relevant edges,
+ * the results are identical to a linear scan.
+ *
+ * There are two sets of slabs: one in geographic coordinates (for
+ * PolygonInterior()) and one in the flat projection (for ray
+ * intersections).  The index must be rebuilt after the polygon was
+ * modified or projected.
+ */
+class PolygonSlabIndex {
+  class Slabs {
+    double origin, scale;
+
+    /**
+     * The edges of slab i are edges[offsets[i]..offsets[i+1]].
+     */
+    std::vector<unsigned> offsets;
+    std::vector<unsigned> edges;
+
+    /**
+     * The lowest slab of each edge.
+     */
+    std::vector<unsigned> first_slab;
+
+  public:
+    template<typename Y>
+    void Build(std::size_t n_points, Y &&get_y) noexcept;
+
+    void Clear() noexcept {
+      offsets.clear();
+      edges.clear();
+      first_slab.clear();
+    }
+
+    bool empty() const noexcept {
+      return offsets.empty();
+    }
+
+    [[gnu::pure]]
+    unsigned FindSlab(double y) const noexcept;
+
+    std::span<const unsigned> GetEdges(unsigned slab) const noexcept {
+      return std::span{edges}.subspan(offsets[slab],
+                                      offsets[slab + 1] - offsets[slab]);
+    }
+
+    /**
+     * Invoke a function once for each edge that overlaps the given
+     * vertical range.
+     */
+    template<typename F>
+    void VisitEdges(double y_min, double y_max, F &&f) const noexcept {
+      const unsigned first = FindSlab(y_min), last = FindSlab(y_max);
+      for (unsigned slab = first; slab <= last; ++slab)
+        for (const unsigned i : GetEdges(slab))
+          /* visit edges spanning several slabs only once */
+          if (slab == first || first_slab[i] == slab)
+            f(i);
+    }
+
+    std::size_t GetMemoryUsage() const noexcept {
+      return (offsets.capacity() + edges.capacity() +
+              first_slab.capacity()) * sizeof(unsigned);
+    }
+  };
+
+  Slabs geo, flat;
+
+public:
+  /**
+   * Polygons with fewer points than this are not worth indexing.
+   */
+  static constexpr std::size_t MIN_POINTS = 32;
+
+  /**
+   * Build the index for the given closed polygon, which must have
+   * been projected already.  Does nothing if the polygon is too
+   * small.
+   */
+  void Build(const SearchPointVector &polygon) noexcept;
+
+  void Clear() noexcept {
+    geo.Clear();
+    flat.Clear();
+  }
+
+  bool empty() const noexcept {
+    return geo.empty();
+  }
+
+  /**
+   * Like SearchPointVector::IsInside(), but sub-linear.
+   */
+  [[gnu::pure]]
+  bool IsInside(const SearchPointVector &polygon,
+                const GeoPoint &p) const noexcept;
+
+  /**
+   * Invoke a function once for each edge (index of its first point)
+   * whose flat vertical extent overlaps the vertical extent of the
+   * flat line from #a to #b.
+   */
+  template<typename F>
+  void VisitEdges(FlatGeoPoint a, FlatGeoPoint b, F &&f) const noexcept {
+    flat.VisitEdges(std::min(a.y, b.y), std::max(a.y, b.y), f);
+  }
+
+  std::size_t GetMemoryUsage() const noexcept {
+    return geo.GetMemoryUsage() + flat.GetMemoryUsage();
+  }
+};
@@ -17,9 +17,9 @@
 bool
 TrailRenderer::LoadTrace(const TraceComputer &trace_computer) noexcept
 {
-  trace.clear();
-  trace_computer.LockedCopyTo(trace);
-  return !trace.empty();
+  snapshot = trace_computer.GetSnapshot();
+  trace = &snapshot->GetPoints();
+  return !trace->empty();
 }
 
 bool
@@ -27,12 +27,14 @@ TrailRenderer::LoadTrace(const TraceComputer &trace_computer,
                          TimeStamp min_time,
                          const WindowProjection &projection) noexcept
 {
-  trace.clear();
-  trace_computer.LockedCopyTo(trace,
-                              min_time.Cast<std::chrono::duration<unsigned>>(),
-                              projection.GetGeoScreenCenter(),
-                              projection.DistancePixelsToMeters(3));
-  return !trace.empty();
+  snapshot = trace_computer.GetSnapshot();
+  filtered.clear();
+  snapshot->GetPoints(filtered,
+                      min_time.Cast<std::chrono::duration<unsigned>>(),
+                      projection.GetGeoScreenCenter(),
+                      projection.DistancePixelsToMeters(3));
+  trace = &filtered;
+  return !trace->empty();
 }
 
 /**
@@ -113,7 +115,7 @@ TrailRenderer::Draw(Canvas &canvas, const TraceComputer &trace_computer,
     traildrift = basic.location - tp1;
   }
 
-  auto minmax = GetMinMax(settings.type, trace);
+  auto minmax = GetMinMax(settings.type, *trace);
   auto value_min = minmax.first;
   auto value_max = minmax.second;
 
@@ -124,7 +126,7 @@ TrailRenderer::Draw(Canvas &canvas, const TraceComputer &trace_computer,
 
   PixelPoint last_point(0, 0);
   bool last_valid = false;
-  for (const auto &i : trace) {
+  for (const auto &i : *trace) {
     const GeoPoint gp = enable_traildrift
       ? i.GetLocation().Parametric(traildrift, i.CalculateDrift(basic.time))
       : i.GetLocation();
@@ -184,7 +186,7 @@ void
 TrailRenderer::Draw(Canvas &canvas, const WindowProjection &projection) noexcept
 {
   canvas.Select(look.trace_pen);
-  DrawTraceVector(canvas, projection, trace);
+  DrawTraceVector(canvas, projection, *trace);
 }
 
 void
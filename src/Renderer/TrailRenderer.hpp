@@ -8,10 +8,13 @@
 #include "Engine/Trace/Vector.hpp"
 #include "time/Stamp.hpp"
 
+#include <memory>
+
 struct PixelPoint;
 struct BulkPixelPoint;
 class Canvas;
 class TraceComputer;
+class TraceSnapshot;
 class Projection;
 class WindowProjection;
 class ContestTraceVector;
@@ -29,14 +32,34 @@ struct TrailSettings;
 class TrailRenderer {
   const TrailLook &look;
 
-  TracePointVector trace;
+  /**
+   * The trace snapshot obtained by the last LoadTrace() call.  The
+   * reference keeps it alive while #trace points into it.
+   */
+  std::shared_ptr<const TraceSnapshot> snapshot;
+
+  /**
+   * A buffer for the filtered trace.
+   */
+  TracePointVector filtered;
+
+  /**
+   * The points loaded by LoadTrace(): either the points of
+   * #snapshot or #filtered.
+   */
+  const TracePointVector *trace = &filtered;
+
   AllocatedArray<BulkPixelPoint> points;
 
 public:
   TrailRenderer(const TrailLook &_look) noexcept:look(_look) {}
 
+  TrailRenderer(const TrailRenderer &) = delete;
+  TrailRenderer &operator=(const TrailRenderer &) = delete;
+
   /**
-   * Load the full trace into this object.
+   * Load the full trace into this object.  This does not copy the
+   * points; it only keeps a reference to the current snapshot.
    */
   bool LoadTrace(const TraceComputer &trace_computer) noexcept;
 
@@ -48,7 +71,7 @@ public:
                  const WindowProjection &projection) noexcept;
 
   void ScanBounds(GeoBounds &bounds) const noexcept {
-    trace.ScanBounds(bounds);
+    trace->ScanBounds(bounds);
   }
 
   void Draw(Canvas &canvas, const TraceComputer &trace_computer,
@@ -522,7 +522,7 @@ Startup(UI::Display &display)
   // Reads the airspace files
   {
     SubOperationEnvironment sub_env(operation, 768, 1024);
-    ReadAirspace(*data_components->airspaces,
+    ReadAirspace(*data_components->airspaces, file_cache,
                  computer_settings.pressure,
                  sub_env);
   }
@@ -738,6 +738,7 @@ Shutdown()
 
     if (backend_components->calculation_thread && backend_components->calculation_thread->IsDefined()) {
       backend_components->calculation_thread->Join();
+      LogCalculationTiming(backend_components->calculation_thread->GetTiming());
       backend_components->calculation_thread.reset();
     }
   }
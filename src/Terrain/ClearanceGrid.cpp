@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "ClearanceGrid.hpp"
+#include "RasterTileCache.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+void
+ClearanceGrid::Clear() noexcept
+{
+  cache = nullptr;
+  blocks.clear();
+}
+
+void
+ClearanceGrid::Update(const RasterTileCache &_cache) noexcept
+{
+  if (&_cache == cache && _cache.GetSerial() == serial)
+    return;
+
+  cache = &_cache;
+  serial = _cache.GetSerial();
+
+  const auto size = _cache.GetSize();
+  constexpr unsigned CELL_MASK = (1u << CELL_BITS) - 1;
+  n_cells = {
+    (size.x + CELL_MASK) >> CELL_BITS,
+    (size.y + CELL_MASK) >> CELL_BITS,
+  };
+  n_blocks = {
+    (n_cells.x + BLOCK_SIZE - 1) >> BLOCK_BITS,
+    (n_cells.y + BLOCK_SIZE - 1) >> BLOCK_BITS,
+  };
+
+  blocks.clear();
+  blocks.resize(n_blocks.x * n_blocks.y);
+}
+
+std::optional<int>
+ClearanceGrid::GetCell(unsigned x, unsigned y) noexcept
+{
+  assert(cache != nullptr);
+  assert(x < n_cells.x);
+  assert(y < n_cells.y);
+
+  auto &block = blocks[(y >> BLOCK_BITS) * n_blocks.x + (x >> BLOCK_BITS)];
+  if (!block) {
+    block = std::make_unique<Block>();
+    block->fill(UNKNOWN);
+  }
+
+  auto &cell = (*block)[(y % BLOCK_SIZE) * BLOCK_SIZE + (x % BLOCK_SIZE)];
+  if (cell == UNKNOWN) {
+    const auto size = cache->GetSize();
+    const RasterLocation start{x << CELL_BITS, y << CELL_BITS};
+    const RasterLocation end{
+      std::min((x + 1) << CELL_BITS, size.x),
+      std::min((y + 1) << CELL_BITS, size.y),
+    };
+
+    const auto h = cache->GetMaximumHeight(start, end);
+    cell = h ? int16_t(*h) : INVALID;
+  }
+
+  if (cell == INVALID)
+    return std::nullopt;
+
+  return cell;
+}
+
+bool
+ClearanceGrid::IsBelow(const SignedRasterLocation a,
+                       const SignedRasterLocation b,
+                       const int height, const int slope_fact,
+                       const int max_height) noexcept
+{
+  assert(cache != nullptr);
+
+  /* walk along the major axis one cell column at a time, and check
+     all cells which the line touches in this column; the minor range
+     is widened by one pixel because the raster walk in
+     RasterTileCache::FirstIntersection() may deviate from the
+     exact line */
+
+  const bool x_major = std::abs(b.x - a.x) >= std::abs(b.y - a.y);
+  const int major_a = x_major ? a.x : a.y, major_b = x_major ? b.x : b.y;
+  const int minor_a = x_major ? a.y : a.x, minor_b = x_major ? b.y : b.x;
+  const int n_major = x_major ? n_cells.x : n_cells.y;
+  const int n_minor = x_major ? n_cells.y : n_cells.x;
+
+  const int d_major = major_b - major_a;
+  const double slope = d_major != 0
+    ? double(minor_b - minor_a) / d_major
+    : 0.;
+
+  const int major_min = std::min(major_a, major_b);
+  const int major_max = std::max(major_a, major_b);
+
+  const int first_column = std::max(major_min >> (int)CELL_BITS, 0);
+  const int last_column = std::min(major_max >> (int)CELL_BITS, n_major - 1);
+
+  for (int column = first_column; column <= last_column; ++column) {
+    const int m0 = std::max(major_min, column << CELL_BITS);
+    const int m1 = std::min(major_max, ((column + 1) << CELL_BITS) - 1);
+
+    /* the raster walk needs at least this many steps to reach this
+       column, and the glide path rises with each step */
+    const int steps = major_b >= major_a ? m0 - major_a : major_a - m1;
+    const int column_height =
+      std::min(height + ((steps * slope_fact) >> RASTER_SLOPE_FACT),
+               max_height);
+
+    double n0 = minor_a + (m0 - major_a) * slope;
+    double n1 = minor_a + (m1 - major_a) * slope;
+    if (n0 > n1)
+      std::swap(n0, n1);
+
+    const int first_row = std::max((int)std::floor(n0 - 1) >> (int)CELL_BITS,
+                                   0);
+    const int last_row = std::min((int)std::ceil(n1 + 1) >> (int)CELL_BITS,
+                                  n_minor - 1);
+
+    for (int row = first_row; row <= last_row; ++row) {
+      const auto h = x_major
+        ? GetCell(column, row)
+        : GetCell(row, column);
+      if (!h || *h > column_height)
+        return false;
+    }
+  }
+
+  return true;
+}
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "RasterLocation.hpp"
+#include "RasterTraits.hpp"
+#include "util/Serial.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+class RasterTileCache;
+
+/**
+ * A coarse grid over a #RasterTileCache which stores the maximum
+ * terrain height of each cell.  The cells are calculated lazily,
+ * when they are first needed, and discarded when the terrain
+ * changes (e.g. when tiles are loaded).
+ *
+ * It is used to prove quickly that a glide path is clear of terrain
+ * without walking the raster, see RasterMap::IsClear().
+ */
+class ClearanceGrid {
+public:
+  /**
+   * Each cell covers 2^CELL_BITS x 2^CELL_BITS raster pixels; this
+   * is the size of one overview pixel.
+   */
+  static constexpr unsigned CELL_BITS = RasterTraits::OVERVIEW_BITS;
+
+private:
+  /**
+   * The cells are allocated in blocks of 2^BLOCK_BITS x 2^BLOCK_BITS
+   * cells, so only the area which is actually used takes memory.
+   */
+  static constexpr unsigned BLOCK_BITS = 4;
+  static constexpr unsigned BLOCK_SIZE = 1u << BLOCK_BITS;
+
+  /**
+   * Marks a cell which has not been calculated yet.
+   */
+  static constexpr int16_t UNKNOWN = INT16_MIN;
+
+  /**
+   * Marks a cell which contains invalid pixels.
+   */
+  static constexpr int16_t INVALID = INT16_MIN + 1;
+
+  using Block = std::array<int16_t, BLOCK_SIZE * BLOCK_SIZE>;
+
+  const RasterTileCache *cache = nullptr;
+  Serial serial;
+
+  UnsignedPoint2D n_cells, n_blocks;
+  std::vector<std::unique_ptr<Block>> blocks;
+
+public:
+  void Clear() noexcept;
+
+  /**
+   * Prepare the grid for the specified terrain.  This discards all
+   * cells if the terrain has changed since the last call.
+   */
+  void Update(const RasterTileCache &_cache) noexcept;
+
+  /**
+   * Is the terrain along the specified line (in raster pixels) not
+   * higher than the specified height?  This is conservative: it
+   * checks all cells near the line, and returns false if one of them
+   * contains invalid pixels.  Cells outside of the map are ignored.
+   *
+   * Update() must have been called before.
+   *
+   * @param height the allowed height at #a
+   * @param slope_fact the allowed height rises by this value (shifted
+   * by #RASTER_SLOPE_FACT) per pixel along the major axis, like the
+   * glide path in RasterTileCache::FirstIntersection()
+   * @param max_height the allowed height does not rise above this
+   */
+  bool IsBelow(SignedRasterLocation a, SignedRasterLocation b,
+               int height, int slope_fact, int max_height) noexcept;
+
+private:
+  /**
+   * @return the maximum height of the cell or std::nullopt if it
+   * contains invalid pixels
+   */
+  std::optional<int> GetCell(unsigned x, unsigned y) noexcept;
+};
@@ -23,6 +23,13 @@ class TerrainHeight {
   int16_t value;
 
 public:
+  /**
+   * All values up to and including this one are "special" (see
+   * IsSpecial()).  This is exposed for vectorised code which
+   * operates on raw integers.
+   */
+  static constexpr int16_t MAX_SPECIAL = WATER_THRESHOLD;
+
   TerrainHeight() noexcept = default;
   explicit constexpr TerrainHeight(int16_t _value) noexcept
     :value(_value) {}
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "HeightInterpolator.hpp"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#ifdef __SSE4_1__
+#include <smmintrin.h>
+#endif
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#ifdef __SSE2__
+
+/**
+ * Multiply 32 bit integers and keep the lower 32 bits of the result;
+ * SSE2 lacks SSE4.1's _mm_mullo_epi32().
+ */
+[[gnu::always_inline]]
+static inline __m128i
+MulLo32(__m128i a, __m128i b) noexcept
+{
+#ifdef __SSE4_1__
+  return _mm_mullo_epi32(a, b);
+#else
+  const __m128i even = _mm_mul_epu32(a, b);
+  const __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4),
+                                    _mm_srli_si128(b, 4));
+  return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                            _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+
+#endif
+
+/*
+ * This is the same formula as in RasterBuffer::GetInterpolated(), but
+ * with the multiplications factored so all intermediate values fit in
+ * 32 bit integers.  The result is exactly the same.
+ */
+void
+HeightInterpolator::Interpolate(std::size_t count) noexcept
+{
+  assert(count % WIDTH == 0);
+
+#ifdef __SSE2__
+  const __m128i limit = _mm_set1_epi16(TerrainHeight::MAX_SPECIAL + 1);
+  const __m128i one = _mm_set1_epi16(0x100);
+  const __m128i zero = _mm_setzero_si128();
+
+  for (std::size_t i = 0; i < count; i += 8) {
+    const __m128i c00 = _mm_load_si128((const __m128i *)(h00 + i));
+    const __m128i c01 = _mm_load_si128((const __m128i *)(h01 + i));
+    const __m128i c10 = _mm_load_si128((const __m128i *)(h10 + i));
+    const __m128i c11 = _mm_load_si128((const __m128i *)(h11 + i));
+    const __m128i ix = _mm_load_si128((const __m128i *)(sub_x + i));
+    const __m128i iy = _mm_load_si128((const __m128i *)(sub_y + i));
+    const __m128i kx = _mm_sub_epi16(one, ix);
+    const __m128i ky = _mm_sub_epi16(one, iy);
+
+    const __m128i special =
+      _mm_or_si128(_mm_or_si128(_mm_cmplt_epi16(c00, limit),
+                                _mm_cmplt_epi16(c01, limit)),
+                   _mm_or_si128(_mm_cmplt_epi16(c10, limit),
+                                _mm_cmplt_epi16(c11, limit)));
+
+    /* horizontal interpolation: pairs of 16 bit products added to 32
+       bit */
+    const __m128i wx_lo = _mm_unpacklo_epi16(kx, ix);
+    const __m128i wx_hi = _mm_unpackhi_epi16(kx, ix);
+    const __m128i top_lo =
+      _mm_madd_epi16(_mm_unpacklo_epi16(c00, c01), wx_lo);
+    const __m128i top_hi =
+      _mm_madd_epi16(_mm_unpackhi_epi16(c00, c01), wx_hi);
+    const __m128i bottom_lo =
+      _mm_madd_epi16(_mm_unpacklo_epi16(c10, c11), wx_lo);
+    const __m128i bottom_hi =
+      _mm_madd_epi16(_mm_unpackhi_epi16(c10, c11), wx_hi);
+
+    /* vertical interpolation */
+    const __m128i ky_lo = _mm_unpacklo_epi16(ky, zero);
+    const __m128i ky_hi = _mm_unpackhi_epi16(ky, zero);
+    const __m128i iy_lo = _mm_unpacklo_epi16(iy, zero);
+    const __m128i iy_hi = _mm_unpackhi_epi16(iy, zero);
+    const __m128i r_lo =
+      _mm_srai_epi32(_mm_add_epi32(MulLo32(top_lo, ky_lo),
+                                   MulLo32(bottom_lo, iy_lo)), 16);
+    const __m128i r_hi =
+      _mm_srai_epi32(_mm_add_epi32(MulLo32(top_hi, ky_hi),
+                                   MulLo32(bottom_hi, iy_hi)), 16);
+
+    /* the result is within the range of the inputs, therefore the
+       saturation does not happen */
+    const __m128i r = _mm_packs_epi32(r_lo, r_hi);
+
+    _mm_store_si128((__m128i *)(result + i),
+                    _mm_or_si128(_mm_and_si128(special, c00),
+                                 _mm_andnot_si128(special, r)));
+  }
+#elif defined(__ARM_NEON)
+  const int16x8_t max_special = vdupq_n_s16(TerrainHeight::MAX_SPECIAL);
+  const int16x8_t one = vdupq_n_s16(0x100);
+
+  for (std::size_t i = 0; i < count; i += 8) {
+    const int16x8_t c00 = vld1q_s16(h00 + i), c01 = vld1q_s16(h01 + i);
+    const int16x8_t c10 = vld1q_s16(h10 + i), c11 = vld1q_s16(h11 + i);
+    const int16x8_t ix = vld1q_s16(sub_x + i), iy = vld1q_s16(sub_y + i);
+    const int16x8_t kx = vsubq_s16(one, ix), ky = vsubq_s16(one, iy);
+
+    const uint16x8_t special =
+      vorrq_u16(vorrq_u16(vcleq_s16(c00, max_special),
+                          vcleq_s16(c01, max_special)),
+                vorrq_u16(vcleq_s16(c10, max_special),
+                          vcleq_s16(c11, max_special)));
+
+    /* horizontal interpolation */
+    const int32x4_t top_lo =
+      vmlal_s16(vmull_s16(vget_low_s16(c00), vget_low_s16(kx)),
+                vget_low_s16(c01), vget_low_s16(ix));
+    const int32x4_t top_hi =
+      vmlal_s16(vmull_s16(vget_high_s16(c00), vget_high_s16(kx)),
+                vget_high_s16(c01), vget_high_s16(ix));
+    const int32x4_t bottom_lo =
+      vmlal_s16(vmull_s16(vget_low_s16(c10), vget_low_s16(kx)),
+                vget_low_s16(c11), vget_low_s16(ix));
+    const int32x4_t bottom_hi =
+      vmlal_s16(vmull_s16(vget_high_s16(c10), vget_high_s16(kx)),
+                vget_high_s16(c11), vget_high_s16(ix));
+
+    /* vertical interpolation */
+    const int32x4_t r_lo =
+      vmlaq_s32(vmulq_s32(top_lo, vmovl_s16(vget_low_s16(ky))),
+                bottom_lo, vmovl_s16(vget_low_s16(iy)));
+    const int32x4_t r_hi =
+      vmlaq_s32(vmulq_s32(top_hi, vmovl_s16(vget_high_s16(ky))),
+                bottom_hi, vmovl_s16(vget_high_s16(iy)));
+
+    const int16x8_t r = vcombine_s16(vshrn_n_s32(r_lo, 16),
+                                     vshrn_n_s32(r_hi, 16));
+    vst1q_s16(result + i, vbslq_s16(special, c00, r));
+  }
+#else
+  for (std::size_t i = 0; i < count; ++i) {
+    const int c00 = h00[i], c01 = h01[i], c10 = h10[i], c11 = h11[i];
+
+    if (c00 <= TerrainHeight::MAX_SPECIAL ||
+        c01 <= TerrainHeight::MAX_SPECIAL ||
+        c10 <= TerrainHeight::MAX_SPECIAL ||
+        c11 <= TerrainHeight::MAX_SPECIAL) {
+      result[i] = c00;
+      continue;
+    }
+
+    const int ix = sub_x[i], iy = sub_y[i];
+    const int kx = 0x100 - ix, ky = 0x100 - iy;
+
+    result[i] = ((c00 * kx + c01 * ix) * ky +
+                 (c10 * kx + c11 * ix) * iy) >> 16;
+  }
+#endif
+}
+
+void
+HeightInterpolator::Flush() noexcept
+{
+  if (n == 0)
+    return;
+
+  /* pad to a multiple of the vector width */
+  const std::size_t padded = (n + WIDTH - 1) & ~(WIDTH - 1);
+  for (std::size_t i = n; i < padded; ++i)
+    h00[i] = h01[i] = h10[i] = h11[i] = sub_x[i] = sub_y[i] = 0;
+
+  Interpolate(padded);
+
+  for (std::size_t i = 0; i < n; ++i)
+    *dest[i] = TerrainHeight(result[i]);
+
+  n = 0;
+}
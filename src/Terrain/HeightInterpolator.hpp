@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "RasterBuffer.hpp"
+#include "Height.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Bilinear interpolation of many terrain heights at a time, with the
+ * same result as RasterBuffer::GetInterpolated().
+ *
+ * The caller gathers the four neighbours of each point with Add()
+ * (possibly from different buffers, e.g. from a tile and the
+ * overview), and they are interpolated in blocks with SIMD
+ * instructions.  The results are only available after Flush() has
+ * been called.
+ */
+class HeightInterpolator {
+  /**
+   * The number of points which are gathered before they get
+   * interpolated.
+   */
+  static constexpr std::size_t CAPACITY = 64;
+
+  /**
+   * The number of points processed at a time by Interpolate(); the
+   * number of points in a block is rounded up to a multiple of this.
+   */
+  static constexpr std::size_t WIDTH = 8;
+
+  std::size_t n = 0;
+
+  /* "structure of arrays": the four neighbouring heights and the
+     sub-pixel position of each point */
+  alignas(16) int16_t h00[CAPACITY], h01[CAPACITY];
+  alignas(16) int16_t h10[CAPACITY], h11[CAPACITY];
+  alignas(16) int16_t sub_x[CAPACITY], sub_y[CAPACITY];
+
+  alignas(16) int16_t result[CAPACITY];
+
+  TerrainHeight *dest[CAPACITY];
+
+public:
+  HeightInterpolator() noexcept = default;
+
+  ~HeightInterpolator() noexcept {
+    /* Flush() must be called before destruction */
+    assert(n == 0);
+  }
+
+  HeightInterpolator(const HeightInterpolator &) = delete;
+  HeightInterpolator &operator=(const HeightInterpolator &) = delete;
+
+  /**
+   * Schedule the interpolation of one point.
+   *
+   * @param px the pixel column within the buffer (must be in range)
+   * @param py the pixel row within the buffer (must be in range)
+   * @param ix the sub-pixel column for interpolation (0..255)
+   * @param iy the sub-pixel row for interpolation (0..255)
+   * @param _dest the result will be stored here by Flush()
+   */
+  void Add(const RasterBuffer &buffer, unsigned px, unsigned py,
+           unsigned ix, unsigned iy, TerrainHeight &_dest) noexcept {
+    assert(ix < 0x100);
+    assert(iy < 0x100);
+
+    if (n == CAPACITY)
+      Flush();
+
+    const auto size = buffer.GetSize();
+    const unsigned dx = (px == size.x - 1) ? 0 : 1;
+    const unsigned dy = (py == size.y - 1) ? 0 : size.x;
+    const TerrainHeight *tm = buffer.GetDataAt({px, py});
+
+    h00[n] = tm->GetValue();
+    h01[n] = tm[dx].GetValue();
+    h10[n] = tm[dy].GetValue();
+    h11[n] = tm[dx + dy].GetValue();
+    sub_x[n] = ix;
+    sub_y[n] = iy;
+    dest[n] = &_dest;
+    ++n;
+  }
+
+  /**
+   * Schedule the interpolation of one point at the given sub-pixel
+   * location, which may be out of range (the result is then
+   * TerrainHeight::Invalid(), stored immediately).
+   */
+  void Add(const RasterBuffer &buffer, RasterLocation fine,
+           TerrainHeight &_dest) noexcept {
+    const auto [px, ix] = RasterTraits::CalcSubpixel(fine.x);
+    const auto [py, iy] = RasterTraits::CalcSubpixel(fine.y);
+
+    if (px >= buffer.GetSize().x || py >= buffer.GetSize().y)
+      _dest = TerrainHeight::Invalid();
+    else
+      Add(buffer, px, py, ix, iy, _dest);
+  }
+
+  /**
+   * Interpolate all pending points and store the results.
+   */
+  void Flush() noexcept;
+
+private:
+  /**
+   * Interpolate the first #count points into #result.
+   *
+   * @param count a multiple of #WIDTH
+   */
+  void Interpolate(std::size_t count) noexcept;
+};
@@ -6,6 +6,7 @@
 
 #include <stdlib.h>
 #include <algorithm>
+#include <climits>
 
 //#define DEBUG_TILE
 #ifdef DEBUG_TILE
@@ -221,6 +222,29 @@ RasterTileCache::GetFieldDirect(RasterLocation p) const noexcept
   return std::make_pair(overview.Get(p_overview), false);
 }
 
+std::optional<int>
+RasterTileCache::GetMaximumHeight(const RasterLocation start,
+                                  const RasterLocation end) const noexcept
+{
+  assert(start.x < end.x && end.x <= size.x);
+  assert(start.y < end.y && end.y <= size.y);
+
+  int maximum = INT_MIN;
+
+  RasterLocation p;
+  for (p.y = start.y; p.y < end.y; ++p.y) {
+    for (p.x = start.x; p.x < end.x; ++p.x) {
+      const TerrainHeight h = GetFieldDirect(p).first;
+      if (h.IsInvalid())
+        return std::nullopt;
+
+      maximum = std::max(maximum, int(h.GetValueOr0()));
+    }
+  }
+
+  return maximum;
+}
+
 SignedRasterLocation
 RasterTileCache::GroundIntersection(const SignedRasterLocation origin,
                                     const SignedRasterLocation destination,
@@ -6,6 +6,7 @@
 #include "RasterProjection.hpp"
 #include "ZzipStream.hpp"
 #include "WorldFile.hpp"
+#include "TileDecodePool.hpp"
 #include "Operation/Operation.hpp"
 #include "system/ConvertPathName.hpp"
 #include "util/ScopeExit.hxx"
@@ -16,6 +17,8 @@ extern "C" {
 #include "jasper/jpc/jpc_t1cod.h"
 }
 
+#include <optional>
+
 #include <string.h>
 
 long
@@ -142,6 +145,22 @@ TerrainLoader::StartTile(unsigned index)
     raster_tile_cache.StartTile(index);
 }
 
+bool
+TerrainLoader::SubmitTile(std::function<bool()> &&job)
+{
+  if (decode_pool == nullptr)
+    return false;
+
+  decode_pool->Submit(std::move(job));
+  return true;
+}
+
+bool
+TerrainLoader::WaitTiles() noexcept
+{
+  return decode_pool == nullptr || decode_pool->Wait();
+}
+
 void
 TerrainLoader::SetSize(unsigned _width, unsigned _height,
                        uint_least16_t _tile_width, uint_least16_t _tile_height,
@@ -291,7 +310,8 @@ LoadTerrainOverview(struct zzip_dir *dir,
 
 inline void
 TerrainLoader::UpdateTiles(struct zzip_dir *dir, const char *path,
-                           SignedRasterLocation p, unsigned radius)
+                           SignedRasterLocation p, unsigned radius,
+                           unsigned n_threads)
 {
   assert(!scan_overview);
 
@@ -306,20 +326,40 @@ TerrainLoader::UpdateTiles(struct zzip_dir *dir, const char *path,
   }
 
   AtScopeExit(this) { raster_tile_cache.FinishTileUpdate(); };
+
+  /* the tiles decoded by the pool are published all at once by
+     FinishTileUpdate(), just like the ones decoded by this thread */
+  std::optional<TileDecodePool> pool;
+  if (n_threads > 0) {
+    pool.emplace(n_threads);
+    decode_pool = &*pool;
+  }
+
+  AtScopeExit(this) { decode_pool = nullptr; };
   LoadJPG2000(dir, path);
 }
 
 void
 UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
                    RasterTileCache &raster_tile_cache, SharedMutex &mutex,
-                   SignedRasterLocation p, unsigned radius)
+                   SignedRasterLocation p, unsigned radius,
+                   unsigned n_threads)
 {
   if (!raster_tile_cache.IsValid())
     return;
 
   NullOperationEnvironment env;
   TerrainLoader loader(mutex, raster_tile_cache, false, true, env);
-  loader.UpdateTiles(dir, path, p, radius);
+  loader.UpdateTiles(dir, path, p, radius, n_threads);
+}
+
+void
+UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
+                   RasterTileCache &raster_tile_cache, SharedMutex &mutex,
+                   SignedRasterLocation p, unsigned radius)
+{
+  UpdateTerrainTiles(dir, path, raster_tile_cache, mutex, p, radius,
+                     TileDecodePool::GetDefaultThreadCount());
 }
 
 void
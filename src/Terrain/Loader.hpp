@@ -7,12 +7,14 @@
 #include "thread/SharedMutex.hpp"
 
 #include <cstdint>
+#include <functional>
 
 struct zzip_dir;
 struct GeoPoint;
 class RasterTileCache;
 class RasterProjection;
 class OperationEnvironment;
+class TileDecodePool;
 
 class TerrainLoader {
   SharedMutex &mutex;
@@ -28,6 +30,12 @@ class TerrainLoader {
    */
   mutable unsigned remaining_segments = 0;
 
+  /**
+   * If set, then complete tiles are decoded by these threads while
+   * this thread continues reading the code stream.
+   */
+  TileDecodePool *decode_pool = nullptr;
+
 public:
   TerrainLoader(SharedMutex &_mutex, RasterTileCache &_rtc,
                 bool _scan_overview, bool _scan_all,
@@ -45,9 +53,13 @@ public:
 
   /**
    * Throws on error.
+   *
+   * @param n_threads the number of threads which decode tiles in
+   * parallel; 0 decodes all of them in the calling thread
    */
   void UpdateTiles(struct zzip_dir *dir, const char *path,
-                   SignedRasterLocation p, unsigned radius);
+                   SignedRasterLocation p, unsigned radius,
+                   unsigned n_threads);
 
   /* callback methods for libjasper (via jas_rtc.cpp) */
 
@@ -58,6 +70,17 @@ public:
 
   void StartTile(unsigned index);
 
+  /**
+   * @return false if there is no #TileDecodePool, and the tile shall
+   * be decoded right away
+   */
+  bool SubmitTile(std::function<bool()> &&job);
+
+  /**
+   * @return false if decoding one of the submitted tiles has failed
+   */
+  bool WaitTiles() noexcept;
+
   void SetSize(unsigned width, unsigned height,
                uint_least16_t tile_width, uint_least16_t tile_height,
                unsigned tile_columns, unsigned tile_rows);
@@ -98,6 +121,18 @@ LoadTerrainOverview(struct zzip_dir *dir,
                       tile_cache, false, env);
 }
 
+/**
+ * Throws on error.
+ *
+ * @param n_threads the number of threads which decode tiles in
+ * parallel; 0 decodes all of them in the calling thread
+ */
+void
+UpdateTerrainTiles(struct zzip_dir *dir, const char *path,
+                   RasterTileCache &raster_tile_cache, SharedMutex &mutex,
+                   SignedRasterLocation p, unsigned radius,
+                   unsigned n_threads);
+
 /**
  * Throws on error.
  */
@@ -2,6 +2,7 @@
 // Copyright The XCSoar Project
 
 #include "Terrain/RasterBuffer.hpp"
+#include "Terrain/HeightInterpolator.hpp"
 
 #include <algorithm>
 #include <cassert>
@@ -13,7 +14,9 @@ RasterBuffer::Resize(RasterLocation _size) noexcept
   assert(_size.x > 0);
   assert(_size.y > 0);
 
-  data.GrowDiscard(_size.x, _size.y);
+  storage.GrowDiscard(std::size_t(_size.x) * _size.y);
+  data = storage.data();
+  size = _size;
 }
 
 TerrainHeight
@@ -60,6 +63,20 @@ RasterBuffer::GetInterpolated(RasterLocation p) const noexcept
   return GetInterpolated(px, py, ix, iy);
 }
 
+void
+RasterBuffer::GetInterpolated(std::span<const RasterLocation> fine,
+                              TerrainHeight *dest) const noexcept
+{
+  assert(IsDefined());
+
+  HeightInterpolator interpolator;
+
+  for (const auto &p : fine)
+    interpolator.Add(*this, p, *dest++);
+
+  interpolator.Flush();
+}
+
 /**
  * This class implements an algorithm to traverse pixels quickly with
  * only integer addition, no multiplication and division.
@@ -243,7 +260,7 @@ TerrainHeight
 RasterBuffer::GetMaximum() const noexcept
 {
   return IsDefined()
-    ? *std::max_element(data.begin(), data.end(),
+    ? *std::max_element(data, data + std::size_t(size.x) * size.y,
                         [](TerrainHeight a, TerrainHeight b) {
                           return a.GetValue() < b.GetValue();
                         })
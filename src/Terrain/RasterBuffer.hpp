@@ -6,26 +6,46 @@
 #include "RasterTraits.hpp"
 #include "RasterLocation.hpp"
 #include "Height.hpp"
-#include "util/AllocatedGrid.hxx"
+#include "util/AllocatedArray.hxx"
 #include "util/Compiler.h"
 
+#include <cassert>
+#include <span>
+
 class RasterBuffer {
-  AllocatedGrid<TerrainHeight> data;
+  AllocatedArray<TerrainHeight> storage;
+
+  /**
+   * The first row of the grid.  Usually, this points into #storage,
+   * but it may also point to read-only memory owned by somebody else
+   * (see SetExternal()).
+   */
+  const TerrainHeight *data = nullptr;
+
+  RasterLocation size{0, 0};
 
 public:
   RasterBuffer() noexcept = default;
   RasterBuffer(unsigned _width, unsigned _height) noexcept
-    :data(_width, _height) {}
+    :storage(_width * _height), data(storage.data()),
+     size(_width, _height) {}
 
   RasterBuffer(const RasterBuffer &) = delete;
   RasterBuffer &operator=(const RasterBuffer &) = delete;
 
   bool IsDefined() const noexcept {
-    return data.IsDefined();
+    return data != nullptr;
+  }
+
+  /**
+   * Does this buffer refer to memory owned by somebody else?
+   */
+  bool IsExternal() const noexcept {
+    return data != nullptr && data != storage.data();
   }
 
   RasterLocation GetSize() const noexcept {
-    return {data.GetWidth(), data.GetHeight()};
+    return size;
   }
 
   RasterLocation GetFineSize() const noexcept {
@@ -33,23 +53,42 @@ public:
   }
 
   TerrainHeight *GetData() noexcept {
-    return data.begin();
+    assert(!IsExternal());
+
+    return storage.data();
   }
 
   const TerrainHeight *GetData() const noexcept {
-    return data.begin();
+    return data;
   }
 
   const TerrainHeight *GetDataAt(RasterLocation p) const noexcept {
-    return data.GetPointerAt(p.x, p.y);
+    assert(p.x < size.x);
+    assert(p.y < size.y);
+
+    return data + p.y * size.x + p.x;
   }
 
   void Reset() noexcept {
-    data.Reset();
+    storage = nullptr;
+    data = nullptr;
+    size = {0, 0};
   }
 
   void Resize(RasterLocation _size) noexcept;
 
+  /**
+   * Use the given memory instead of an own allocation.  It must
+   * remain valid until Reset() or Resize() gets called.
+   */
+  void SetExternal(const TerrainHeight *_data, RasterLocation _size) noexcept {
+    assert(_data != nullptr);
+
+    storage = nullptr;
+    data = _data;
+    size = _size;
+  }
+
   [[gnu::pure]]
   TerrainHeight GetInterpolated(unsigned lx, unsigned ly,
                                 unsigned ix, unsigned iy) const noexcept;
@@ -57,6 +96,16 @@ public:
   [[gnu::pure]]
   TerrainHeight GetInterpolated(RasterLocation p) const noexcept;
 
+  /**
+   * Batch version of GetInterpolated(RasterLocation).  The
+   * interpolation is done with SIMD instructions if available.
+   *
+   * @param fine the sub-pixel locations; may be out of range
+   * @param dest an array with one element per location
+   */
+  void GetInterpolated(std::span<const RasterLocation> fine,
+                       TerrainHeight *dest) const noexcept;
+
   [[gnu::pure]]
   TerrainHeight Get(RasterLocation p) const noexcept {
     return *GetDataAt(p);
@@ -2,11 +2,13 @@
 // Copyright The XCSoar Project
 
 #include "Terrain/RasterMap.hpp"
+#include "ClearanceGrid.hpp"
 #include "Geo/GeoClip.hpp"
 #include "Math/Util.hpp"
 
 #include <algorithm>
 #include <cassert>
+#include <climits>
 
 void
 RasterMap::UpdateProjection() noexcept
@@ -35,6 +37,48 @@ RasterMap::GetInterpolatedHeight(const GeoPoint &location) const noexcept
   return raster_tile_cache.GetInterpolatedHeight(pt);
 }
 
+/**
+ * The number of locations which are projected at a time by the batch
+ * methods.
+ */
+static constexpr std::size_t HEIGHT_BATCH_SIZE = 256;
+
+void
+RasterMap::GetHeights(std::span<const GeoPoint> locations,
+                      TerrainHeight *dest) const noexcept
+{
+  RasterLocation buffer[HEIGHT_BATCH_SIZE];
+
+  while (!locations.empty()) {
+    const auto chunk =
+      locations.first(std::min(locations.size(), HEIGHT_BATCH_SIZE));
+
+    projection.ProjectCoarse(chunk, buffer);
+    raster_tile_cache.GetHeights({buffer, chunk.size()}, dest);
+
+    locations = locations.subspan(chunk.size());
+    dest += chunk.size();
+  }
+}
+
+void
+RasterMap::GetInterpolatedHeights(std::span<const GeoPoint> locations,
+                                  TerrainHeight *dest) const noexcept
+{
+  RasterLocation buffer[HEIGHT_BATCH_SIZE];
+
+  while (!locations.empty()) {
+    const auto chunk =
+      locations.first(std::min(locations.size(), HEIGHT_BATCH_SIZE));
+
+    projection.ProjectFine(chunk, buffer);
+    raster_tile_cache.GetInterpolatedHeights({buffer, chunk.size()}, dest);
+
+    locations = locations.subspan(chunk.size());
+    dest += chunk.size();
+  }
+}
+
 void
 RasterMap::ScanLine(const GeoPoint &start, const GeoPoint &end,
                     TerrainHeight *buffer, unsigned size,
@@ -141,6 +185,47 @@ RasterMap::FirstIntersection(const GeoPoint &origin, const int h_origin,
   return {projection.UnprojectCoarse(intersection->location), intersection->height};
 }
 
+bool
+RasterMap::IsClear(ClearanceGrid &grid,
+                   const GeoPoint &origin, const int h_origin,
+                   const GeoPoint &destination, const int h_destination,
+                   const int h_virt, const int h_ceiling,
+                   const int h_safety) const noexcept
+{
+  /* this follows the calculations of FirstIntersection() */
+
+  const auto c_origin = projection.ProjectCoarseRound(origin);
+  const auto c_destination = projection.ProjectCoarseRound(destination);
+  const int c_diff = ManhattanDistance(c_origin, c_destination);
+  if (c_diff == 0)
+    return true; // no distance
+
+  if (h_virt < 0 || !raster_tile_cache.IsInside(RasterLocation(c_origin)))
+    return false;
+
+  const int slope_fact = (((int)h_virt) << RASTER_SLOPE_FACT) / c_diff;
+  const int vh_origin = std::max(h_origin,
+                                 h_destination
+                                 - ((c_diff * slope_fact) >> RASTER_SLOPE_FACT));
+
+  /* the glide path climbs from vh_origin by not more than h_virt;
+     it is clear if it never reaches the ceiling and all terrain near
+     it is below it */
+  if (vh_origin + h_virt > h_ceiling)
+    return false;
+
+  /* when climbing, the glide path is capped at the destination
+     height */
+  const bool can_climb = h_destination < h_virt;
+  const int max_height = can_climb
+    ? std::max(h_destination, vh_origin) - h_safety
+    : INT_MAX;
+
+  grid.Update(raster_tile_cache);
+  return grid.IsBelow(c_origin, c_destination, vh_origin - h_safety,
+                      slope_fact, max_height);
+}
+
 GeoPoint
 RasterMap::GroundIntersection(const GeoPoint &origin,
                               const int h_origin, const int h_glide,
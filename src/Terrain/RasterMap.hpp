@@ -7,7 +7,10 @@
 #include "RasterTileCache.hpp"
 #include "Geo/GeoPoint.hpp"
 
+#include <span>
+
 class OperationEnvironment;
+class ClearanceGrid;
 
 class RasterMap {
   RasterTileCache raster_tile_cache;
@@ -95,6 +98,24 @@ public:
   [[gnu::pure]]
   TerrainHeight GetInterpolatedHeight(const GeoPoint &location) const noexcept;
 
+  /**
+   * Determine the non-interpolated heights of many locations at once.
+   * This is faster than calling GetHeight() for each of them, see
+   * RasterTileCache::GetHeights().
+   *
+   * @param dest an array with one element per location
+   */
+  void GetHeights(std::span<const GeoPoint> locations,
+                  TerrainHeight *dest) const noexcept;
+
+  /**
+   * Determine the interpolated heights of many locations at once.
+   *
+   * @param dest an array with one element per location
+   */
+  void GetInterpolatedHeights(std::span<const GeoPoint> locations,
+                              TerrainHeight *dest) const noexcept;
+
   /**
    * Scan a straight line and fill the buffer with the specified
    * number of samples along the line.
@@ -122,6 +143,17 @@ public:
                                  int h_destination,
                                  int h_virt, int h_ceiling, int h_safety) const noexcept;
 
+  /**
+   * A quick check whether FirstIntersection() would find no
+   * intersection, using a #ClearanceGrid instead of walking the
+   * raster.  This is conservative: false means that the path may
+   * not be clear, and FirstIntersection() needs to be called.
+   */
+  bool IsClear(ClearanceGrid &grid,
+               const GeoPoint &origin, int h_origin,
+               const GeoPoint &destination, int h_destination,
+               int h_virt, int h_ceiling, int h_safety) const noexcept;
+
   /**
    * Find location where aircraft hits the ground or height_floor
    * @todo margin
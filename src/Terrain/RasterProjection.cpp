@@ -19,6 +19,22 @@ RasterProjection::Set(const GeoBounds &bounds,
   top = AngleToHeight(bounds.GetNorth());
 }
 
+void
+RasterProjection::ProjectFine(std::span<const GeoPoint> src,
+                              RasterLocation *dest) const noexcept
+{
+  for (const auto &i : src)
+    *dest++ = ProjectFine(i);
+}
+
+void
+RasterProjection::ProjectCoarse(std::span<const GeoPoint> src,
+                                RasterLocation *dest) const noexcept
+{
+  for (const auto &i : src)
+    *dest++ = ProjectCoarse(i);
+}
+
 double
 RasterProjection::FinePixelDistance(const GeoPoint &location,
                                     unsigned pixels) const noexcept
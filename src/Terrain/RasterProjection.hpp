@@ -7,6 +7,8 @@
 #include "RasterLocation.hpp"
 #include "Geo/GeoPoint.hpp"
 
+#include <span>
+
 class GeoBounds;
 
 /**
@@ -57,6 +59,20 @@ public:
     return ProjectFine(location) >> RasterTraits::SUBPIXEL_BITS;
   }
 
+  /**
+   * Bulk version of ProjectFine().  Locations outside of the map
+   * wrap around to large unsigned values, just like the conversion
+   * from #SignedRasterLocation.
+   */
+  void ProjectFine(std::span<const GeoPoint> src,
+                   RasterLocation *dest) const noexcept;
+
+  /**
+   * Bulk version of ProjectCoarse(), see ProjectFine().
+   */
+  void ProjectCoarse(std::span<const GeoPoint> src,
+                     RasterLocation *dest) const noexcept;
+
   constexpr GeoPoint UnprojectCoarse(SignedRasterLocation coords) const noexcept {
     return UnprojectFine(coords << RasterTraits::SUBPIXEL_BITS);
   }
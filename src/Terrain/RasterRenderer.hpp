@@ -4,20 +4,17 @@
 #pragma once
 
 #include "Terrain/HeightMatrix.hpp"
+#include "Terrain/TerrainShader.hpp"
 
 #ifdef ENABLE_OPENGL
 #include "Geo/GeoBounds.hpp"
 #endif
 
-static constexpr unsigned NUM_COLOR_RAMP_LEVELS = 13;
-
 class Angle;
 class Canvas;
 class RasterMap;
 class WindowProjection;
 class RawBitmap;
-struct RawColor;
-struct ColorRamp;
 
 #ifdef ENABLE_OPENGL
 class GLTexture;
@@ -57,12 +54,10 @@ class RasterRenderer {
   HeightMatrix height_matrix;
   RawBitmap *image = nullptr;
 
-  unsigned char *contour_column_base = nullptr;
+  TerrainShader shader;
 
   double pixel_size;
 
-  RawColor *color_table = nullptr;
-
 public:
   RasterRenderer() noexcept;
   ~RasterRenderer() noexcept;
@@ -116,7 +111,10 @@ public:
    * preventing the same color calculations over and over again.
    */
   void PrepareColorTable(const ColorRamp *color_ramp, bool do_water,
-                         unsigned height_scale, int interp_levels) noexcept;
+                         unsigned height_scale, int interp_levels) noexcept {
+    shader.PrepareColorTable(color_ramp, do_water,
+                             height_scale, interp_levels);
+  }
 
   /**
    * Scan the map and fill the height matrix.
@@ -138,29 +136,4 @@ public:
 
   void Draw(Canvas &canvas, const WindowProjection &projection,
             bool transparent_white=false) const noexcept;
-
-protected:
-  /**
-   * Convert the height matrix into the image, without shading.
-   */
-  void GenerateUnshadedImage(unsigned height_scale,
-                             unsigned contour_height_scale) noexcept;
-
-  /**
-   * Convert the height matrix into the image, with slope shading.
-   */
-  void GenerateSlopeImage(unsigned height_scale, int contrast,
-                          int sx, int sy, int sz,
-                          unsigned contour_height_scale) noexcept;
-
-  /**
-   * Convert the height matrix into the image, with slope shading.
-   */
-  void GenerateSlopeImage(unsigned height_scale,
-                          int contrast, int brightness,
-                          Angle sunazimuth,
-                          unsigned contour_height_scale) noexcept;
-
-private:
-  void ContourStart(unsigned contour_height_scale) noexcept;
 };
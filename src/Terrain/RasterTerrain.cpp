@@ -45,8 +45,8 @@ RasterTerrain::SaveCache(FileCache &cache, Path path) const
 }
 
 inline void
-RasterTerrain::Load(Path path, FileCache *cache,
-                    OperationEnvironment &operation)
+RasterTerrain::LoadOverview(Path path, FileCache *cache,
+                            OperationEnvironment &operation)
 {
   try {
     if (LoadCache(cache, path))
@@ -68,6 +68,21 @@ RasterTerrain::Load(Path path, FileCache *cache,
   }
 }
 
+inline void
+RasterTerrain::Load(Path path, FileCache *cache,
+                    OperationEnvironment &operation)
+{
+  LoadOverview(path, cache, operation);
+
+  if (cache != nullptr) {
+    try {
+      map.GetTileCache().OpenTileStore(*cache, path);
+    } catch (...) {
+      LogError(std::current_exception(), "Failed to open terrain tile cache");
+    }
+  }
+}
+
 std::unique_ptr<RasterTerrain>
 RasterTerrain::OpenTerrain(FileCache *cache, Path path,
                            OperationEnvironment &operation)
@@ -59,6 +59,18 @@ public:
     return lease->GetHeight(location);
   }
 
+  /**
+   * Batch version of GetTerrainHeight() which obtains the lock only
+   * once, see RasterMap::GetHeights().
+   *
+   * @param dest an array with one element per location
+   */
+  void GetTerrainHeights(std::span<const GeoPoint> locations,
+                         TerrainHeight *dest) const noexcept {
+    Lease lease(*this);
+    lease->GetHeights(locations, dest);
+  }
+
   GeoPoint GetTerrainCenter() const noexcept {
     return map.GetMapCenter();
   }
@@ -84,6 +96,12 @@ private:
    */
   void SaveCache(FileCache &cache, Path path) const;
 
+  /**
+   * Throws on error.
+   */
+  void LoadOverview(Path path, FileCache *cache,
+                    OperationEnvironment &operation);
+
   /**
    * Throws on error.
    */
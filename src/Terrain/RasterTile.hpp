@@ -7,6 +7,8 @@
 #include "RasterLocation.hpp"
 #include "RasterBuffer.hpp"
 
+#include <span>
+
 struct jas_matrix;
 class BufferedOutputStream;
 class BufferedReader;
@@ -85,6 +87,32 @@ public:
     return buffer.IsDefined();
   }
 
+  /**
+   * Has this tile been decoded into its own buffer (as opposed to
+   * using data from a #TerrainTileStore)?
+   */
+  bool IsDecoded() const noexcept {
+    return buffer.IsDefined() && !buffer.IsExternal();
+  }
+
+  /**
+   * Load this tile from already decoded height data which remains
+   * valid until Unload() gets called.
+   */
+  void SetExternal(const TerrainHeight *data) noexcept {
+    if (IsDefined())
+      buffer.SetExternal(data, size);
+  }
+
+  /**
+   * Returns the height data of a loaded tile.
+   */
+  std::span<const TerrainHeight> GetData() const noexcept {
+    assert(IsLoaded());
+
+    return {buffer.GetData(), std::size_t(size.x) * size.y};
+  }
+
   void CopyFrom(const struct jas_matrix &m) noexcept;
 
   /**
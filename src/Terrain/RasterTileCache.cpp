@@ -2,9 +2,14 @@
 // Copyright The XCSoar Project
 
 #include "RasterTileCache.hpp"
+#include "TileStore.hpp"
+#include "HeightInterpolator.hpp"
 #include "Math/Angle.hpp"
 #include "io/BufferedOutputStream.hxx"
 #include "io/BufferedReader.hxx"
+#include "io/FileCache.hpp"
+#include "io/FileMapping.hpp"
+#include "io/FileOutputStream.hxx"
 #include "util/SpanCast.hxx"
 
 extern "C" {
@@ -57,6 +62,13 @@ RasterTileCache::PutOverviewTile(unsigned index,
     CopyOverviewRow(dest, m.rows_[y], width, skip);
 }
 
+RasterTileCache::RasterTileCache() noexcept
+{
+  Reset();
+}
+
+RasterTileCache::~RasterTileCache() noexcept = default;
+
 void
 RasterTileCache::PutTileData(unsigned index,
                              const struct jas_matrix &m) noexcept
@@ -128,11 +140,22 @@ RasterTileCache::PollTiles(SignedRasterLocation p, unsigned radius) noexcept
   dirty = false;
 
   unsigned num_activate = 0;
+  unsigned num_mapped = 0;
   for (unsigned i = 0; i < request_tiles.size(); ++i) {
     RasterTile &tile = tiles.GetLinear(request_tiles[i]);
     if (tile.IsLoaded())
       continue;
 
+    if (tile_store != nullptr) {
+      if (const auto *data = tile_store->Find(request_tiles[i])) {
+        /* no need to decode this one, and no need to limit the
+           number of these */
+        tile.SetExternal(data);
+        ++num_mapped;
+        continue;
+      }
+    }
+
     if (++num_activate <= MAX_ACTIVATE)
       /* request the tile in the current iteration */
       tile.SetRequest();
@@ -141,6 +164,11 @@ RasterTileCache::PollTiles(SignedRasterLocation p, unsigned radius) noexcept
       dirty = true;
   }
 
+  if (num_activate == 0 && num_mapped > 0)
+    /* there is nothing to decode, and FinishTileUpdate() will not be
+       called; publish the mapped tiles right now */
+    ++serial;
+
   return num_activate > 0;
 }
 
@@ -177,6 +205,68 @@ RasterTileCache::GetInterpolatedHeight(RasterLocation l) const noexcept
   return overview.GetInterpolated({RasterTraits::ToOverview(l.x), RasterTraits::ToOverview(l.y)});
 }
 
+void
+RasterTileCache::GetHeights(std::span<const RasterLocation> p,
+                            TerrainHeight *dest) const noexcept
+{
+  HeightInterpolator interpolator;
+  const RasterTile *tile = nullptr;
+
+  for (const auto &i : p) {
+    if (i.x >= size.x || i.y >= size.y) {
+      // outside overall bounds
+      *dest++ = TerrainHeight::Invalid();
+      continue;
+    }
+
+    tile = &FindTile(i, tile);
+    if (tile->IsLoaded())
+      *dest = tile->GetHeight(i);
+    else
+      // still not found, so go to overview
+      interpolator.Add(overview,
+                       i << (RasterTraits::SUBPIXEL_BITS - RasterTraits::OVERVIEW_BITS),
+                       *dest);
+
+    ++dest;
+  }
+
+  interpolator.Flush();
+}
+
+void
+RasterTileCache::GetInterpolatedHeights(std::span<const RasterLocation> p,
+                                        TerrainHeight *dest) const noexcept
+{
+  HeightInterpolator interpolator;
+  const RasterTile *tile = nullptr;
+
+  for (const auto &l : p) {
+    if (l.x >= overview_size_fine.x || l.y >= overview_size_fine.y) {
+      // outside overall bounds
+      *dest++ = TerrainHeight::Invalid();
+      continue;
+    }
+
+    const auto [px, ix] = RasterTraits::CalcSubpixel(l.x);
+    const auto [py, iy] = RasterTraits::CalcSubpixel(l.y);
+
+    tile = &FindTile({px, py}, tile);
+    if (tile->IsLoaded())
+      interpolator.Add(tile->buffer, px - tile->start.x, py - tile->start.y,
+                       ix, iy, *dest);
+    else
+      // still not found, so go to overview
+      interpolator.Add(overview,
+                       {RasterTraits::ToOverview(l.x), RasterTraits::ToOverview(l.y)},
+                       *dest);
+
+    ++dest;
+  }
+
+  interpolator.Flush();
+}
+
 void
 RasterTileCache::SetSize(UnsignedPoint2D _size,
                          Point2D<uint_least16_t> _tile_size,
@@ -219,6 +309,52 @@ RasterTileCache::Reset() noexcept
 
   for (auto &i : tiles)
     i.Unload();
+
+  /* after all tiles have been unloaded, because they may point into
+     its mapping */
+  tile_store.reset();
+}
+
+void
+RasterTileCache::OpenTileStore(FileCache &cache, Path original_path)
+{
+  static constexpr const char *name = "terrain.tiles";
+
+  assert(IsValid());
+
+  const TerrainTileStore::Geometry geometry{
+    size,
+    {tiles.GetWidth(), tiles.GetHeight()},
+    tile_size,
+  };
+
+  auto store = std::make_unique<TerrainTileStore>(geometry);
+
+  std::span<const std::byte> payload;
+  auto mapping = cache.Map(name, original_path, payload);
+  if (mapping == nullptr || !store->Map(std::move(mapping), payload)) {
+    /* start a new file */
+    auto os = cache.Save(name, original_path);
+    store->WriteHeader(*os);
+    os->Commit();
+  }
+
+  try {
+    store->SetOutput(cache.Append(name));
+  } catch (...) {
+    /* use the store read-only; this happens on Windows, where a
+       mapped file cannot be opened for writing */
+  }
+
+  tile_store = std::move(store);
+}
+
+unsigned
+RasterTileCache::CountLoadedTiles() const noexcept
+{
+  return std::count_if(tiles.begin(), tiles.end(), [](const RasterTile &tile){
+    return tile.IsLoaded();
+  });
 }
 
 const RasterTileCache::MarkerSegmentInfo *
@@ -239,8 +375,13 @@ RasterTileCache::FinishTileUpdate() noexcept
      loop */
   for (std::size_t i : request_tiles) {
     RasterTile &tile = tiles.GetLinear(i);
-    if (tile.IsRequested() && !tile.IsLoaded())
+    if (!tile.IsRequested())
+      continue;
+
+    if (!tile.IsLoaded())
       tile.Clear();
+    else if (tile_store != nullptr && tile.IsDecoded())
+      tile_store->Append(i, tile.GetData());
   }
 
   ++serial;
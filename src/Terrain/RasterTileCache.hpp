@@ -7,12 +7,15 @@
 #include "RasterTile.hpp"
 #include "RasterLocation.hpp"
 #include "Geo/GeoBounds.hpp"
+#include "util/AllocatedGrid.hxx"
 #include "util/StaticArray.hxx"
 #include "util/Serial.hpp"
 
 #include <cassert>
 #include <cstdint>
+#include <memory>
 #include <optional>
+#include <span>
 
 static constexpr unsigned  RASTER_SLOPE_FACT = 12;
 
@@ -20,6 +23,9 @@ struct jas_matrix;
 struct GridLocation;
 class BufferedOutputStream;
 class BufferedReader;
+class FileCache;
+class Path;
+class TerrainTileStore;
 
 class RasterTileCache {
   static constexpr unsigned MAX_RTC_TILES = 4096;
@@ -112,10 +118,14 @@ protected:
    */
   StaticArray<uint16_t, MAX_RTC_TILES> request_tiles;
 
+  /**
+   * Optional on-disk cache of decoded tiles, see OpenTileStore().
+   */
+  std::unique_ptr<TerrainTileStore> tile_store;
+
 public:
-  RasterTileCache() noexcept {
-    Reset();
-  }
+  RasterTileCache() noexcept;
+  ~RasterTileCache() noexcept;
 
   RasterTileCache(const RasterTileCache &) = delete;
   RasterTileCache &operator=(const RasterTileCache &) = delete;
@@ -150,6 +160,27 @@ public:
   [[gnu::pure]]
   TerrainHeight GetInterpolatedHeight(RasterLocation p) const noexcept;
 
+  /**
+   * Batch version of GetHeight().  Consecutive points in the same
+   * tile share one tile lookup, and all interpolations (in tiles and
+   * in the overview) are done in blocks with SIMD instructions, see
+   * #HeightInterpolator.
+   *
+   * @param p the pixel positions; may be out of range
+   * @param dest an array with one element per position
+   */
+  void GetHeights(std::span<const RasterLocation> p,
+                  TerrainHeight *dest) const noexcept;
+
+  /**
+   * Batch version of GetInterpolatedHeight(), see GetHeights().
+   *
+   * @param p the sub-pixel positions; may be out of range
+   * @param dest an array with one element per position
+   */
+  void GetInterpolatedHeights(std::span<const RasterLocation> p,
+                              TerrainHeight *dest) const noexcept;
+
   /**
    * Scan a straight line and fill the buffer with the specified
    * number of samples along the line.
@@ -175,6 +206,21 @@ public:
                                                 int h_safety,
                                                 bool can_climb) const noexcept;
 
+  /**
+   * Determine the maximum height of all pixels in a rectangle, as
+   * seen by FirstIntersection() (i.e. from the overview where no
+   * tile is loaded, and with special values counting as 0).
+   *
+   * @param start the top left pixel
+   * @param end the pixel after the bottom right one; must be inside
+   * the map
+   * @return the maximum height or std::nullopt if one of the pixels
+   * is invalid
+   */
+  [[gnu::pure]]
+  std::optional<int> GetMaximumHeight(RasterLocation start,
+                                      RasterLocation end) const noexcept;
+
   /**
    * @return {-1,-1} if no intersection was found
    */
@@ -185,6 +231,24 @@ public:
                      int height_floor) const noexcept;
 
 private:
+  /**
+   * Look up the tile containing the given pixel location, which must
+   * be inside the map.  The division is skipped if the location is
+   * inside the #hint tile (e.g. the result of the previous call);
+   * that is very common in batch queries, because the points are
+   * usually spatially coherent.
+   */
+  [[gnu::pure]]
+  const RasterTile &FindTile(RasterLocation p,
+                             const RasterTile *hint) const noexcept {
+    if (hint != nullptr &&
+        p.x - hint->start.x < hint->size.x &&
+        p.y - hint->start.y < hint->size.y)
+      return *hint;
+
+    return tiles.Get(p.x / tile_size.x, p.y / tile_size.y);
+  }
+
   /**
    * Get field (not interpolated) directly, without bringing tiles to front.
    * @param p position/256
@@ -225,12 +289,31 @@ public:
 
   void Reset() noexcept;
 
+  /**
+   * Open (or create) the on-disk cache of decoded tiles for this
+   * terrain.  Tiles which are found there are loaded from the mapped
+   * file instead of being decoded, and newly decoded tiles are added
+   * to it.  Call this after the overview has been loaded, before
+   * loading tiles.
+   *
+   * Throws on error.
+   *
+   * @param original_path the path of the terrain (map) file
+   */
+  void OpenTileStore(FileCache &cache, Path original_path);
+
   const GeoBounds &GetBounds() const noexcept {
     assert(bounds.IsValid());
 
     return bounds;
   }
 
+  /**
+   * Count the tiles which are currently loaded (for statistics).
+   */
+  [[gnu::pure]]
+  unsigned CountLoadedTiles() const noexcept;
+
 public:
   /* methods called by class TerrainLoader */
 
@@ -0,0 +1,120 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "ShadingSSE2.hpp"
+
+#ifndef __AVX2__
+#error AVX2 required
+#endif
+
+#include <immintrin.h>
+
+/**
+ * Implementation of the terrain rendering kernels using Intel AVX2
+ * instructions.  This differs from #SSE2ShadingKernel only in the
+ * slope formula, which is calculated in 4 lanes of "double".
+ */
+class AVX2ShadingKernel {
+public:
+  static constexpr const char *NAME = "AVX2";
+
+  /**
+   * Vectorised ShadingParameters::Calculate() for four pixels.
+   */
+  [[gnu::always_inline]]
+  static __m128i Calculate(__m256d p22, __m256d p32,
+                           __m256d p20, __m256d p31,
+                           __m256d dd2_sz, __m256d dd2_square,
+                           __m256d sx, __m256d sy, __m256d sz,
+                           __m256d contrast) noexcept {
+    const __m256d dd0 = _mm256_mul_pd(p22, p31);
+    const __m256d dd1 = _mm256_mul_pd(p20, p32);
+    const __m256d num =
+      _mm256_add_pd(_mm256_add_pd(dd2_sz, _mm256_mul_pd(dd0, sx)),
+                    _mm256_mul_pd(dd1, sy));
+    const __m256d square_mag =
+      _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(dd0, dd0),
+                                  _mm256_mul_pd(dd1, dd1)),
+                    dd2_square);
+    const __m256d mag = _mm256_max_pd(_mm256_sqrt_pd(square_mag),
+                                      _mm256_set1_pd(1));
+
+    const __m256d sval =
+      _mm256_cvtepi32_pd(_mm256_cvttpd_epi32(_mm256_div_pd(num, mag)));
+
+    __m256d sindex =
+      _mm256_mul_pd(_mm256_mul_pd(_mm256_sub_pd(sval, sz), contrast),
+                    _mm256_set1_pd(1. / 128));
+    sindex = _mm256_min_pd(_mm256_max_pd(sindex, _mm256_set1_pd(-63)),
+                           _mm256_set1_pd(63));
+    return _mm256_cvttpd_epi32(sindex);
+  }
+
+  static void Index(const TerrainHeight *src, unsigned n,
+                    unsigned height_scale, unsigned contour_height_scale,
+                    uint8_t *index, uint8_t *contour) noexcept {
+    SSE2ShadingKernel::Index(src, n, height_scale, contour_height_scale,
+                             index, contour);
+  }
+
+  static void Shade(const ShadingParameters &shading,
+                    const TerrainHeight *above, const TerrainHeight *row,
+                    const TerrainHeight *below,
+                    unsigned step, unsigned p31, unsigned n,
+                    int8_t *illumination) noexcept {
+    using SSE2 = SSE2ShadingKernel;
+
+    const unsigned p20 = 2 * step;
+    const double dd2 = double(p20) * double(p31) *
+      double(shading.height_slope_factor);
+
+    const __m256d v_p20 = _mm256_set1_pd(p20), v_p31 = _mm256_set1_pd(p31);
+    const __m256d v_dd2_sz = _mm256_set1_pd(dd2 * double(shading.sz));
+    const __m256d v_dd2_square = _mm256_set1_pd(dd2 * dd2);
+    const __m256d sx = _mm256_set1_pd(shading.sx);
+    const __m256d sy = _mm256_set1_pd(shading.sy);
+    const __m256d sz = _mm256_set1_pd(shading.sz);
+    const __m256d contrast = _mm256_set1_pd(shading.contrast);
+    const __m128i no_illumination = _mm_set1_epi16(NO_ILLUMINATION);
+
+    unsigned i = 0;
+    for (; i + 8 <= n; i += 8) {
+      const __m128i h_above = SSE2::Load(above + i);
+      const __m128i h_below = SSE2::Load(below + i);
+      const __m128i h_left = SSE2::Load(row + i - step);
+      const __m128i h_right = SSE2::Load(row + i + step);
+
+      const __m128i special =
+        _mm_or_si128(_mm_or_si128(SSE2::IsSpecial(h_above),
+                                  SSE2::IsSpecial(h_below)),
+                     _mm_or_si128(SSE2::IsSpecial(h_left),
+                                  SSE2::IsSpecial(h_right)));
+
+      const __m256i p22 =
+        _mm256_cvtepi16_epi32(SSE2::ClipHeightDelta(h_right, h_left));
+      const __m256i p32 =
+        _mm256_cvtepi16_epi32(SSE2::ClipHeightDelta(h_above, h_below));
+
+      const __m128i lo =
+        Calculate(_mm256_cvtepi32_pd(_mm256_castsi256_si128(p22)),
+                  _mm256_cvtepi32_pd(_mm256_castsi256_si128(p32)),
+                  v_p20, v_p31, v_dd2_sz, v_dd2_square,
+                  sx, sy, sz, contrast);
+      const __m128i hi =
+        Calculate(_mm256_cvtepi32_pd(_mm256_extracti128_si256(p22, 1)),
+                  _mm256_cvtepi32_pd(_mm256_extracti128_si256(p32, 1)),
+                  v_p20, v_p31, v_dd2_sz, v_dd2_square,
+                  sx, sy, sz, contrast);
+
+      __m128i result = _mm_packs_epi32(lo, hi);
+      result = _mm_blendv_epi8(result, no_illumination, special);
+      _mm_storel_epi64((__m128i *)(illumination + i),
+                       _mm_packs_epi16(result, result));
+    }
+
+    PortableShadingKernel::Shade(shading, above + i, row + i, below + i,
+                                 step, p31, n - i, illumination + i);
+  }
+};
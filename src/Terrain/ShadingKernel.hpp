@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Height.hpp"
+
+#include <algorithm> // for std::clamp()
+#include <cmath>
+#include <cstdint>
+
+/**
+ * The value in the illumination row of pixels whose slope could not
+ * be calculated because one of its neighbours is "special" (water or
+ * invalid).
+ */
+static constexpr int8_t NO_ILLUMINATION = INT8_MIN;
+
+/**
+ * Clip the difference between two adjacent terrain height values to
+ * sane bounds.  This works around integer overflows in the
+ * ShadingParameters::Calculate() formula when the map file is broken,
+ * avoiding the sqrt() call with a negative argument.
+ */
+static constexpr int
+ClipHeightDelta(int d) noexcept
+{
+  return std::clamp(d, -512, 512);
+}
+
+static constexpr int
+ClipHeightDelta(TerrainHeight a, TerrainHeight b) noexcept
+{
+  return ClipHeightDelta(a.GetValue() - b.GetValue());
+}
+
+/**
+ * The parameters of the slope shading formula, which are constant
+ * for a whole image.
+ */
+struct ShadingParameters {
+  /**
+   * The direction of the sun light, scaled to 255.
+   */
+  int sx, sy, sz;
+
+  int contrast;
+
+  unsigned height_slope_factor;
+
+  /**
+   * Calculate the illumination of one pixel.
+   *
+   * @param p22 the (clipped) height difference between the right
+   * and the left neighbour
+   * @param p32 the (clipped) height difference between the upper
+   * and the lower neighbour
+   * @param p20 the distance between the left and the right neighbour
+   * @param p31 the distance between the upper and the lower neighbour
+   * @return the illumination in the range -63..63
+   */
+  [[gnu::pure]]
+  int Calculate(int p22, int p32,
+                unsigned p20, unsigned p31) const noexcept {
+    const int dd0 = p22 * int(p31);
+    const int dd1 = int(p20) * p32;
+    const double dd2 = double(p20) * double(p31) *
+      double(height_slope_factor);
+    const double num =
+      dd2 * double(sz) + double(dd0) * double(sx) +
+      double(dd1) * double(sy);
+    const double square_mag =
+      double(dd0) * double(dd0) +
+      double(dd1) * double(dd1) +
+      dd2 * dd2;
+    const double mag = sqrt(square_mag);
+    /* this is a workaround for a SIGFPE (division by zero)
+       observed by our users on some Android devices (e.g. Nexus
+       7), even though we did our best to make sure that the
+       integer arithmetics above can't overflow */
+    /* TODO: debug this problem and replace this workaround */
+    const int sval = int(num / std::max(mag, 1.0));
+    const int sindex = (sval - sz) * contrast / 128;
+    return std::clamp(sindex, -63, 63);
+  }
+};
+
+/**
+ * Portable implementation of the per-row terrain rendering kernels.
+ * The SIMD implementations use it for the remainder of each row.
+ *
+ * Since all inputs are integers and all intermediate values are
+ * exactly representable as "double", the SIMD implementations yield
+ * the very same pixels.
+ */
+class PortableShadingKernel {
+public:
+  static constexpr const char *NAME = "portable";
+
+  /**
+   * Calculate the color table index and the contour interval of
+   * each pixel in a row.  Both are 0 for "special" values; those
+   * must be handled by the caller.
+   */
+  static void Index(const TerrainHeight *src, unsigned n,
+                    unsigned height_scale, unsigned contour_height_scale,
+                    uint8_t *index, uint8_t *contour) noexcept {
+    for (unsigned i = 0; i < n; ++i) {
+      const unsigned h = std::max(0, (int)src[i].GetValue());
+      index[i] = std::min(254u, h >> height_scale);
+      contour[i] = std::min(254u, h >> contour_height_scale);
+    }
+  }
+
+  /**
+   * Calculate the illumination of each pixel in a row, or
+   * #NO_ILLUMINATION.  All neighbours must be inside the height
+   * matrix, i.e. the caller handles pixels near the left and right
+   * edge.
+   *
+   * @param above the row above #row, at the same column
+   * @param below the row below #row, at the same column
+   * @param step the distance to the left and the right neighbour
+   * @param p31 the distance between #above and #below in rows
+   */
+  static void Shade(const ShadingParameters &shading,
+                    const TerrainHeight *above, const TerrainHeight *row,
+                    const TerrainHeight *below,
+                    unsigned step, unsigned p31, unsigned n,
+                    int8_t *illumination) noexcept {
+    const unsigned p20 = 2 * step;
+
+    for (unsigned i = 0; i < n; ++i) {
+      const auto h_above = above[i];
+      const auto h_below = below[i];
+      const auto h_left = row[(int)i - (int)step];
+      const auto h_right = row[i + step];
+
+      if (h_above.IsSpecial() || h_below.IsSpecial() ||
+          h_left.IsSpecial() || h_right.IsSpecial()) [[unlikely]] {
+        illumination[i] = NO_ILLUMINATION;
+        continue;
+      }
+
+      illumination[i] = shading.Calculate(ClipHeightDelta(h_right, h_left),
+                                          ClipHeightDelta(h_above, h_below),
+                                          p20, p31);
+    }
+  }
+};
@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "ShadingKernel.hpp"
+
+#if !defined(__ARM_NEON) || !defined(__aarch64__)
+#error AArch64 NEON required
+#endif
+
+#include <arm_neon.h>
+
+/**
+ * Implementation of the terrain rendering kernels using ARM NEON
+ * instructions.  Heights are processed in 8 lanes of 16 bit, the
+ * slope formula in 2 lanes of "double" (which is why this requires
+ * AArch64; 32 bit ARM NEON has no "double" vectors).
+ */
+class NEONShadingKernel {
+public:
+  static constexpr const char *NAME = "NEON";
+
+  [[gnu::always_inline]]
+  static int16x8_t Load(const TerrainHeight *p) noexcept {
+    return vld1q_s16((const int16_t *)p);
+  }
+
+  [[gnu::always_inline]]
+  static uint16x8_t IsSpecial(int16x8_t v) noexcept {
+    return vcleq_s16(v, vdupq_n_s16(TerrainHeight::MAX_SPECIAL));
+  }
+
+  [[gnu::always_inline]]
+  static int16x8_t ClipHeightDelta(int16x8_t a, int16x8_t b) noexcept {
+    const int16x8_t d = vqsubq_s16(a, b);
+    return vminq_s16(vmaxq_s16(d, vdupq_n_s16(-512)), vdupq_n_s16(512));
+  }
+
+  /**
+   * Vectorised ShadingParameters::Calculate() for two pixels.
+   */
+  [[gnu::always_inline]]
+  static int32x2_t Calculate(int32x2_t _p22, int32x2_t _p32,
+                             float64x2_t p20, float64x2_t p31,
+                             float64x2_t dd2_sz, float64x2_t dd2_square,
+                             float64x2_t sx, float64x2_t sy, float64x2_t sz,
+                             float64x2_t contrast) noexcept {
+    const float64x2_t p22 = vcvtq_f64_s64(vmovl_s32(_p22));
+    const float64x2_t p32 = vcvtq_f64_s64(vmovl_s32(_p32));
+
+    const float64x2_t dd0 = vmulq_f64(p22, p31);
+    const float64x2_t dd1 = vmulq_f64(p20, p32);
+    const float64x2_t num = vaddq_f64(vaddq_f64(dd2_sz, vmulq_f64(dd0, sx)),
+                                      vmulq_f64(dd1, sy));
+    const float64x2_t square_mag =
+      vaddq_f64(vaddq_f64(vmulq_f64(dd0, dd0), vmulq_f64(dd1, dd1)),
+                dd2_square);
+    const float64x2_t mag = vmaxq_f64(vsqrtq_f64(square_mag),
+                                      vdupq_n_f64(1));
+
+    /* vcvtq_s64_f64() truncates, just like the portable
+       implementation */
+    const float64x2_t sval =
+      vcvtq_f64_s64(vcvtq_s64_f64(vdivq_f64(num, mag)));
+
+    float64x2_t sindex = vmulq_f64(vmulq_f64(vsubq_f64(sval, sz), contrast),
+                                   vdupq_n_f64(1. / 128));
+    sindex = vminq_f64(vmaxq_f64(sindex, vdupq_n_f64(-63)),
+                       vdupq_n_f64(63));
+    return vmovn_s64(vcvtq_s64_f64(sindex));
+  }
+
+  static void Index(const TerrainHeight *src, unsigned n,
+                    unsigned height_scale, unsigned contour_height_scale,
+                    uint8_t *index, uint8_t *contour) noexcept {
+    const int16x8_t zero = vdupq_n_s16(0);
+    const uint16x8_t max_index = vdupq_n_u16(254);
+
+    /* a negative shift count shifts right */
+    const int16x8_t v_height_scale = vdupq_n_s16(-(int)height_scale);
+    const int16x8_t v_contour_height_scale =
+      vdupq_n_s16(-(int)contour_height_scale);
+
+    for (; n >= 8; n -= 8, src += 8, index += 8, contour += 8) {
+      const uint16x8_t h = vreinterpretq_u16_s16(vmaxq_s16(Load(src), zero));
+      const uint16x8_t i = vminq_u16(vshlq_u16(h, v_height_scale),
+                                     max_index);
+      const uint16x8_t c = vminq_u16(vshlq_u16(h, v_contour_height_scale),
+                                     max_index);
+      vst1_u8(index, vmovn_u16(i));
+      vst1_u8(contour, vmovn_u16(c));
+    }
+
+    PortableShadingKernel::Index(src, n, height_scale, contour_height_scale,
+                                 index, contour);
+  }
+
+  static void Shade(const ShadingParameters &shading,
+                    const TerrainHeight *above, const TerrainHeight *row,
+                    const TerrainHeight *below,
+                    unsigned step, unsigned p31, unsigned n,
+                    int8_t *illumination) noexcept {
+    const unsigned p20 = 2 * step;
+    const double dd2 = double(p20) * double(p31) *
+      double(shading.height_slope_factor);
+
+    const float64x2_t v_p20 = vdupq_n_f64(p20), v_p31 = vdupq_n_f64(p31);
+    const float64x2_t v_dd2_sz = vdupq_n_f64(dd2 * double(shading.sz));
+    const float64x2_t v_dd2_square = vdupq_n_f64(dd2 * dd2);
+    const float64x2_t sx = vdupq_n_f64(shading.sx);
+    const float64x2_t sy = vdupq_n_f64(shading.sy);
+    const float64x2_t sz = vdupq_n_f64(shading.sz);
+    const float64x2_t contrast = vdupq_n_f64(shading.contrast);
+    const int16x8_t no_illumination = vdupq_n_s16(NO_ILLUMINATION);
+
+    unsigned i = 0;
+    for (; i + 8 <= n; i += 8) {
+      const int16x8_t h_above = Load(above + i), h_below = Load(below + i);
+      const int16x8_t h_left = Load(row + i - step);
+      const int16x8_t h_right = Load(row + i + step);
+
+      const uint16x8_t special =
+        vorrq_u16(vorrq_u16(IsSpecial(h_above), IsSpecial(h_below)),
+                  vorrq_u16(IsSpecial(h_left), IsSpecial(h_right)));
+
+      const int16x8_t p22 = ClipHeightDelta(h_right, h_left);
+      const int16x8_t p32 = ClipHeightDelta(h_above, h_below);
+
+      const int32x4_t p22_lo = vmovl_s16(vget_low_s16(p22));
+      const int32x4_t p22_hi = vmovl_high_s16(p22);
+      const int32x4_t p32_lo = vmovl_s16(vget_low_s16(p32));
+      const int32x4_t p32_hi = vmovl_high_s16(p32);
+
+      const int32x4_t lo =
+        vcombine_s32(Calculate(vget_low_s32(p22_lo), vget_low_s32(p32_lo),
+                               v_p20, v_p31, v_dd2_sz, v_dd2_square,
+                               sx, sy, sz, contrast),
+                     Calculate(vget_high_s32(p22_lo), vget_high_s32(p32_lo),
+                               v_p20, v_p31, v_dd2_sz, v_dd2_square,
+                               sx, sy, sz, contrast));
+      const int32x4_t hi =
+        vcombine_s32(Calculate(vget_low_s32(p22_hi), vget_low_s32(p32_hi),
+                               v_p20, v_p31, v_dd2_sz, v_dd2_square,
+                               sx, sy, sz, contrast),
+                     Calculate(vget_high_s32(p22_hi), vget_high_s32(p32_hi),
+                               v_p20, v_p31, v_dd2_sz, v_dd2_square,
+                               sx, sy, sz, contrast));
+
+      const int16x8_t result =
+        vbslq_s16(special, no_illumination,
+                  vcombine_s16(vmovn_s32(lo), vmovn_s32(hi)));
+      vst1_s8(illumination + i, vmovn_s16(result));
+    }
+
+    PortableShadingKernel::Shade(shading, above + i, row + i, below + i,
+                                 step, p31, n - i, illumination + i);
+  }
+};
@@ -0,0 +1,167 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "ShadingKernel.hpp"
+
+#ifndef __SSE2__
+#error SSE2 required
+#endif
+
+#include <emmintrin.h>
+
+/**
+ * Implementation of the terrain rendering kernels using Intel SSE2
+ * instructions.  Heights are processed in 8 lanes of 16 bit, the
+ * slope formula in 2 lanes of "double".
+ */
+class SSE2ShadingKernel {
+public:
+  static constexpr const char *NAME = "SSE2";
+
+  [[gnu::always_inline]]
+  static __m128i Load(const TerrainHeight *p) noexcept {
+    return _mm_loadu_si128((const __m128i *)p);
+  }
+
+  /**
+   * Returns all bits set in each lane where the height is "special".
+   */
+  [[gnu::always_inline]]
+  static __m128i IsSpecial(__m128i v) noexcept {
+    return _mm_cmplt_epi16(v, _mm_set1_epi16(TerrainHeight::MAX_SPECIAL + 1));
+  }
+
+  /**
+   * Vectorised ClipHeightDelta().  The saturating subtraction does
+   * not change the result after clipping.
+   */
+  [[gnu::always_inline]]
+  static __m128i ClipHeightDelta(__m128i a, __m128i b) noexcept {
+    const __m128i d = _mm_subs_epi16(a, b);
+    return _mm_min_epi16(_mm_max_epi16(d, _mm_set1_epi16(-512)),
+                         _mm_set1_epi16(512));
+  }
+
+  /**
+   * Vectorised ShadingParameters::Calculate() for two pixels.
+   *
+   * @return the illumination in the lower two 32 bit lanes
+   */
+  [[gnu::always_inline]]
+  static __m128i Calculate(__m128d p22, __m128d p32,
+                           __m128d p20, __m128d p31,
+                           __m128d dd2_sz, __m128d dd2_square,
+                           __m128d sx, __m128d sy, __m128d sz,
+                           __m128d contrast) noexcept {
+    const __m128d dd0 = _mm_mul_pd(p22, p31);
+    const __m128d dd1 = _mm_mul_pd(p20, p32);
+    const __m128d num = _mm_add_pd(_mm_add_pd(dd2_sz, _mm_mul_pd(dd0, sx)),
+                                   _mm_mul_pd(dd1, sy));
+    const __m128d square_mag = _mm_add_pd(_mm_add_pd(_mm_mul_pd(dd0, dd0),
+                                                     _mm_mul_pd(dd1, dd1)),
+                                          dd2_square);
+    const __m128d mag = _mm_max_pd(_mm_sqrt_pd(square_mag),
+                                   _mm_set1_pd(1));
+
+    /* truncate to integer, just like the portable implementation */
+    const __m128d sval = _mm_cvtepi32_pd(_mm_cvttpd_epi32(_mm_div_pd(num, mag)));
+
+    /* multiplying with 1/128 is exact, and truncating the clamped
+       value is the same as clamping the truncated integer
+       division */
+    __m128d sindex = _mm_mul_pd(_mm_mul_pd(_mm_sub_pd(sval, sz), contrast),
+                                _mm_set1_pd(1. / 128));
+    sindex = _mm_min_pd(_mm_max_pd(sindex, _mm_set1_pd(-63)),
+                        _mm_set1_pd(63));
+    return _mm_cvttpd_epi32(sindex);
+  }
+
+  static void Index(const TerrainHeight *src, unsigned n,
+                    unsigned height_scale, unsigned contour_height_scale,
+                    uint8_t *index, uint8_t *contour) noexcept {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max_index = _mm_set1_epi16(254);
+    const __m128i v_height_scale = _mm_cvtsi32_si128(height_scale);
+    const __m128i v_contour_height_scale =
+      _mm_cvtsi32_si128(contour_height_scale);
+
+    for (; n >= 8; n -= 8, src += 8, index += 8, contour += 8) {
+      const __m128i h = _mm_max_epi16(Load(src), zero);
+      const __m128i i = _mm_min_epi16(_mm_srl_epi16(h, v_height_scale),
+                                      max_index);
+      const __m128i c = _mm_min_epi16(_mm_srl_epi16(h, v_contour_height_scale),
+                                      max_index);
+      _mm_storel_epi64((__m128i *)index, _mm_packus_epi16(i, i));
+      _mm_storel_epi64((__m128i *)contour, _mm_packus_epi16(c, c));
+    }
+
+    PortableShadingKernel::Index(src, n, height_scale, contour_height_scale,
+                                 index, contour);
+  }
+
+  static void Shade(const ShadingParameters &shading,
+                    const TerrainHeight *above, const TerrainHeight *row,
+                    const TerrainHeight *below,
+                    unsigned step, unsigned p31, unsigned n,
+                    int8_t *illumination) noexcept {
+    const unsigned p20 = 2 * step;
+    const double dd2 = double(p20) * double(p31) *
+      double(shading.height_slope_factor);
+
+    const __m128d v_p20 = _mm_set1_pd(p20), v_p31 = _mm_set1_pd(p31);
+    const __m128d v_dd2_sz = _mm_set1_pd(dd2 * double(shading.sz));
+    const __m128d v_dd2_square = _mm_set1_pd(dd2 * dd2);
+    const __m128d sx = _mm_set1_pd(shading.sx), sy = _mm_set1_pd(shading.sy);
+    const __m128d sz = _mm_set1_pd(shading.sz);
+    const __m128d contrast = _mm_set1_pd(shading.contrast);
+    const __m128i no_illumination = _mm_set1_epi16(NO_ILLUMINATION);
+
+    unsigned i = 0;
+    for (; i + 8 <= n; i += 8) {
+      const __m128i h_above = Load(above + i), h_below = Load(below + i);
+      const __m128i h_left = Load(row + i - step);
+      const __m128i h_right = Load(row + i + step);
+
+      const __m128i special =
+        _mm_or_si128(_mm_or_si128(IsSpecial(h_above), IsSpecial(h_below)),
+                     _mm_or_si128(IsSpecial(h_left), IsSpecial(h_right)));
+
+      const __m128i p22 = ClipHeightDelta(h_right, h_left);
+      const __m128i p32 = ClipHeightDelta(h_above, h_below);
+
+      /* sign-extend to 32 bit */
+      const __m128i p22_lo = _mm_srai_epi32(_mm_unpacklo_epi16(p22, p22), 16);
+      const __m128i p22_hi = _mm_srai_epi32(_mm_unpackhi_epi16(p22, p22), 16);
+      const __m128i p32_lo = _mm_srai_epi32(_mm_unpacklo_epi16(p32, p32), 16);
+      const __m128i p32_hi = _mm_srai_epi32(_mm_unpackhi_epi16(p32, p32), 16);
+
+      __m128i r[4];
+      r[0] = Calculate(_mm_cvtepi32_pd(p22_lo), _mm_cvtepi32_pd(p32_lo),
+                       v_p20, v_p31, v_dd2_sz, v_dd2_square,
+                       sx, sy, sz, contrast);
+      r[1] = Calculate(_mm_cvtepi32_pd(_mm_srli_si128(p22_lo, 8)),
+                       _mm_cvtepi32_pd(_mm_srli_si128(p32_lo, 8)),
+                       v_p20, v_p31, v_dd2_sz, v_dd2_square,
+                       sx, sy, sz, contrast);
+      r[2] = Calculate(_mm_cvtepi32_pd(p22_hi), _mm_cvtepi32_pd(p32_hi),
+                       v_p20, v_p31, v_dd2_sz, v_dd2_square,
+                       sx, sy, sz, contrast);
+      r[3] = Calculate(_mm_cvtepi32_pd(_mm_srli_si128(p22_hi, 8)),
+                       _mm_cvtepi32_pd(_mm_srli_si128(p32_hi, 8)),
+                       v_p20, v_p31, v_dd2_sz, v_dd2_square,
+                       sx, sy, sz, contrast);
+
+      __m128i result = _mm_packs_epi32(_mm_unpacklo_epi64(r[0], r[1]),
+                                       _mm_unpacklo_epi64(r[2], r[3]));
+      result = _mm_or_si128(_mm_andnot_si128(special, result),
+                            _mm_and_si128(special, no_illumination));
+      _mm_storel_epi64((__m128i *)(illumination + i),
+                       _mm_packs_epi16(result, result));
+    }
+
+    PortableShadingKernel::Shade(shading, above + i, row + i, below + i,
+                                 step, p31, n - i, illumination + i);
+  }
+};
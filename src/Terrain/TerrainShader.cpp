@@ -0,0 +1,370 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "Terrain/TerrainShader.hpp"
+#include "Terrain/HeightMatrix.hpp"
+#include "Terrain/ShadingKernel.hpp"
+#include "Math/Angle.hpp"
+#include "ui/canvas/Ramp.hpp"
+#include "ui/canvas/RawBitmap.hpp"
+
+#if defined(__AVX2__)
+#include "Terrain/ShadingAVX2.hpp"
+using ShadingKernel = AVX2ShadingKernel;
+#elif defined(__SSE2__)
+#include "Terrain/ShadingSSE2.hpp"
+using ShadingKernel = SSE2ShadingKernel;
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include "Terrain/ShadingNEON.hpp"
+using ShadingKernel = NEONShadingKernel;
+#else
+using ShadingKernel = PortableShadingKernel;
+#endif
+
+#include <algorithm> // for std::clamp()
+#include <cassert>
+
+/**
+ * Interpolate between x and y with i/128, i.e. i/(1 << 7).
+ *
+ * i must be below or equal to 128.
+ */
+static constexpr unsigned
+MIX(unsigned x, unsigned y, unsigned i) noexcept
+{
+  return (x * i + y * ((1 << 7) - i)) >> 7;
+}
+
+/**
+ * Shade the given color according to the illumination value.
+ *
+ * illum = 64: Contour, mixed with 50% brown
+ * illum < 0:  Shadow, mixed with up to 50% dark blue
+ * illum > 0:  Highlight, mixed with up to 25% yellow
+ * illum = 0:  No shading
+ */
+static constexpr RawColor
+TerrainShading(const int illum, RGB8Color color) noexcept
+{
+  if (illum == -64) {
+    // brown color mixed in for contours
+    return RawColor(MIX(100, color.Red(), 64),
+                    MIX(70, color.Green(), 64),
+                    MIX(26, color.Blue(), 64));
+  } else if (illum < 0) {
+    // shadow to blue
+    int x = std::min(63, -illum);
+    return RawColor(MIX(0, color.Red(), x),
+                    MIX(0, color.Green(), x),
+                    MIX(64, color.Blue(), x));
+  } else if (illum > 0) {
+    // highlight to yellow
+    int x = std::min(32, illum / 2);
+    return RawColor(MIX(255, color.Red(), x),
+                    MIX(255, color.Green(), x),
+                    MIX(16, color.Blue(), x));
+  } else
+    return RawColor(color.Red(), color.Green(), color.Blue());
+}
+
+TerrainShader::~TerrainShader() noexcept
+{
+  delete[] color_table;
+  delete[] contour_column_base;
+  delete[] index_row;
+  delete[] contour_row;
+  delete[] illumination_row;
+}
+
+const char *
+TerrainShader::GetKernelName() noexcept
+{
+  return ShadingKernel::NAME;
+}
+
+void
+TerrainShader::AllocateBuffers(unsigned width) noexcept
+{
+  if (width <= buffer_width)
+    return;
+
+  delete[] contour_column_base;
+  delete[] index_row;
+  delete[] contour_row;
+  delete[] illumination_row;
+
+  buffer_width = width;
+  contour_column_base = new uint8_t[width];
+  index_row = new uint8_t[width];
+  contour_row = new uint8_t[width];
+  illumination_row = new int8_t[width];
+}
+
+void
+TerrainShader::GenerateImage(const HeightMatrix &matrix,
+                             RawColor *dest, std::ptrdiff_t pitch,
+                             bool do_shading,
+                             unsigned height_scale,
+                             int contrast, int brightness,
+                             const Angle sunazimuth,
+                             bool do_contour,
+                             unsigned quantisation_effective,
+                             double pixel_size) noexcept
+{
+  assert(color_table != nullptr);
+
+  AllocateBuffers(matrix.GetSize().x);
+
+  if (quantisation_effective == 0) {
+    do_shading = false;
+    do_contour = false;
+  }
+
+  const unsigned contour_height_scale = do_contour? height_scale * 2 : 16;
+
+  ContourStart(matrix, contour_height_scale);
+
+  if (do_shading) {
+    const Angle fudgeelevation = Angle::Degrees(10) +
+      Angle::Degrees(80.0 / 255.0) * brightness;
+
+    const int sx = (int)(255 * fudgeelevation.fastcosine() * -sunazimuth.fastsine());
+    const int sy = (int)(255 * fudgeelevation.fastcosine() * -sunazimuth.fastcosine());
+    const int sz = (int)(255 * fudgeelevation.fastsine());
+
+    const unsigned height_slope_factor =
+      std::clamp((unsigned)pixel_size, 1u,
+                 /* this upper limit avoids integer overflows in the
+                    "mag" formula; it effectively limits "dd2" so
+                    calculating its square will not overflow */
+                 8192u / (quantisation_effective * quantisation_effective));
+
+    const ShadingParameters shading{
+      sx, sy, sz, contrast, height_slope_factor,
+    };
+
+    GenerateSlopeImage(matrix, dest, pitch, height_scale, shading,
+                       quantisation_effective, contour_height_scale);
+  } else
+    GenerateUnshadedImage(matrix, dest, pitch,
+                          height_scale, contour_height_scale);
+}
+
+void
+TerrainShader::GenerateUnshadedImage(const HeightMatrix &matrix,
+                                     RawColor *dest, std::ptrdiff_t pitch,
+                                     const unsigned height_scale,
+                                     const unsigned contour_height_scale) noexcept
+{
+  const unsigned width = matrix.GetSize().x;
+  const RawColor *oColorBuf = color_table + 64 * 256;
+
+  for (unsigned y = 0; y < matrix.GetSize().y; ++y, dest += pitch) {
+    const TerrainHeight *const src = matrix.GetRow(y);
+
+    ShadingKernel::Index(src, width, height_scale, contour_height_scale,
+                         index_row, contour_row);
+
+    unsigned contour_row_base = contour_row[0];
+
+    for (unsigned x = 0; x < width; ++x) {
+      const auto e = src[x];
+      if (!e.IsSpecial()) [[likely]] {
+        const unsigned h = index_row[x];
+        const unsigned contour_interval = contour_row[x];
+
+        if (contour_interval != contour_row_base ||
+            contour_interval != contour_column_base[x]) [[unlikely]] {
+          dest[x] = oColorBuf[(int)h - 64 * 256];
+          contour_column_base[x] = contour_row_base = contour_interval;
+        } else {
+          dest[x] = oColorBuf[h];
+        }
+      } else if (e.IsWater()) {
+        // we're in the water, so look up the color for water
+        dest[x] = oColorBuf[255];
+      } else {
+        /* outside the terrain file bounds: white background */
+        dest[x] = RawColor(0xff, 0xff, 0xff);
+      }
+    }
+  }
+}
+
+/**
+ * Calculate the illumination of a pixel near the left or right edge
+ * of the height matrix, where the horizontal neighbours are closer
+ * than #quantisation_effective.
+ */
+[[gnu::pure]]
+static int
+ShadeEdgePixel(const ShadingParameters &shading,
+               const TerrainHeight *above, const TerrainHeight *row,
+               const TerrainHeight *below,
+               unsigned x, unsigned width,
+               unsigned quantisation_effective, unsigned p31) noexcept
+{
+  const unsigned column_plus_index = x + quantisation_effective < width
+    ? quantisation_effective
+    : width - 1 - x;
+  const unsigned column_minus_index = x >= quantisation_effective
+    ? quantisation_effective : x;
+
+  const auto h_above = above[x];
+  const auto h_below = below[x];
+  const auto h_left = row[x - column_minus_index];
+  const auto h_right = row[x + column_plus_index];
+
+  if (h_above.IsSpecial() || h_below.IsSpecial() ||
+      h_left.IsSpecial() || h_right.IsSpecial())
+    return NO_ILLUMINATION;
+
+  return shading.Calculate(ClipHeightDelta(h_right, h_left),
+                           ClipHeightDelta(h_above, h_below),
+                           column_plus_index + column_minus_index, p31);
+}
+
+// JMW: if zoomed right in (e.g. one unit is larger than terrain
+// grid), then increase the step size to be equal to the terrain
+// grid for purposes of calculating slope, to avoid shading problems
+// (gridding of display) This is why quantisation_effective is used instead of 1
+// previously.  for large zoom levels, quantisation_effective=1
+void
+TerrainShader::GenerateSlopeImage(const HeightMatrix &matrix,
+                                  RawColor *dest, std::ptrdiff_t pitch,
+                                  unsigned height_scale,
+                                  const ShadingParameters &shading,
+                                  const unsigned quantisation_effective,
+                                  const unsigned contour_height_scale) noexcept
+{
+  assert(quantisation_effective > 0);
+
+  const auto size = matrix.GetSize();
+  const RawColor *oColorBuf = color_table + 64 * 256;
+
+  /* the SIMD kernel shades the columns whose horizontal neighbours
+     are quantisation_effective pixels away; the ones near the edges
+     are done by ShadeEdgePixel() */
+  const unsigned interior_begin = std::min(quantisation_effective, size.x);
+  const unsigned interior_end =
+    std::max(interior_begin,
+             size.x > quantisation_effective
+             ? size.x - quantisation_effective
+             : 0u);
+
+  for (unsigned y = 0; y < size.y; ++y, dest += pitch) {
+    const unsigned row_plus_index = y + quantisation_effective < size.y
+      ? quantisation_effective
+      : size.y - 1 - y;
+    const unsigned row_minus_index = y >= quantisation_effective
+      ? quantisation_effective : y;
+
+    const unsigned p31 = row_plus_index + row_minus_index;
+
+    const TerrainHeight *const src = matrix.GetRow(y);
+    const TerrainHeight *const above = matrix.GetRow(y - row_minus_index);
+    const TerrainHeight *const below = matrix.GetRow(y + row_plus_index);
+
+    assert(below < matrix.GetDataEnd());
+
+    ShadingKernel::Index(src, size.x, height_scale, contour_height_scale,
+                         index_row, contour_row);
+
+    if (interior_end > interior_begin)
+      ShadingKernel::Shade(shading,
+                           above + interior_begin, src + interior_begin,
+                           below + interior_begin,
+                           quantisation_effective, p31,
+                           interior_end - interior_begin,
+                           illumination_row + interior_begin);
+
+    for (unsigned x = 0; x < interior_begin; ++x)
+      illumination_row[x] = ShadeEdgePixel(shading, above, src, below,
+                                           x, size.x,
+                                           quantisation_effective, p31);
+
+    for (unsigned x = interior_end; x < size.x; ++x)
+      illumination_row[x] = ShadeEdgePixel(shading, above, src, below,
+                                           x, size.x,
+                                           quantisation_effective, p31);
+
+    unsigned contour_row_base = contour_row[0];
+
+    for (unsigned x = 0; x < size.x; ++x) {
+      const auto e = src[x];
+      if (!e.IsSpecial()) [[likely]] {
+        // no need to calculate slope if undefined height or sea level
+
+        const unsigned h = index_row[x];
+        const int illumination = illumination_row[x];
+
+        if (illumination == NO_ILLUMINATION) [[unlikely]] {
+          /* some "special" terrain value surrounding us (water or
+             invalid), skip slope calculation */
+          dest[x] = oColorBuf[h];
+          continue;
+        }
+
+        const unsigned contour_interval = contour_row[x];
+        if (contour_interval != contour_row_base ||
+            contour_interval != contour_column_base[x]) [[unlikely]] {
+          contour_column_base[x] = contour_row_base = contour_interval;
+          dest[x] = oColorBuf[int(h) - 64 * 256];
+          continue;
+        }
+
+        dest[x] = oColorBuf[int(h) + 256 * illumination];
+      } else if (e.IsWater()) {
+        // we're in the water, so look up the color for water
+        dest[x] = oColorBuf[255];
+      } else {
+        /* outside the terrain file bounds: white background */
+        dest[x] = RawColor(0xff, 0xff, 0xff);
+      }
+    }
+  }
+}
+
+void
+TerrainShader::PrepareColorTable(const ColorRamp *color_ramp, bool do_water,
+                                 unsigned height_scale, int interp_levels) noexcept
+{
+  if (color_table == nullptr)
+    color_table = new RawColor[256 * 128];
+
+  for (int i = 0; i < 256; i++) {
+    for (int mag = -64; mag < 64; mag++) {
+      RawColor color;
+
+      if (i == 255) {
+        if (do_water) {
+          // water colours
+          color = RawColor(85, 160, 255);
+        } else {
+          color = RawColor(255, 255, 255);
+
+          // ColorRampLookup(0, r, g, b,
+          // Color_ramp, NUM_COLOR_RAMP_LEVELS, interp_levels);
+        }
+      } else {
+        const RGB8Color color2 =
+          ColorRampLookup(i << height_scale, color_ramp,
+                          NUM_COLOR_RAMP_LEVELS, interp_levels);
+
+        color = TerrainShading(mag, color2);
+      }
+
+      color_table[i + (mag + 64) * 256] = color;
+    }
+  }
+}
+
+void
+TerrainShader::ContourStart(const HeightMatrix &matrix,
+                            const unsigned contour_height_scale) noexcept
+{
+  // initialise column to first row
+  ShadingKernel::Index(matrix.GetData(), matrix.GetSize().x,
+                       0, contour_height_scale,
+                       index_row, contour_column_base);
+}
@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+static constexpr unsigned NUM_COLOR_RAMP_LEVELS = 13;
+
+class Angle;
+class HeightMatrix;
+struct RawColor;
+struct ColorRamp;
+struct ShadingParameters;
+
+/**
+ * Converts a #HeightMatrix to pixels, with optional slope shading and
+ * contour lines.
+ *
+ * The arithmetic is done row by row with SIMD instructions (SSE2 or
+ * AVX2 on x86, NEON on AArch64) if the compiler targets them, with a
+ * portable fallback; only the color table lookups are scalar.
+ *
+ * This class does not depend on the screen library, which allows
+ * benchmarking it without a display.
+ */
+class TerrainShader {
+  RawColor *color_table = nullptr;
+
+  /**
+   * The number of columns the following buffers have been allocated
+   * for.
+   */
+  unsigned buffer_width = 0;
+
+  /**
+   * The contour interval of the previous row in each column.
+   */
+  uint8_t *contour_column_base = nullptr;
+
+  /**
+   * Scratch buffers for one row, filled by the SIMD kernels: the
+   * color table index, the contour interval and the illumination of
+   * each pixel.
+   */
+  uint8_t *index_row = nullptr, *contour_row = nullptr;
+  int8_t *illumination_row = nullptr;
+
+public:
+  TerrainShader() noexcept = default;
+  ~TerrainShader() noexcept;
+
+  TerrainShader(const TerrainShader &) = delete;
+  TerrainShader &operator=(const TerrainShader &) = delete;
+
+  /**
+   * Returns the name of the SIMD kernel which was compiled in.
+   */
+  [[gnu::const]]
+  static const char *GetKernelName() noexcept;
+
+  /**
+   * Fills the color_table array with precomputed colors for 256 height and
+   * 64 illumination levels. This is used to speed up the rendering by
+   * preventing the same color calculations over and over again.
+   */
+  void PrepareColorTable(const ColorRamp *color_ramp, bool do_water,
+                         unsigned height_scale, int interp_levels) noexcept;
+
+  /**
+   * Convert the height matrix into an image.
+   *
+   * @param dest the top row of the image
+   * @param pitch the distance from one row of the image to the next
+   * one (negative for bottom-up images)
+   * @param quantisation_effective the step size used for slope
+   * calculations; 0 disables slope shading and contour lines
+   * @param pixel_size the edge length of one height matrix cell in
+   * meters
+   */
+  void GenerateImage(const HeightMatrix &matrix,
+                     RawColor *dest, std::ptrdiff_t pitch,
+                     bool do_shading,
+                     unsigned height_scale, int contrast, int brightness,
+                     Angle sunazimuth,
+                     bool do_contour,
+                     unsigned quantisation_effective,
+                     double pixel_size) noexcept;
+
+private:
+  void AllocateBuffers(unsigned width) noexcept;
+
+  void ContourStart(const HeightMatrix &matrix,
+                    unsigned contour_height_scale) noexcept;
+
+  /**
+   * Convert the height matrix into the image, without shading.
+   */
+  void GenerateUnshadedImage(const HeightMatrix &matrix,
+                             RawColor *dest, std::ptrdiff_t pitch,
+                             unsigned height_scale,
+                             unsigned contour_height_scale) noexcept;
+
+  /**
+   * Convert the height matrix into the image, with slope shading.
+   */
+  void GenerateSlopeImage(const HeightMatrix &matrix,
+                          RawColor *dest, std::ptrdiff_t pitch,
+                          unsigned height_scale,
+                          const ShadingParameters &shading,
+                          unsigned quantisation_effective,
+                          unsigned contour_height_scale) noexcept;
+};
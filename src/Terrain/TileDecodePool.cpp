@@ -0,0 +1,102 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "TileDecodePool.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+TileDecodePool::TileDecodePool(unsigned n_threads)
+  :max_queued(n_threads)
+{
+  for (unsigned i = 0; i < n_threads; ++i) {
+    auto &worker = workers.emplace_back(*this);
+    try {
+      worker.Start();
+    } catch (...) {
+      /* this one was never started, so Stop() must not join it */
+      workers.pop_back();
+      Stop();
+      throw;
+    }
+  }
+}
+
+TileDecodePool::~TileDecodePool() noexcept
+{
+  Stop();
+}
+
+void
+TileDecodePool::Stop() noexcept
+{
+  {
+    const std::scoped_lock lock{mutex};
+    quit = true;
+    work_cond.notify_all();
+  }
+
+  for (auto &i : workers)
+    i.Join();
+}
+
+unsigned
+TileDecodePool::GetDefaultThreadCount() noexcept
+{
+  /* leave one core for the thread which reads the code stream (and
+     for the rest of XCSoar); decoding is CPU bound, and more than a
+     few threads don't help because MAX_ACTIVATE limits the number of
+     tiles per update */
+  const unsigned n_cpus = std::thread::hardware_concurrency();
+  if (n_cpus <= 1)
+    return 0;
+
+  return std::min(n_cpus - 1, 8U);
+}
+
+void
+TileDecodePool::Submit(Job &&job) noexcept
+{
+  std::unique_lock lock{mutex};
+  done_cond.wait(lock, [this]{ return queue.size() < max_queued; });
+
+  queue.emplace_back(std::move(job));
+  work_cond.notify_one();
+}
+
+bool
+TileDecodePool::Wait() noexcept
+{
+  std::unique_lock lock{mutex};
+  done_cond.wait(lock, [this]{ return queue.empty() && running == 0; });
+
+  return !std::exchange(failed, false);
+}
+
+void
+TileDecodePool::Run() noexcept
+{
+  std::unique_lock lock{mutex};
+
+  while (true) {
+    work_cond.wait(lock, [this]{ return quit || !queue.empty(); });
+    if (queue.empty())
+      /* quit, but only after all jobs have been finished */
+      break;
+
+    Job job = std::move(queue.front());
+    queue.pop_front();
+    ++running;
+
+    lock.unlock();
+    const bool success = job();
+    lock.lock();
+
+    --running;
+    if (!success)
+      failed = true;
+
+    done_cond.notify_all();
+  }
+}
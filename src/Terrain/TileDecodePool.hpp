@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "thread/Mutex.hxx"
+#include "thread/Cond.hxx"
+#include "thread/Thread.hpp"
+
+#include <deque>
+#include <functional>
+#include <list>
+
+/**
+ * A set of threads which decode terrain tiles in parallel while the
+ * #TerrainLoader keeps reading the JPEG2000 code stream.
+ *
+ * The number of queued jobs is limited, so Submit() blocks when the
+ * workers fall behind; this bounds the amount of memory occupied by
+ * tiles which have been read but not yet decoded.
+ */
+class TileDecodePool {
+public:
+  /**
+   * A decoder job.  Returns false on error.
+   */
+  using Job = std::function<bool()>;
+
+private:
+  class Worker final : public Thread {
+    TileDecodePool &pool;
+
+  public:
+    explicit Worker(TileDecodePool &_pool) noexcept
+      :Thread("TileDecode"), pool(_pool) {}
+
+  protected:
+    void Run() noexcept override {
+      pool.Run();
+    }
+  };
+
+  std::list<Worker> workers;
+
+  Mutex mutex;
+
+  /**
+   * Signalled when a job has been queued and when the pool shall be
+   * stopped.
+   */
+  Cond work_cond;
+
+  /**
+   * Signalled when a job has been finished.
+   */
+  Cond done_cond;
+
+  std::deque<Job> queue;
+
+  const std::size_t max_queued;
+
+  /**
+   * The number of jobs which are currently running.
+   */
+  unsigned running = 0;
+
+  /**
+   * Has one of the jobs failed since the last Wait() call?
+   */
+  bool failed = false;
+
+  bool quit = false;
+
+public:
+  /**
+   * Throws on error.
+   *
+   * @param n_threads the number of worker threads
+   */
+  explicit TileDecodePool(unsigned n_threads);
+
+  ~TileDecodePool() noexcept;
+
+  TileDecodePool(const TileDecodePool &) = delete;
+  TileDecodePool &operator=(const TileDecodePool &) = delete;
+
+  /**
+   * Determine how many worker threads are useful on this machine.
+   *
+   * @return the number of threads, or 0 if tiles shall rather be
+   * decoded by the calling thread
+   */
+  static unsigned GetDefaultThreadCount() noexcept;
+
+  /**
+   * Queue a job.  Blocks while the queue is full.
+   */
+  void Submit(Job &&job) noexcept;
+
+  /**
+   * Wait until all jobs have been finished.
+   *
+   * @return false if at least one of them has failed
+   */
+  bool Wait() noexcept;
+
+private:
+  void Stop() noexcept;
+  void Run() noexcept;
+};
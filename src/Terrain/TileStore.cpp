@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "TileStore.hpp"
+#include "io/FileMapping.hpp"
+#include "io/FileOutputStream.hxx"
+#include "util/SpanCast.hxx"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+/* the file is in host byte order; on a machine with a different byte
+   order, the magic doesn't match, and the store is rebuilt */
+static constexpr uint32_t TILE_STORE_MAGIC = 0x7e1a5704;
+static constexpr uint32_t TILE_STORE_VERSION = 1;
+
+static constexpr uint32_t TILE_SLOT_MAGIC = 0x5107e1a5;
+
+/**
+ * Don't let the file grow beyond this size.  This is well below the
+ * limit of class #FileMapping.
+ */
+static constexpr uint64_t MAX_TILE_STORE_SIZE = 512 * 1024 * 1024;
+
+struct TileStoreHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t width, height;
+  uint32_t n_tiles_x, n_tiles_y;
+  uint16_t tile_width, tile_height;
+};
+
+/**
+ * Each slot begins with this header, followed by the tile's height
+ * data (row by row, without padding); the rest of the slot is unused.
+ */
+struct TileSlotHeader {
+  uint32_t magic;
+  uint32_t tile;
+};
+
+static_assert(std::is_trivially_copyable_v<TerrainHeight>);
+static_assert(sizeof(TerrainHeight) == 2);
+static_assert(sizeof(TileStoreHeader) % alignof(TerrainHeight) == 0);
+static_assert(sizeof(TileSlotHeader) % alignof(TerrainHeight) == 0);
+
+TerrainTileStore::TerrainTileStore(const Geometry &_geometry) noexcept
+  :geometry(_geometry),
+   mapped(geometry.GetTileCount()),
+   stored(geometry.GetTileCount(), false)
+{
+  std::fill(mapped.begin(), mapped.end(), nullptr);
+}
+
+TerrainTileStore::~TerrainTileStore() noexcept = default;
+
+inline std::size_t
+TerrainTileStore::GetSlotSize() const noexcept
+{
+  return sizeof(TileSlotHeader) +
+    std::size_t(geometry.tile_size.x) * geometry.tile_size.y *
+    sizeof(TerrainHeight);
+}
+
+[[gnu::pure]]
+static TileStoreHeader
+MakeHeader(const TerrainTileStore::Geometry &geometry) noexcept
+{
+  TileStoreHeader header{};
+  header.magic = TILE_STORE_MAGIC;
+  header.version = TILE_STORE_VERSION;
+  header.width = geometry.size.x;
+  header.height = geometry.size.y;
+  header.n_tiles_x = geometry.n_tiles.x;
+  header.n_tiles_y = geometry.n_tiles.y;
+  header.tile_width = geometry.tile_size.x;
+  header.tile_height = geometry.tile_size.y;
+  return header;
+}
+
+bool
+TerrainTileStore::Map(std::unique_ptr<FileMapping> &&_mapping,
+                      std::span<const std::byte> payload) noexcept
+{
+  const TileStoreHeader expected = MakeHeader(geometry);
+  if (payload.size() < sizeof(expected) ||
+      memcmp(payload.data(), &expected, sizeof(expected)) != 0)
+    return false;
+
+  /* the height data is accessed in place */
+  if (reinterpret_cast<uintptr_t>(payload.data()) % alignof(TerrainHeight) != 0)
+    return false;
+
+  const auto slots = payload.subspan(sizeof(expected));
+  const std::size_t slot_size = GetSlotSize();
+
+  /* a partial slot at the end (after a crash) would misalign all
+     slots appended later */
+  if (slots.size() % slot_size != 0)
+    return false;
+
+  for (std::size_t offset = 0; offset < slots.size(); offset += slot_size) {
+    TileSlotHeader slot;
+    memcpy(&slot, slots.data() + offset, sizeof(slot));
+
+    if (slot.magic != TILE_SLOT_MAGIC || slot.tile >= mapped.size())
+      return false;
+
+    mapped[slot.tile] = reinterpret_cast<const TerrainHeight *>(slots.data() + offset + sizeof(slot));
+    stored[slot.tile] = true;
+  }
+
+  mapping = std::move(_mapping);
+  file_size = payload.size();
+  return true;
+}
+
+void
+TerrainTileStore::WriteHeader(OutputStream &os)
+{
+  const TileStoreHeader header = MakeHeader(geometry);
+  os.Write(ReferenceAsBytes(header));
+  file_size = sizeof(header);
+}
+
+void
+TerrainTileStore::SetOutput(std::unique_ptr<FileOutputStream> &&_output) noexcept
+{
+  output = std::move(_output);
+}
+
+void
+TerrainTileStore::Append(unsigned index,
+                         std::span<const TerrainHeight> data) noexcept
+{
+  if (output == nullptr || index >= stored.size() || stored[index])
+    return;
+
+  const std::size_t slot_size = GetSlotSize();
+  if (file_size + slot_size > MAX_TILE_STORE_SIZE ||
+      data.size_bytes() > slot_size - sizeof(TileSlotHeader)) {
+    output.reset();
+    return;
+  }
+
+  /* write the whole slot with one system call, so a crash leaves at
+     most a partial slot at the end of the file, which is detected
+     by Map() */
+  std::vector<std::byte> slot(slot_size);
+
+  TileSlotHeader header;
+  header.magic = TILE_SLOT_MAGIC;
+  header.tile = index;
+  memcpy(slot.data(), &header, sizeof(header));
+  memcpy(slot.data() + sizeof(header), data.data(), data.size_bytes());
+
+  try {
+    output->Write(slot);
+  } catch (...) {
+    /* the store is only a cache; stop writing to it */
+    output.reset();
+    return;
+  }
+
+  stored[index] = true;
+  file_size += slot_size;
+}
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "Height.hpp"
+#include "RasterLocation.hpp"
+#include "util/AllocatedArray.hxx"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+class FileMapping;
+class FileOutputStream;
+class OutputStream;
+
+/**
+ * An on-disk cache of decoded terrain tiles.  The file is mapped into
+ * memory, and a #RasterTile which is in this store points right into
+ * the mapping, i.e. it is loaded without decoding and without
+ * allocating heap memory; the kernel reads its pages on demand.
+ *
+ * The file consists of a header followed by fixed-size slots, each
+ * containing one tile.  Newly decoded tiles are appended to the file;
+ * they are used from the mapping after the file has been mapped
+ * again (i.e. on the next startup).
+ */
+class TerrainTileStore {
+public:
+  /**
+   * The file layout depends on these parameters; if the terrain file
+   * does not match them, the store is discarded.
+   */
+  struct Geometry {
+    RasterLocation size;
+    UnsignedPoint2D n_tiles;
+    Point2D<uint_least16_t> tile_size;
+
+    unsigned GetTileCount() const noexcept {
+      return n_tiles.x * n_tiles.y;
+    }
+  };
+
+private:
+  const Geometry geometry;
+
+  std::unique_ptr<FileMapping> mapping;
+
+  /**
+   * The height data of each tile inside the #mapping, or nullptr if
+   * the tile is not in the mapped portion of the file.
+   */
+  AllocatedArray<const TerrainHeight *> mapped;
+
+  /**
+   * Which tiles are in the file?  This includes the ones appended
+   * after the file was mapped.
+   */
+  std::vector<bool> stored;
+
+  /**
+   * The file new tiles are appended to; nullptr if the store is
+   * read-only (e.g. after an I/O error or if it is full).
+   */
+  std::unique_ptr<FileOutputStream> output;
+
+  /**
+   * The current size of the file (without the #FileCache header).
+   */
+  uint64_t file_size = 0;
+
+public:
+  explicit TerrainTileStore(const Geometry &_geometry) noexcept;
+  ~TerrainTileStore() noexcept;
+
+  TerrainTileStore(const TerrainTileStore &) = delete;
+  TerrainTileStore &operator=(const TerrainTileStore &) = delete;
+
+  /**
+   * Use the tiles in the given file mapping.
+   *
+   * @param payload the portion of the mapping after the #FileCache
+   * header
+   * @return false if the file is malformed or does not belong to
+   * this terrain
+   */
+  bool Map(std::unique_ptr<FileMapping> &&_mapping,
+           std::span<const std::byte> payload) noexcept;
+
+  /**
+   * Write the header of a new (empty) file.
+   *
+   * Throws on error.
+   */
+  void WriteHeader(OutputStream &os);
+
+  /**
+   * Enable appending new tiles to the file (which must have been
+   * mapped or created with WriteHeader() before).
+   */
+  void SetOutput(std::unique_ptr<FileOutputStream> &&_output) noexcept;
+
+  /**
+   * Returns the height data of the given tile, or nullptr if it is
+   * not available from the mapped file.
+   */
+  [[gnu::pure]]
+  const TerrainHeight *Find(unsigned index) const noexcept {
+    return index < mapped.size() ? mapped[index] : nullptr;
+  }
+
+  /**
+   * Append a freshly decoded tile to the file (unless it is already
+   * there).  Errors are not fatal: they just disable appending.
+   */
+  void Append(unsigned index, std::span<const TerrainHeight> data) noexcept;
+
+private:
+  std::size_t GetSlotSize() const noexcept;
+};
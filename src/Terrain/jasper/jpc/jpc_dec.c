@@ -693,18 +693,24 @@ static int jpc_dec_process_sod(jpc_dec_t *dec, jpc_ms_t *ms)
 
 	}
 
+	dec->curtile = 0;
+
 	if (tile->numparts > 0 && tile->partno == tile->numparts - 1) {
-		if (jpc_dec_tiledecode(dec, tile)) {
-			return -1;
+		/* Increment the expected tile-part number before the tile
+		  may be handed to another thread. */
+		++tile->partno;
+
+		if (!jas_rtc_SubmitTile(dec->loader, dec, tile)) {
+			if (jpc_dec_tiledecode(dec, tile)) {
+				return -1;
+			}
+			jpc_dec_tilefini(dec, tile);
 		}
-		jpc_dec_tilefini(dec, tile);
+	} else {
+		/* Increment the expected tile-part number. */
+		++tile->partno;
 	}
 
-	dec->curtile = 0;
-
-	/* Increment the expected tile-part number. */
-	++tile->partno;
-
 	/* We should expect to encounter a SOT marker segment next. */
 	dec->state = JPC_TPHSOT;
 
@@ -1325,6 +1331,13 @@ static int jpc_dec_tiledecode(jpc_dec_t *dec, jpc_dec_tile_t *tile)
 	return 0;
 }
 
+int jpc_dec_tiledecode_fini(jpc_dec_t *dec, jpc_dec_tile_t *tile)
+{
+	const int ret = jpc_dec_tiledecode(dec, tile);
+	jpc_dec_tilefini(dec, tile);
+	return ret;
+}
+
 static int jpc_dec_process_eoc(jpc_dec_t *dec, jpc_ms_t *ms)
 {
 	jpc_dec_tile_t *tile;
@@ -1332,6 +1345,11 @@ static int jpc_dec_process_eoc(jpc_dec_t *dec, jpc_ms_t *ms)
 	/* Eliminate compiler warnings about unused variables. */
 	(void)ms;
 
+	/* Wait for the tiles which are being decoded asynchronously. */
+	if (jas_rtc_WaitTiles(dec->loader)) {
+		return -1;
+	}
+
 	unsigned tileno;
 	for (tileno = 0, tile = dec->tiles; tileno < dec->numtiles; ++tileno,
 	  ++tile) {
@@ -2210,6 +2228,7 @@ jpc_dec_t *jpc_dec_create(jpc_dec_importopts_t *impopts, jas_stream_t *in)
 	dec->ppmstab = 0;
 #endif /* ENABLE_JASPER_PPM */
 	dec->curtileendoff = 0;
+	dec->loader = 0;
 	dec->max_samples = impopts->max_samples;
 
 	if (jas_getdbglevel() >= 1) {
@@ -2221,6 +2240,12 @@ jpc_dec_t *jpc_dec_create(jpc_dec_importopts_t *impopts, jas_stream_t *in)
 
 void jpc_dec_destroy(jpc_dec_t *dec)
 {
+	/* After an error, tiles may still be decoded asynchronously, and
+	  they need the decoder state. */
+	if (dec->loader) {
+		jas_rtc_WaitTiles(dec->loader);
+	}
+
 	if (dec->cstate) {
 		jpc_cstate_destroy(dec->cstate);
 	}
@@ -692,6 +692,11 @@ void jpc_dec_destroy(jpc_dec_t *dec);
 
 int jpc_dec_decode(jpc_dec_t *dec);
 
+/* Decode a tile whose last tile-part has been read, and finalize it.
+  This does not access the code stream, and may therefore be called
+  in another thread (see jas_rtc_SubmitTile()). */
+int jpc_dec_tiledecode_fini(jpc_dec_t *dec, jpc_dec_tile_t *tile);
+
 /* Create a decoder segment object. */
 gcc_malloc
 jpc_dec_seg_t *jpc_seg_alloc(void);
@@ -1,4 +1,7 @@
 #include "jasper/jpc_rtc.h"
+extern "C" {
+#include "jasper/jpc/jpc_dec.h"
+}
 #include "Terrain/Loader.hpp"
 #include "Terrain/RasterLocation.hpp"
 
@@ -34,6 +37,20 @@ extern "C" {
                                      *data);
   }
 
+  bool jas_rtc_SubmitTile(void *_loader, void *_dec, void *_tile) {
+    auto &loader = *(TerrainLoader *)_loader;
+    auto *dec = (jpc_dec_t *)_dec;
+    auto *tile = (jpc_dec_tile_t *)_tile;
+    return loader.SubmitTile([dec, tile]{
+      return jpc_dec_tiledecode_fini(dec, tile) == 0;
+    });
+  }
+
+  int jas_rtc_WaitTiles(void *_loader) {
+    auto &loader = *(TerrainLoader *)_loader;
+    return loader.WaitTiles() ? 0 : -1;
+  }
+
   void jas_rtc_SetSize(void *_loader,
                        unsigned width, unsigned height,
                        unsigned tile_width, unsigned tile_height,
@@ -2,6 +2,10 @@
 
 #include "util/Compiler.h"
 
+#ifndef __cplusplus
+#include <stdbool.h>
+#endif
+
 struct jas_matrix;
 
 #ifdef __cplusplus
@@ -20,6 +24,24 @@ extern "C" {
 			   unsigned end_x, unsigned end_y,
 			   const struct jas_matrix *data);
 
+  /**
+   * Offer a tile whose last tile-part has been read to the loader,
+   * which may decode it in another thread by calling
+   * jpc_dec_tiledecode_fini().
+   *
+   * @return false if the tile was not accepted and shall be decoded
+   * right away
+   */
+  bool jas_rtc_SubmitTile(void *loader, void *dec, void *tile);
+
+  /**
+   * Wait until all tiles accepted by jas_rtc_SubmitTile() have been
+   * decoded.
+   *
+   * @return 0 on success, -1 if decoding one of them has failed
+   */
+  int jas_rtc_WaitTiles(void *loader);
+
   void jas_rtc_SetSize(void *loader,
 		       unsigned width, unsigned height,
 		       unsigned tile_width, unsigned tile_height,
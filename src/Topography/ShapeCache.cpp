@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "ShapeCache.hpp"
+#include "XShape.hpp"
+
+ShapeCache::ShapeCache() noexcept = default;
+ShapeCache::~ShapeCache() noexcept = default;
+
+bool
+ShapeCache::Contains(const TopographyFile &file, std::size_t index) noexcept
+{
+  return cache.Get(Key{&file, index}) != nullptr;
+}
+
+std::unique_ptr<const XShape>
+ShapeCache::Take(const TopographyFile &file, std::size_t index) noexcept
+{
+  auto *p = cache.Get(Key{&file, index});
+  if (p == nullptr)
+    return nullptr;
+
+  auto shape = std::move(*p);
+  cache.RemoveItem(*p);
+  return shape;
+}
+
+void
+ShapeCache::Put(const TopographyFile &file, std::size_t index,
+                std::unique_ptr<const XShape> shape) noexcept
+{
+  cache.Put(Key{&file, index}, std::move(shape));
+}
+
+void
+ShapeCache::Remove(const TopographyFile &file) noexcept
+{
+  cache.RemoveIf([&file](const Key &key, const auto &){
+    return key.file == &file;
+  });
+}
+
+void
+ShapeCache::Clear() noexcept
+{
+  cache.Clear();
+}
@@ -0,0 +1,82 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "util/StaticCache.hxx"
+
+#include <cstddef>
+#include <memory>
+
+class TopographyFile;
+class XShape;
+
+/**
+ * A LRU cache of decoded #XShape objects which are currently not
+ * used by their #TopographyFile, i.e. shapes which have left the
+ * screen recently, or which were loaded ahead of time by
+ * TopographyStore::Prefetch().  It is shared by all files of a
+ * #TopographyStore, so the least recently used shapes get discarded
+ * first, no matter which layer they belong to.
+ *
+ * This class is not thread-safe; it is only used by the thread which
+ * updates the #TopographyStore.
+ */
+class ShapeCache {
+public:
+  /**
+   * The maximum number of shapes in the cache.
+   */
+  static constexpr std::size_t MAX_SHAPES = 4096;
+
+private:
+  struct Key {
+    const TopographyFile *file;
+    std::size_t index;
+
+    constexpr bool operator==(const Key &) const noexcept = default;
+
+    struct Hash {
+      [[gnu::pure]]
+      std::size_t operator()(const Key &key) const noexcept {
+        return reinterpret_cast<std::size_t>(key.file) ^ (key.index * 31);
+      }
+    };
+  };
+
+  StaticCache<Key, std::unique_ptr<const XShape>,
+              MAX_SHAPES, 4093, Key::Hash> cache;
+
+public:
+  ShapeCache() noexcept;
+  ~ShapeCache() noexcept;
+
+  /**
+   * Is this shape in the cache?  If yes, it is marked as recently
+   * used.
+   */
+  bool Contains(const TopographyFile &file, std::size_t index) noexcept;
+
+  /**
+   * Remove a shape from the cache and return it.
+   *
+   * @return the shape or nullptr if it is not in the cache
+   */
+  std::unique_ptr<const XShape> Take(const TopographyFile &file,
+                                     std::size_t index) noexcept;
+
+  /**
+   * Add a shape which is not used anymore.  If the cache is full,
+   * the least recently used shape is deleted.  The shape must not be
+   * in the cache already.
+   */
+  void Put(const TopographyFile &file, std::size_t index,
+           std::unique_ptr<const XShape> shape) noexcept;
+
+  /**
+   * Delete all shapes of the specified file.
+   */
+  void Remove(const TopographyFile &file) noexcept;
+
+  void Clear() noexcept;
+};
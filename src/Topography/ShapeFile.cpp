@@ -3,14 +3,59 @@
 
 #include "ShapeFile.hpp"
 
+#include <span>
 #include <stdexcept>
 
+#include <stdlib.h>
+
 ShapeFile::ShapeFile(zzip_dir *dir, const char *filename)
 {
   if (msShapefileOpen(&obj, "rb", dir, filename, 0) == -1)
     throw std::runtime_error{"Failed to open shapefile"};
 }
 
+/**
+ * Read the bounds of all shapes; this reads the file sequentially,
+ * which is cheap even inside a ZIP file.
+ */
+static void
+ReadShapeBounds(SHPHandle shp, std::span<rectObj> bounds) noexcept
+{
+  for (std::size_t i = 0; i < bounds.size(); ++i) {
+    if (msSHPReadBounds(shp, i, &bounds[i]) != MS_SUCCESS) {
+      /* NULL or empty shape: this rectangle never overlaps */
+      bounds[i].minx = bounds[i].miny = 1;
+      bounds[i].maxx = bounds[i].maxy = -1;
+    }
+  }
+}
+
+int
+ShapeFile::WhichShapes(rectObj rect) noexcept
+{
+  free(obj.status);
+  obj.status = nullptr;
+
+  if (!msRectOverlap(&obj.bounds, &rect))
+    return MS_DONE;
+
+  if (shape_bounds.empty()) {
+    shape_bounds.ResizeDiscard(size());
+    ReadShapeBounds(obj.hSHP, shape_bounds);
+  }
+
+  obj.status = msAllocBitArray(size());
+  if (obj.status == nullptr)
+    return MS_FAILURE;
+
+  for (std::size_t i = 0; i < shape_bounds.size(); ++i)
+    if (msRectOverlap(&shape_bounds[i], &rect))
+      msSetBit(obj.status, i, 1);
+
+  obj.lastshape = -1;
+  return MS_SUCCESS;
+}
+
 void
 ShapeFile::ReadShape(shapeObj &shape, std::size_t i)
 {
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "shapelib/mapserver.h"
+#include "util/AllocatedArray.hxx"
 
 #include <cstddef>
 
@@ -15,6 +16,13 @@ struct zzip_dir;
 class ShapeFile {
   shapefileObj obj;
 
+  /**
+   * The bounds of all shapes, loaded by the first WhichShapes()
+   * call.  Shapes without bounds get an empty rectangle which never
+   * overlaps.
+   */
+  AllocatedArray<rectObj> shape_bounds;
+
 public:
   /**
    * Throws on error.
@@ -36,9 +44,16 @@ public:
     return obj.bounds;
   }
 
-  int WhichShapes(struct zzip_dir *dir, rectObj rect) noexcept {
-    return msShapefileWhichShapes(&obj, dir, rect, 0);
-  }
+  /**
+   * Determine which shapes overlap the given rectangle, see
+   * GetStatus().  Unlike msShapefileWhichShapes(), this does not
+   * read the file again on each call; the bounds of all shapes are
+   * read once and kept in memory.
+   *
+   * @return MS_SUCCESS, MS_DONE if the rectangle does not overlap
+   * with the file or MS_FAILURE on error
+   */
+  int WhichShapes(rectObj rect) noexcept;
 
   ms_const_bitarray GetStatus() const noexcept {
     return obj.status;
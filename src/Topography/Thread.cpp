@@ -35,9 +35,16 @@ TopographyThread::Trigger(const WindowProjection &_projection)
   last_bounds = new_bounds.Scale(1.1);
   scale_threshold = store.GetNextScaleThreshold(_projection.GetMapScale());
 
+  const GeoPoint center = new_bounds.GetCenter();
+  std::optional<Angle> direction;
+  if (last_center.IsValid() && center != last_center)
+    direction = last_center.Bearing(center);
+  last_center = center;
+
   {
     const std::lock_guard lock{mutex};
     next_projection = _projection;
+    prefetch_direction = direction;
     StandbyThread::Trigger();
   }
 }
@@ -61,4 +68,15 @@ TopographyThread::Tick() noexcept
     const ScopeUnlock unlock(mutex);
     callback();
   }
+
+  /* the screen is complete; now decode the shapes which will be
+     needed when the screen moves on */
+  if (prefetch_direction && next_projection.IsValid() && !IsStopped()) {
+    const WindowProjection projection = next_projection;
+    const Angle direction = *prefetch_direction;
+    prefetch_direction.reset();
+
+    const ScopeUnlock unlock(mutex);
+    store.Prefetch(projection, direction);
+  }
 }
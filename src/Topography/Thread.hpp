@@ -8,6 +8,7 @@
 #include "Geo/GeoBounds.hpp"
 
 #include <functional>
+#include <optional>
 
 class TopographyStore;
 
@@ -21,7 +22,14 @@ class TopographyThread final : private StandbyThread {
 
   WindowProjection next_projection;
 
+  /**
+   * The direction in which the screen has moved since the previous
+   * Trigger().  If set, Tick() prefetches shapes in this direction.
+   */
+  std::optional<Angle> prefetch_direction;
+
   GeoBounds last_bounds;
+  GeoPoint last_center = GeoPoint::Invalid();
   double scale_threshold;
 
 public:
@@ -3,6 +3,7 @@
 
 #include "Topography/TopographyFile.hpp"
 #include "Topography/XShape.hpp"
+#include "Topography/ShapeCache.hpp"
 #include "Convert.hpp"
 #include "Projection/WindowProjection.hpp"
 #include "util/ScopeExit.hxx"
@@ -85,7 +86,8 @@ LoadShape(ShapeFile &file, GeoPoint &center, std::size_t i, int label_field)
 }
 
 bool
-TopographyFile::Update(const WindowProjection &map_projection)
+TopographyFile::Update(const WindowProjection &map_projection,
+                       ShapeCache *cache)
 {
   if (map_projection.GetMapScale() > scale_threshold)
     /* not visible, don't update cache now */
@@ -101,7 +103,7 @@ TopographyFile::Update(const WindowProjection &map_projection)
 
   // Test which shapes are inside the given bounds and save the
   // status to file.status
-  switch (file.WhichShapes(dir, ConvertRect(cache_bounds))) {
+  switch (file.WhichShapes(ConvertRect(cache_bounds))) {
   case MS_FAILURE:
     ClearCache();
     throw std::runtime_error{"Failed to update shapefile"};
@@ -134,9 +136,12 @@ TopographyFile::Update(const WindowProjection &map_projection)
           ++serial;
         }
 
-        /* now it's unreachable, and we can delete the XShape without
-           holding a lock */
-        it->shape.reset();
+        /* now it's unreachable, and we can delete the XShape (or
+           move it to the cache) without holding a lock */
+        if (cache != nullptr)
+          cache->Put(*this, i, std::move(it->shape));
+        else
+          it->shape.reset();
       }
     } else {
       // is inside the bounds
@@ -144,7 +149,10 @@ TopographyFile::Update(const WindowProjection &map_projection)
         assert(&*std::next(prev) != &*it);
 
         // shape isn't cached yet -> cache the shape
-        it->shape = LoadShape(file, center, i, label_field);
+        if (cache != nullptr)
+          it->shape = cache->Take(*this, i);
+        if (it->shape == nullptr)
+          it->shape = LoadShape(file, center, i, label_field);
 
         /* insert into linked list (protected) */
         {
@@ -164,6 +172,38 @@ TopographyFile::Update(const WindowProjection &map_projection)
   return true;
 }
 
+unsigned
+TopographyFile::Prefetch(const GeoBounds &bounds, ShapeCache &cache,
+                         unsigned max_shapes)
+{
+  switch (file.WhichShapes(ConvertRect(bounds))) {
+  case MS_FAILURE:
+    throw std::runtime_error{"Failed to update shapefile"};
+
+  case MS_DONE:
+    /* outside of map bounds */
+    return 0;
+
+  case MS_SUCCESS:
+    break;
+  }
+
+  const auto status = file.GetStatus();
+  assert(status != nullptr);
+
+  unsigned n = 0;
+  for (std::size_t i = 0; i < file.size() && n < max_shapes; ++i) {
+    if (!msGetBit(status, i) || shapes[i].shape != nullptr ||
+        cache.Contains(*this, i))
+      continue;
+
+    cache.Put(*this, i, LoadShape(file, center, i, label_field));
+    ++n;
+  }
+
+  return n;
+}
+
 void
 TopographyFile::LoadAll()
 {
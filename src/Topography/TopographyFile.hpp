@@ -21,6 +21,7 @@
 
 class WindowProjection;
 class XShape;
+class ShapeCache;
 struct zzip_dir;
 
 class TopographyFile {
@@ -247,9 +248,26 @@ public:
   /**
    * Throws on error.
    *
+   * @param cache if not nullptr, then shapes which leave the screen
+   * are moved to this cache, and shapes which enter the screen are
+   * taken from it instead of being loaded from the file
    * @return true if new data from the topography file has been loaded
    */
-  bool Update(const WindowProjection &map_projection);
+  bool Update(const WindowProjection &map_projection,
+              ShapeCache *cache=nullptr);
+
+  /**
+   * Load shapes inside the given bounds into the #ShapeCache, so the
+   * next Update() which needs them does not have to decode them.
+   * Shapes which are already loaded are skipped.
+   *
+   * Throws on error.
+   *
+   * @param max_shapes the maximum number of shapes to be loaded
+   * @return the number of shapes which were loaded
+   */
+  unsigned Prefetch(const GeoBounds &bounds, ShapeCache &cache,
+                    unsigned max_shapes);
 
   /**
    * Throws on error.
@@ -3,6 +3,7 @@
 
 #include "Topography/TopographyStore.hpp"
 #include "Index.hpp"
+#include "Projection/WindowProjection.hpp"
 #include "util/StringAPI.hxx"
 #include "util/StringCompare.hxx"
 #include "io/LineReader.hpp"
@@ -44,7 +45,8 @@ TopographyStore::ScanVisibility(const WindowProjection &m_projection,
   unsigned num_updated = 0;
   for (auto &file : files) {
     try {
-      if (file.Update(m_projection)) {
+      if (file.Update(m_projection,
+                      shape_cache_enabled ? &shape_cache : nullptr)) {
         ++num_updated;
         if (num_updated >= max_update)
           break;
@@ -58,6 +60,42 @@ TopographyStore::ScanVisibility(const WindowProjection &m_projection,
   return num_updated;
 }
 
+unsigned
+TopographyStore::Prefetch(const WindowProjection &projection,
+                          Angle direction, unsigned max_shapes) noexcept
+{
+  if (!shape_cache_enabled)
+    return 0;
+
+  /* the screen bounds, moved by one screen size in the specified
+     direction, and enlarged like TopographyFile::Update() does */
+  const GeoBounds &screen = projection.GetScreenBounds();
+  const GeoPoint offset(screen.GetWidth() * direction.sin(),
+                        screen.GetHeight() * direction.cos());
+  const GeoBounds bounds =
+    GeoBounds(screen.GetNorthWest() + offset,
+              screen.GetSouthEast() + offset).Scale(2);
+
+  const double map_scale = projection.GetMapScale();
+
+  unsigned n = 0;
+  for (auto &file : files) {
+    if (n >= max_shapes)
+      break;
+
+    if (!file.IsVisible(map_scale))
+      continue;
+
+    try {
+      n += file.Prefetch(bounds, shape_cache, max_shapes - n);
+    } catch (...) {
+      LogError(std::current_exception());
+    }
+  }
+
+  return n;
+}
+
 void
 TopographyStore::LoadAll() noexcept
 {
@@ -118,5 +156,6 @@ TopographyStore::Load(NLineReader &reader,
 void
 TopographyStore::Reset() noexcept
 {
+  shape_cache.Clear();
   files.clear();
 }
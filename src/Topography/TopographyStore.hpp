@@ -4,6 +4,7 @@
 #pragma once
 
 #include "TopographyFile.hpp"
+#include "ShapeCache.hpp"
 #include "util/NonCopyable.hpp"
 
 #include <forward_list>
@@ -24,6 +25,13 @@ class TopographyStore : private NonCopyable {
    */
   unsigned serial = 0;
 
+  /**
+   * Decoded shapes which are currently not on the screen.
+   */
+  ShapeCache shape_cache;
+
+  bool shape_cache_enabled = true;
+
 public:
   TopographyStore() noexcept;
   ~TopographyStore() noexcept;
@@ -58,6 +66,29 @@ public:
   unsigned ScanVisibility(const WindowProjection &m_projection,
                           unsigned max_update=1024) noexcept;
 
+  /**
+   * Decode shapes which will probably be needed soon into the shape
+   * cache: those of the visible files in the area ahead of the
+   * screen in the specified direction.  This is meant to be called
+   * when the screen is up to date, and the thread is idle.
+   *
+   * @param direction the direction in which the screen is moving
+   * (usually the direction of flight)
+   * @param max_shapes the maximum number of shapes to be loaded
+   * @return the number of shapes which were loaded
+   */
+  unsigned Prefetch(const WindowProjection &projection, Angle direction,
+                    unsigned max_shapes=ShapeCache::MAX_SHAPES / 4) noexcept;
+
+  /**
+   * Enable or disable the shape cache (enabled by default).  For
+   * benchmarking.
+   */
+  void SetShapeCacheEnabled(bool enabled) noexcept {
+    shape_cache_enabled = enabled;
+    shape_cache.Clear();
+  }
+
   /**
    * Load all shapes of all files into memory.  For debugging
    * purposes.
@@ -10,13 +10,30 @@
 #include "net/UniqueSocketDescriptor.hxx"
 #include "util/CRC16CCITT.hpp"
 
+#include <array>
+#include <cassert>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
+
 static UniqueSocketDescriptor
-CreateBindUDP(SocketAddress address)
+CreateBindUDP(SocketAddress address, bool reuse_port)
 {
   UniqueSocketDescriptor s;
   if (!s.Create(address.GetFamily(), SOCK_DGRAM, 0))
     throw MakeSocketError("Failed to create socket");
 
+  if (reuse_port) {
+#ifdef __linux__
+    if (!s.SetReusePort())
+      throw MakeSocketError("Failed to set SO_REUSEPORT");
+#else
+    throw std::runtime_error("SO_REUSEPORT not supported");
+#endif
+  }
+
   if (!s.Bind(address))
     throw MakeSocketError("Failed to connect socket");
 
@@ -26,10 +43,12 @@ CreateBindUDP(SocketAddress address)
 namespace SkyLinesTracking {
 
 Server::Server(EventLoop &event_loop,
-               SocketAddress server_address)
+               SocketAddress server_address, bool reuse_port)
   :socket(event_loop, BIND_THIS_METHOD(OnSocketReady),
-          CreateBindUDP(server_address).Release())
+          CreateBindUDP(server_address, reuse_port).Release()),
+   flush_event(event_loop, BIND_THIS_METHOD(FlushQueue))
 {
+  send_queue.reserve(MAX_QUEUED_DATAGRAMS);
   socket.ScheduleRead();
 }
 
@@ -43,7 +62,7 @@ Server::SendBuffer(SocketAddress address,
                    std::span<const std::byte> buffer) noexcept
 {
   try {
-    ssize_t nbytes = socket.GetSocket().WriteNoWait(buffer);
+    ssize_t nbytes = socket.GetSocket().WriteNoWait(buffer, address);
     if (nbytes < 0)
       throw MakeSocketError("Failed to send");
   } catch (...) {
@@ -51,6 +70,86 @@ Server::SendBuffer(SocketAddress address,
   }
 }
 
+void
+Server::QueueBuffer(SocketAddress address,
+                    std::span<const std::byte> buffer) noexcept
+{
+  if (send_queue.size() >= MAX_QUEUED_DATAGRAMS)
+    FlushQueue();
+
+  auto &d = send_queue.emplace_back();
+  d.address = address;
+  d.offset = send_buffer.size();
+  d.size = buffer.size();
+  send_buffer.insert(send_buffer.end(), buffer.begin(), buffer.end());
+
+  flush_event.Schedule();
+}
+
+#ifdef __linux__
+
+void
+Server::SendQueue() noexcept
+{
+  std::array<struct iovec, MAX_QUEUED_DATAGRAMS> iov;
+  std::array<struct mmsghdr, MAX_QUEUED_DATAGRAMS> msgs;
+
+  const std::size_t n = send_queue.size();
+  assert(n <= msgs.size());
+
+  for (std::size_t i = 0; i < n; ++i) {
+    const auto &d = send_queue[i];
+    iov[i].iov_base = send_buffer.data() + d.offset;
+    iov[i].iov_len = d.size;
+
+    msgs[i] = {};
+    msgs[i].msg_hdr.msg_name =
+      const_cast<struct sockaddr *>((const struct sockaddr *)d.address);
+    msgs[i].msg_hdr.msg_namelen = d.address.GetSize();
+    msgs[i].msg_hdr.msg_iov = &iov[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  const int fd = socket.GetSocket().Get();
+  for (std::size_t i = 0; i < n;) {
+    int result = sendmmsg(fd, &msgs[i], n - i, MSG_DONTWAIT|MSG_NOSIGNAL);
+    if (result < 0) {
+      /* the first remaining datagram has failed; report it and
+         continue with the next one */
+      try {
+        throw MakeSocketError("Failed to send");
+      } catch (...) {
+        OnSendError(send_queue[i].address, std::current_exception());
+      }
+
+      ++i;
+    } else
+      i += result;
+  }
+}
+
+#else
+
+void
+Server::SendQueue() noexcept
+{
+  for (const auto &d : send_queue)
+    SendBuffer(d.address, {send_buffer.data() + d.offset, d.size});
+}
+
+#endif
+
+void
+Server::FlushQueue() noexcept
+{
+  flush_event.Cancel();
+
+  SendQueue();
+
+  send_queue.clear();
+  send_buffer.clear();
+}
+
 void
 Server::OnPing(const Client &client, unsigned id)
 {
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "event/SocketEvent.hxx"
+#include "event/DeferEvent.hxx"
 #include "net/StaticSocketAddress.hxx"
 #include "util/SpanCast.hxx"
 
@@ -11,6 +12,7 @@
 #include <cstdint>
 #include <exception>
 #include <span>
+#include <vector>
 
 struct GeoPoint;
 
@@ -25,6 +27,35 @@ namespace SkyLinesTracking {
 class Server {
   SocketEvent socket;
 
+  /**
+   * Flushes the #send_queue at the end of the current event loop
+   * iteration.
+   */
+  DeferEvent flush_event;
+
+  /**
+   * Flush the #send_queue immediately once it has this many
+   * datagrams.
+   */
+  static constexpr std::size_t MAX_QUEUED_DATAGRAMS = 256;
+
+  struct QueuedDatagram {
+    StaticSocketAddress address;
+
+    /**
+     * The location of the payload within #send_buffer.
+     */
+    std::size_t offset, size;
+  };
+
+  /**
+   * Outgoing datagrams which were submitted with QueueBuffer() and
+   * have not yet been sent.  Their payloads are stored back-to-back
+   * in #send_buffer.
+   */
+  std::vector<QueuedDatagram> send_queue;
+  std::vector<std::byte> send_buffer;
+
 public:
   struct Client {
     StaticSocketAddress address;
@@ -32,7 +63,14 @@ public:
   };
 
 public:
-  Server(EventLoop &event_loop, SocketAddress server_address);
+  /**
+   * Throws on error.
+   *
+   * @param reuse_port set SO_REUSEPORT, allowing several instances
+   * (e.g. in different threads) to share the incoming traffic
+   */
+  Server(EventLoop &event_loop, SocketAddress server_address,
+         bool reuse_port=false);
 
   ~Server();
 
@@ -58,7 +96,23 @@ public:
     SendBuffer(address, ReferenceAsBytes(packet));
   }
 
+  /**
+   * Like SendBuffer(), but copy the datagram to a queue instead of
+   * sending it right away.  The queue is flushed at the end of the
+   * current event loop iteration (or when it is full), with a single
+   * sendmmsg() system call where available.
+   */
+  void QueueBuffer(SocketAddress address,
+                   std::span<const std::byte> buffer) noexcept;
+
+  /**
+   * Send all datagrams queued by QueueBuffer() now.
+   */
+  void FlushQueue() noexcept;
+
 private:
+  void SendQueue() noexcept;
+
   void OnDatagramReceived(Client &&client, void *data, size_t length);
   void OnSocketReady(unsigned events) noexcept;
 
@@ -170,7 +170,7 @@ SettingsLeave(const UISettings &old_ui_settings)
 
     auto &airspace_database = *data_components->airspaces;
     airspace_database.Clear();
-    ReadAirspace(airspace_database,
+    ReadAirspace(airspace_database, file_cache,
                  CommonInterface::GetComputerSettings().pressure,
                  operation);
 
@@ -5,6 +5,8 @@
 
 #include "Engine/Waypoint/Waypoint.hpp"
 
+#include <span>
+
 class RasterTerrain;
 
 /**
@@ -42,4 +44,11 @@ public:
    * set, false if no fallback was found
    */
   bool FallbackElevation(Waypoint &waypoint) const noexcept;
+
+  /**
+   * Call FallbackElevation() for all waypoints which have no
+   * elevation.  This looks up the terrain elevations of all of them
+   * at once, which is much faster than doing it one by one.
+   */
+  void FallbackElevations(std::span<Waypoint> waypoints) const noexcept;
 };
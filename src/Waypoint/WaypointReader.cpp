@@ -12,14 +12,15 @@
 #include "system/Path.hpp"
 #include "io/FileReader.hxx"
 #include "io/CupxArchive.hpp"
-#include "io/MemoryReader.hxx"
 #include "io/ZipReader.hpp"
 #include "io/ProgressReader.hpp"
 #include "io/BufferedReader.hxx"
 
 #include "util/Compiler.h"
 
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 static WaypointReaderBase *
 CreateWaypointReader(WaypointFileType type, WaypointFactory factory)
@@ -53,6 +54,30 @@ CreateWaypointReader(WaypointFileType type, WaypointFactory factory)
   return nullptr;
 }
 
+/**
+ * Read the whole file into memory.
+ */
+static std::vector<std::byte>
+ReadAll(Reader &reader, uint_least64_t size_hint)
+{
+  std::vector<std::byte> data(size_hint);
+  std::size_t fill = 0;
+
+  while (true) {
+    if (fill == data.size())
+      data.resize(std::max<std::size_t>(data.size() * 2, 4096));
+
+    const std::size_t nbytes = reader.Read(std::span{data}.subspan(fill));
+    if (nbytes == 0)
+      break;
+
+    fill += nbytes;
+  }
+
+  data.resize(fill);
+  return data;
+}
+
 static void
 ReadWaypointFile(Reader &file_reader, WaypointFileType file_type,
                  uint_least64_t total_size,
@@ -60,11 +85,12 @@ ReadWaypointFile(Reader &file_reader, WaypointFileType file_type,
                  ProgressListener &progress)
 {
   ProgressReader progress_reader{file_reader, total_size, progress};
-  BufferedReader buffered_reader{progress_reader};
 
   switch (file_type) {
   case WaypointFileType::SEEYOU:
-    ParseSeeYou(factory, way_points, buffered_reader);
+    /* the CUP parser splits the file into chunks which are parsed in
+       parallel */
+    ParseSeeYou(factory, way_points, ReadAll(progress_reader, total_size));
     break;
 
   case WaypointFileType::CUPX:
@@ -75,6 +101,7 @@ ReadWaypointFile(Reader &file_reader, WaypointFileType file_type,
     if (!reader)
       throw std::runtime_error{"Unrecognised waypoint file"};
 
+    BufferedReader buffered_reader{progress_reader};
     reader->Parse(way_points, buffered_reader);
     break;
   }
@@ -90,10 +117,7 @@ ReadWaypointFile(Path path, WaypointFileType file_type,
     if (cup_data.empty())
       throw std::runtime_error{"Failed to read POINTS.CUP from CUPX archive"};
 
-    MemoryReader mem_reader{cup_data};
-    ProgressReader progress_reader{mem_reader, cup_data.size(), progress};
-    BufferedReader buffered_reader{progress_reader};
-    ParseSeeYou(factory, way_points, buffered_reader);
+    ParseSeeYou(factory, way_points, cup_data);
     return;
   }
 
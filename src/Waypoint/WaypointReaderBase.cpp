@@ -2,15 +2,26 @@
 // Copyright The XCSoar Project
 
 #include "WaypointReaderBase.hpp"
+#include "Waypoint/Waypoints.hpp"
 #include "io/BufferedReader.hxx"
+#include "util/ScopeExit.hxx"
 
 void
 WaypointReaderBase::Parse(Waypoints &way_points, BufferedReader &reader)
 {
+  std::vector<Waypoint> waypoints;
+
+  /* add the waypoints in one go, even if reading the file fails
+     halfway */
+  AtScopeExit(this, &way_points, &waypoints) {
+    factory.FallbackElevations(waypoints);
+    way_points.Append(std::move(waypoints));
+  };
+
   // Read through the lines of the file
   char *line;
   while ((line = reader.ReadLine()) != nullptr) {
     // and parse them
-    ParseLine(line, way_points);
+    ParseLine(line, waypoints);
   }
 }
@@ -5,6 +5,8 @@
 
 #include "Factory.hpp"
 
+#include <vector>
+
 class Waypoints;
 class BufferedReader;
 
@@ -29,12 +31,14 @@ public:
 
 protected:
   /**
-   * Parse a file line
+   * Parse a file line.  The missing elevations are filled in by
+   * Parse(), see WaypointFactory::FallbackElevations().
+   *
    * @param line The line to parse
-   * @param linenum The line number in the file
-   * @param way_points The waypoint list to fill
+   * @param waypoints The list of parsed waypoints to append to
    * @return True if the line was parsed correctly or ignored, False if
    * parsing error occured
    */
-  virtual bool ParseLine(const char *line, Waypoints &way_points) = 0;
+  virtual bool ParseLine(const char *line,
+                         std::vector<Waypoint> &waypoints) = 0;
 };
@@ -119,7 +119,8 @@ ParseAltitude(const char *&src, double &dest) noexcept
 }
 
 bool
-WaypointReaderCompeGPS::ParseLine(const char *line, Waypoints &waypoints)
+WaypointReaderCompeGPS::ParseLine(const char *line,
+                                  std::vector<Waypoint> &waypoints)
 {
   /*
    * G  WGS 84
@@ -198,8 +199,6 @@ WaypointReaderCompeGPS::ParseLine(const char *line, Waypoints &waypoints)
   // Parse altitude
   if (ParseAltitude(line, waypoint.elevation))
     waypoint.has_elevation = true;
-  else
-    factory.FallbackElevation(waypoint);
 
   // Skip whitespace
   while (*line == ' ')
@@ -208,7 +207,7 @@ WaypointReaderCompeGPS::ParseLine(const char *line, Waypoints &waypoints)
   // Parse waypoint name
   waypoint.comment.assign(string_converter.Convert(line));
 
-  waypoints.Append(std::move(waypoint));
+  waypoints.push_back(std::move(waypoint));
   return true;
 }
 
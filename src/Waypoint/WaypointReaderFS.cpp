@@ -110,7 +110,8 @@ ParseAltitude(const char *src, double &dest) noexcept
 }
 
 bool
-WaypointReaderFS::ParseLine(const char *line, Waypoints &way_points)
+WaypointReaderFS::ParseLine(const char *line,
+                            std::vector<Waypoint> &waypoints)
 {
   //$FormatGEO
   //ACONCAGU  S 32 39 12.00    W 070 00 42.00  6962  Aconcagua
@@ -153,14 +154,12 @@ WaypointReaderFS::ParseLine(const char *line, Waypoints &way_points)
 
   if (ParseAltitude(line + (is_utm ? 32 : 41), new_waypoint.elevation))
     new_waypoint.has_elevation = true;
-  else
-    factory.FallbackElevation(new_waypoint);
 
   // Description (Characters 35-44)
   if (len > (is_utm ? 38 : 47))
     new_waypoint.comment = std::string{string_converter.Convert(line + (is_utm ? 38 : 47))};
 
-  way_points.Append(std::move(new_waypoint));
+  waypoints.push_back(std::move(new_waypoint));
   return true;
 }
 
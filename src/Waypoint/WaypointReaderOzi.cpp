@@ -31,7 +31,8 @@ NextColumn(std::string_view &line) noexcept
 }
 
 bool
-WaypointReaderOzi::ParseLine(const char *line, Waypoints &way_points)
+WaypointReaderOzi::ParseLine(const char *line,
+                             std::vector<Waypoint> &waypoints)
 {
   if (line[0] == '\0')
     return true;
@@ -90,10 +91,9 @@ WaypointReaderOzi::ParseLine(const char *line, Waypoints &way_points)
   if (elevation_feet) {
     new_waypoint.elevation = Units::ToSysUnit(*elevation_feet, Unit::FEET);
     new_waypoint.has_elevation = true;
-  } else
-    factory.FallbackElevation(new_waypoint);
+  }
 
-  way_points.Append(std::move(new_waypoint));
+  waypoints.push_back(std::move(new_waypoint));
   return true;
 }
 
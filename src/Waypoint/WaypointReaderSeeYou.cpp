@@ -7,8 +7,17 @@
 #include "util/DecimalParser.hxx"
 #include "util/IterableSplitString.hxx"
 #include "util/NumberParser.hxx"
+#include "util/ScopeExit.hxx"
+#include "util/SpanCast.hxx"
+#include "util/UTF8.hpp"
 #include "io/StringConverter.hpp"
 #include "io/BufferedCsvReader.hpp"
+#include "io/MemoryReader.hxx"
+#include "thread/ParallelFor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <exception>
 
 #include <stdlib.h>
 
@@ -175,180 +184,387 @@ ParseStyle(std::string_view src, Waypoint::Type &type)
   return true;
 }
 
-bool ParseSeeYou(WaypointFactory factory, Waypoints &waypoints, BufferedReader &reader) {
-  StringConverter string_converter;
-
-  // 2018: name, code, country, lat, lon, elev, style, rwydir, rwylen, freq, desc
-  // 2022: name, code, country, lat, lon, elev, style, rwdir, rwlen, rwwidth, freq, desc, userdata, pics
-  enum {
-    iName = 0,
-    iShortname = 1,
-    iLatitude = 3,
-    iLongitude = 4,
-    iElevation = 5,
-    iStyle = 6,
-    iRWDir = 7,
-    iRWLen = 8,
-    iRWWidth = 9,
-    iUserData = 12,
-    iPics = 13
-  };
+// 2018: name, code, country, lat, lon, elev, style, rwydir, rwylen, freq, desc
+// 2022: name, code, country, lat, lon, elev, style, rwdir, rwlen, rwwidth, freq, desc, userdata, pics
+enum {
+  iName = 0,
+  iShortname = 1,
+  iLatitude = 3,
+  iLongitude = 4,
+  iElevation = 5,
+  iStyle = 6,
+  iRWDir = 7,
+  iRWLen = 8,
+  iRWWidth = 9,
+  iUserData = 12,
+  iPics = 13
+};
+
+using SeeYouRecord = std::array<std::string_view, 14>;
+
+/**
+ * The columns which depend on the version of the CUP file.
+ */
+struct SeeYouColumns {
   unsigned iFrequency = 9;
   unsigned iDescription = 10;
+  bool has_rwwidth = false;
+};
 
-  size_t params_num;
-  std::array<std::string_view,14> params;
+/**
+ * Check whether this is a header (a line with only field names),
+ * and if so, determine the columns from it.
+ */
+static bool
+ParseHeader(const SeeYouRecord &params, size_t params_num,
+            SeeYouColumns &columns) noexcept
+{
+  if (!StringIsEqualIgnoreCase(params[iLatitude],"lat"sv))
+    return false;
 
-  bool tasks { false };
-  bool first_line = true;
-  bool has_rwwidth = false;
+  /*
+   * Newer cup/cupx specification adds rwwidth, shifts freq and desc
+   * right, and adds userdata and pics.
+   */
+  if (params_num > iRWWidth &&
+      StringIsEqualIgnoreCase(params[iRWWidth], "rwwidth"sv)) {
+    columns.has_rwwidth = true;
+    columns.iFrequency = 10;
+    columns.iDescription = 11;
+  }
+
+  return true;
+}
+
+/**
+ * Parse one record of the waypoint section.
+ *
+ * @return false if this is the start of the task section
+ */
+static bool
+ParseRecord(WaypointFactory factory, StringConverter &string_converter,
+            const SeeYouColumns &columns,
+            const SeeYouRecord &params, size_t params_num,
+            std::vector<Waypoint> &waypoints)
+{
+  const unsigned iFrequency = columns.iFrequency;
+  const unsigned iDescription = columns.iDescription;
 
-  while ( true ) {
-    params_num = ReadCsvRecord(reader, params);
-
-    // first line of file
-    if (first_line) {
-      first_line = false;
-
-      // Empty file
-      if (params_num == 0)
-        return false;
-
-      // Check whether this is a header (a line with only field names).
-      if (StringIsEqualIgnoreCase(params[iLatitude],"lat"sv)) {
-
-        /*
-         * Newer cup/cupx specification adds rwwidth, shifts freq and desc
-         * right, and adds userdata and pics.
-         */
-        if (params_num > iRWWidth &&
-            StringIsEqualIgnoreCase(params[iRWWidth], "rwwidth"sv)) {
-          has_rwwidth = true;
-          iFrequency = 10;
-          iDescription = 11;
+  // Tasks section
+  if (params_num == 1 &&
+      StringIsEqualIgnoreCase(params[0],"-----Related Tasks-----"sv))
+    return false;
+
+  // Skip blank lines and comments (comments are an extension)
+  if ( (params_num == 1 && params[0].empty()) ||
+       params[0].starts_with('*') )
+    return true;
+
+  // Latitude (e.g. 5115.900N)
+  GeoPoint location;
+
+  if ( params_num <= iLatitude ||
+       !ParseAngle(params[iLatitude], location.latitude, true))
+    return true;
+
+  // Longitude (e.g. 00715.900W)
+  if ( params_num <= iLongitude ||
+       !ParseAngle(params[iLongitude], location.longitude, false))
+    return true;
+
+  location.Normalize(); // ensure longitude is within -180:180
+
+  Waypoint new_waypoint = factory.Create(location);
+
+  // Name (e.g. "Some Turnpoint")
+  if ( params_num <= iName ||
+       params[iName].empty() )
+    return true;
+  new_waypoint.name.assign(string_converter.Convert(params[iName]));
+
+  // Elevation (e.g. 458.0m)
+  /// @todo configurable behaviour
+  if ( params_num > iElevation &&
+       !params[iElevation].empty() &&
+       ParseAltitude(params[iElevation], new_waypoint.elevation) )
+    new_waypoint.has_elevation = true;
+
+  // Style (e.g. 5)
+  if ( params_num > iStyle &&
+       !params[iStyle].empty())
+    ParseStyle(params[iStyle], new_waypoint.type);
+
+  new_waypoint.flags.turn_point = true;
+
+  // Short name (code) of waypoint
+  if ( params_num <= iShortname )
+    return true;
+  new_waypoint.shortname.assign(string_converter.Convert(params[iShortname]));
+
+  // Frequency & runway direction/length (for airports and landables)
+  // and description (e.g. "Some Description")
+  if ( new_waypoint.IsLandable() ) {
+    if ( params_num > iFrequency &&
+         !params[iFrequency].empty() )
+      new_waypoint.radio_frequency = RadioFrequency::Parse(params[iFrequency]);
+
+    // Runway length (e.g. 546.0m)
+    double rwlen = -1;
+    if ( params_num > iRWLen &&
+         !params[iRWLen].empty() &&
+         ParseDistance(params[iRWLen], rwlen) &&
+         rwlen > 0 && rwlen <= 30000)
+      new_waypoint.runway.SetLength(uround(rwlen));
+
+    // Runway width (e.g. 15.0m; available in newer CUP formats)
+    double rwwidth = -1;
+    if (columns.has_rwwidth &&
+        params_num > iRWWidth &&
+        !params[iRWWidth].empty() &&
+        ParseDistance(params[iRWWidth], rwwidth) &&
+        rwwidth > 0 && rwwidth <= 30000)
+      new_waypoint.runway.SetWidth(uround(rwwidth));
+
+    if ( params_num > iRWDir &&
+         !params[iRWDir].empty()) {
+      if (auto value = ParseInteger<unsigned>(params[iRWDir])) {
+        unsigned direction = *value;
+
+        if (direction <= 360) {
+          if (direction == 360)
+            direction = 0;
+
+          new_waypoint.runway.SetDirectionDegrees(direction);
         }
-        continue;
       }
     }
+  }
+
+  /*
+   * This convention was introduced by the OpenAIP project
+   * (http://www.openaip.net/), since no waypoint type exists for
+   * thermal hotspots.
+   */
+  if ( params_num > iDescription &&
+       params[iDescription].starts_with("Hotspot"sv) )
+    new_waypoint.type = Waypoint::Type::THERMAL_HOTSPOT;
+
+  if ( params_num > iDescription )
+    new_waypoint.comment.assign(string_converter.Convert(params[iDescription]));
+
+  if ( params_num > iUserData )
+    new_waypoint.details.assign(string_converter.Convert(params[iUserData]));
+
+  if ( params_num > iPics &&
+       !params[iPics].empty() ) {
+    for (const auto i : IterableSplitString(params[iPics], ';')) {
+      new_waypoint.files_embed.emplace_front(string_converter.Convert(i));
+    }
+  }
+
+  waypoints.push_back(std::move(new_waypoint));
+  return true;
+}
+
+/**
+ * Parse records until the end of the file or the start of the task
+ * section.
+ *
+ * @return true if the "Related Tasks" line was found
+ */
+static bool
+ParseRecords(WaypointFactory factory, StringConverter &string_converter,
+             const SeeYouColumns &columns, BufferedReader &reader,
+             std::vector<Waypoint> &waypoints)
+{
+  SeeYouRecord params;
+  size_t params_num;
+
+  while ((params_num = ReadCsvRecord(reader, params)) > 0)
+    if (!ParseRecord(factory, string_converter, columns,
+                     params, params_num, waypoints))
+      return true;
+
+  return false;
+}
+
+static bool
+ParseSeeYou(WaypointFactory factory, std::vector<Waypoint> &waypoints,
+            BufferedReader &reader)
+{
+  StringConverter string_converter;
+  SeeYouColumns columns;
+
+  // first line of file
+  SeeYouRecord params;
+  const size_t params_num = ReadCsvRecord(reader, params);
+
+  // Empty file
+  if (params_num == 0)
+    return false;
 
-    // Tasks section
-    tasks = params_num == 1 &&
-      StringIsEqualIgnoreCase(params[0],"-----Related Tasks-----"sv);
+  if (!ParseHeader(params, params_num, columns) &&
+      !ParseRecord(factory, string_converter, columns,
+                   params, params_num, waypoints))
+    return true;
 
-    // End of file or start of task section
-    if ( !params_num || tasks )
+  return ParseRecords(factory, string_converter, columns, reader, waypoints);
+}
+
+static bool
+ParseSeeYou(WaypointFactory factory, std::vector<Waypoint> &waypoints,
+            std::span<const std::byte> data)
+{
+  MemoryReader memory_reader{data};
+  BufferedReader reader{memory_reader};
+  return ParseSeeYou(factory, waypoints, reader);
+}
+
+bool
+ParseSeeYou(WaypointFactory factory, Waypoints &waypoints,
+            BufferedReader &reader)
+{
+  std::vector<Waypoint> parsed;
+
+  /* add the waypoints in one go, even if parsing fails halfway */
+  AtScopeExit(factory, &waypoints, &parsed) {
+    factory.FallbackElevations(parsed);
+    waypoints.Append(std::move(parsed));
+  };
+
+  return ParseSeeYou(factory, parsed, reader);
+}
+
+/**
+ * Determine the columns from the header of the file, if there is
+ * one.
+ */
+static SeeYouColumns
+ReadColumns(std::span<const std::byte> data)
+{
+  MemoryReader memory_reader{data};
+  BufferedReader reader{memory_reader};
+
+  SeeYouColumns columns;
+  SeeYouRecord params;
+  if (const size_t params_num = ReadCsvRecord(reader, params); params_num > 0)
+    ParseHeader(params, params_num, columns);
+
+  return columns;
+}
+
+/**
+ * Split the file into chunks of roughly the specified size.  Each
+ * chunk begins after a newline character; since quoted fields may
+ * contain newlines, this is not necessarily the beginning of a
+ * record.
+ *
+ * @return the start offsets of the chunks
+ */
+static std::vector<std::size_t>
+SplitSeeYou(std::span<const std::byte> data, std::size_t chunk_size) noexcept
+{
+  std::vector<std::size_t> chunks{0};
+
+  for (std::size_t position = chunk_size; position < data.size();
+       position += chunk_size) {
+    const auto i = std::find(data.begin() + position, data.end(),
+                             std::byte{'\n'});
+    position = std::distance(data.begin(), i) + 1;
+    if (position >= data.size())
       break;
 
-    // Skip blank lines and comments (comments are an extension)
-    if ( (params_num == 1 && params[0].empty()) ||
-         params[0].starts_with('*') )
-      continue;
-
-    // Latitude (e.g. 5115.900N)
-    GeoPoint location;
-
-    if ( params_num <= iLatitude ||
-         !ParseAngle(params[iLatitude], location.latitude, true))
-      continue;
-
-    // Longitude (e.g. 00715.900W)
-    if ( params_num <= iLongitude ||
-         !ParseAngle(params[iLongitude], location.longitude, false))
-      continue;
-
-    location.Normalize(); // ensure longitude is within -180:180
-
-    Waypoint new_waypoint = factory.Create(location);
-
-    // Name (e.g. "Some Turnpoint")
-    if ( params_num <= iName ||
-         params[iName].empty() )
-      continue;
-    new_waypoint.name.assign(string_converter.Convert(params[iName]));
-
-    // Elevation (e.g. 458.0m)
-    /// @todo configurable behaviour
-    if ( params_num > iElevation &&
-         !params[iElevation].empty() &&
-         ParseAltitude(params[iElevation], new_waypoint.elevation) )
-      new_waypoint.has_elevation = true;
-    else
-      factory.FallbackElevation(new_waypoint);
-
-    // Style (e.g. 5)
-    if ( params_num > iStyle &&
-         !params[iStyle].empty())
-      ParseStyle(params[iStyle], new_waypoint.type);
-
-    new_waypoint.flags.turn_point = true;
-
-    // Short name (code) of waypoint
-    if ( params_num <= iShortname )
-      continue;
-    new_waypoint.shortname.assign(string_converter.Convert(params[iShortname]));
-
-    // Frequency & runway direction/length (for airports and landables)
-    // and description (e.g. "Some Description")
-    if ( new_waypoint.IsLandable() ) {
-      if ( params_num > iFrequency &&
-           !params[iFrequency].empty() )
-        new_waypoint.radio_frequency = RadioFrequency::Parse(params[iFrequency]);
-
-      // Runway length (e.g. 546.0m)
-      double rwlen = -1;
-      if ( params_num > iRWLen &&
-           !params[iRWLen].empty() &&
-           ParseDistance(params[iRWLen], rwlen) &&
-           rwlen > 0 && rwlen <= 30000)
-        new_waypoint.runway.SetLength(uround(rwlen));
-
-      // Runway width (e.g. 15.0m; available in newer CUP formats)
-      double rwwidth = -1;
-      if (has_rwwidth &&
-          params_num > iRWWidth &&
-          !params[iRWWidth].empty() &&
-          ParseDistance(params[iRWWidth], rwwidth) &&
-          rwwidth > 0 && rwwidth <= 30000)
-        new_waypoint.runway.SetWidth(uround(rwwidth));
-
-      if ( params_num > iRWDir &&
-           !params[iRWDir].empty()) {
-        if (auto value = ParseInteger<unsigned>(params[iRWDir])) {
-          unsigned direction = *value;
-
-          if (direction <= 360) {
-            if (direction == 360)
-              direction = 0;
-
-            new_waypoint.runway.SetDirectionDegrees(direction);
-          }
-        }
-      }
-    }
+    chunks.push_back(position);
+  }
+
+  return chunks;
+}
+
+bool
+ParseSeeYou(WaypointFactory factory, Waypoints &waypoints,
+            std::span<const std::byte> data, unsigned n_threads)
+{
+  std::vector<Waypoint> parsed;
+
+  /* add the waypoints in one go, even if parsing fails halfway */
+  AtScopeExit(factory, &waypoints, &parsed) {
+    factory.FallbackElevations(parsed);
+    waypoints.Append(std::move(parsed));
+  };
+
+  /* a few chunks per thread; the charset auto-detection of
+     #StringConverter works only chunk by chunk if all of the file is
+     valid UTF-8 */
+  static constexpr std::size_t MIN_CHUNK_SIZE = 64 * 1024;
+  const std::size_t chunk_size =
+    std::max(data.size() / (n_threads * 4), MIN_CHUNK_SIZE);
+
+  const auto chunks =
+    n_threads > 1 && data.size() > chunk_size &&
+    ValidateUTF8(ToStringView(data))
+    ? SplitSeeYou(data, chunk_size)
+    : std::vector<std::size_t>{0};
 
-    /*
-     * This convention was introduced by the OpenAIP project
-     * (http://www.openaip.net/), since no waypoint type exists for
-     * thermal hotspots.
-     */
-    if ( params_num > iDescription &&
-         params[iDescription].starts_with("Hotspot"sv) )
-      new_waypoint.type = Waypoint::Type::THERMAL_HOTSPOT;
-
-    if ( params_num > iDescription )
-      new_waypoint.comment.assign(string_converter.Convert(params[iDescription]));
-
-    if ( params_num > iUserData )
-      new_waypoint.details.assign(string_converter.Convert(params[iUserData]));
-
-    if ( params_num > iPics &&
-         !params[iPics].empty() ) {
-      for (const auto i : IterableSplitString(params[iPics], ';')) {
-        new_waypoint.files_embed.emplace_front(string_converter.Convert(i));
+  if (chunks.size() < 2)
+    return ParseSeeYou(factory, parsed, data);
+
+  const auto columns = ReadColumns(data);
+
+  struct ChunkResult {
+    std::vector<Waypoint> waypoints;
+    bool tasks = false;
+    std::exception_ptr error;
+  };
+
+  std::vector<ChunkResult> results(chunks.size());
+
+  ParallelFor(chunks.size(), n_threads, [&](std::size_t i){
+    const std::size_t end = i + 1 < chunks.size()
+      ? chunks[i + 1]
+      : data.size();
+    const auto chunk = data.subspan(chunks[i], end - chunks[i]);
+    auto &result = results[i];
+
+    try {
+      if (i == 0) {
+        result.tasks = ParseSeeYou(factory, result.waypoints, chunk);
+      } else {
+        MemoryReader memory_reader{chunk};
+        BufferedReader reader{memory_reader};
+        StringConverter string_converter;
+        result.tasks = ParseRecords(factory, string_converter, columns,
+                                    reader, result.waypoints);
       }
+    } catch (...) {
+      result.error = std::current_exception();
+    }
+  });
+
+  /* add the waypoints in file order, up to the task section */
+  for (auto &i : results) {
+    if (i.error) {
+      /* a chunk ended in the middle of a quoted field: either the
+         field contains a newline, and the next chunk did not begin
+         at a record; or the file is malformed; parse all of it again
+         to find out */
+      parsed.clear();
+      return ParseSeeYou(factory, parsed, data);
     }
-    waypoints.Append(std::move(new_waypoint));
+
+    parsed.insert(parsed.end(),
+                  std::make_move_iterator(i.waypoints.begin()),
+                  std::make_move_iterator(i.waypoints.end()));
+
+    if (i.tasks)
+      return true;
   }
 
-  return tasks;
+  return false;
+}
+
+bool
+ParseSeeYou(WaypointFactory factory, Waypoints &waypoints,
+            std::span<const std::byte> data)
+{
+  return ParseSeeYou(factory, waypoints, data, GetParallelThreadCount());
 }
@@ -5,13 +5,40 @@
 
 #include "Factory.hpp"
 
+#include <cstddef>
+#include <span>
+
 class Waypoints;
 class BufferedReader;
 
 /**
+ * Parse the waypoints of a CUP file.  This stops at the "Related
+ * Tasks" line, so the caller can read the tasks from #reader
+ * afterwards.
+ *
  * @return true if the "Related Tasks" line was found, false if the
  * file contains no task
  *
  * Throws on error.
  */
 bool ParseSeeYou(WaypointFactory factory, Waypoints &waypoints, BufferedReader &reader);
+
+/**
+ * Parse the waypoints of a CUP file which was loaded into memory.
+ * Large files are split into chunks which are parsed on up to
+ * #n_threads threads; the result is the same as with the
+ * #BufferedReader overload.
+ *
+ * @return true if the "Related Tasks" line was found, false if the
+ * file contains no task
+ *
+ * Throws on error.
+ */
+bool ParseSeeYou(WaypointFactory factory, Waypoints &waypoints,
+                 std::span<const std::byte> data, unsigned n_threads);
+
+/**
+ * Like above, but use GetParallelThreadCount() threads.
+ */
+bool ParseSeeYou(WaypointFactory factory, Waypoints &waypoints,
+                 std::span<const std::byte> data);
@@ -198,7 +198,8 @@ ParseFlags(std::string_view src, Waypoint &dest)
 }
 
 bool
-WaypointReaderWinPilot::ParseLine(const char *line, Waypoints &waypoints)
+WaypointReaderWinPilot::ParseLine(const char *line,
+                                  std::vector<Waypoint> &waypoints)
 {
   // If (end-of-file)
   if (line[0] == '\0')
@@ -237,8 +238,6 @@ WaypointReaderWinPilot::ParseLine(const char *line, Waypoints &waypoints)
   /// @todo configurable behaviour
   if (ParseAltitude(NextColumn(rest), new_waypoint.elevation))
     new_waypoint.has_elevation = true;
-  else
-    factory.FallbackElevation(new_waypoint);
 
   // Waypoint Flags (e.g. AT)
   ParseFlags(NextColumn(rest), new_waypoint);
@@ -253,6 +252,6 @@ WaypointReaderWinPilot::ParseLine(const char *line, Waypoints &waypoints)
   new_waypoint.comment = std::string{string_converter.Convert(comment)};
   ParseRunwayDirection(comment, new_waypoint.runway);
 
-  waypoints.Append(std::move(new_waypoint));
+  waypoints.push_back(std::move(new_waypoint));
   return true;
 }
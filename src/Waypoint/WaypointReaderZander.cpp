@@ -130,7 +130,8 @@ ParseFlagsFromDescription(const char *src, Waypoint &dest) noexcept
 }
 
 bool
-WaypointReaderZander::ParseLine(const char *line, Waypoints &way_points)
+WaypointReaderZander::ParseLine(const char *line,
+                                std::vector<Waypoint> &waypoints)
 {
   // If (end-of-file or comment)
   if (line[0] == '\0' || line[0] == '*')
@@ -165,8 +166,6 @@ WaypointReaderZander::ParseLine(const char *line, Waypoints &way_points)
   /// @todo configurable behaviour
   if (ParseAltitude(line + 30, new_waypoint.elevation))
     new_waypoint.has_elevation = true;
-  else
-    factory.FallbackElevation(new_waypoint);
 
   // Description (Characters 35-44)
   if (len > 35)
@@ -177,6 +176,6 @@ WaypointReaderZander::ParseLine(const char *line, Waypoints &way_points)
     if (len < 36 || !ParseFlagsFromDescription(line + 35, new_waypoint))
       new_waypoint.flags.turn_point = true;
 
-  way_points.Append(std::move(new_waypoint));
+  waypoints.push_back(std::move(new_waypoint));
   return true;
 }
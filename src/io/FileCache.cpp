@@ -4,6 +4,7 @@
 #include "FileCache.hpp"
 #include "FileReader.hxx"
 #include "FileOutputStream.hxx"
+#include "FileMapping.hpp"
 #include "system/FileUtil.hpp"
 #include "util/SpanCast.hxx"
 
@@ -120,6 +121,49 @@ FileCache::Load(const char *name, Path original_path) noexcept
   return nullptr;
 }
 
+std::unique_ptr<FileMapping>
+FileCache::Map(const char *name, Path original_path,
+               std::span<const std::byte> &payload_r) noexcept
+{
+  FileInfo original_info;
+  if (!GetRegularFileInfo(original_path, original_info))
+    return nullptr;
+
+  const auto path = MakeCachePath(name);
+
+  FileInfo cached_info;
+  if (!GetRegularFileInfo(path, cached_info))
+    return nullptr;
+
+  /* see Load() */
+  if (original_info.mtime > cached_info.mtime && !original_info.IsFuture()) {
+    File::Delete(path);
+    return nullptr;
+  }
+
+  try {
+    auto mapping = std::make_unique<FileMapping>(path, false);
+    const std::span<const std::byte> contents = *mapping;
+
+    unsigned magic;
+    struct FileInfo old_info;
+    if (contents.size() >= sizeof(magic) + sizeof(old_info)) {
+      memcpy(&magic, contents.data(), sizeof(magic));
+      memcpy(&old_info, contents.data() + sizeof(magic), sizeof(old_info));
+
+      if (magic == FILE_CACHE_MAGIC &&
+          old_info == original_info) {
+        payload_r = contents.subspan(sizeof(magic) + sizeof(old_info));
+        return mapping;
+      }
+    }
+  } catch (...) {
+  }
+
+  File::Delete(path);
+  return nullptr;
+}
+
 std::unique_ptr<FileOutputStream>
 FileCache::Save(const char *name, Path original_path)
 {
@@ -139,3 +183,10 @@ FileCache::Save(const char *name, Path original_path)
   os->Write(ReferenceAsBytes(original_info));
   return os;
 }
+
+std::unique_ptr<FileOutputStream>
+FileCache::Append(const char *name)
+{
+  return std::make_unique<FileOutputStream>(MakeCachePath(name),
+                                            FileOutputStream::Mode::APPEND_EXISTING);
+}
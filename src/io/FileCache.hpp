@@ -5,10 +5,13 @@
 
 #include "system/Path.hpp"
 
+#include <cstddef>
 #include <memory>
+#include <span>
 #include <stdio.h>
 class Reader;
 class FileOutputStream;
+class FileMapping;
 
 class FileCache {
   AllocatedPath cache_path;
@@ -30,8 +33,27 @@ public:
    */
   std::unique_ptr<Reader> Load(const char *name, Path original_path) noexcept;
 
+  /**
+   * Like Load(), but map the whole file into memory.
+   *
+   * Returns nullptr on error.
+   *
+   * @param payload_r on success, receives the file contents after the
+   * cache header
+   */
+  std::unique_ptr<FileMapping> Map(const char *name, Path original_path,
+                                   std::span<const std::byte> &payload_r) noexcept;
+
   /**
    * Throws on error.
    */
   std::unique_ptr<FileOutputStream> Save(const char *name, Path original_path);
+
+  /**
+   * Open an existing cache file (created by Save()) for appending
+   * more data.
+   *
+   * Throws on error.
+   */
+  std::unique_ptr<FileOutputStream> Append(const char *name);
 };
@@ -19,7 +19,7 @@
 #include <winbase.h> // for CreateFileMapping(), UnmapViewOfFile()
 #endif
 
-FileMapping::FileMapping(Path path)
+FileMapping::FileMapping(Path path, [[maybe_unused]] bool will_need)
 {
 #ifdef HAVE_POSIX
   auto fd = OpenReadOnly(path.c_str());
@@ -42,7 +42,8 @@ FileMapping::FileMapping(Path path)
   if (data == (void *)-1)
     throw FmtErrno("Failed to map {}", path);
 
-  madvise(data, size, MADV_WILLNEED);
+  if (will_need)
+    madvise(data, size, MADV_WILLNEED);
 #else /* !HAVE_POSIX */
   hFile = ::CreateFile(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
                        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
@@ -25,8 +25,11 @@ class FileMapping {
 public:
   /**
    * Throws on error.
+   *
+   * @param will_need start reading the whole file into the page
+   * cache; pass false for large files which are accessed sparsely
    */
-  FileMapping(Path path);
+  FileMapping(Path path, bool will_need=true);
 
   ~FileMapping() noexcept;
 
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "ParallelFor.hpp"
+#include "Thread.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <thread>
+
+namespace {
+
+/**
+ * The state shared by all threads of one ParallelFor() call.
+ */
+struct ParallelJob {
+  const std::function<void(std::size_t)> &f;
+  const std::size_t n;
+  std::atomic_size_t next{0};
+
+  ParallelJob(std::size_t _n,
+              const std::function<void(std::size_t)> &_f) noexcept
+    :f(_f), n(_n) {}
+
+  void Run() noexcept {
+    std::size_t i;
+    while ((i = next.fetch_add(1, std::memory_order_relaxed)) < n)
+      f(i);
+  }
+};
+
+class ParallelWorker final : public Thread {
+  ParallelJob &job;
+
+public:
+  explicit ParallelWorker(ParallelJob &_job) noexcept
+    :Thread("Parallel"), job(_job) {}
+
+protected:
+  void Run() noexcept override {
+    job.Run();
+  }
+};
+
+} // anonymous namespace
+
+unsigned
+GetParallelThreadCount() noexcept
+{
+  /* more than a few threads don't pay off for the small batch jobs
+     this is used for */
+  const unsigned n_cpus = std::thread::hardware_concurrency();
+  return std::clamp(n_cpus, 1U, 8U);
+}
+
+void
+ParallelFor(std::size_t n, unsigned n_threads,
+            const std::function<void(std::size_t)> &f) noexcept
+{
+  ParallelJob job{n, f};
+
+  std::list<ParallelWorker> workers;
+  for (std::size_t i = 1; i < std::min<std::size_t>(n_threads, n); ++i) {
+    auto &worker = workers.emplace_back(job);
+    try {
+      worker.Start();
+    } catch (...) {
+      /* not fatal: the calling thread does the rest */
+      workers.pop_back();
+      break;
+    }
+  }
+
+  job.Run();
+
+  for (auto &i : workers)
+    i.Join();
+}
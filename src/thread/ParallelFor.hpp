@@ -0,0 +1,37 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * Determine how many threads are useful for ParallelFor() on this
+ * machine.
+ *
+ * @return the number of threads (including the calling thread), at
+ * least 1
+ */
+[[gnu::const]]
+unsigned
+GetParallelThreadCount() noexcept;
+
+/**
+ * Invoke a function for each index from 0 to n-1, distributed over
+ * up to #n_threads threads.  The calling thread is one of them, and
+ * this function returns after all calls have finished.  The indexes
+ * are handed out in ascending order, but the calls may finish in any
+ * order.
+ *
+ * This is meant for short CPU-bound batch jobs such as parsing data
+ * files at startup; the worker threads are created and destroyed by
+ * each call.  If a thread cannot be created, the calling thread does
+ * its share of the work.
+ *
+ * @param f the function; it must not throw, and calls for different
+ * indexes must not conflict with each other
+ */
+void
+ParallelFor(std::size_t n, unsigned n_threads,
+            const std::function<void(std::size_t)> &f) noexcept;
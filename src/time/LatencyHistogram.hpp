@@ -0,0 +1,134 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * A histogram of durations with logarithmic buckets: bucket 0 counts
+ * durations below 1 microsecond, bucket i counts durations between
+ * 2^(i-1) and 2^i microseconds, and the last bucket counts
+ * everything above that.
+ *
+ * Adding a sample costs only a few instructions, which allows
+ * leaving this enabled in hot code paths.  This class is trivial, so
+ * it can be copied to another thread with memcpy().
+ */
+class LatencyHistogram {
+public:
+  using Clock = std::chrono::steady_clock;
+  using Duration = std::chrono::microseconds;
+
+  static constexpr unsigned N_BUCKETS = 24;
+
+private:
+  std::array<uint32_t, N_BUCKETS> buckets;
+
+  uint32_t count;
+
+  uint64_t sum_us;
+
+  uint32_t max_us;
+
+public:
+  constexpr void Clear() noexcept {
+    buckets = {};
+    count = 0;
+    sum_us = 0;
+    max_us = 0;
+  }
+
+  /**
+   * Returns the upper bound of the specified bucket (exclusive).
+   */
+  static constexpr Duration GetBucketLimit(unsigned i) noexcept {
+    return Duration{Duration::rep{1} << i};
+  }
+
+  template<class Rep, class Period>
+  constexpr void Add(std::chrono::duration<Rep, Period> _d) noexcept {
+    const auto d = std::chrono::duration_cast<Duration>(_d);
+    const uint32_t us = d.count() > 0
+      ? (d.count() < UINT32_MAX ? uint32_t(d.count()) : UINT32_MAX)
+      : 0;
+
+    unsigned i = std::bit_width(us);
+    if (i >= N_BUCKETS)
+      i = N_BUCKETS - 1;
+
+    ++buckets[i];
+    ++count;
+    sum_us += us;
+    if (us > max_us)
+      max_us = us;
+  }
+
+  constexpr bool empty() const noexcept {
+    return count == 0;
+  }
+
+  constexpr unsigned GetCount() const noexcept {
+    return count;
+  }
+
+  constexpr unsigned GetBucket(unsigned i) const noexcept {
+    return buckets[i];
+  }
+
+  constexpr Duration GetMean() const noexcept {
+    return count > 0 ? Duration{sum_us / count} : Duration{};
+  }
+
+  constexpr Duration GetMax() const noexcept {
+    return Duration{max_us};
+  }
+
+  /**
+   * Returns an upper bound for the given quantile, i.e. the limit of
+   * the bucket containing it (but not more than the maximum).
+   *
+   * @param q the quantile (0..1)
+   */
+  constexpr Duration GetQuantile(double q) const noexcept {
+    if (count == 0)
+      return {};
+
+    const uint64_t rank = uint64_t(q * count + 0.5);
+    uint64_t n = 0;
+    for (unsigned i = 0; i < N_BUCKETS - 1; ++i) {
+      n += buckets[i];
+      if (n >= rank && n > 0)
+        return std::min(GetBucketLimit(i), GetMax());
+    }
+
+    return GetMax();
+  }
+
+  /**
+   * Measures the time between construction and destruction of this
+   * object and adds it to a #LatencyHistogram.
+   */
+  class ScopeTimer {
+    LatencyHistogram &histogram;
+    const Clock::time_point start = Clock::now();
+
+  public:
+    explicit ScopeTimer(LatencyHistogram &_histogram) noexcept
+      :histogram(_histogram) {}
+
+    ~ScopeTimer() noexcept {
+      histogram.Add(Clock::now() - start);
+    }
+
+    ScopeTimer(const ScopeTimer &) = delete;
+    ScopeTimer &operator=(const ScopeTimer &) = delete;
+  };
+};
+
+static_assert(std::is_trivial_v<LatencyHistogram>);
@@ -3,9 +3,11 @@
 
 #pragma once
 
+#include <algorithm>
 #include <utility>
 #include <limits>
 #include <memory>
+#include <vector>
 
 #include <cassert>
 
@@ -1383,4 +1385,108 @@ public:
 			      V &visitor) const {
 		VisitWithinRange(GetPosition(value), range, visitor);
 	}
+
+	/**
+	 * Visit all values within the range which match the predicate,
+	 * in ascending order of their distance to the location
+	 * ("best-first" search).  Buckets are only opened when they may
+	 * contain a value nearer than all values which are still
+	 * pending, therefore stopping after the first k values is much
+	 * cheaper than visiting the whole range.
+	 *
+	 * @param visitor a callable which gets the value and its square
+	 * distance; if it returns false, the search stops
+	 */
+	template<class P, class V>
+	void VisitNearestIf(const Point location, distance_type range,
+			    const P &predicate, V &&visitor) const {
+		const distance_type square_range = Square(range);
+
+		/* a pending bucket (with its bounds) or leaf */
+		struct Item {
+			distance_type square_distance;
+			const Bucket *bucket;
+			const Leaf *leaf;
+			Rectangle bounds;
+		};
+
+		const auto compare = [](const Item &a, const Item &b){
+			return a.square_distance > b.square_distance;
+		};
+
+		std::vector<Item> heap;
+		const auto push = [&heap, &compare](const Item &item){
+			heap.push_back(item);
+			std::push_heap(heap.begin(), heap.end(), compare);
+		};
+
+		/* the bounds are only known (and valid) in a splitted tree */
+		push({0, &root, nullptr, bounds});
+
+		while (!heap.empty()) {
+			std::pop_heap(heap.begin(), heap.end(), compare);
+			const Item item = heap.back();
+			heap.pop_back();
+
+			if (item.leaf != nullptr) {
+				if (!visitor((const T &)item.leaf->value,
+					     item.square_distance))
+					return;
+			} else if (item.bucket->IsSplitted()) {
+				const Point middle = item.bounds.GetMiddle();
+				const Rectangle child_bounds[QuadBucket::N] = {
+					QuadBucket::GetTopLeft(item.bounds, middle),
+					QuadBucket::GetTopRight(item.bounds, middle),
+					QuadBucket::GetBottomLeft(item.bounds, middle),
+					QuadBucket::GetBottomRight(item.bounds, middle),
+				};
+
+				for (unsigned i = 0; i < QuadBucket::N; ++i) {
+					const Bucket &child = item.bucket->children->buckets[i];
+					if (child.IsEmpty())
+						continue;
+
+					const distance_type square_distance =
+						child_bounds[i].SquareDistanceTo(location);
+					if (square_distance <= square_range)
+						push({square_distance, &child, nullptr,
+						      child_bounds[i]});
+				}
+			} else {
+				for (const Leaf *i = item.bucket->leaves.head;
+				     i != nullptr; i = i->next) {
+					if (!predicate(i->value))
+						continue;
+
+					const distance_type square_distance =
+						i->SquareDistanceTo(location);
+					if (square_distance <= square_range)
+						push({square_distance, nullptr, i,
+						      item.bounds});
+				}
+			}
+		}
+	}
+
+	/**
+	 * Find the (up to) #n nearest values within the range which
+	 * match the predicate, see VisitNearestIf().
+	 *
+	 * @return the number of values written to #out, nearest first
+	 */
+	template<class P, class O>
+	std::size_t FindNearestIf(const Point location, distance_type range,
+				  const P &predicate, std::size_t n,
+				  O out) const {
+		std::size_t count = 0;
+		if (n == 0)
+			return count;
+
+		VisitNearestIf(location, range, predicate,
+			       [&out, &count, n](const T &value, distance_type){
+				       *out++ = value;
+				       return ++count < n;
+			       });
+		return count;
+	}
 };
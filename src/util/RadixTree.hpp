@@ -8,6 +8,11 @@
 
 #include <string>
 #include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
 #include <cassert>
 #ifdef PRINT_RADIX_TREE
 #include <ostream>
@@ -24,6 +29,13 @@
  */
 template<typename T>
 class RadixTree {
+public:
+	/**
+	 * A key/value pair for AddAll().
+	 */
+	using KeyValue = std::pair<const char *, T>;
+
+private:
 	template<class V>
 	struct KeyVisitorAdapter {
 		V &visitor;
@@ -149,6 +161,117 @@ class RadixTree {
 		}
 	};
 
+	/**
+	 * Compare two keys in the order of the tree: character by
+	 * character like FindChild() (i.e. with the signedness of
+	 * "char"), and a key before all keys which it is a prefix of.
+	 */
+	[[gnu::pure]]
+	static bool KeyLess(const char *a, const char *b) noexcept {
+		while (*a == *b && *a != '\0') {
+			++a;
+			++b;
+		}
+
+		if (*b == '\0')
+			return false;
+
+		return *a == '\0' || *a < *b;
+	}
+
+	/**
+	 * KeyPrefix() packs this many characters into an integer.
+	 */
+	static constexpr unsigned PREFIX_LENGTH = 7;
+	static constexpr unsigned PREFIX_CHAR_BITS = 9;
+	static constexpr uint_least64_t PREFIX_CHAR_MASK =
+		(1u << PREFIX_CHAR_BITS) - 1;
+
+	/**
+	 * Pack the first characters of the key into an integer which
+	 * compares like KeyLess(), for sorting many keys quickly.  The
+	 * end of the key is 0, and the characters are mapped to 1..256
+	 * in the order of "char".
+	 */
+	[[gnu::const]]
+	static uint_least64_t KeyPrefix(const char *key) noexcept {
+		uint_least64_t prefix = 0;
+		for (unsigned i = 0; i < PREFIX_LENGTH; ++i) {
+			prefix <<= PREFIX_CHAR_BITS;
+			if (*key != '\0')
+				prefix |= unsigned(int(*key++) - CHAR_MIN) + 1;
+		}
+
+		return prefix;
+	}
+
+	struct SortItem {
+		uint_least64_t prefix;
+		const KeyValue *kv;
+	};
+
+	/**
+	 * Sort the items with KeyLess(), ignoring the first #offset
+	 * characters (stable).  This is a radix sort of the key
+	 * prefixes; items with equal prefixes are sorted recursively by
+	 * the following characters.
+	 *
+	 * @param buffer scratch space for at least as many items
+	 */
+	static void Sort(std::span<SortItem> items, std::size_t offset,
+			 std::span<SortItem> buffer) {
+		const auto less = [offset](const SortItem &a, const SortItem &b){
+			return KeyLess(a.kv->first + offset, b.kv->first + offset);
+		};
+
+		if (items.size() < 64) {
+			std::stable_sort(items.begin(), items.end(), less);
+			return;
+		}
+
+		for (auto &i : items)
+			i.prefix = KeyPrefix(i.kv->first + offset);
+
+		std::span<SortItem> src = items, dest = buffer.first(items.size());
+		for (unsigned shift = 0; shift < 64; shift += 8) {
+			std::size_t offsets[257]{};
+			for (const auto &i : src)
+				++offsets[((i.prefix >> shift) & 0xff) + 1];
+
+			if (std::find(std::begin(offsets), std::end(offsets),
+				      src.size()) != std::end(offsets))
+				/* all items have the same byte here */
+				continue;
+
+			for (unsigned i = 1; i < 257; ++i)
+				offsets[i] += offsets[i - 1];
+
+			for (const auto &i : src)
+				dest[offsets[(i.prefix >> shift) & 0xff]++] = i;
+
+			std::swap(src, dest);
+		}
+
+		if (src.data() != items.data())
+			std::copy(src.begin(), src.end(), items.begin());
+
+		for (auto i = items.begin(); i != items.end();) {
+			const auto prefix = i->prefix;
+			const auto end = std::find_if(i, items.end(),
+						      [prefix](const SortItem &item){
+							      return item.prefix != prefix;
+						      });
+
+			/* the prefix is ambiguous only if the keys are
+			   longer */
+			if (std::distance(i, end) > 1 &&
+			    (prefix & PREFIX_CHAR_MASK) != 0)
+				Sort({i, end}, offset + PREFIX_LENGTH, buffer);
+
+			i = end;
+		}
+	}
+
 	/**
 	 * A node in the radix tree.  The "label" attribute is a substring
 	 * of the key.  A node can have any number of values (or none).
@@ -165,6 +288,9 @@ class RadixTree {
 		constexpr Node(const char *_label) noexcept
 			:label(_label) {}
 
+		explicit Node(std::string_view _label) noexcept
+			:label(_label) {}
+
 		Node(const Node &) = delete;
 
 		~Node() noexcept {
@@ -682,6 +808,55 @@ class RadixTree {
 			}
 		}
 
+		/**
+		 * Fill this empty node with the specified values, which
+		 * must be sorted with KeyLess().  All keys begin with
+		 * this node's key, which is #offset characters long.
+		 */
+		void Build(const KeyValue *const*begin,
+			   const KeyValue *const*end,
+			   std::size_t offset) {
+			assert(children == nullptr);
+			assert(leaves.head == nullptr);
+
+			/* the keys which end here come first; LeafList::Add()
+			   prepends, therefore add them in reverse order */
+			const KeyValue *const*i = begin;
+			while (i != end && (*i)->first[offset] == '\0')
+				++i;
+
+			for (const KeyValue *const*j = i; j != begin;)
+				AddValue((*--j)->second);
+
+			Node **tail = &children;
+			while (i != end) {
+				const char ch = (*i)->first[offset];
+				const KeyValue *const*group_end =
+					std::find_if(i, end, [ch, offset](const KeyValue *kv){
+						return kv->first[offset] != ch;
+					});
+
+				/* the longest common prefix of the sorted group
+				   is the one of its first and its last key; it
+				   is split into several nodes if it is too long
+				   for the StaticString */
+				const char *first = (*i)->first + offset;
+				const char *last = group_end[-1]->first + offset;
+				std::size_t length = 1;
+				while (length < Node::label.capacity() - 1 &&
+				       first[length] != '\0' &&
+				       first[length] == last[length])
+					++length;
+
+				Node *node = new Node(std::string_view{first, length});
+				*tail = node;
+				tail = &node->next_sibling;
+
+				node->Build(i, group_end, offset + length);
+				i = group_end;
+			}
+		}
+
 #ifdef PRINT_RADIX_TREE
 		template <typename Char, typename Traits>
 		friend std::basic_ostream<Char, Traits> &
@@ -784,6 +959,59 @@ public:
 		root.Add(key, value);
 	}
 
+	/**
+	 * Add many values at once.  The result is the same as calling
+	 * Add() for each of them in the given order, but the tree is
+	 * rebuilt from scratch, which is much faster than Add() if
+	 * there are many new values compared to the existing ones.
+	 *
+	 * @param items key/value pairs; the keys only need to be valid
+	 * during this call
+	 */
+	void AddAll(std::span<const KeyValue> items) {
+		if (items.empty())
+			return;
+
+		/* with equal keys, the last one added comes first, see
+		   LeafList::Add() */
+		std::vector<SortItem> sorted;
+		sorted.reserve(items.size());
+		for (auto i = items.rbegin(); i != items.rend(); ++i)
+			sorted.push_back({0, &*i});
+
+		std::vector<SortItem> buffer(sorted.size());
+		Sort(sorted, 0, buffer);
+
+		/* the existing values are already sorted, and they come
+		   after new values with the same key */
+		std::vector<std::pair<std::string, T>> existing_keys;
+		const auto collect = [&existing_keys](const char *key, const T &value){
+			existing_keys.emplace_back(key, value);
+		};
+		VisitAllPairs(collect);
+
+		std::vector<KeyValue> existing;
+		existing.reserve(existing_keys.size());
+		for (const auto &[key, value] : existing_keys)
+			existing.emplace_back(key.c_str(), value);
+
+		std::vector<const KeyValue *> merged;
+		merged.reserve(sorted.size() + existing.size());
+		auto i = sorted.begin();
+		for (const auto &e : existing) {
+			for (; i != sorted.end() && !KeyLess(e.first, i->kv->first); ++i)
+				merged.push_back(i->kv);
+
+			merged.push_back(&e);
+		}
+
+		for (; i != sorted.end(); ++i)
+			merged.push_back(i->kv);
+
+		root.Clear();
+		root.Build(merged.data(), merged.data() + merged.size(), 0);
+	}
+
 	/**
 	 * Remove all values with the specified key.
 	 */
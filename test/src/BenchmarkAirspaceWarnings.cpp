@@ -0,0 +1,186 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Replays an IGC file over an airspace file and feeds each fix into
+ * two #AirspaceWarningManager instances: one querying the
+ * #Airspaces R-tree directly, and one using the candidate cache.
+ * Prints the time per update and verifies that both managers
+ * produce the same warnings.
+ */
+
+#include "Airspace/AirspaceParser.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Airspace/AirspaceWarningManager.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "Engine/GlideSolvers/GlidePolar.hpp"
+#include "Engine/Task/Stats/TaskStats.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
+#include "Atmosphere/Pressure.hpp"
+#include "Geo/GeoVector.hpp"
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCFix.hpp"
+#include "IGC/IGCExtensions.hpp"
+#include "io/FileLineReader.hpp"
+#include "io/FileReader.hxx"
+#include "io/BufferedReader.hxx"
+#include "system/Args.hpp"
+#include "util/NumberParser.hpp"
+#include "util/PrintException.hxx"
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std::chrono;
+
+static std::vector<AircraftState>
+LoadFlight(Path path)
+{
+  FileLineReaderA reader(path);
+
+  IGCExtensions extensions;
+  extensions.clear();
+
+  std::vector<AircraftState> states;
+
+  char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    IGCFix fix;
+    if (!IGCParseFix(line, extensions, fix) || !fix.gps_valid)
+      continue;
+
+    AircraftState state;
+    state.Reset();
+    state.time = TimeStamp{fix.time.DurationSinceMidnight()};
+    state.location = fix.location;
+    state.altitude = fix.gps_altitude;
+    state.flying = true;
+
+    if (!states.empty()) {
+      const AircraftState &previous = states.back();
+      const double dt = (state.time - previous.time).count();
+      if (dt <= 0)
+        continue;
+
+      const GeoVector vector(previous.location, state.location);
+      state.ground_speed = state.true_airspeed = vector.distance / dt;
+      state.track = vector.bearing;
+      state.vario = (state.altitude - previous.altitude) / dt;
+    }
+
+    states.push_back(state);
+  }
+
+  return states;
+}
+
+using WarningKey = std::pair<const AbstractAirspace *,
+                             AirspaceWarning::State>;
+
+static std::vector<WarningKey>
+GetWarnings(const AirspaceWarningManager &manager) noexcept
+{
+  std::vector<WarningKey> v;
+  for (const auto &w : manager)
+    v.emplace_back(&w.GetAirspace(), w.GetWarningState());
+
+  std::sort(v.begin(), v.end());
+  return v;
+}
+
+int main(int argc, char **argv)
+try {
+  Args args(argc, argv, "AIRSPACES FILE.igc [REPEAT]");
+  const auto airspace_path = args.ExpectNextPath();
+  const auto igc_path = args.ExpectNextPath();
+
+  unsigned repeat = 10;
+  if (!args.IsEmpty())
+    repeat = ParseUnsigned(args.GetNext());
+
+  args.ExpectEnd();
+
+  Airspaces airspaces;
+
+  {
+    FileReader file_reader{airspace_path};
+    BufferedReader buffered_reader{file_reader};
+    ParseAirspaceFile(airspaces, buffered_reader);
+  }
+
+  airspaces.Optimise();
+  airspaces.SetFlightLevels(AtmosphericPressure::Standard());
+
+  const auto states = LoadFlight(igc_path);
+  if (states.empty()) {
+    fprintf(stderr, "No fixes\n");
+    return EXIT_FAILURE;
+  }
+
+  const GlidePolar glide_polar(1);
+  TaskStats task_stats;
+  task_stats.reset();
+
+  AirspaceWarningConfig config;
+  config.SetDefaults();
+
+  AirspaceWarningManager direct(config, airspaces), cached(config, airspaces);
+  direct.SetCandidateCacheEnabled(false);
+
+  steady_clock::duration direct_time{}, cached_time{};
+  unsigned n_updates = 0, n_mismatches = 0;
+  std::size_t n_candidates = 0, n_warnings = 0, max_warnings = 0;
+
+  for (unsigned i = 0; i < repeat; ++i) {
+    direct.Reset(states.front());
+    cached.Reset(states.front());
+
+    for (const auto &state : states) {
+      const bool circling = state.vario > 0.5;
+
+      auto start = steady_clock::now();
+      direct.Update(state, glide_polar, task_stats, circling, seconds{1});
+      direct_time += steady_clock::now() - start;
+
+      start = steady_clock::now();
+      cached.Update(state, glide_polar, task_stats, circling, seconds{1});
+      cached_time += steady_clock::now() - start;
+
+      ++n_updates;
+      n_candidates += cached.GetCandidateCache().size();
+      n_warnings += cached.size();
+      max_warnings = std::max(max_warnings, std::size_t(cached.size()));
+
+      if (GetWarnings(direct) != GetWarnings(cached))
+        ++n_mismatches;
+    }
+  }
+
+  const duration<double, std::micro> direct_us = direct_time;
+  const duration<double, std::micro> cached_us = cached_time;
+
+  printf("%u airspaces, %zu fixes, %u times\n",
+         airspaces.GetSize(), states.size(), repeat);
+  printf("warnings: %.2f average, %zu max\n",
+         double(n_warnings) / n_updates, max_warnings);
+  printf("direct:  %8.2f us/update\n", direct_us.count() / n_updates);
+  printf("cached:  %8.2f us/update, %u rebuilds, %.1f candidates average\n",
+         cached_us.count() / n_updates,
+         cached.GetCandidateCache().GetRebuildCount(),
+         double(n_candidates) / n_updates);
+
+  if (n_mismatches > 0) {
+    fprintf(stderr, "%u updates with different warnings\n", n_mismatches);
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,226 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Measures how long saving the xcsoar-cloud-server database blocks
+ * packet processing, and how long the server needs to start up.
+ *
+ * While the database is being saved, a probe thread keeps submitting
+ * fixes (like an EventLoop thread would) and records the slowest
+ * one.  This is done once with the old full locked save and once
+ * with CloudPersistence::Compact().  Then the database is loaded
+ * from the snapshot plus a journal of the given number of fixes.
+ */
+
+#include "Cloud/Persist.hpp"
+#include "Cloud/Serialiser.hpp"
+#include "io/FileOutputStream.hxx"
+#include "net/IPv4Address.hxx"
+#include "thread/Thread.hpp"
+#include "system/Args.hpp"
+#include "system/Path.hpp"
+#include "util/NumberParser.hpp"
+#include "util/PrintException.hxx"
+
+#include <atomic>
+#include <random>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std::chrono;
+
+static constexpr unsigned N_SHARDS = 4;
+
+static GeoPoint
+RandomLocation(std::mt19937 &random) noexcept
+{
+  std::uniform_real_distribution<double> longitude(-10, 30);
+  std::uniform_real_distribution<double> latitude(40, 55);
+  return GeoPoint(Angle::Degrees(longitude(random)),
+                  Angle::Degrees(latitude(random)));
+}
+
+static void
+SubmitFix(CloudShardedData &data, std::mt19937 &random,
+          unsigned n_clients) noexcept
+{
+  const IPv4Address address(127, 0, 0, 1, 5597);
+  const uint64_t key = std::uniform_int_distribution<unsigned>(1, n_clients)(random);
+  data.MakeClient(address, key, RandomLocation(random), 1000);
+}
+
+/**
+ * Submits fixes in a loop and measures how long each one takes.
+ */
+class FixProbe final : Thread {
+  CloudShardedData &data;
+  const unsigned n_clients;
+
+  std::atomic<bool> stop{false};
+
+  steady_clock::duration max_latency{};
+  unsigned n_fixes = 0;
+
+public:
+  FixProbe(CloudShardedData &_data, unsigned _n_clients) noexcept
+    :Thread("probe"), data(_data), n_clients(_n_clients) {}
+
+  using Thread::Start;
+
+  void Stop() noexcept {
+    stop = true;
+    Join();
+  }
+
+  double GetMaxLatencyMs() const noexcept {
+    return duration<double, std::milli>(max_latency).count();
+  }
+
+  unsigned GetFixCount() const noexcept {
+    return n_fixes;
+  }
+
+protected:
+  void Run() noexcept override {
+    std::mt19937 random{1};
+
+    while (!stop) {
+      const auto start = steady_clock::now();
+      SubmitFix(data, random, n_clients);
+      max_latency = std::max(max_latency, steady_clock::now() - start);
+      ++n_fixes;
+    }
+  }
+};
+
+/**
+ * The old CloudDatabase::Save(): serialise everything while the
+ * database is locked.
+ */
+static void
+LockedSave(const CloudShardedData &data, Path path)
+{
+  FileOutputStream fos(path);
+
+  {
+    Serialiser s(fos);
+    data.Save(s);
+    s.Flush();
+  }
+
+  fos.Commit();
+}
+
+template<typename F>
+static void
+MeasureSave(const char *name, CloudShardedData &data, unsigned n_clients,
+            F &&f)
+{
+  FixProbe probe(data, n_clients);
+  probe.Start();
+
+  const auto start = steady_clock::now();
+  f();
+  const duration<double, std::milli> elapsed = steady_clock::now() - start;
+
+  probe.Stop();
+
+  printf("%s: %.1f ms, %u fixes meanwhile, slowest fix %.2f ms\n",
+         name, elapsed.count(), probe.GetFixCount(),
+         probe.GetMaxLatencyMs());
+}
+
+static void
+MeasureLoad(const char *name, Path path)
+{
+  CloudShardedData data(N_SHARDS);
+  CloudPersistence persistence(data, path);
+
+  const auto start = steady_clock::now();
+  persistence.Load();
+  const duration<double, std::milli> elapsed = steady_clock::now() - start;
+
+  printf("%s: %.1f ms\n", name, elapsed.count());
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv, "DIRECTORY [CLIENTS] [JOURNAL_FIXES]");
+  const auto directory = args.ExpectNextPath();
+
+  unsigned n_clients = 100000, n_journal_fixes = 100000;
+  if (!args.IsEmpty())
+    n_clients = ParseUnsigned(args.GetNext());
+  if (!args.IsEmpty())
+    n_journal_fixes = ParseUnsigned(args.GetNext());
+  args.ExpectEnd();
+
+  if (n_clients == 0)
+    throw std::runtime_error("Need at least one client");
+
+  const auto db_path = AllocatedPath::Build(directory, "cloud.db");
+
+  CloudShardedData data(N_SHARDS);
+  CloudPersistence persistence(data, db_path);
+  persistence.Open(0);
+
+  std::mt19937 random{42};
+
+  for (unsigned i = 1; i <= n_clients; ++i) {
+    const IPv4Address address(127, 0, 0, 1, 5597);
+    const auto location = RandomLocation(random);
+    data.MakeClient(address, i, location, 1000);
+
+    if (i % 10 == 0)
+      data.MakeThermal(i, AGeoPoint(location, 800),
+                       AGeoPoint(location, 2000), 2.5);
+  }
+
+  persistence.Flush();
+
+  printf("clients: %u\n", n_clients);
+
+  MeasureSave("locked save", data, n_clients, [&]{
+    LockedSave(data, AllocatedPath::Build(directory, "cloud-locked.db"));
+  });
+
+  MeasureSave("snapshot+journal compaction", data, n_clients, [&]{
+    persistence.Compact();
+  });
+
+  {
+    /* this is how long Compact() locks the database; the buffers
+       have been allocated by the first call */
+    CloudShardedData::Snapshot snapshot;
+    data.TakeSnapshot(snapshot);
+    persistence.Compact();
+
+    const auto start = steady_clock::now();
+    data.TakeSnapshot(snapshot);
+    const duration<double, std::milli> elapsed = steady_clock::now() - start;
+    printf("snapshot copy (database locked): %.1f ms\n", elapsed.count());
+  }
+
+  /* our TakeSnapshot() call has consumed the pending journal
+     records; compact again to get them into the snapshot file */
+  persistence.Compact();
+
+  MeasureLoad("startup (snapshot only)", db_path);
+
+  for (unsigned i = 0; i < n_journal_fixes; ++i)
+    SubmitFix(data, random, n_clients);
+
+  persistence.Flush();
+
+  char name[64];
+  snprintf(name, sizeof(name), "startup (snapshot + %u journal records)",
+           n_journal_fixes);
+  MeasureLoad(name, db_path);
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Prints the time per speed to fly of the numeric search and the
+ * closed form GlidePolar::SpeedToFly().
+ */
+
+#include "GlideSolvers/GlidePolar.hpp"
+#include "SpeedToFlySearch.hpp"
+
+#include <array>
+#include <chrono>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std::chrono;
+
+static constexpr unsigned N_ROUNDS = 200;
+
+int
+main()
+{
+  /* the built-in reference polar, see TestGlidePolar */
+  GlidePolar polar(0);
+  polar.SetMC(1.5);
+
+  std::array<double, 256> head_winds;
+  for (unsigned i = 0; i < head_winds.size(); ++i)
+    head_winds[i] = -15. + 30. * i / head_winds.size();
+
+  /* prevents the compiler from discarding the results */
+  double checksum = 0;
+
+  /* the search is much slower, so it gets fewer rounds */
+  auto start = steady_clock::now();
+  for (unsigned j = 0; j < N_ROUNDS / 20; ++j)
+    for (const double head_wind : head_winds)
+      checksum += SpeedToFlySearch(polar, -0.5, head_wind).Solve();
+  const double search_ns =
+    duration<double, std::nano>(steady_clock::now() - start).count()
+    / (N_ROUNDS / 20 * head_winds.size());
+
+  start = steady_clock::now();
+  for (unsigned j = 0; j < N_ROUNDS; ++j)
+    for (const double head_wind : head_winds)
+      checksum += polar.SpeedToFly(-0.5, head_wind);
+  const double scalar_ns =
+    duration<double, std::nano>(steady_clock::now() - start).count()
+    / (N_ROUNDS * head_winds.size());
+
+  printf("search:       %.1f ns\n"
+         "closed form:  %.1f ns per speed\n"
+         "(checksum %g)\n",
+         search_ns, scalar_ns, checksum);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Compares the throughput of per-point terrain height queries
+ * (RasterMap::GetHeight(), RasterMap::GetInterpolatedHeight()) with
+ * the batch versions, and verifies that both return the same
+ * heights.
+ */
+
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/Loader.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Operation/Operation.hpp"
+#include "system/Args.hpp"
+#include "io/ZipArchive.hpp"
+#include "util/NumberParser.hpp"
+#include "util/PrintException.hxx"
+
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include <stdio.h>
+
+using namespace std::chrono;
+
+/**
+ * Random points scattered over the whole map.
+ */
+static std::vector<GeoPoint>
+MakeRandomPoints(const GeoBounds &bounds, unsigned n)
+{
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> lon(bounds.GetWest().Degrees(),
+                                             bounds.GetEast().Degrees());
+  std::uniform_real_distribution<double> lat(bounds.GetSouth().Degrees(),
+                                             bounds.GetNorth().Degrees());
+
+  std::vector<GeoPoint> points;
+  points.reserve(n);
+  for (unsigned i = 0; i < n; ++i)
+    points.emplace_back(Angle::Degrees(lon(rng)), Angle::Degrees(lat(rng)));
+  return points;
+}
+
+/**
+ * Points on concentric rings around the center, similar to the
+ * queries of the reach and route solvers.
+ */
+static std::vector<GeoPoint>
+MakeCoherentPoints(GeoPoint center, double radius, unsigned n)
+{
+  constexpr unsigned n_rings = 20;
+  const unsigned per_ring = n / n_rings;
+
+  std::vector<GeoPoint> points;
+  points.reserve(n);
+  for (unsigned ring = 1; ring <= n_rings; ++ring)
+    for (unsigned i = 0; i < per_ring; ++i)
+      points.push_back(GeoVector(radius * ring / n_rings,
+                                 Angle::FullCircle() * i / per_ring)
+                       .EndPoint(center));
+  return points;
+}
+
+template<typename F>
+static double
+Measure(unsigned n_runs, F &&f)
+{
+  const auto start = steady_clock::now();
+  for (unsigned i = 0; i < n_runs; ++i)
+    f();
+  const duration<double> elapsed = steady_clock::now() - start;
+  return elapsed.count() / n_runs;
+}
+
+static bool
+Benchmark(const RasterMap &map, const char *name,
+          const std::vector<GeoPoint> &points, unsigned n_runs)
+{
+  std::vector<TerrainHeight> single(points.size()), batch(points.size());
+  bool success = true;
+
+  for (const bool interpolated : {false, true}) {
+    const double t_single = Measure(n_runs, [&]{
+      for (std::size_t i = 0; i < points.size(); ++i)
+        single[i] = interpolated
+          ? map.GetInterpolatedHeight(points[i])
+          : map.GetHeight(points[i]);
+    });
+
+    const double t_batch = Measure(n_runs, [&]{
+      if (interpolated)
+        map.GetInterpolatedHeights(points, batch.data());
+      else
+        map.GetHeights(points, batch.data());
+    });
+
+    unsigned mismatches = 0;
+    for (std::size_t i = 0; i < points.size(); ++i)
+      if (single[i].GetValue() != batch[i].GetValue())
+        ++mismatches;
+
+    const double mpoints = points.size() / 1e6;
+    printf("%-8s %-12s single %7.2f Mpoints/s  batch %7.2f Mpoints/s"
+           "  speedup %.2f  mismatches %u\n",
+           name, interpolated ? "interpolated" : "coarse",
+           mpoints / t_single, mpoints / t_batch, t_single / t_batch,
+           mismatches);
+
+    if (mismatches > 0)
+      success = false;
+  }
+
+  return success;
+}
+
+int main(int argc, char **argv)
+try {
+  Args args(argc, argv, "PATH [RADIUS] [RUNS]");
+  const auto map_path = args.ExpectNextPath();
+
+  double radius = 20000;
+  if (!args.IsEmpty())
+    radius = ParseDouble(args.GetNext());
+
+  unsigned n_runs = 20;
+  if (!args.IsEmpty())
+    n_runs = ParseUnsigned(args.GetNext());
+
+  args.ExpectEnd();
+
+  ZipArchive archive(map_path);
+
+  RasterMap map;
+
+  {
+    NullOperationEnvironment operation;
+    LoadTerrainOverview(archive.get(), map.GetTileCache(), operation);
+  }
+
+  map.UpdateProjection();
+
+  /* load the tiles around the center; the other points are looked up
+     in the overview */
+  SharedMutex mutex;
+  do {
+    UpdateTerrainTiles(archive.get(), map.GetTileCache(), mutex,
+                       map.GetProjection(),
+                       map.GetMapCenter(), radius);
+  } while (map.IsDirty());
+
+  constexpr unsigned n_points = 100000;
+
+  bool success = true;
+  success &= Benchmark(map, "random",
+                       MakeRandomPoints(map.GetBounds(), n_points),
+                       n_runs);
+  success &= Benchmark(map, "coherent",
+                       MakeCoherentPoints(map.GetMapCenter(), radius,
+                                          n_points),
+                       n_runs);
+
+  return success ? EXIT_SUCCESS : EXIT_FAILURE;
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Renders a fixed area around the center of a terrain file at
+ * several resolutions with the #TerrainShader (which is what
+ * RasterRenderer::GenerateImage() does each time the map is redrawn)
+ * and prints the time per frame, with and without slope shading.
+ *
+ * The checksum of each image allows comparing the output of the
+ * SIMD kernels with the portable one (e.g. in a build for another
+ * architecture).
+ */
+
+#include "Terrain/TerrainShader.hpp"
+#include "Terrain/RasterMap.hpp"
+#include "Terrain/HeightMatrix.hpp"
+#include "Terrain/Loader.hpp"
+#include "Operation/Operation.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "ui/canvas/Ramp.hpp"
+#include "ui/canvas/RawBitmap.hpp"
+#include "system/Args.hpp"
+#include "io/ZipArchive.hpp"
+#include "util/NumberParser.hpp"
+#include "util/PrintException.hxx"
+
+#include <chrono>
+#include <memory>
+
+#include <stdio.h>
+
+using namespace std::chrono;
+
+static constexpr ColorRamp terrain_colors[NUM_COLOR_RAMP_LEVELS] = {
+  {0, { 0x70, 0xc0, 0xa7 }},
+  {250, { 0xca, 0xe7, 0xb9 }},
+  {500, { 0xf4, 0xea, 0xaf }},
+  {750, { 0xdc, 0xb2, 0x82 }},
+  {1000, { 0xca, 0x8e, 0x72 }},
+  {1250, { 0xde, 0xc8, 0xbd }},
+  {1500, { 0xe3, 0xe4, 0xe9 }},
+  {1750, { 0xdb, 0xd9, 0xef }},
+  {2000, { 0xce, 0xcd, 0xf5 }},
+  {2250, { 0xc2, 0xc1, 0xfa }},
+  {2500, { 0xb7, 0xb9, 0xff }},
+  {5000, { 0xb7, 0xb9, 0xff }},
+  {6000, { 0xb7, 0xb9, 0xff }}
+};
+
+static constexpr PixelSize resolutions[] = {
+  { 320, 240 },
+  { 640, 480 },
+  { 1280, 720 },
+  { 1920, 1080 },
+};
+
+/**
+ * FNV-1a over the image.
+ */
+[[gnu::pure]]
+static uint32_t
+Checksum(const RawColor *p, std::size_t n) noexcept
+{
+  const auto *b = (const uint8_t *)p;
+  uint32_t hash = 2166136261u;
+  for (std::size_t i = 0; i < n * sizeof(*p); ++i)
+    hash = (hash ^ b[i]) * 16777619u;
+  return hash;
+}
+
+static void
+Benchmark(TerrainShader &shader, const HeightMatrix &matrix,
+          double pixel_size, unsigned n_frames,
+          bool do_shading, unsigned quantisation_effective=1)
+{
+  const auto size = matrix.GetSize();
+  const auto image = std::make_unique<RawColor[]>(size.x * size.y);
+
+  const Angle sunazimuth = Angle::Degrees(45);
+
+  const auto start = steady_clock::now();
+  for (unsigned i = 0; i < n_frames; ++i)
+    shader.GenerateImage(matrix, image.get(), size.x,
+                         do_shading, 4, 64, 64, sunazimuth, true,
+                         quantisation_effective, pixel_size);
+  const duration<double, std::milli> elapsed = steady_clock::now() - start;
+
+  printf("%4ux%-4u %-8s q=%u %7.3f ms/frame  checksum %08x\n",
+         size.x, size.y, do_shading ? "shaded" : "unshaded",
+         quantisation_effective, elapsed.count() / n_frames,
+         Checksum(image.get(), size.x * size.y));
+}
+
+int main(int argc, char **argv)
+try {
+  Args args(argc, argv, "PATH [RADIUS] [FRAMES]");
+  const auto map_path = args.ExpectNextPath();
+
+  double radius = 20000;
+  if (!args.IsEmpty())
+    radius = ParseDouble(args.GetNext());
+
+  unsigned n_frames = 50;
+  if (!args.IsEmpty())
+    n_frames = ParseUnsigned(args.GetNext());
+
+  args.ExpectEnd();
+
+  ZipArchive archive(map_path);
+
+  RasterMap map;
+
+  {
+    NullOperationEnvironment operation;
+    LoadTerrainOverview(archive.get(), map.GetTileCache(), operation);
+  }
+
+  map.UpdateProjection();
+
+  SharedMutex mutex;
+  do {
+    UpdateTerrainTiles(archive.get(), map.GetTileCache(), mutex,
+                       map.GetProjection(),
+                       map.GetMapCenter(), radius);
+  } while (map.IsDirty());
+
+  TerrainShader shader;
+  shader.PrepareColorTable(terrain_colors, true, 4, 2);
+
+  printf("kernel: %s\n", TerrainShader::GetKernelName());
+
+  for (const auto &resolution : resolutions) {
+    WindowProjection projection;
+    projection.SetScreenSize(resolution);
+    projection.SetScaleFromRadius(radius);
+    projection.SetGeoLocation(map.GetMapCenter());
+    projection.SetScreenOrigin(resolution.width / 2, resolution.height / 2);
+    projection.UpdateScreenBounds();
+
+    HeightMatrix matrix;
+#ifdef ENABLE_OPENGL
+    matrix.Fill(map, projection.GetScreenBounds(),
+                (UnsignedPoint2D)projection.GetScreenSize(),
+                true);
+#else
+    matrix.Fill(map, projection, 1, true);
+#endif
+
+    const double pixel_size = 1 / projection.GetScale();
+
+    Benchmark(shader, matrix, pixel_size, n_frames, false);
+    Benchmark(shader, matrix, pixel_size, n_frames, true);
+    Benchmark(shader, matrix, pixel_size, n_frames, true, 3);
+  }
+
+  return EXIT_SUCCESS;
+} catch (const std::runtime_error &e) {
+  PrintException(e);
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,136 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Replays an IGC file (repeatedly, to simulate a long flight) into
+ * both #Trace implementations and prints the push_back() throughput,
+ * the time spent in thinning and the memory used per point.
+ */
+
+#include "Engine/Trace/ListTrace.hpp"
+#include "Engine/Trace/FlatTrace.hpp"
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCFix.hpp"
+#include "IGC/IGCExtensions.hpp"
+#include "io/FileLineReader.hpp"
+#include "system/Args.hpp"
+#include "util/NumberParser.hpp"
+#include "util/PrintException.hxx"
+
+#include <chrono>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std::chrono;
+
+static constexpr unsigned trace_sizes[] = { 128, 256, 1024, 4096 };
+
+static std::vector<TracePoint>
+LoadFlight(Path path)
+{
+  FileLineReaderA reader(path);
+
+  IGCExtensions extensions;
+  extensions.clear();
+
+  std::vector<TracePoint> fixes;
+
+  char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    IGCFix fix;
+    if (!IGCParseFix(line, extensions, fix) || !fix.gps_valid)
+      continue;
+
+    const auto time = fix.time.DurationSinceMidnight();
+    fixes.emplace_back(fix.location,
+                       duration_cast<duration<unsigned>>(time),
+                       fix.gps_altitude, 0, 0);
+  }
+
+  return fixes;
+}
+
+template<typename T>
+static void
+Benchmark(const char *name, const std::vector<TracePoint> &fixes,
+          unsigned repeat, unsigned max_size)
+{
+  T trace({}, T::null_time, max_size);
+
+  const duration<unsigned> flight_duration =
+    fixes.back().GetTime() - fixes.front().GetTime() + seconds{2};
+
+  unsigned n_points = 0, n_thinned = 0;
+  steady_clock::duration total{}, thinning{};
+  std::size_t max_memory = 0;
+
+  for (unsigned i = 0; i < repeat; ++i) {
+    /* shift the flight in time to continue the previous one */
+    const duration<unsigned> offset = i * flight_duration;
+
+    for (TracePoint fix : fixes) {
+      fix = TracePoint(fix.GetLocation(), fix.GetTime() + offset,
+                       fix.GetAltitude(), fix.GetVario(), 0);
+
+      const unsigned old_size = trace.size();
+
+      const auto start = steady_clock::now();
+      trace.push_back(fix);
+      const auto elapsed = steady_clock::now() - start;
+
+      total += elapsed;
+      ++n_points;
+
+      if (trace.size() < old_size) {
+        thinning += elapsed;
+        ++n_thinned;
+      }
+
+      max_memory = std::max(max_memory, trace.GetMemoryUsage());
+    }
+  }
+
+  const duration<double, std::nano> total_ns = total;
+  const duration<double, std::micro> thinning_us = thinning;
+
+  printf("%-5s %5u %9.1f %7u %9.1f %9.1f\n",
+         name, max_size,
+         total_ns.count() / n_points,
+         n_thinned,
+         n_thinned > 0 ? thinning_us.count() / n_thinned : 0.,
+         double(max_memory) / max_size);
+}
+
+int main(int argc, char **argv)
+try {
+  Args args(argc, argv, "FILE.igc [REPEAT]");
+  const auto path = args.ExpectNextPath();
+
+  unsigned repeat = 10;
+  if (!args.IsEmpty())
+    repeat = ParseUnsigned(args.GetNext());
+
+  args.ExpectEnd();
+
+  const auto fixes = LoadFlight(path);
+  if (fixes.empty()) {
+    fprintf(stderr, "No fixes\n");
+    return EXIT_FAILURE;
+  }
+
+  printf("%zu fixes, %u times\n", fixes.size(), repeat);
+  printf("%-5s %5s %9s %7s %9s %9s\n",
+         "", "size", "ns/push", "thins", "us/thin", "bytes/pt");
+
+  for (const unsigned max_size : trace_sizes) {
+    Benchmark<ListTrace>("list", fixes, repeat, max_size);
+    Benchmark<FlatTrace>("flat", fixes, repeat, max_size);
+  }
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,199 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Compares the cost of copying a #Trace under a lock (which is what
+ * the renderers used to do each frame) with the cost of publishing
+ * and reading immutable #TraceSnapshot objects, for synthetic
+ * flights of various lengths.
+ *
+ * Each flight is recorded twice: with the size limit of
+ * #TraceComputer (which thins the trace to 1024 points) and without
+ * a size limit, to show how the copy cost grows with the flight
+ * length.
+ */
+
+#include "Engine/Trace/Trace.hpp"
+#include "Engine/Trace/Snapshot.hpp"
+#include "Engine/Trace/Vector.hpp"
+#include "thread/Mutex.hxx"
+#include "Math/Angle.hpp"
+#include "system/Args.hpp"
+#include "util/NumberParser.hpp"
+#include "util/PrintException.hxx"
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std::chrono;
+
+static constexpr unsigned flight_hours[] = { 1, 2, 5, 10 };
+
+/* the Trace class accepts only one point per two seconds */
+static constexpr unsigned FIX_INTERVAL = 2;
+
+static const GeoPoint origin(Angle::Degrees(7.7), Angle::Degrees(51.05));
+
+/**
+ * Generate a fix of a synthetic flight: circling in a thermal for
+ * five minutes, then gliding for ten minutes, repeatedly.
+ */
+[[gnu::pure]]
+static TracePoint
+MakePoint(unsigned i) noexcept
+{
+  const unsigned t = i * FIX_INTERVAL;
+  const unsigned cycle = t / 900, phase = t % 900;
+
+  /* 20 km per cycle to the east */
+  double x = cycle * 20000., y = 0;
+  double altitude = 1500, vario = -1;
+
+  if (phase < 300) {
+    const double a = phase * (2 * M_PI / 30);
+    x += 150 * std::sin(a);
+    y += 150 * std::cos(a);
+    altitude += phase * 2;
+    vario = 2;
+  } else {
+    x += (phase - 300) * 20000. / 600;
+    altitude += 600 - (phase - 300);
+  }
+
+  const GeoPoint location(origin.longitude +
+                          Angle::Degrees(x / 70000),
+                          origin.latitude +
+                          Angle::Degrees(y / 111000));
+  return TracePoint(location, duration<unsigned>(t), altitude, vario, 0);
+}
+
+template<typename F>
+static double
+MeasureMicroseconds(unsigned n, F &&f) noexcept
+{
+  const auto start = steady_clock::now();
+  for (unsigned i = 0; i < n; ++i)
+    f();
+  const duration<double, std::micro> elapsed = steady_clock::now() - start;
+  return elapsed.count() / n;
+}
+
+static void
+Benchmark(unsigned hours, unsigned max_size, unsigned n_reads)
+{
+  const unsigned n_fixes = hours * 3600 / FIX_INTERVAL;
+
+  Trace trace(minutes{2}, Trace::null_time, max_size);
+  Mutex mutex, snapshot_mutex;
+  auto snapshot = std::make_shared<const TraceSnapshot>();
+
+  /* record the flight, publishing a new snapshot after each fix
+     like TraceComputer::Update() does */
+  steady_clock::duration publish{};
+  for (unsigned i = 0; i < n_fixes; ++i) {
+    {
+      const std::lock_guard lock{mutex};
+      trace.push_back(MakePoint(i));
+    }
+
+    const auto start = steady_clock::now();
+    if (!snapshot->IsCurrent(trace)) {
+      std::shared_ptr<const TraceSnapshot> next =
+        std::make_shared<const TraceSnapshot>(*snapshot, trace);
+      const std::lock_guard lock{snapshot_mutex};
+      snapshot.swap(next);
+    }
+    publish += steady_clock::now() - start;
+  }
+
+  const duration<double, std::micro> publish_us = publish;
+
+  /* the parameters of a filtered load in a map window, see
+     TrailRenderer::LoadTrace() */
+  const TraceSnapshot::Time min_time{};
+  const double resolution = 50;
+
+  TracePointVector v;
+  std::size_t n_points = 0;
+
+  const double locked_copy = MeasureMicroseconds(n_reads, [&]{
+    const std::lock_guard lock{mutex};
+    v.clear();
+    trace.GetPoints(v);
+    n_points += v.size();
+  });
+
+  const double locked_filtered = MeasureMicroseconds(n_reads, [&]{
+    const std::lock_guard lock{mutex};
+    v.clear();
+    trace.GetPoints(v, min_time, origin, resolution);
+    n_points += v.size();
+  });
+
+  const std::size_t n_filtered = v.size();
+
+  const double snapshot_load = MeasureMicroseconds(n_reads, [&]{
+    const auto s = [&]{
+      const std::lock_guard lock{snapshot_mutex};
+      return snapshot;
+    }();
+    n_points += s->GetPoints().size();
+  });
+
+  const double snapshot_filtered = MeasureMicroseconds(n_reads, [&]{
+    const auto s = [&]{
+      const std::lock_guard lock{snapshot_mutex};
+      return snapshot;
+    }();
+    v.clear();
+    s->GetPoints(v, min_time, origin, resolution);
+    n_points += v.size();
+  });
+
+  if (v.size() != n_filtered) {
+    fprintf(stderr, "Snapshot mismatch: %zu filtered points, expected %zu\n",
+            v.size(), n_filtered);
+    exit(EXIT_FAILURE);
+  }
+
+  printf("%3uh %-9s %6u %8.3f %8.3f %8.3f %8.3f %8.3f\n",
+         hours, max_size == 1024 ? "1024" : "unlimited",
+         trace.size(),
+         locked_copy, locked_filtered,
+         snapshot_load, snapshot_filtered,
+         publish_us.count() / n_fixes);
+
+  /* prevent gcc from optimizing the loops away */
+  if (n_points == 0)
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv)
+try {
+  Args args(argc, argv, "[READS]");
+
+  unsigned n_reads = 1000;
+  if (!args.IsEmpty())
+    n_reads = ParseUnsigned(args.GetNext());
+
+  args.ExpectEnd();
+
+  printf("all times in microseconds per operation\n");
+  printf("%4s %-9s %6s %8s %8s %8s %8s %8s\n",
+         "", "max_size", "points",
+         "copy", "filtered", "snap", "snapfilt", "publish");
+
+  for (const unsigned hours : flight_hours) {
+    Benchmark(hours, 1024, n_reads);
+    Benchmark(hours, hours * 3600 / FIX_INTERVAL + 1, n_reads);
+  }
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
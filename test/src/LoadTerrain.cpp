@@ -4,22 +4,89 @@
 /*
  * This program loads the terrain from a map file and exits.  Useful
  * for valgrind and profiling.
+ *
+ * The tiles around the center of the map are loaded once by the
+ * calling thread only and once with the given number of tile decoder
+ * threads (default: as many as XCSoar would use), and the decoder
+ * throughput is printed.
+ *
+ * If a cache directory is given, the tiles are then loaded twice with
+ * a #TerrainTileStore: the first run fills it, the second one loads
+ * the tiles from the mapped file.
  */
 
 #include "Terrain/RasterTileCache.hpp"
 #include "Terrain/Loader.hpp"
+#include "Terrain/TileDecodePool.hpp"
 #include "Operation/ConsoleOperationEnvironment.hpp"
+#include "Operation/Operation.hpp"
 #include "system/Args.hpp"
 #include "system/ConvertPathName.hpp"
 #include "io/ZipArchive.hpp"
+#include "io/FileCache.hpp"
+#include "util/NumberParser.hpp"
 #include "util/PrintException.hxx"
 
+#include <chrono>
+#include <optional>
+
 #include <stdio.h>
 #include <string.h>
+
+using namespace std::chrono;
+
+static void
+LoadTiles(ZipArchive &archive, unsigned radius, unsigned n_threads,
+          FileCache *cache=nullptr, Path map_path=nullptr)
+{
+  RasterTileCache rtc;
+
+  {
+    NullOperationEnvironment operation;
+    LoadTerrainOverview(archive.get(), rtc, operation);
+  }
+
+  if (cache != nullptr)
+    rtc.OpenTileStore(*cache, map_path);
+
+  const SignedRasterLocation center(rtc.GetSize().x / 2,
+                                    rtc.GetSize().y / 2);
+
+  SharedMutex mutex;
+  unsigned n_updates = 0;
+
+  const auto start = steady_clock::now();
+  do {
+    UpdateTerrainTiles(archive.get(), "terrain.jp2", rtc, mutex,
+                       center, radius, n_threads);
+    ++n_updates;
+  } while (rtc.IsDirty());
+  const duration<double> elapsed = steady_clock::now() - start;
+
+  const unsigned n_tiles = rtc.CountLoadedTiles();
+  printf("%u decoder threads%s: %u tiles in %u updates, %.1f ms, %.1f tiles/s\n",
+         n_threads, cache != nullptr ? " with tile store" : "",
+         n_tiles, n_updates, elapsed.count() * 1000,
+         n_tiles / elapsed.count());
+}
+
 int main(int argc, char **argv)
 try {
-  Args args(argc, argv, "PATH");
+  Args args(argc, argv, "PATH [RADIUS] [THREADS] [CACHE_DIR]");
   const auto map_path = args.ExpectNextPath();
+
+  unsigned radius = 1000;
+  if (!args.IsEmpty())
+    radius = ParseUnsigned(args.GetNext());
+
+  unsigned n_threads = TileDecodePool::GetDefaultThreadCount();
+  if (!args.IsEmpty())
+    n_threads = ParseUnsigned(args.GetNext());
+
+  std::optional<FileCache> cache;
+  if (!args.IsEmpty())
+    cache.emplace(args.ExpectNextPath());
+
   args.ExpectEnd();
 
   ZipArchive archive(map_path);
@@ -28,7 +95,11 @@ try {
 
   {
     ConsoleOperationEnvironment operation;
+
+    const auto start = steady_clock::now();
     LoadTerrainOverview(archive.get(), rtc, operation);
+    const duration<double, std::milli> elapsed = steady_clock::now() - start;
+    printf("overview: %.1f ms\n", elapsed.count());
   }
 
   GeoBounds bounds = rtc.GetBounds();
@@ -38,13 +109,15 @@ try {
          (double)bounds.GetEast().Degrees(),
          (double)bounds.GetSouth().Degrees());
 
-  SharedMutex mutex;
-  do {
-    UpdateTerrainTiles(archive.get(), rtc, mutex,
-                       SignedRasterLocation(rtc.GetSize().x / 2,
-                                            rtc.GetSize().y / 2),
-                       1000);
-  } while (rtc.IsDirty());
+  LoadTiles(archive, radius, 0);
+  if (n_threads > 0)
+    LoadTiles(archive, radius, n_threads);
+
+  if (cache) {
+    cache->Flush("terrain.tiles");
+    LoadTiles(archive, radius, n_threads, &*cache, map_path);
+    LoadTiles(archive, radius, n_threads, &*cache, map_path);
+  }
 
   return EXIT_SUCCESS;
 } catch (const std::runtime_error &e) {
@@ -4,18 +4,31 @@
 /*
  * This program loads the topography from a map file and exits.  Useful
  * for valgrind and profiling.
+ *
+ * With "--pan", it simulates panning the map back and forth across
+ * the topography instead, and prints how long the updates take
+ * without the shape cache, with the shape cache, and with the shape
+ * cache and prefetching.
  */
 
 #include "Topography/TopographyStore.hpp"
 #include "Topography/TopographyFile.hpp"
 #include "Topography/XShape.hpp"
+#include "Projection/WindowProjection.hpp"
+#include "Geo/GeoVector.hpp"
 #include "system/Args.hpp"
 #include "io/FileLineReader.hpp"
 #include "io/ZipArchive.hpp"
 #include "io/ZipLineReader.hpp"
 #include "util/PrintException.hxx"
+#include "util/StringAPI.hxx"
+
+#include <chrono>
 
 #include <stdio.h>
+
+using namespace std::chrono;
+
 #ifdef ENABLE_OPENGL
 
 static const uint16_t *
@@ -41,17 +54,9 @@ TriangulateAll(const TopographyStore &store)
 
 #endif
 
-int main(int argc, char **argv)
-try {
-  Args args(argc, argv, "{FILE.xcm | FILE.tpl PATH}");
-  const auto file = args.ExpectNextPath();
-  decltype(args.ExpectNextPath()) directory{};
-  if (!args.IsEmpty())
-    directory = args.ExpectNextPath();
-  args.ExpectEnd();
-
-  TopographyStore topography;
-
+static void
+Load(TopographyStore &topography, Path file, Path directory)
+{
   if (directory == nullptr) {
     ZipArchive archive(file);
 
@@ -61,6 +66,99 @@ try {
     FileLineReaderA reader{file};
     topography.Load(reader, directory, nullptr);
   }
+}
+
+/**
+ * Pan the map back and forth (west to east and back, twice) over the
+ * center of the topography, in steps of 500 m, like the map follows
+ * a fast glider.
+ */
+static void
+Pan(Path file, Path directory, bool cache, bool prefetch)
+{
+  TopographyStore topography;
+  Load(topography, file, directory);
+  topography.SetShapeCacheEnabled(cache);
+
+  if (topography.begin() == topography.end())
+    throw std::runtime_error("No topography");
+
+  const GeoPoint center = topography.begin()->GetCenter();
+  constexpr double LEG = 20000, STEP = 500;
+  const GeoPoint west =
+    GeoVector(LEG / 2, Angle::Degrees(270)).EndPoint(center);
+
+  WindowProjection projection;
+  projection.SetScreenSize({640, 480});
+  projection.SetScaleFromRadius(2000);
+  projection.SetScreenOrigin(320, 240);
+
+  steady_clock::duration update_time{}, prefetch_time{};
+  unsigned n_steps = 0, n_updates = 0, n_prefetched = 0;
+
+  for (unsigned leg = 0; leg < 4; ++leg) {
+    const Angle direction = Angle::Degrees(leg % 2 == 0 ? 90 : 270);
+    const GeoPoint start = leg % 2 == 0
+      ? west
+      : GeoVector(LEG, Angle::Degrees(90)).EndPoint(west);
+
+    for (double d = 0; d < LEG; d += STEP, ++n_steps) {
+      projection.SetGeoLocation(GeoVector(d, direction).EndPoint(start));
+      projection.UpdateScreenBounds();
+
+      auto t = steady_clock::now();
+      const unsigned n = topography.ScanVisibility(projection);
+      update_time += steady_clock::now() - t;
+
+      if (n == 0)
+        continue;
+
+      ++n_updates;
+
+      if (prefetch) {
+        t = steady_clock::now();
+        n_prefetched += topography.Prefetch(projection, direction);
+        prefetch_time += steady_clock::now() - t;
+      }
+    }
+  }
+
+  const duration<double, std::milli> update_ms = update_time;
+  const duration<double, std::milli> prefetch_ms = prefetch_time;
+
+  printf("%-16s %u steps, %u updates: %8.2f ms updating, "
+         "%8.2f ms prefetching %u shapes\n",
+         !cache ? "no cache:" : !prefetch ? "cache:" : "cache+prefetch:",
+         n_steps, n_updates, update_ms.count(),
+         prefetch_ms.count(), n_prefetched);
+}
+
+int main(int argc, char **argv)
+try {
+  Args args(argc, argv, "[--pan] {FILE.xcm | FILE.tpl PATH}");
+
+  bool pan = false;
+  const char *arg = args.PeekNext();
+  if (arg != nullptr && StringIsEqual(arg, "--pan")) {
+    args.Skip();
+    pan = true;
+  }
+
+  const auto file = args.ExpectNextPath();
+  decltype(args.ExpectNextPath()) directory{};
+  if (!args.IsEmpty())
+    directory = args.ExpectNextPath();
+  args.ExpectEnd();
+
+  if (pan) {
+    Pan(file, directory, false, false);
+    Pan(file, directory, true, false);
+    Pan(file, directory, true, true);
+    return EXIT_SUCCESS;
+  }
+
+  TopographyStore topography;
+  Load(topography, file, directory);
 
   topography.LoadAll();
 
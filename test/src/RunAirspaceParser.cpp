@@ -1,30 +1,109 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 // Copyright The XCSoar Project
 
+/*
+ * Loads one or more airspace files like XCSoar does at startup and
+ * prints how long each phase takes.  With "--cache", the parsed
+ * airspaces are cached in the specified directory, and the next run
+ * loads them from there.
+ */
+
+#include "Airspace/AirspaceCache.hpp"
 #include "Airspace/AirspaceParser.hpp"
 #include "Engine/Airspace/Airspaces.hpp"
 #include "system/Args.hpp"
+#include "io/FileCache.hpp"
 #include "io/FileLineReader.hpp"
 #include "Operation/ConsoleOperationEnvironment.hpp"
+#include "thread/ParallelFor.hpp"
 #include "util/PrintException.hxx"
+#include "util/StringCompare.hxx"
+
+#include <chrono>
+#include <memory>
+#include <vector>
 
 #include <stdio.h>
+#include <stdlib.h>
+
+using namespace std::chrono;
+
+static double
+ToMilliseconds(steady_clock::duration d) noexcept
+{
+  return duration<double, std::milli>(d).count();
+}
+
 int main(int argc, char **argv)
 try {
-  Args args(argc, argv, "PATH");
-  const auto path = args.ExpectNextPath();
-  args.ExpectEnd();
+  Args args(argc, argv,
+            "[OPTIONS] PATH...\n"
+            "Options:\n"
+            "  --threads=N   Parse with N threads (default: number of CPUs)\n"
+            "  --cache=DIR   Cache the parsed airspaces in DIR");
+
+  unsigned n_threads = GetParallelThreadCount();
+  std::unique_ptr<FileCache> cache;
 
-  FileReader file_reader{path};
-  BufferedReader buffered_reader{file_reader};
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--threads=")) != nullptr) {
+      n_threads = strtoul(value, nullptr, 10);
+      if (n_threads == 0)
+        args.UsageError();
+    } else if ((value = StringAfterPrefix(arg, "--cache=")) != nullptr) {
+      cache = std::make_unique<FileCache>(AllocatedPath{value});
+    } else {
+      args.UsageError();
+    }
+  }
+
+  std::vector<Path> paths;
+  do {
+    paths.push_back(args.ExpectNextPath());
+  } while (!args.IsEmpty());
 
   Airspaces airspaces;
 
-  ParseAirspaceFile(airspaces, buffered_reader);
+  const auto start = steady_clock::now();
+
+  for (const auto path : paths) {
+    const auto file_start = steady_clock::now();
+
+    std::vector<AirspacePtr> parsed;
+    if (cache && LoadAirspaceCache(*cache, path, parsed)) {
+      printf("load cache %s: %.1f ms\n", path.c_str(),
+             ToMilliseconds(steady_clock::now() - file_start));
+    } else {
+      FileReader file_reader{path};
+      BufferedReader buffered_reader{file_reader};
+      ParseAirspaceFile(parsed, buffered_reader, n_threads);
+
+      printf("parse %s: %.1f ms\n", path.c_str(),
+             ToMilliseconds(steady_clock::now() - file_start));
+
+      if (cache) {
+        const auto save_start = steady_clock::now();
+        SaveAirspaceCache(*cache, path, parsed);
+        printf("save cache: %.1f ms\n",
+               ToMilliseconds(steady_clock::now() - save_start));
+      }
+    }
+
+    for (auto &i : parsed)
+      airspaces.Add(std::move(i));
+  }
 
+  const auto optimise_start = steady_clock::now();
   airspaces.Optimise();
+  const auto end = steady_clock::now();
 
-  printf("OK\n");
+  printf("optimise: %.1f ms\n", ToMilliseconds(end - optimise_start));
+  printf("total: %.1f ms, %u airspaces, %u threads\n",
+         ToMilliseconds(end - start), airspaces.GetSize(), n_threads);
 
   return EXIT_SUCCESS;
 } catch (const std::runtime_error &e) {
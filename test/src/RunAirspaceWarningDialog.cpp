@@ -54,7 +54,8 @@ LoadFiles(Airspaces &airspace_database)
   const auto paths = Profile::GetMultiplePaths(ProfileKeys::AirspaceFileList,
                                                AIRSPACE_FILE_PATTERNS);
   for (auto it = paths.begin(); it < paths.end(); it++) {
-    ParseAirspaceFile(airspace_database, *it, test_operation_environment);
+    ParseAirspaceFile(airspace_database, *it, nullptr,
+                      test_operation_environment);
   }
   airspace_database.Optimise();
 }
@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Replays a flight through the #GlideComputer like the
+ * #CalculationThread does (without the user interface) and prints
+ * the run time histograms of all computers (#CalculationTiming).
+ *
+ * The "latency" histogram measures the time from handing the GPS
+ * fix to the #GlideComputer until GlideComputer::ProcessGPS() has
+ * finished.
+ */
+
+#include "Computer/GlideComputer.hpp"
+#include "Computer/GlideComputerInterface.hpp"
+#include "Computer/Settings.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Engine/Task/TaskManager.hpp"
+#include "Task/ProtectedTaskManager.hpp"
+#include "DebugReplay.hpp"
+#include "system/Args.hpp"
+#include "util/PrintException.hxx"
+
+#include <memory>
+
+#include <stdio.h>
+
+/* fake symbols: */
+
+#include "Computer/ConditionMonitor/ConditionMonitors.hpp"
+#include "Dialogs/Dialogs.h"
+#include "Dialogs/Airspace/AirspaceWarningDialog.hpp"
+#include "Input/InputQueue.hpp"
+#include "Logger/Logger.hpp"
+
+void dlgBasicSettingsShowModal() {}
+void ShowWindSettingsDialog() {}
+
+void
+dlgAirspaceWarningsShowModal([[maybe_unused]] ProtectedAirspaceWarningManager &warnings,
+                             [[maybe_unused]] bool auto_close)
+{
+}
+
+void
+dlgStatusShowModal([[maybe_unused]] int page)
+{
+}
+
+void
+ConditionMonitors::Update([[maybe_unused]] const NMEAInfo &basic,
+                          [[maybe_unused]] const DerivedInfo &calculated,
+                          [[maybe_unused]] const ComputerSettings &settings) noexcept
+{
+}
+
+bool InputEvents::processGlideComputer(unsigned) { return false; }
+
+void Logger::LogStartEvent([[maybe_unused]] const NMEAInfo &gps_info) {}
+void Logger::LogFinishEvent([[maybe_unused]] const NMEAInfo &gps_info) {}
+void Logger::LogPoint([[maybe_unused]] const NMEAInfo &gps_info) {}
+
+/* done with fake symbols. */
+
+static void
+PrintHistogram(const char *name, const LatencyHistogram &histogram)
+{
+  char buffer[128];
+  FormatLatencySummary(buffer, sizeof(buffer), histogram);
+  printf("%-14s %s\n", name, buffer);
+}
+
+static void
+PrintBuckets(const char *name, const LatencyHistogram &histogram)
+{
+  printf("\n%s:\n", name);
+
+  for (unsigned i = 0; i < LatencyHistogram::N_BUCKETS; ++i) {
+    const unsigned n = histogram.GetBucket(i);
+    if (n > 0)
+      printf("  < %8lu us  %u\n",
+             (unsigned long)LatencyHistogram::GetBucketLimit(i).count(), n);
+  }
+}
+
+int
+main(int argc, char **argv)
+try {
+  Args args(argc, argv, "DRIVER FILE");
+  std::unique_ptr<DebugReplay> replay{CreateDebugReplay(args)};
+  if (!replay)
+    return EXIT_FAILURE;
+
+  args.ExpectEnd();
+
+  ComputerSettings settings;
+  settings.SetDefaults();
+  settings.polar.glide_polar_task = GlidePolar(1);
+  settings.contest.enable = true;
+
+  const Waypoints way_points;
+
+  TaskBehaviour task_behaviour;
+  task_behaviour.SetDefaults();
+
+  TaskManager task_manager(task_behaviour, way_points);
+  task_manager.SetGlidePolar(settings.polar.glide_polar_task);
+
+  GlideComputerTaskEvents task_events;
+  task_manager.SetTaskEvents(task_events);
+
+  Airspaces airspace_database;
+
+  ProtectedTaskManager protected_task_manager(task_manager, settings.task);
+
+  GlideComputer glide_computer(settings, way_points, airspace_database,
+                               protected_task_manager, task_events);
+  glide_computer.Initialise();
+
+  unsigned n_fixes = 0;
+  while (replay->Next()) {
+    const auto start = LatencyHistogram::Clock::now();
+
+    glide_computer.ReadBlackboard(replay->Basic());
+    glide_computer.ProcessGPS();
+
+    glide_computer.SetTiming().latency.Add(LatencyHistogram::Clock::now() -
+                                           start);
+
+    /* the CalculationThread runs the idle calculations every 500 ms;
+       a flight log usually has one fix per second or less, so run
+       them for each fix */
+    glide_computer.ProcessIdle();
+
+    ++n_fixes;
+  }
+
+  printf("%u fixes\n\n", n_fixes);
+
+  const CalculationTiming &timing = glide_computer.GetTiming();
+
+  PrintHistogram("latency", timing.latency);
+  PrintHistogram("gps", timing.gps);
+  PrintHistogram("idle", timing.idle);
+
+  for (unsigned i = 0; i < unsigned(CalculationStage::COUNT); ++i)
+    PrintHistogram(ToString(CalculationStage(i)), timing.stages[i]);
+
+  PrintBuckets("gps", timing.gps);
+  PrintBuckets("idle", timing.idle);
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
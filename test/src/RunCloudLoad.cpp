@@ -0,0 +1,298 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * A load generator for xcsoar-cloud-server.  It simulates a number of
+ * gliders flying around in a small area, each submitting one fix per
+ * second and requesting nearby traffic.  At the end, it prints how
+ * many fixes per second were submitted and how the server kept up
+ * (traffic pushes received, ping round-trip time).
+ */
+
+#include "Tracking/SkyLines/Assemble.hpp"
+#include "Tracking/SkyLines/Protocol.hpp"
+#include "Tracking/SkyLines/Server.hpp"
+#include "Geo/GeoPoint.hpp"
+#include "Geo/Math.hpp"
+#include "Math/Angle.hpp"
+#include "net/AddressInfo.hxx"
+#include "net/Resolver.hxx"
+#include "net/SocketError.hxx"
+#include "net/UniqueSocketDescriptor.hxx"
+#include "net/AllocatedSocketAddress.hxx"
+#include "event/Loop.hxx"
+#include "event/SocketEvent.hxx"
+#include "event/FineTimerEvent.hxx"
+#include "system/Args.hpp"
+#include "util/ByteOrder.hxx"
+#include "util/NumberParser.hpp"
+#include "util/PrintException.hxx"
+#include "util/SpanCast.hxx"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace std::chrono;
+
+static constexpr auto TICK = milliseconds(100);
+
+struct SimulatedGlider {
+  uint64_t key;
+  GeoPoint location;
+  Angle track;
+  int altitude;
+
+  /**
+   * Has this glider already requested traffic?  This is done after
+   * the first fix, because the server ignores requests from unknown
+   * clients.
+   */
+  bool traffic_requested = false;
+};
+
+class CloudLoad {
+  EventLoop &event_loop;
+  const AllocatedSocketAddress address;
+
+  SocketEvent socket;
+
+  FineTimerEvent tick_timer{event_loop, BIND_THIS_METHOD(OnTick)};
+  FineTimerEvent stop_timer{event_loop, BIND_THIS_METHOD(OnStop)};
+
+  bool stopping = false;
+
+  std::vector<SimulatedGlider> gliders;
+  std::mt19937 random{42};
+
+  /**
+   * The index of the next glider in #gliders which shall submit a
+   * fix.
+   */
+  std::size_t next_glider = 0;
+
+  /**
+   * How many fixes should have been sent by now.
+   */
+  double fix_budget = 0;
+  const double fixes_per_tick;
+
+  steady_clock::time_point start_time, stop_time;
+
+  uint16_t next_ping_id = 0;
+  std::vector<steady_clock::time_point> ping_times;
+
+  unsigned n_fixes = 0, n_pings = 0, n_acks = 0;
+  unsigned n_traffic_datagrams = 0, n_traffic_records = 0;
+  steady_clock::duration rtt_sum{}, rtt_max{};
+
+public:
+  CloudLoad(EventLoop &_event_loop, SocketAddress _address,
+            unsigned n_gliders, double fix_rate)
+    :event_loop(_event_loop), address(_address),
+     socket(event_loop, BIND_THIS_METHOD(OnSocketReady)),
+     fixes_per_tick(n_gliders * fix_rate * duration<double>(TICK).count())
+  {
+    UniqueSocketDescriptor s;
+    if (!s.Create(address.GetFamily(), SOCK_DGRAM, 0))
+      throw MakeSocketError("Failed to create socket");
+
+    socket.Open(s.Release());
+    socket.ScheduleRead();
+
+    /* spread the gliders over a 40x40 km area, so each one sees
+       plenty of traffic */
+    std::uniform_real_distribution<double> offset(-0.2, 0.2);
+    std::uniform_real_distribution<double> bearing(0, 360);
+    std::uniform_int_distribution<int> altitude(800, 3000);
+
+    gliders.reserve(n_gliders);
+    for (unsigned i = 0; i < n_gliders; ++i)
+      gliders.push_back({
+        0x10000 + i,
+        GeoPoint(Angle::Degrees(11 + offset(random)),
+                 Angle::Degrees(47 + offset(random))),
+        Angle::Degrees(bearing(random)),
+        altitude(random),
+      });
+  }
+
+  ~CloudLoad() noexcept {
+    socket.Close();
+  }
+
+  void Start(steady_clock::duration duration) noexcept {
+    start_time = steady_clock::now();
+
+    tick_timer.Schedule(steady_clock::duration::zero());
+    stop_timer.Schedule(duration);
+  }
+
+  void PrintResults() const noexcept {
+    const double elapsed =
+      duration<double>(stop_time - start_time).count();
+
+    printf("gliders: %zu\n", gliders.size());
+    printf("duration: %.1f s\n", elapsed);
+    printf("fixes sent: %u (%.0f fixes/s)\n",
+           n_fixes, n_fixes / elapsed);
+    printf("traffic received: %u datagrams (%.0f/s), %u records (%.0f/s)\n",
+           n_traffic_datagrams, n_traffic_datagrams / elapsed,
+           n_traffic_records, n_traffic_records / elapsed);
+    printf("pings: %u sent, %u acknowledged\n", n_pings, n_acks);
+
+    if (n_acks > 0)
+      printf("ping RTT: avg %.2f ms, max %.2f ms\n",
+             duration<double, std::milli>(rtt_sum).count() / n_acks,
+             duration<double, std::milli>(rtt_max).count());
+  }
+
+private:
+  template<typename P>
+  void Send(const P &packet) noexcept {
+    (void)socket.GetSocket().WriteNoWait(ReferenceAsBytes(packet), address);
+  }
+
+  void SendFix(SimulatedGlider &g) noexcept {
+    /* fly straight at 30 m/s, turn a bit now and then */
+    g.location = FindLatitudeLongitude(g.location, g.track, 30);
+    if (std::uniform_int_distribution<int>(0, 9)(random) == 0)
+      g.track += Angle::Degrees(30);
+
+    const auto time_of_day = duration_cast<milliseconds>
+      (system_clock::now().time_since_epoch()) % hours(24);
+
+    Send(SkyLinesTracking::MakeFix(g.key,
+                                   SkyLinesTracking::FixPacket::FLAG_LOCATION |
+                                   SkyLinesTracking::FixPacket::FLAG_ALTITUDE,
+                                   time_of_day.count(),
+                                   g.location, g.track, 30, 30,
+                                   g.altitude, 0, 0));
+    ++n_fixes;
+
+    if (!g.traffic_requested) {
+      Send(SkyLinesTracking::MakeTrafficRequest(g.key, false, false, true));
+      g.traffic_requested = true;
+    }
+  }
+
+  void SendPing() noexcept {
+    const uint16_t id = next_ping_id++;
+    ping_times.push_back(steady_clock::now());
+    Send(SkyLinesTracking::MakePing(gliders.front().key, id));
+    ++n_pings;
+  }
+
+  void OnTick() noexcept {
+    fix_budget += fixes_per_tick;
+    while (fix_budget >= 1) {
+      SendFix(gliders[next_glider]);
+      if (++next_glider == gliders.size())
+        next_glider = 0;
+
+      fix_budget -= 1;
+    }
+
+    if (n_fixes > 0 && next_ping_id < (steady_clock::now() - start_time) / seconds(1))
+      SendPing();
+
+    tick_timer.Schedule(TICK);
+  }
+
+  void OnStop() noexcept {
+    if (stopping) {
+      event_loop.Break();
+      return;
+    }
+
+    /* stop sending, but wait a little for outstanding responses */
+    stopping = true;
+    stop_time = steady_clock::now();
+    tick_timer.Cancel();
+    stop_timer.Schedule(seconds(1));
+  }
+
+  void OnAck(uint16_t id) noexcept {
+    if (id >= ping_times.size())
+      return;
+
+    const auto rtt = steady_clock::now() - ping_times[id];
+    rtt_sum += rtt;
+    rtt_max = std::max(rtt_max, rtt);
+    ++n_acks;
+  }
+
+  void OnDatagram(std::span<const std::byte> data) noexcept {
+    using namespace SkyLinesTracking;
+
+    if (data.size() < sizeof(Header))
+      return;
+
+    const auto &header = *(const Header *)data.data();
+    switch ((Type)FromBE16(header.type)) {
+    case ACK:
+      if (data.size() >= sizeof(ACKPacket))
+        OnAck(FromBE16(((const ACKPacket *)data.data())->id));
+      break;
+
+    case TRAFFIC_RESPONSE:
+      if (data.size() >= sizeof(TrafficResponsePacket)) {
+        ++n_traffic_datagrams;
+        n_traffic_records +=
+          ((const TrafficResponsePacket *)data.data())->traffic_count;
+      }
+      break;
+
+    default:
+      break;
+    }
+  }
+
+  void OnSocketReady(unsigned) noexcept {
+    std::byte buffer[4096];
+    ssize_t nbytes;
+    while ((nbytes = socket.GetSocket().ReadNoWait(buffer)) > 0)
+      OnDatagram({buffer, std::size_t(nbytes)});
+  }
+};
+
+int
+main(int argc, char *argv[])
+try {
+  Args args(argc, argv, "HOST [GLIDERS] [SECONDS] [FIXES_PER_SECOND]");
+  const char *host = args.ExpectNext();
+
+  unsigned n_gliders = 1000, n_seconds = 10;
+  double fix_rate = 1;
+  if (!args.IsEmpty())
+    n_gliders = ParseUnsigned(args.GetNext());
+  if (!args.IsEmpty())
+    n_seconds = ParseUnsigned(args.GetNext());
+  if (!args.IsEmpty())
+    fix_rate = ParseDouble(args.GetNext());
+  args.ExpectEnd();
+
+  if (n_gliders == 0)
+    throw std::runtime_error("Need at least one glider");
+
+  const auto address_list =
+    Resolve(host, SkyLinesTracking::Server::GetDefaultPort(),
+            0, SOCK_DGRAM);
+
+  EventLoop event_loop;
+
+  CloudLoad load(event_loop, address_list.GetBest(),
+                 n_gliders, fix_rate);
+  load.Start(seconds(n_seconds));
+
+  event_loop.Run();
+
+  load.PrintResults();
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Replays an IGC file into the contest traces, and runs the
+ * time-budgeted contest optimisation
+ * (ContestManager::UpdateIdle(duration)) once per fix, like the
+ * calculation thread does in each idle slice.  At the end, the
+ * convergence statistics and the best result found are printed and
+ * compared with an exhaustive search.
+ */
+
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCFix.hpp"
+#include "IGC/IGCExtensions.hpp"
+#include "io/FileLineReader.hpp"
+#include "Engine/Trace/Trace.hpp"
+#include "Engine/Contest/ContestManager.hpp"
+#include "Engine/Contest/Solvers/Contests.hpp"
+#include "time/Stamp.hpp"
+#include "system/Args.hpp"
+#include "util/NumberParser.hpp"
+#include "util/PrintException.hxx"
+
+#include <algorithm>
+#include <memory>
+
+#include <stdio.h>
+
+using namespace std::chrono;
+
+using Clock = AbstractContest::Clock;
+
+static constexpr Contest contests[] = {
+  Contest::OLC_PLUS,
+  Contest::DMST,
+  Contest::XCONTEST,
+  Contest::WEGLIDE_FREE,
+};
+
+int main(int argc, char **argv)
+try {
+  Args args(argc, argv, "FILE.igc [BUDGET_MS]");
+  const auto path = args.ExpectNextPath();
+
+  Clock::duration budget = milliseconds(50);
+  if (!args.IsEmpty())
+    budget = duration_cast<Clock::duration>(duration<double, std::milli>{
+        ParseDouble(args.GetNext())});
+
+  args.ExpectEnd();
+
+  /* the same trace sizes as TraceComputer */
+  Trace full_trace({}, Trace::null_time, 1024);
+  Trace triangle_trace({}, Trace::null_time, 256);
+  Trace sprint_trace({}, minutes{120}, 128);
+
+  std::unique_ptr<ContestManager> managers[std::size(contests)];
+  Clock::duration max_slice[std::size(contests)]{};
+
+  for (std::size_t i = 0; i < std::size(contests); ++i) {
+    managers[i] = std::make_unique<ContestManager>(contests[i],
+                                                   full_trace,
+                                                   triangle_trace,
+                                                   sprint_trace,
+                                                   true);
+    managers[i]->SetIncremental(true);
+  }
+
+  FileLineReaderA reader(path);
+  IGCExtensions extensions;
+  extensions.clear();
+
+  unsigned n_fixes = 0;
+  char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    IGCFix fix;
+    if (!IGCParseFix(line, extensions, fix) || !fix.gps_valid)
+      continue;
+
+    const TimeStamp time{fix.time.DurationSinceMidnight()};
+    const TracePoint point(fix.location, time.Cast<duration<unsigned>>(),
+                           fix.gps_altitude, 0, 0);
+    full_trace.push_back(point);
+    triangle_trace.push_back(point);
+    sprint_trace.push_back(point);
+    ++n_fixes;
+
+    for (std::size_t i = 0; i < std::size(contests); ++i) {
+      const auto start = Clock::now();
+      managers[i]->UpdateIdle(budget);
+      max_slice[i] = std::max(max_slice[i], Clock::now() - start);
+    }
+  }
+
+  printf("%u fixes, budget %.1f ms per slice\n", n_fixes,
+         duration<double, std::milli>(budget).count());
+
+  for (std::size_t i = 0; i < std::size(contests); ++i) {
+    ContestManager &manager = *managers[i];
+    const ContestProgress progress = manager.GetStats().progress;
+    const double score = manager.GetStats().GetResult().score;
+
+    manager.SolveExhaustive();
+    const double exhaustive_score = manager.GetStats().GetResult().score;
+
+    printf("%s\n"
+           "  slices %u, steps %u, solver time %.1f ms, max slice %.1f ms\n"
+           "  improvements %u, last improvement in slice %u, converged %s\n"
+           "  score %.2f, exhaustive %.2f\n",
+           ContestToString(contests[i]),
+           progress.slices, progress.steps,
+           duration<double, std::milli>(progress.elapsed).count(),
+           duration<double, std::milli>(max_slice[i]).count(),
+           progress.improvements, progress.last_improvement,
+           progress.converged ? "yes" : "no",
+           score, exhaustive_score);
+  }
+
+  return EXIT_SUCCESS;
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -112,7 +112,7 @@ LoadFiles(PlacesOfInterestSettings &poi_settings,
   const auto paths = Profile::GetMultiplePaths(ProfileKeys::AirspaceFileList,
                                                AIRSPACE_FILE_PATTERNS);
   for (auto it = paths.begin(); it < paths.end(); it++) {
-    ParseAirspaceFile(airspace_database, *it, operation);
+    ParseAirspaceFile(airspace_database, *it, nullptr, operation);
   }
 
   airspace_database.Optimise();
@@ -1,28 +1,92 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 // Copyright The XCSoar Project
 
+/*
+ * Loads a waypoint file like XCSoar does at startup and prints all
+ * waypoints in alphabetic order.  The time each phase takes is
+ * printed to stderr.
+ */
+
 #include "Waypoint/WaypointReader.hpp"
+#include "Waypoint/WaypointReaderSeeYou.hpp"
+#include "Waypoint/WaypointFileType.hpp"
 #include "Waypoint/Factory.hpp"
 #include "Waypoint/Waypoints.hpp"
 #include "system/Args.hpp"
+#include "io/FileReader.hxx"
 #include "Operation/ConsoleOperationEnvironment.hpp"
+#include "thread/ParallelFor.hpp"
 #include "util/PrintException.hxx"
+#include "util/StringCompare.hxx"
+
+#include <chrono>
+#include <vector>
 
 #include <stdio.h>
+#include <stdlib.h>
+
+using namespace std::chrono;
+
+static double
+ToMilliseconds(steady_clock::duration d) noexcept
+{
+  return duration<double, std::milli>(d).count();
+}
+
 int main(int argc, char **argv)
 try {
-  Args args(argc, argv, "PATH\n");
+  Args args(argc, argv,
+            "[OPTIONS] PATH\n"
+            "Options:\n"
+            "  --threads=N   Parse CUP files with N threads (default: number of CPUs)");
+
+  unsigned n_threads = GetParallelThreadCount();
+
+  const char *arg;
+  while ((arg = args.PeekNext()) != nullptr && *arg == '-') {
+    args.Skip();
+
+    const char *value;
+    if ((value = StringAfterPrefix(arg, "--threads=")) != nullptr) {
+      n_threads = strtoul(value, nullptr, 10);
+      if (n_threads == 0)
+        args.UsageError();
+    } else {
+      args.UsageError();
+    }
+  }
+
   const auto path = args.ExpectNextPath();
   args.ExpectEnd();
 
   Waypoints way_points;
+  const WaypointFactory factory(WaypointOrigin::NONE);
 
-  ConsoleOperationEnvironment operation;
-  ReadWaypointFile(path, way_points,
-                   WaypointFactory(WaypointOrigin::NONE),
-                   operation);
+  const auto start = steady_clock::now();
 
+  if (DetermineWaypointFileType(path) == WaypointFileType::SEEYOU) {
+    /* like ReadWaypointFile(), but with the specified number of
+       threads */
+    FileReader file_reader{path};
+    std::vector<std::byte> data(file_reader.GetSize());
+    file_reader.ReadFull(data);
+    ParseSeeYou(factory, way_points, data, n_threads);
+  } else {
+    ConsoleOperationEnvironment operation;
+    ReadWaypointFile(path, way_points, factory, operation);
+  }
+
+  const auto optimise_start = steady_clock::now();
   way_points.Optimise();
+  const auto end = steady_clock::now();
+
+  fprintf(stderr, "parse: %.1f ms\n",
+          ToMilliseconds(optimise_start - start));
+  fprintf(stderr, "optimise: %.1f ms\n",
+          ToMilliseconds(end - optimise_start));
+  fprintf(stderr, "total: %.1f ms, %u waypoints, %u threads\n",
+          ToMilliseconds(end - start), way_points.size(), n_threads);
+
   printf("Size %d\n", way_points.size());
 
   way_points.VisitNamePrefix("", [](const auto &p){
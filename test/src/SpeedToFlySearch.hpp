@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#pragma once
+
+#include "GlideSolvers/GlidePolar.hpp"
+#include "Math/ZeroFinder.hpp"
+
+#include <algorithm>
+
+/**
+ * Searches the speed to fly numerically, for comparison with
+ * GlidePolar::SpeedToFly().
+ */
+class SpeedToFlySearch final : public ZeroFinder {
+  const GlidePolar &polar;
+  const double net_sink_rate;
+  const double head_wind;
+
+public:
+  SpeedToFlySearch(const GlidePolar &_polar, double _net_sink_rate,
+                   double _head_wind) noexcept
+    :ZeroFinder(std::max(1., _polar.GetVMin() - _head_wind),
+                _polar.GetVMax() - _head_wind, 0.0001),
+     polar(_polar), net_sink_rate(_net_sink_rate), head_wind(_head_wind) {}
+
+  /**
+   * @return the MacCready-adjusted inverse glide ratio over ground
+   * at the given airspeed
+   */
+  double GetInverseGlideRatio(double V) const noexcept {
+    return (polar.MSinkRate(V) + net_sink_rate) / (V - head_wind);
+  }
+
+  double f(double V) noexcept override {
+    return GetInverseGlideRatio(V + head_wind);
+  }
+
+  double Solve() noexcept {
+    return find_min(polar.GetVMax() - head_wind) + head_wind;
+  }
+};
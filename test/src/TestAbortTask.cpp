@@ -0,0 +1,236 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Verifies that the #AbortTask, which evaluates the landables nearest
+ * first and stops early, selects exactly the same alternates as
+ * evaluating and sorting all landables within range.
+ */
+
+#include "Engine/Task/Unordered/AbortTask.hpp"
+#include "Engine/Task/Unordered/AbortIntersectionTest.hpp"
+#include "Engine/Task/Unordered/UnorderedTaskPoint.hpp"
+#include "Engine/Task/Solvers/TaskSolution.hpp"
+#include "Engine/Task/TaskBehaviour.hpp"
+#include "Engine/GlideSolvers/GlidePolar.hpp"
+#include "Engine/Waypoint/Waypoints.hpp"
+#include "Engine/Navigation/Aircraft.hpp"
+#include "Geo/GeoVector.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+static constexpr unsigned N_WAYPOINTS = 5000;
+static constexpr unsigned N_SAMPLES = 50;
+static constexpr std::size_t MAX_ABORT = 10;
+
+static const GeoPoint center(Angle::Degrees(7.85), Angle::Degrees(51.4));
+
+/**
+ * Pretends that the terrain east of the center is too high.
+ */
+class EastIntersectionTest final : public AbortIntersectionTest {
+public:
+  bool Intersects(const AGeoPoint &destination) const noexcept override {
+    return destination.longitude > center.longitude;
+  }
+};
+
+/**
+ * Exposes AbortTask::UpdateSample().
+ */
+class TestingAbortTask final : public AbortTask {
+public:
+  using AbortTask::AbortTask;
+  using AbortTask::UpdateSample;
+};
+
+static void
+AddRandomWaypoints(Waypoints &waypoints, std::mt19937 &rng)
+{
+  std::uniform_real_distribution<double> bearing(0, 360);
+  std::uniform_real_distribution<double> distance(0, 150000);
+  std::uniform_real_distribution<double> elevation(-50, 800);
+  std::uniform_int_distribution<unsigned> type(0, 9);
+
+  for (unsigned i = 0; i < N_WAYPOINTS; ++i) {
+    Waypoint wp{GeoVector(distance(rng), Angle::Degrees(bearing(rng)))
+                .EndPoint(center)};
+    wp.original_id = i;
+    wp.elevation = elevation(rng);
+    wp.has_elevation = true;
+
+    const unsigned t = type(rng);
+    wp.type = t < 2
+      ? Waypoint::Type::AIRFIELD
+      : (t < 7 ? Waypoint::Type::OUTLANDING : Waypoint::Type::NORMAL);
+
+    waypoints.Append(std::move(wp));
+  }
+
+  waypoints.Optimise();
+}
+
+struct Candidate {
+  WaypointPtr waypoint;
+  GlideResult solution;
+};
+
+/**
+ * A copy of the old AbortTask::FillReachable() which evaluates all
+ * candidates and sorts them.
+ */
+static bool
+FillReachable(std::vector<unsigned> &result, const AircraftState &state,
+              std::vector<Candidate> &candidates,
+              const TaskBehaviour &task_behaviour, const GlidePolar &polar,
+              const AbortIntersectionTest *intersection_test,
+              bool only_airfield, bool final_glide) noexcept
+{
+  if (result.size() >= MAX_ABORT || candidates.empty())
+    return false;
+
+  bool found_final_glide = false;
+  std::vector<Candidate> q;
+
+  for (auto v = candidates.begin(); v != candidates.end();) {
+    if (only_airfield && !v->waypoint->IsAirport()) {
+      ++v;
+      continue;
+    }
+
+    UnorderedTaskPoint t(v->waypoint, task_behaviour);
+    GlideResult solution =
+      TaskSolution::GlideSolutionRemaining(t, state,
+                                           task_behaviour.glide, polar);
+
+    const bool is_reachable_final = solution.IsFinalGlide();
+    if (final_glide ? is_reachable_final : solution.IsAchievable()) {
+      const bool intersects = intersection_test != nullptr &&
+        final_glide && is_reachable_final &&
+        intersection_test->Intersects(AGeoPoint(v->waypoint->location,
+                                                solution.min_arrival_altitude));
+
+      if (!intersects) {
+        q.push_back({v->waypoint, solution});
+        v = candidates.erase(v);
+
+        if (is_reachable_final)
+          found_final_glide = true;
+
+        continue;
+      }
+    }
+
+    ++v;
+  }
+
+  if (final_glide) {
+    std::sort(q.begin(), q.end(), [](const auto &x, const auto &y){
+      return x.solution.altitude_difference > y.solution.altitude_difference;
+    });
+  } else {
+    std::sort(q.begin(), q.end(), [](const auto &x, const auto &y){
+      return x.solution.time_elapsed + x.solution.time_virtual <
+        y.solution.time_elapsed + y.solution.time_virtual;
+    });
+  }
+
+  const auto n = std::min(q.size(), MAX_ABORT - result.size());
+  for (std::size_t j = 0; j < n; ++j)
+    result.push_back(q[j].waypoint->id);
+
+  return found_final_glide;
+}
+
+static std::vector<unsigned>
+GetExpected(const Waypoints &waypoints, const AircraftState &state,
+            const TaskBehaviour &task_behaviour, const GlidePolar &polar,
+            const AbortIntersectionTest *intersection_test,
+            bool &reachable)
+{
+  std::vector<Candidate> candidates;
+  const double range = std::clamp(state.altitude * polar.GetBestLD(),
+                                  50000., 100000.);
+  waypoints.VisitWithinRange(state.location, range,
+                             [&candidates](const auto &wp){
+                               if (wp->IsLandable())
+                                 candidates.push_back({wp, {}});
+                             });
+
+  std::vector<unsigned> result;
+  reachable = FillReachable(result, state, candidates, task_behaviour, polar,
+                            intersection_test, true, true);
+  reachable |= FillReachable(result, state, candidates, task_behaviour, polar,
+                             intersection_test, false, true);
+  FillReachable(result, state, candidates, task_behaviour, polar,
+                intersection_test, false, false);
+  return result;
+}
+
+static std::vector<unsigned>
+GetAlternates(const TestingAbortTask &task)
+{
+  std::vector<unsigned> result;
+  for (unsigned i = 0; i < task.TaskSize(); ++i)
+    result.push_back(task.GetAlternate(i).GetWaypoint().id);
+  return result;
+}
+
+static void
+TestAbortTask(const Waypoints &waypoints, const TaskBehaviour &task_behaviour,
+              AbortIntersectionTest *intersection_test,
+              std::mt19937 &rng)
+{
+  std::uniform_real_distribution<double> offset(0, 100000);
+  std::uniform_real_distribution<double> bearing(0, 360);
+  std::uniform_real_distribution<double> altitude(100, 3500);
+  std::uniform_real_distribution<double> wind(0, 20);
+  std::uniform_int_distribution<unsigned> mc(0, 3);
+
+  TestingAbortTask task(task_behaviour, waypoints);
+  task.SetIntersectionTest(intersection_test);
+
+  for (unsigned i = 0; i < N_SAMPLES; ++i) {
+    AircraftState state;
+    state.Reset();
+    state.location = GeoVector(offset(rng), Angle::Degrees(bearing(rng)))
+      .EndPoint(center);
+    state.altitude = altitude(rng);
+    state.wind = SpeedVector(Angle::Degrees(bearing(rng)), wind(rng));
+
+    GlidePolar polar(mc(rng) * 0.75);
+    polar.SetCruiseEfficiency(mc(rng) == 0 ? 1.1 : 1.);
+
+    bool expected_reachable;
+    const auto expected = GetExpected(waypoints, state, task_behaviour, polar,
+                                      intersection_test, expected_reachable);
+
+    task.UpdateSample(state, polar, true);
+    ok1(GetAlternates(task) == expected);
+    ok1(task.HasReachableLandable() == expected_reachable);
+  }
+}
+
+int
+main()
+{
+  plan_tests(4 * N_SAMPLES);
+
+  std::mt19937 rng(42);
+
+  Waypoints waypoints;
+  AddRandomWaypoints(waypoints, rng);
+
+  TaskBehaviour task_behaviour;
+  task_behaviour.SetDefaults();
+
+  TestAbortTask(waypoints, task_behaviour, nullptr, rng);
+
+  EastIntersectionTest intersection_test;
+  TestAbortTask(waypoints, task_behaviour, &intersection_test, rng);
+
+  return exit_status();
+}
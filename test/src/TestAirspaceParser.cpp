@@ -1,6 +1,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 // Copyright The XCSoar Project
 
+#include "Airspace/AirspaceCache.hpp"
 #include "Airspace/AirspaceParser.hpp"
 #include "Engine/Airspace/AbstractAirspace.hpp"
 #include "Engine/Airspace/AirspaceCircle.hpp"
@@ -10,10 +11,16 @@
 #include "util/Macros.hpp"
 #include "util/StringAPI.hxx"
 #include "util/PrintException.hxx"
+#include "io/BufferedOutputStream.hxx"
 #include "io/FileLineReader.hpp"
+#include "io/StringOutputStream.hxx"
 #include "Operation/Operation.hpp"
+#include "thread/ParallelFor.hpp"
 #include "TestUtil.hpp"
 
+#include <algorithm>
+#include <vector>
+
 struct AirspaceClassTestCouple
 {
   const char* name;
@@ -21,13 +28,14 @@ struct AirspaceClassTestCouple
 };
 
 static bool
-ParseFile(Path path, Airspaces &airspaces)
+ParseFile(Path path, Airspaces &airspaces,
+          unsigned n_threads=GetParallelThreadCount())
 {
   FileReader file_reader{path};
   BufferedReader buffered_reader{file_reader};
 
   try {
-    ParseAirspaceFile(airspaces, buffered_reader);
+    ParseAirspaceFile(airspaces, buffered_reader, n_threads);
     ok1(true);
   } catch (...) {
     ok1(false);
@@ -286,13 +294,138 @@ TestOpenAirExtended()
   }
 }
 
+[[gnu::pure]]
+static bool
+Equals(const AirspaceAltitude &a, const AirspaceAltitude &b) noexcept
+{
+  if (a.reference != b.reference || a.altitude != b.altitude)
+    return false;
+
+  switch (a.reference) {
+  case AltitudeReference::AGL:
+    return a.altitude_above_terrain == b.altitude_above_terrain;
+
+  case AltitudeReference::STD:
+    return a.flight_level == b.flight_level;
+
+  default:
+    return true;
+  }
+}
+
+[[gnu::pure]]
+static bool
+Equals(TransponderCode a, TransponderCode b) noexcept
+{
+  if (!a.IsDefined() || !b.IsDefined())
+    return a.IsDefined() == b.IsDefined();
+
+  return a.GetCode() == b.GetCode();
+}
+
+[[gnu::pure]]
+static bool
+Equals(const AbstractAirspace &a, const AbstractAirspace &b) noexcept
+{
+  const auto &a_points = a.GetPoints(), &b_points = b.GetPoints();
+
+  return StringIsEqual(a.GetName(), b.GetName()) &&
+    StringIsEqual(a.GetStationName(), b.GetStationName()) &&
+    a.GetRadioFrequency() == b.GetRadioFrequency() &&
+    Equals(a.GetTransponderCode(), b.GetTransponderCode()) &&
+    a.GetDays().equals(b.GetDays()) &&
+    a.GetShape() == b.GetShape() &&
+    a.GetClass() == b.GetClass() && a.GetType() == b.GetType() &&
+    Equals(a.GetBase(), b.GetBase()) && Equals(a.GetTop(), b.GetTop()) &&
+    std::equal(a_points.begin(), a_points.end(),
+               b_points.begin(), b_points.end(),
+               [](const SearchPoint &x, const SearchPoint &y){
+                 return x.GetLocation() == y.GetLocation();
+               });
+}
+
+/**
+ * Parse a large file sequentially and in parallel, and verify that
+ * the results are identical.
+ */
+static void
+TestParallel()
+{
+  const Path path("test/data/AirspaceAus-DAA.txt");
+
+  Airspaces sequential, parallel;
+  if (!ParseFile(path, sequential, 1) || !ParseFile(path, parallel, 4)) {
+    skip(1, 0, "Failed to parse input file");
+    return;
+  }
+
+  const auto a = sequential.QueryAll(), b = parallel.QueryAll();
+  ok1(sequential.GetSize() > 600 &&
+      std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                 [](const Airspace &x, const Airspace &y){
+                   return Equals(x.GetAirspace(), y.GetAirspace());
+                 }));
+}
+
+/**
+ * Write the airspaces of a file to a cache and load them back.
+ */
+static void
+TestCache(Path path)
+{
+  std::vector<AirspacePtr> parsed;
+
+  try {
+    FileReader file_reader{path};
+    BufferedReader buffered_reader{file_reader};
+    ParseAirspaceFile(parsed, buffered_reader, 1);
+  } catch (...) {
+    skip(4, 0, "Failed to parse input file");
+    return;
+  }
+
+  const uint64_t source_hash = HashAirspaceFile(path);
+
+  StringOutputStream sos;
+  BufferedOutputStream bos{sos};
+  WriteAirspaceCache(bos, source_hash, parsed);
+  bos.Flush();
+
+  const auto cache = std::as_bytes(std::span{sos.GetValue()});
+
+  std::vector<AirspacePtr> loaded;
+  ok1(ReadAirspaceCache(cache, source_hash, loaded));
+  ok1(!parsed.empty() &&
+      std::equal(parsed.begin(), parsed.end(),
+                 loaded.begin(), loaded.end(),
+                 [](const AirspacePtr &x, const AirspacePtr &y){
+                   return Equals(*x, *y);
+                 }));
+
+  /* a cache of a different file is rejected */
+  loaded.clear();
+  ok1(!ReadAirspaceCache(cache, source_hash + 1, loaded) && loaded.empty());
+
+  /* a truncated cache is an error */
+  try {
+    ReadAirspaceCache(cache.first(cache.size() - 1), source_hash, loaded);
+    ok1(false);
+  } catch (const std::runtime_error &) {
+    ok1(true);
+  }
+}
+
 int main()
 try {
-  plan_tests(113);
+  plan_tests(128);
 
   TestOpenAir();
   TestTNP();
   TestOpenAirExtended();
+  TestParallel();
+  TestCache(Path("test/data/airspace/openair.txt"));
+  TestCache(Path("test/data/airspace/tnp.sua"));
+  TestCache(Path("test/data/AirspaceAus-DAA.txt"));
 
   return exit_status();
 } catch (const std::runtime_error &e) {
@@ -0,0 +1,246 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Replays IGC files into a #ListTrace and a #FlatTrace with various
+ * settings and verifies that both keep exactly the same points after
+ * each fix.
+ */
+
+#include "Engine/Trace/ListTrace.hpp"
+#include "Engine/Trace/FlatTrace.hpp"
+#include "Engine/Trace/Vector.hpp"
+#include "IGC/IGCParser.hpp"
+#include "IGC/IGCFix.hpp"
+#include "IGC/IGCExtensions.hpp"
+#include "io/FileLineReader.hpp"
+#include "system/Path.hpp"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <vector>
+
+using namespace std::chrono;
+
+static constexpr const char *igc_files[] = {
+  "test/data/01lz1hq1.igc",
+  "test/data/0asljd01.igc",
+  "test/data/9crx3101.igc",
+  "test/data/apf-bug554.igc",
+};
+
+struct TraceSettings {
+  duration<unsigned> no_thin_time;
+  duration<unsigned> max_time;
+  unsigned max_size;
+};
+
+static constexpr TraceSettings trace_settings[] = {
+  /* TraceComputer and the contest traces */
+  { minutes{2}, ListTrace::null_time, 1024 },
+  { {}, ListTrace::null_time, 1024 },
+  { {}, ListTrace::null_time, 256 },
+  { {}, minutes{120}, 128 },
+  /* small traces which get thinned very often */
+  { seconds{1000}, ListTrace::null_time, 16 },
+  { {}, minutes{10}, 4 },
+};
+
+[[gnu::pure]]
+static bool
+Equals(const TracePoint &a, const TracePoint &b) noexcept
+{
+  return a.GetTime() == b.GetTime() &&
+    a.GetLocation() == b.GetLocation() &&
+    a.GetFlatLocation() == b.GetFlatLocation() &&
+    a.GetAltitude() == b.GetAltitude() &&
+    a.GetVario() == b.GetVario();
+}
+
+/**
+ * Remembers the serials of a trace to check whether the other
+ * implementation modifies its serials at the same time.
+ */
+class SerialTracker {
+  Serial append, modify;
+
+public:
+  template<typename T>
+  unsigned Update(const T &trace) noexcept {
+    unsigned result = 0;
+    if (trace.GetAppendSerial() != append) {
+      append = trace.GetAppendSerial();
+      result |= 1;
+    }
+
+    if (trace.GetModifySerial() != modify) {
+      modify = trace.GetModifySerial();
+      result |= 2;
+    }
+
+    return result;
+  }
+};
+
+static bool
+Equals(const ListTrace &a, const FlatTrace &b) noexcept
+{
+  if (a.size() != b.size() ||
+      a.GetAverageDeltaDistance() != b.GetAverageDeltaDistance() ||
+      a.GetAverageDeltaTime() != b.GetAverageDeltaTime())
+    return false;
+
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                    [](const TracePoint &x, const TracePoint &y){
+                      return Equals(x, y);
+                    });
+}
+
+class TracePair {
+  ListTrace list;
+  FlatTrace flat;
+
+  SerialTracker list_serials, flat_serials;
+
+  unsigned n_thinned = 0;
+
+public:
+  explicit TracePair(const TraceSettings &settings) noexcept
+    :list(settings.no_thin_time, settings.max_time, settings.max_size),
+     flat(settings.no_thin_time, settings.max_time, settings.max_size) {}
+
+  unsigned GetThinnedCount() const noexcept {
+    return n_thinned;
+  }
+
+  /**
+   * @return false if the two implementations differ
+   */
+  bool Append(const TracePoint &point) noexcept {
+    const unsigned old_size = list.size();
+
+    list.push_back(point);
+    flat.push_back(point);
+
+    if (list.size() < old_size)
+      ++n_thinned;
+
+    const unsigned changed = list_serials.Update(list);
+    if (changed != flat_serials.Update(flat))
+      return false;
+
+    /* appending modifies only the end of the trace; compare all
+       points only after the trace was thinned or pruned */
+    if (changed & 2)
+      return Equals(list, flat);
+
+    return list.size() == flat.size() &&
+      (list.empty() || Equals(list.back(), flat.back()));
+  }
+
+  bool CheckAll() const noexcept {
+    return Equals(list, flat);
+  }
+
+  bool CheckFiltered(const GeoPoint &location) const noexcept {
+    TracePointVector a, b;
+    list.GetPoints(a, duration<unsigned>{}, location, 100);
+    flat.GetPoints(b, duration<unsigned>{}, location, 100);
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                      [](const TracePoint &x, const TracePoint &y){
+                        return Equals(x, y);
+                      });
+  }
+};
+
+static std::vector<TracePoint>
+LoadFlight(const char *path)
+{
+  FileLineReaderA reader{Path{path}};
+
+  IGCExtensions extensions;
+  extensions.clear();
+
+  std::vector<TracePoint> fixes;
+
+  char *line;
+  while ((line = reader.ReadLine()) != nullptr) {
+    IGCFix fix;
+    if (!IGCParseFix(line, extensions, fix) || !fix.gps_valid)
+      continue;
+
+    const auto time = fix.time.DurationSinceMidnight();
+    fixes.emplace_back(fix.location,
+                       duration_cast<duration<unsigned>>(time),
+                       fix.gps_altitude, 0, 0);
+  }
+
+  return fixes;
+}
+
+static void
+TestReplay(const char *path, const std::vector<TracePoint> &fixes,
+           const TraceSettings &settings)
+{
+  TracePair pair(settings);
+
+  bool equal = true;
+  for (const auto &fix : fixes) {
+    if (!pair.Append(fix)) {
+      equal = false;
+      break;
+    }
+  }
+
+  ok(equal && pair.CheckAll() &&
+     pair.CheckFiltered(fixes.back().GetLocation()),
+     "%s max_size=%u: identical", path, settings.max_size);
+}
+
+/**
+ * Feed fixes which jump back in time, which exercises
+ * EraseLaterThan() and clear().
+ */
+static void
+TestTimeWarp(const std::vector<TracePoint> &fixes)
+{
+  TracePair pair(TraceSettings{{}, ListTrace::null_time, 16});
+
+  bool equal = true;
+  for (std::size_t i = 0; i < fixes.size() && equal; ++i) {
+    equal = pair.Append(fixes[i]);
+
+    if (i % 200 == 100 && i >= 20)
+      /* a small time warp: this removes the last few points */
+      equal = equal && pair.Append(fixes[i - 5]);
+    else if (i % 1000 == 999)
+      /* a large time warp: this clears the trace */
+      equal = equal && pair.Append(fixes[i / 2]);
+  }
+
+  ok(equal && pair.CheckAll(), "time warps: identical");
+}
+
+int main()
+{
+  plan_tests(std::size(igc_files) * (std::size(trace_settings) + 1) + 2);
+
+  for (const char *path : igc_files) {
+    const auto fixes = LoadFlight(path);
+    ok(!fixes.empty(), "%s: %zu fixes", path, fixes.size());
+
+    for (const auto &settings : trace_settings)
+      TestReplay(path, fixes, settings);
+  }
+
+  /* make sure that the settings above do thin the trace */
+  const auto fixes = LoadFlight(igc_files[0]);
+  TracePair pair(trace_settings[4]);
+  for (const auto &fix : fixes)
+    pair.Append(fix);
+  ok1(pair.GetThinnedCount() > 0);
+
+  TestTimeWarp(fixes);
+
+  return exit_status();
+}
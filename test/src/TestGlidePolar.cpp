@@ -2,10 +2,11 @@
 // Copyright The XCSoar Project
 
 #include "TestUtil.hpp"
+#include "SpeedToFlySearch.hpp"
 #include "GlideSolvers/GlidePolar.hpp"
 #include "Units/System.hpp"
 
-#include <cstdio>
+#include <array>
 
 class GlidePolarTest
 {
@@ -20,6 +21,7 @@ private:
   void TestBallast();
   void TestBugs();
   void TestMC();
+  void TestSpeedToFly();
 };
 
 void
@@ -145,6 +147,43 @@ GlidePolarTest::TestMC()
   ok1(equals(polar.GetVBestLD(), 25.830434162));
 }
 
+void
+GlidePolarTest::TestSpeedToFly()
+{
+  static constexpr std::array net_sink_rates{-4., -1.5, 0., 0.7, 3.};
+
+  std::array<double, 41> head_winds;
+  for (unsigned i = 0; i < head_winds.size(); ++i)
+    head_winds[i] = -20. + i;
+
+  for (const double mc : {0., 1., 3.}) {
+    polar.SetMC(mc);
+
+    for (const double net_sink_rate : net_sink_rates) {
+      bool optimal = true, within_tolerance = true;
+      for (const double head_wind : head_winds) {
+        const double v = polar.SpeedToFly(net_sink_rate, head_wind);
+
+        SpeedToFlySearch search(polar, net_sink_rate, head_wind);
+        const double v_search = search.Solve();
+
+        /* the numeric search is not exact, but it can't be better */
+        if (search.GetInverseGlideRatio(v) >
+            search.GetInverseGlideRatio(v_search) + 1e-9)
+          optimal = false;
+
+        if (fabs(v - v_search) > 0.01)
+          within_tolerance = false;
+      }
+
+      ok1(optimal);
+      ok1(within_tolerance);
+    }
+  }
+
+  polar.SetMC(0);
+}
+
 void
 GlidePolarTest::Run()
 {
@@ -153,11 +192,12 @@ GlidePolarTest::Run()
   TestBallast();
   TestBugs();
   TestMC();
+  TestSpeedToFly();
 }
 
 int main()
 {
-  plan_tests(46);
+  plan_tests(46 + 3 * 5 * 2);
 
   GlidePolarTest test;
   test.Run();
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+#include "time/LatencyHistogram.hpp"
+#include "TestUtil.hpp"
+
+using namespace std::chrono;
+
+static void
+TestEmpty()
+{
+  LatencyHistogram h;
+  h.Clear();
+
+  ok1(h.empty());
+  ok1(h.GetCount() == 0);
+  ok1(h.GetMean() == microseconds{});
+  ok1(h.GetMax() == microseconds{});
+  ok1(h.GetQuantile(0.5) == microseconds{});
+}
+
+static void
+TestBuckets()
+{
+  LatencyHistogram h;
+  h.Clear();
+
+  h.Add(microseconds{0});
+  h.Add(microseconds{-5});
+  h.Add(microseconds{1});
+  h.Add(microseconds{3});
+  h.Add(microseconds{1000});
+  h.Add(hours{1});
+
+  ok1(h.GetCount() == 6);
+  ok1(h.GetBucket(0) == 2);
+  ok1(h.GetBucket(1) == 1);
+  ok1(h.GetBucket(2) == 1);
+  ok1(h.GetBucket(10) == 1);
+  ok1(h.GetBucket(LatencyHistogram::N_BUCKETS - 1) == 1);
+  ok1(h.GetMax() == hours{1});
+
+  /* sub-microsecond durations are truncated */
+  h.Add(nanoseconds{999});
+  ok1(h.GetBucket(0) == 3);
+}
+
+static void
+TestStatistics()
+{
+  LatencyHistogram h;
+  h.Clear();
+
+  for (unsigned i = 0; i < 99; ++i)
+    h.Add(microseconds{100});
+  h.Add(microseconds{50000});
+
+  ok1(h.GetCount() == 100);
+  ok1(h.GetMean() == microseconds{(99 * 100 + 50000) / 100});
+  ok1(h.GetMax() == microseconds{50000});
+
+  /* the quantiles are rounded up to the bucket limit */
+  ok1(h.GetQuantile(0.5) == microseconds{128});
+  ok1(h.GetQuantile(0.99) == microseconds{128});
+  ok1(h.GetQuantile(1) == microseconds{50000});
+
+  h.Clear();
+  ok1(h.empty());
+  ok1(h.GetBucket(7) == 0);
+}
+
+int main()
+{
+  plan_tests(21);
+
+  TestEmpty();
+  TestBuckets();
+  TestStatistics();
+
+  return exit_status();
+}
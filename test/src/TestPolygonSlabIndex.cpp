@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Verifies that the #PolygonSlabIndex of large airspace polygons
+ * gives exactly the same answers as scanning all border edges, for
+ * the polygons in the test airspace files.
+ */
+
+#include "Airspace/AirspaceParser.hpp"
+#include "Engine/Airspace/AbstractAirspace.hpp"
+#include "Engine/Airspace/AirspacePolygon.hpp"
+#include "Engine/Airspace/AirspaceIntersectionVector.hpp"
+#include "Engine/Airspace/Airspaces.hpp"
+#include "Geo/GeoBounds.hpp"
+#include "Geo/GeoVector.hpp"
+#include "Geo/Flat/FlatBoundingBox.hpp"
+#include "Geo/PolygonSlabIndex.hpp"
+#include "io/FileReader.hxx"
+#include "io/BufferedReader.hxx"
+#include "system/Path.hpp"
+#include "util/PrintException.hxx"
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+static constexpr const char *airspace_files[] = {
+  "test/data/airspace/openair.txt",
+  "test/data/airspace/openair_2.txt",
+  "test/data/AirspaceAus-DAA.txt",
+};
+
+/**
+ * The number of random points and lines tested per polygon.
+ */
+static constexpr unsigned N_SAMPLES = 500;
+
+/**
+ * The maximum length of the random lines [m].  This is much longer
+ * than the vectors used for airspace warnings.
+ */
+static constexpr double MAX_LINE_LENGTH = 50000;
+
+/**
+ * Intersections are compared only for polygons whose flat extent is
+ * below this value; beyond that, the cross products in
+ * FlatRay::IntersectsRatio() may overflow, which makes the linear
+ * scan report bogus intersections with distant edges.
+ */
+static constexpr unsigned MAX_FLAT_EXTENT = 25000;
+
+static bool
+Equals(const AirspaceIntersectionVector &a,
+       const AirspaceIntersectionVector &b) noexcept
+{
+  return a.size() == b.size() &&
+    std::equal(a.begin(), a.end(), b.begin(), [](const auto &x, const auto &y){
+      return x.first == y.first && x.second == y.second;
+    });
+}
+
+/**
+ * A random point within the bounds of the polygon (plus a margin,
+ * to test points outside of the polygon, too).
+ */
+static GeoPoint
+RandomPoint(std::mt19937 &rng, const GeoBounds &bounds) noexcept
+{
+  const Angle width = bounds.GetWidth(), height = bounds.GetHeight();
+
+  std::uniform_real_distribution<double> d(-0.1, 1.1);
+  return GeoPoint(bounds.GetWest() + width * d(rng),
+                  bounds.GetSouth() + height * d(rng));
+}
+
+/**
+ * @return the number of mismatches
+ */
+static unsigned
+TestPolygon(std::mt19937 &rng, const AirspacePolygon &polygon,
+            const FlatProjection &projection) noexcept
+{
+  const SearchPointVector &border = polygon.GetPoints();
+  const GeoBounds bounds = border.CalculateGeoBounds();
+  const FlatBoundingBox flat_bounds = border.CalculateBoundingbox();
+  const bool check_intersects =
+    std::max(flat_bounds.GetWidth(), flat_bounds.GetHeight()) <= MAX_FLAT_EXTENT;
+
+  /* the reference: all border edges */
+  std::vector<unsigned> all_edges(border.size() - 1);
+  std::iota(all_edges.begin(), all_edges.end(), 0);
+
+  std::uniform_real_distribution<double> fraction(0, 1);
+
+  unsigned mismatches = 0;
+
+  /* the vertices and the edge midpoints are the difficult cases */
+  for (std::size_t i = 0; i + 1 < border.size(); ++i) {
+    const GeoPoint &a = border[i].GetLocation();
+    const GeoPoint &b = border[i + 1].GetLocation();
+    const GeoPoint middle = a.Middle(b);
+
+    if (polygon.Inside(a) != border.IsInside(a) ||
+        polygon.Inside(middle) != border.IsInside(middle))
+      ++mismatches;
+  }
+
+  for (unsigned i = 0; i < N_SAMPLES; ++i) {
+    const GeoPoint a = RandomPoint(rng, bounds);
+    const GeoPoint b = GeoVector(MAX_LINE_LENGTH * fraction(rng),
+                                 Angle::FullCircle() * fraction(rng))
+      .EndPoint(a);
+
+    if (polygon.Inside(a) != border.IsInside(a) ||
+        (check_intersects &&
+         !Equals(polygon.Intersects(a, b, projection),
+                 polygon.Intersects(a, b, projection, all_edges))))
+      ++mismatches;
+  }
+
+  return mismatches;
+}
+
+static void
+TestFile(const char *path)
+{
+  Airspaces airspaces;
+
+  {
+    FileReader file_reader{Path{path}};
+    BufferedReader buffered_reader{file_reader};
+    ParseAirspaceFile(airspaces, buffered_reader);
+  }
+
+  airspaces.Optimise();
+
+  std::mt19937 rng;
+  unsigned n_polygons = 0, mismatches = 0;
+
+  for (const auto &i : airspaces.QueryAll()) {
+    const AbstractAirspace &airspace = i.GetAirspace();
+    if (airspace.GetShape() != AbstractAirspace::Shape::POLYGON ||
+        airspace.GetPoints().size() < PolygonSlabIndex::MIN_POINTS)
+      continue;
+
+    ++n_polygons;
+    mismatches += TestPolygon(rng,
+                              static_cast<const AirspacePolygon &>(airspace),
+                              airspaces.GetProjection());
+  }
+
+  ok(n_polygons > 0 && mismatches == 0,
+     "%s: %u large polygons, %u mismatches", path, n_polygons, mismatches);
+}
+
+int main()
+try {
+  plan_tests(std::size(airspace_files));
+
+  for (const char *path : airspace_files)
+    TestFile(path);
+
+  return exit_status();
+} catch (...) {
+  PrintException(std::current_exception());
+  return EXIT_FAILURE;
+}
@@ -9,6 +9,10 @@
 #include "util/StringAPI.hxx"
 #include "TestUtil.hpp"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 struct Sum {
   int value;
 
@@ -53,9 +57,105 @@ check_ascending_keys(const RadixTree<T> &tree)
   tree.VisitAllPairs(visitor);
 }
 
+static std::vector<std::pair<std::string, int>>
+all_pairs(const RadixTree<int> &tree)
+{
+  std::vector<std::pair<std::string, int>> pairs;
+  const auto visitor = [&pairs](const char *key, int value){
+    pairs.emplace_back(key, value);
+  };
+  tree.VisitAllPairs(visitor);
+  return pairs;
+}
+
+/**
+ * Check that RadixTree::AddAll() builds the same tree as Add(),
+ * including the order of values with the same key.
+ */
+static void
+TestAddAll()
+{
+  static constexpr std::pair<const char *, int> existing[] = {
+    {"foo", 1}, {"foobarbazquux", 2}, {"bar", 3}, {"foo", 4},
+  };
+
+  static constexpr std::pair<const char *, int> items[] = {
+    {"foo", 10}, {"", 11}, {"foobarbazqu", 12}, {"foobarbazquuy", 13},
+    {"fo", 14}, {"bar", 15}, {"a", 16}, {"foo", 17},
+    {"verylongkeywhichneedsseveralnodes", 18}, {"baz", 19},
+  };
+
+  RadixTree<int> expected, actual;
+  for (const auto &[key, value] : existing) {
+    expected.Add(key, value);
+    actual.Add(key, value);
+  }
+
+  for (const auto &[key, value] : items)
+    expected.Add(key, value);
+  actual.AddAll(items);
+
+  ok1(all_pairs(actual) == all_pairs(expected));
+  check_ascending_keys(actual);
+
+  char buffer[64];
+  ok1(StringIsEqual(actual.Suggest("foobarbaz", buffer, 64), "q"));
+  ok1(StringIsEqual(actual.Suggest("foobarbazqu", buffer, 64), "u"));
+  ok1(actual.Get("verylongkeywhichneedsseveralnodes", 0) == 18);
+  ok1(actual.Get("verylongkey", 0) == 0);
+  ok1(actual.Get("foo", 0) == 17);
+
+  RadixTree<int> empty;
+  empty.AddAll(items);
+  RadixTree<int> incremental;
+  for (const auto &[key, value] : items)
+    incremental.Add(key, value);
+  ok1(all_pairs(empty) == all_pairs(incremental));
+}
+
+/**
+ * Like TestAddAll(), but with enough keys to use the radix sort, and
+ * with many keys sharing long prefixes, which are sorted by their
+ * next characters recursively.
+ */
+static void
+TestAddAllMany()
+{
+  /* groups of more than 64 keys which are equal in their first 7
+     or 14 characters; the numbers are shuffled, and 50 keys appear
+     twice */
+  static constexpr const char *prefixes[] = {
+    "Flugplatz", "Flugplatz Nord", "Flugplatz Nordost", "Flugpl",
+    "Segelfluggelaende", "S", "",
+  };
+
+  std::vector<std::string> keys;
+  for (unsigned i = 0; i < 400; ++i) {
+    const unsigned n = (i * 37) % 50;
+    keys.emplace_back(std::string(prefixes[i % std::size(prefixes)]) +
+                      std::to_string(n));
+  }
+
+  std::vector<std::pair<const char *, int>> items;
+  items.reserve(keys.size());
+  for (unsigned i = 0; i < keys.size(); ++i)
+    items.emplace_back(keys[i].c_str(), int(i));
+
+  RadixTree<int> expected, actual;
+  expected.Add("Flugplatz Nord1", -1);
+  actual.Add("Flugplatz Nord1", -1);
+
+  for (const auto &[key, value] : items)
+    expected.Add(key, value);
+  actual.AddAll(items);
+
+  ok1(all_pairs(actual) == all_pairs(expected));
+  ok1(all_pairs(actual).size() == items.size() + 1);
+}
+
 int main()
 {
-  plan_tests(86);
+  plan_tests(109);
 
   char buffer[64], *suggest;
 
@@ -190,5 +290,8 @@ int main()
 
   check_ascending_keys(irt);
 
+  TestAddAll();
+  TestAddAllMany();
+
   return exit_status();
 }
@@ -0,0 +1,189 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// Copyright The XCSoar Project
+
+/*
+ * Verifies that the SIMD terrain rendering kernels which are enabled
+ * in this build yield exactly the same pixels as the
+ * #PortableShadingKernel, with random heights, special values and
+ * shading parameters.
+ */
+
+#include "Terrain/ShadingKernel.hpp"
+
+#if defined(__AVX2__)
+#include "Terrain/ShadingAVX2.hpp"
+#endif
+#if defined(__SSE2__)
+#include "Terrain/ShadingSSE2.hpp"
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include "Terrain/ShadingNEON.hpp"
+#endif
+
+#include "TestUtil.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+static constexpr unsigned row_lengths[] = {
+  1, 7, 8, 9, 15, 16, 17, 31, 100, 1000,
+};
+
+static constexpr unsigned N_SHADINGS = 5;
+
+static constexpr unsigned N_KERNELS = 0
+#if defined(__AVX2__)
+  + 1
+#endif
+#if defined(__SSE2__)
+  + 1
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+  + 1
+#endif
+  ;
+
+/**
+ * Generate a row of random heights: mostly hilly terrain, with a few
+ * cliffs (to exercise ClipHeightDelta() and the saturating
+ * arithmetic), water and invalid values.
+ */
+static std::vector<TerrainHeight>
+MakeRow(std::mt19937 &rng, std::size_t n)
+{
+  std::uniform_int_distribution<int> kind(0, 99);
+  std::uniform_int_distribution<int> slope(-60, 60);
+  std::uniform_int_distribution<int> any(TerrainHeight::MAX_SPECIAL + 1,
+                                         INT16_MAX);
+  std::uniform_int_distribution<int> water(INT16_MIN + 1,
+                                           TerrainHeight::MAX_SPECIAL);
+
+  std::vector<TerrainHeight> row;
+  row.reserve(n);
+
+  int h = std::uniform_int_distribution<int>(-100, 3000)(rng);
+  for (std::size_t i = 0; i < n; ++i) {
+    const int k = kind(rng);
+    if (k < 2)
+      row.push_back(TerrainHeight::Invalid());
+    else if (k < 5)
+      row.push_back(TerrainHeight(water(rng)));
+    else if (k < 8)
+      row.push_back(TerrainHeight(any(rng)));
+    else {
+      h = std::clamp(h + slope(rng), -500, 8000);
+      row.push_back(TerrainHeight(h));
+    }
+  }
+
+  return row;
+}
+
+/**
+ * Random parameters, calculated like TerrainShader::GenerateImage()
+ * does.
+ */
+static ShadingParameters
+MakeShading(std::mt19937 &rng, unsigned step)
+{
+  std::uniform_real_distribution<double> azimuth(0, 2 * M_PI);
+  std::uniform_int_distribution<int> brightness(0, 255);
+  std::uniform_int_distribution<int> contrast(0, 255);
+  std::uniform_int_distribution<unsigned> factor(1, 8192 / (step * step));
+
+  const double elevation = (10 + 80. / 255. * brightness(rng)) * M_PI / 180;
+  const double a = azimuth(rng);
+
+  return {
+    (int)(255 * cos(elevation) * -sin(a)),
+    (int)(255 * cos(elevation) * -cos(a)),
+    (int)(255 * sin(elevation)),
+    contrast(rng),
+    factor(rng),
+  };
+}
+
+template<typename Kernel>
+static void
+TestIndex(std::mt19937 &rng, unsigned n)
+{
+  const auto src = MakeRow(rng, n);
+  const unsigned height_scale = std::uniform_int_distribution<unsigned>(0, 6)(rng);
+  const unsigned contour_height_scale = height_scale + 1;
+
+  std::vector<uint8_t> index(n), contour(n), expected_index(n),
+    expected_contour(n);
+
+  Kernel::Index(src.data(), n, height_scale, contour_height_scale,
+                index.data(), contour.data());
+  PortableShadingKernel::Index(src.data(), n, height_scale,
+                               contour_height_scale,
+                               expected_index.data(), expected_contour.data());
+
+  ok(index == expected_index && contour == expected_contour,
+     "%s Index() n=%u", Kernel::NAME, n);
+}
+
+template<typename Kernel>
+static void
+TestShade(std::mt19937 &rng, unsigned n)
+{
+  const unsigned step = std::uniform_int_distribution<unsigned>(1, 4)(rng);
+  const unsigned p31 = std::uniform_int_distribution<unsigned>(1, 2 * step)(rng);
+  const auto shading = MakeShading(rng, step);
+
+  /* the row has "step" extra pixels on each side for the left and
+     right neighbours */
+  const auto above = MakeRow(rng, n);
+  const auto row = MakeRow(rng, n + 2 * step);
+  const auto below = MakeRow(rng, n);
+
+  std::vector<int8_t> illumination(n), expected(n);
+
+  Kernel::Shade(shading, above.data(), row.data() + step, below.data(),
+                step, p31, n, illumination.data());
+  PortableShadingKernel::Shade(shading, above.data(), row.data() + step,
+                               below.data(), step, p31, n, expected.data());
+
+  ok(illumination == expected,
+     "%s Shade() n=%u step=%u", Kernel::NAME, n, step);
+}
+
+template<typename Kernel>
+static void
+TestKernel(std::mt19937 &rng)
+{
+  for (const unsigned n : row_lengths) {
+    TestIndex<Kernel>(rng, n);
+
+    for (unsigned i = 0; i < N_SHADINGS; ++i)
+      TestShade<Kernel>(rng, n);
+  }
+}
+
+int
+main()
+{
+  if constexpr (N_KERNELS == 0) {
+    plan_skip_all(const_cast<char *>("no SIMD kernel in this build"));
+    return exit_status();
+  }
+
+  plan_tests(N_KERNELS * std::size(row_lengths) * (1 + N_SHADINGS));
+
+  std::mt19937 rng(42);
+
+#if defined(__AVX2__)
+  TestKernel<AVX2ShadingKernel>(rng);
+#endif
+#if defined(__SSE2__)
+  TestKernel<SSE2ShadingKernel>(rng);
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+  TestKernel<NEONShadingKernel>(rng);
+#endif
+
+  return exit_status();
+}
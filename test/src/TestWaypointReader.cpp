@@ -19,6 +19,7 @@
 #include "util/StringStrip.hxx"
 #include "Operation/Operation.hpp"
 
+#include <cstdio>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -372,6 +373,67 @@ TestCupRoundTrip(const wp_vector &org_wp)
   }
 }
 
+/**
+ * Generate a CUP file which is large enough to be split into
+ * several chunks.
+ *
+ * @param multi_line give each waypoint a description with a
+ * newline, so the chunks begin in the middle of records
+ */
+static std::string
+MakeLargeCup(unsigned n, bool multi_line)
+{
+  std::string s = "name,code,country,lat,lon,elev,style,rwdir,rwlen,freq,desc\n";
+
+  char buffer[256];
+  for (unsigned i = 0; i < n; ++i) {
+    snprintf(buffer, sizeof(buffer),
+             "\"Waypoint %u\",\"W%u\",DE,%02u%02u.%03uN,007%02u.%03uE,%uM,1,,,,"
+             "\"Description %u%s\"\n",
+             i, i, 45 + i % 10, (i / 10) % 60, i % 1000,
+             (i / 7) % 60, (i * 7) % 1000, i % 3000,
+             i, multi_line ? ",\nwith a \"\"second\"\" line" : "");
+    s += buffer;
+  }
+
+  s += "-----Related Tasks-----\n";
+  return s;
+}
+
+static void
+TestCupParallel(bool multi_line)
+{
+  const auto s = MakeLargeCup(5000, multi_line);
+  const auto bytes = std::as_bytes(std::span{s.data(), s.size()});
+
+  Waypoints expected;
+  MemoryReader mr(bytes);
+  BufferedReader br(mr);
+  const bool expected_tasks =
+    ParseSeeYou(WaypointFactory(WaypointOrigin::USER), expected, br);
+
+  Waypoints actual;
+  const bool actual_tasks =
+    ParseSeeYou(WaypointFactory(WaypointOrigin::USER), actual, bytes, 4);
+
+  ok1(expected.size() == 5000);
+  ok1(actual.size() == expected.size());
+  ok1(actual_tasks && expected_tasks);
+
+  bool equal = true;
+  for (unsigned id = 1; id <= expected.size(); ++id) {
+    const auto a = actual.LookupId(id), b = expected.LookupId(id);
+    if (a == nullptr || b == nullptr || a->name != b->name ||
+        a->shortname != b->shortname || a->comment != b->comment ||
+        a->location != b->location || a->elevation != b->elevation) {
+      equal = false;
+      break;
+    }
+  }
+
+  ok(equal, "parallel CUP parser, multi_line=%d", multi_line);
+}
+
 static void
 TestCupx()
 {
@@ -501,7 +563,7 @@ int main()
 {
   wp_vector org_wp = CreateOriginalWaypoints();
 
-  plan_tests(507 + 4);
+  plan_tests(507 + 4 + 2 * 4);
 
   TestWinPilot(org_wp);
   TestSeeYou(org_wp);
@@ -514,6 +576,8 @@ int main()
   TestCompeGPS_UTM(org_wp);
   TestCupWriter(org_wp);
   TestCupRoundTrip(org_wp);
+  TestCupParallel(false);
+  TestCupParallel(true);
 
   return exit_status();
 }
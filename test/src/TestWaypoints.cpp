@@ -216,6 +216,47 @@ TestGetNearest(const Waypoints &waypoints, const GeoPoint &center)
   ok1(waypoint->original_id == 6);
 }
 
+static bool
+IsLandable(const Waypoint &waypoint) {
+  return waypoint.IsLandable();
+}
+
+static void
+TestGetNearestN(const Waypoints &waypoints, const GeoPoint &center)
+{
+  auto result = waypoints.GetNearestIf(center, 100000, IsLandable, 4);
+  ok1(result.size() == 4);
+  ok1(result.size() == 4 &&
+      result[0]->original_id == 0 && result[1]->original_id == 3 &&
+      result[2]->original_id == 6 && result[3]->original_id == 7);
+
+  result = waypoints.GetNearestIf(center, 2500, IsLandable, 4);
+  ok1(result.size() == 1);
+
+  result = waypoints.GetNearestIf(center, 1000000, OriginalIDAbove5, 1000);
+  ok1(result.size() == 145);
+
+  bool ascending = true;
+  for (std::size_t i = 1; i < result.size(); ++i)
+    if (result[i]->original_id < result[i - 1]->original_id)
+      ascending = false;
+  ok1(ascending);
+
+  unsigned n = 0;
+  double last_distance = 0;
+  bool conservative = true;
+  waypoints.VisitNearestIf(center, 1000000, IsLandable,
+                           [&](const WaypointPtr &wp, double distance){
+                             if (distance < last_distance ||
+                                 distance > center.Distance(wp->location))
+                               conservative = false;
+                             last_distance = distance;
+                             return ++n < 10;
+                           });
+  ok1(n == 10);
+  ok1(conservative);
+}
+
 static void
 TestIterator(const Waypoints &waypoints)
 {
@@ -283,7 +324,7 @@ main(int argc, char** argv)
   if (!ParseArgs(argc, argv))
     return 0;
 
-  plan_tests(52);
+  plan_tests(59);
 
   Waypoints waypoints;
   GeoPoint center(Angle::Degrees(51.4), Angle::Degrees(7.85));
@@ -299,6 +340,7 @@ main(int argc, char** argv)
   TestNamePrefixVisitor(waypoints);
   TestRangeVisitor(waypoints, center);
   TestGetNearest(waypoints, center);
+  TestGetNearestN(waypoints, center);
   TestIterator(waypoints);
 
   ok(TestCopy(waypoints), "waypoint copy", 0);
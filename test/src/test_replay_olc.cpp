@@ -162,11 +162,12 @@ test_replay(const Contest olc_type,
   flying_state.Reset();
 
   TraceComputer trace_computer;
+  Trace sprint_trace({}, std::chrono::minutes{120}, 128);
 
   ContestManager contest_manager(olc_type,
                                  trace_computer.GetFull(),
                                  trace_computer.GetFull(),
-                                 trace_computer.GetSprint());
+                                 sprint_trace);
   contest_manager.SetHandicap(settings_computer.contest.handicap);
 
   DerivedInfo calculated;
@@ -180,7 +181,8 @@ test_replay(const Contest olc_type,
 
     calculated.flight.flying = true;
     
-    trace_computer.Update(settings_computer, basic, calculated);
+    if (trace_computer.Update(basic, calculated))
+      sprint_trace.push_back(TracePoint(basic));
     
     contest_manager.UpdateIdle();
   
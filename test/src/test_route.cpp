@@ -41,21 +41,28 @@ test_route(const unsigned n_airspaces, const RasterMap& map)
     Directory::Create(Path("output/results"));
     std::ofstream fout("output/results/terrain.txt");
 
-    unsigned nx = 100;
-    unsigned ny = 100;
+    constexpr unsigned nx = 100;
+    constexpr unsigned ny = 100;
     GeoPoint origin(map.GetMapCenter());
 
+    GeoPoint column[ny];
+    TerrainHeight heights[ny];
+
     for (unsigned i = 0; i < nx; ++i) {
       for (unsigned j = 0; j < ny; ++j) {
         auto fx = (double)i / (nx - 1) * 2 - 1;
         auto fy = (double)j / (ny - 1) * 2 - 1;
-        GeoPoint x(origin.longitude + Angle::Degrees(0.2 + 0.7 * fx),
-                   origin.latitude + Angle::Degrees(0.9 * fy));
-        auto h = map.GetInterpolatedHeight(x);
-        fout << x.longitude.Degrees() << " " << x.latitude.Degrees()
-             << " " << h.GetValue() << "\n";
+        column[j] = GeoPoint(origin.longitude + Angle::Degrees(0.2 + 0.7 * fx),
+                             origin.latitude + Angle::Degrees(0.9 * fy));
       }
 
+      map.GetInterpolatedHeights(column, heights);
+
+      for (unsigned j = 0; j < ny; ++j)
+        fout << column[j].longitude.Degrees() << " "
+             << column[j].latitude.Degrees()
+             << " " << heights[j].GetValue() << "\n";
+
       fout << "\n";
     }
 
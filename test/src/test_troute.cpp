@@ -20,6 +20,10 @@
 
 #include <zzip/zzip.h>
 
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
 #include <string.h>
 
 static void
@@ -46,18 +50,22 @@ test_troute(const RasterMap &map, double mwind, double mc, int ceiling)
   {
     Directory::Create(Path("output/results"));
     std::ofstream fout ("output/results/terrain.txt");
-    unsigned nx = 100;
-    unsigned ny = 100;
+    constexpr unsigned nx = 100;
+    constexpr unsigned ny = 100;
+    GeoPoint column[ny];
+    TerrainHeight heights[ny];
     for (unsigned i=0; i< nx; ++i) {
       for (unsigned j=0; j< ny; ++j) {
         auto fx = (double)i / (nx - 1) * 2 - 1;
         auto fy = (double)j / (ny - 1) * 2 - 1;
-        GeoPoint x(origin.longitude + Angle::Degrees(0.6 * fx),
-                   origin.latitude + Angle::Degrees(0.4 * fy));
-        TerrainHeight h = map.GetInterpolatedHeight(x);
-        fout << x.longitude.Degrees() << " " << x.latitude.Degrees()
-             << " " << h.GetValue() << "\n";
+        column[j] = GeoPoint(origin.longitude + Angle::Degrees(0.6 * fx),
+                             origin.latitude + Angle::Degrees(0.4 * fy));
       }
+      map.GetInterpolatedHeights(column, heights);
+      for (unsigned j=0; j< ny; ++j)
+        fout << column[j].longitude.Degrees() << " "
+             << column[j].latitude.Degrees()
+             << " " << heights[j].GetValue() << "\n";
       fout << "\n";
     }
     fout << "\n";
@@ -86,15 +94,103 @@ test_troute(const RasterMap &map, double mwind, double mc, int ceiling)
   // route.UpdatePolar(polar, wind);
 }
 
+[[gnu::pure]]
+static bool
+SameRoute(const Route &a, const Route &b) noexcept
+{
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+                    [](const AGeoPoint &x, const AGeoPoint &y){
+                      return x == y && x.altitude == y.altitude;
+                    });
+}
+
+/**
+ * Solve routes from the map center to destinations around it and
+ * return the time of the fastest of several runs [ms].
+ */
+static double
+TimeSolve(TerrainRoute &route, const RasterMap &map,
+          const RoutePlannerConfig &config, int height,
+          std::vector<Route> &solutions)
+{
+  const GeoPoint origin(map.GetMapCenter());
+  const AGeoPoint aorigin(origin,
+                          map.GetHeight(origin).GetValueOr0() + height);
+
+  double best = 0;
+  for (unsigned i = 0; i < 5; ++i) {
+    solutions.clear();
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (double ang = 0; ang < M_2PI; ang += M_PI / 8) {
+      const GeoPoint dest = GeoVector(40000.0, Angle::Radians(ang))
+        .EndPoint(origin);
+      const int hdest = map.GetHeight(dest).GetValueOr0() + 100;
+
+      /* forget the previous solution, which would make the next
+         Solve() call trivial */
+      route.Reset();
+      route.Solve(aorigin, AGeoPoint(dest, hdest), config, 10000);
+      solutions.push_back(route.GetSolution());
+    }
+
+    const std::chrono::duration<double, std::milli> duration =
+      std::chrono::steady_clock::now() - start;
+    if (i == 0 || duration.count() < best)
+      best = duration.count();
+  }
+
+  return best;
+}
+
+/**
+ * Compare route solve times with and without the #ClearanceGrid.
+ */
+static void
+BenchmarkTroute(const RasterMap &map, double mc)
+{
+  GlideSettings settings;
+  settings.SetDefaults();
+  RoutePlannerConfig config;
+  config.SetDefaults();
+  config.mode = RoutePlannerConfig::Mode::TERRAIN;
+
+  const GlidePolar polar(mc);
+  TerrainRoute route;
+  route.UpdatePolar(settings, config, polar, polar, {});
+  route.SetTerrain(&map);
+
+  for (const int height : {100, 1000}) {
+    std::vector<Route> raster_solutions, grid_solutions;
+
+    route.SetClearanceGridEnabled(false);
+    const double raster = TimeSolve(route, map, config, height,
+                                    raster_solutions);
+
+    route.SetClearanceGridEnabled(true);
+    const double grid = TimeSolve(route, map, config, height,
+                                  grid_solutions);
+
+    printf("# mc=%g, %d m above terrain: 16 routes, "
+           "raster %.2f ms, clearance grid %.2f ms\n",
+           mc, height, raster, grid);
+
+    ok1(std::equal(raster_solutions.begin(), raster_solutions.end(),
+                   grid_solutions.begin(), grid_solutions.end(),
+                   SameRoute));
+  }
+}
+
 int
 main(int argc, char **argv)
 try {
   static const char hc_path[] = "tmp/map.xcm";
   const char *map_path;
-  if ((argc<2) || !strlen(argv[0])) {
+  if ((argc<2) || !strlen(argv[1])) {
     map_path = hc_path;
   } else {
-    map_path = argv[0];
+    map_path = argv[1];
   }
 
   ZZIP_DIR *dir = zzip_dir_open(map_path, nullptr);
@@ -120,7 +216,10 @@ try {
   } while (map.IsDirty());
   zzip_dir_close(dir);
 
-  plan_tests(16*3);
+  plan_tests(16*3 + 3*2);
+  BenchmarkTroute(map, 0.1);
+  BenchmarkTroute(map, 0);
+  BenchmarkTroute(map, 1);
   test_troute(map, 0, 0.1, 10000);
   test_troute(map, 0, 0, 10000);
   test_troute(map, 5.0, 1, 10000);